@@ -0,0 +1,210 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "flag_set.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define FLAG_FILTER_HAS_AVX2_PATH 1
+#endif
+
+// 8 位命中掩码 -> 命中车道号依次排列，每个车道号占 4 bit，供 AVX2 行号压缩使用
+constexpr std::array<uint32_t, 256> make_flag_compress_table()
+{
+    std::array<uint32_t, 256> table{};
+    for (uint32_t mask = 0; mask < 256; ++mask)
+    {
+        uint32_t packed = 0;
+        int out = 0;
+        for (uint32_t lane = 0; lane < 8; ++lane)
+        {
+            if (mask & (1u << lane))
+            {
+                packed |= lane << (out * 4);
+                ++out;
+            }
+        }
+        table[mask] = packed;
+    }
+    return table;
+}
+
+inline constexpr std::array<uint32_t, 256> kFlagCompressTable = make_flag_compress_table();
+
+/* 列式合约状态筛选：对整列 uint32_t 状态字求 "包含 required 全部标志且不含 excluded 任一标志"，
+ * 结果输出为位图（每行 1 bit）或命中行号列表。
+ * x86-64 下提供 AVX2 实现（每次处理 8 行），运行时检测 CPU 支持后自动选择，否则退回标量实现。
+ * AVX2 函数通过 target 属性单独编译，整个工程无需加 -mavx2。*/
+class FlagFilter
+{
+public:
+    using BitmapFn = size_t (*)(const uint32_t *, size_t, uint32_t, uint32_t, uint64_t *);
+    using IndicesFn = size_t (*)(const uint32_t *, size_t, uint32_t, uint32_t, uint32_t *);
+
+    template<typename E>
+    FlagFilter(FlagSet<E> required, FlagSet<E> excluded = FlagSet<E>())
+        : care_(required.raw() | excluded.raw()), expect_(required.raw())
+    {
+    }
+
+    // 写入位图，bitmap 至少 (count + 63) / 64 个字，末尾多余位清零；返回命中行数
+    size_t select_bitmap(const uint32_t *words, size_t count, uint64_t *bitmap) const
+    {
+        return dispatch().bitmap(words, count, care_, expect_, bitmap);
+    }
+
+    // 写入命中行号（升序），indices 容量至少为 count；返回命中行数
+    size_t select_indices(const uint32_t *words, size_t count, uint32_t *indices) const
+    {
+        return dispatch().indices(words, count, care_, expect_, indices);
+    }
+
+    uint32_t care_mask() const { return care_; }
+    uint32_t expect_mask() const { return expect_; }
+
+    static bool has_avx2()
+    {
+#ifdef FLAG_FILTER_HAS_AVX2_PATH
+        static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+        return supported;
+#else
+        return false;
+#endif
+    }
+
+    // 当前选用的实现名称，便于在基准输出和启动日志中确认
+    static const char *implementation_name() { return dispatch().name; }
+
+    static size_t bitmap_scalar(const uint32_t *words, size_t count, uint32_t care, uint32_t expect, uint64_t *bitmap)
+    {
+        return bitmap_tail(words, 0, count, care, expect, bitmap, 0);
+    }
+
+    static size_t indices_scalar(const uint32_t *words, size_t count, uint32_t care, uint32_t expect, uint32_t *indices)
+    {
+        return indices_tail(words, 0, count, care, expect, indices, 0);
+    }
+
+#ifdef FLAG_FILTER_HAS_AVX2_PATH
+    __attribute__((target("avx2,popcnt")))
+    static size_t bitmap_avx2(const uint32_t *words, size_t count, uint32_t care, uint32_t expect, uint64_t *bitmap)
+    {
+        const __m256i care_v = _mm256_set1_epi32(static_cast<int>(care));
+        const __m256i expect_v = _mm256_set1_epi32(static_cast<int>(expect));
+        size_t matched = 0;
+        size_t i = 0;
+
+        // 每 64 行拼成一个位图字
+        for (; i + 64 <= count; i += 64)
+        {
+            uint64_t bits = 0;
+            for (int lane = 0; lane < 8; ++lane)
+            {
+                bits |= static_cast<uint64_t>(match8(words + i + lane * 8, care_v, expect_v)) << (lane * 8);
+            }
+            bitmap[i / 64] = bits;
+            matched += static_cast<size_t>(_mm_popcnt_u64(bits));
+        }
+        return matched + bitmap_tail(words, i, count, care, expect, bitmap, i / 64);
+    }
+
+    __attribute__((target("avx2,popcnt")))
+    static size_t indices_avx2(const uint32_t *words, size_t count, uint32_t care, uint32_t expect, uint32_t *indices)
+    {
+        const __m256i care_v = _mm256_set1_epi32(static_cast<int>(care));
+        const __m256i expect_v = _mm256_set1_epi32(static_cast<int>(expect));
+        const __m256i lane_ids = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256i nibble_shifts = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+        const __m256i nibble_mask = _mm256_set1_epi32(0xF);
+        size_t matched = 0;
+        size_t i = 0;
+
+        // 按 8 行命中掩码查表得到左移压缩用的排列，一次写出 8 个行号，游标只前进命中个数。
+        // matched <= i，因此整块写 8 个不会越过容量 count
+        for (; i + 8 <= count; i += 8)
+        {
+            uint32_t mask = match8(words + i, care_v, expect_v);
+            __m256i perm = _mm256_and_si256(
+                _mm256_srlv_epi32(_mm256_set1_epi32(static_cast<int>(kFlagCompressTable[mask])), nibble_shifts), nibble_mask);
+            __m256i row_ids = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(i)), lane_ids);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(indices + matched), _mm256_permutevar8x32_epi32(row_ids, perm));
+            matched += static_cast<size_t>(_mm_popcnt_u32(mask));
+        }
+        return indices_tail(words, i, count, care, expect, indices, matched);
+    }
+#endif
+
+private:
+    struct Impl
+    {
+        BitmapFn bitmap;
+        IndicesFn indices;
+        const char *name;
+    };
+
+    static const Impl &dispatch()
+    {
+        static const Impl impl = select_impl();
+        return impl;
+    }
+
+    static Impl select_impl()
+    {
+#ifdef FLAG_FILTER_HAS_AVX2_PATH
+        if (has_avx2())
+        {
+            return {&bitmap_avx2, &indices_avx2, "avx2"};
+        }
+#endif
+        return {&bitmap_scalar, &indices_scalar, "scalar"};
+    }
+
+    static bool match(uint32_t word, uint32_t care, uint32_t expect) { return (word & care) == expect; }
+
+    // 从 begin 行开始的标量处理，begin 必须是 64 的倍数
+    static size_t bitmap_tail(const uint32_t *words, size_t begin, size_t count, uint32_t care, uint32_t expect,
+                              uint64_t *bitmap, size_t word_index)
+    {
+        size_t matched = 0;
+        for (size_t i = begin; i < count; i += 64, ++word_index)
+        {
+            size_t end = count - i < 64 ? count : i + 64;
+            uint64_t bits = 0;
+            for (size_t row = i; row < end; ++row)
+            {
+                bits |= static_cast<uint64_t>(match(words[row], care, expect)) << (row - i);
+            }
+            bitmap[word_index] = bits;
+            matched += static_cast<size_t>(__builtin_popcountll(bits));
+        }
+        return matched;
+    }
+
+    // 无分支写法：总是写入当前行号，命中时游标前进
+    static size_t indices_tail(const uint32_t *words, size_t begin, size_t count, uint32_t care, uint32_t expect,
+                               uint32_t *indices, size_t matched)
+    {
+        for (size_t row = begin; row < count; ++row)
+        {
+            indices[matched] = static_cast<uint32_t>(row);
+            matched += match(words[row], care, expect);
+        }
+        return matched;
+    }
+
+#ifdef FLAG_FILTER_HAS_AVX2_PATH
+    // 8 行状态字的命中掩码，第 k 位对应第 k 行
+    __attribute__((target("avx2")))
+    static uint32_t match8(const uint32_t *words, __m256i care_v, __m256i expect_v)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(words));
+        __m256i eq = _mm256_cmpeq_epi32(_mm256_and_si256(v, care_v), expect_v);
+        return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(eq)));
+    }
+#endif
+
+    uint32_t care_;
+    uint32_t expect_;
+};
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <type_traits>
+
+/* 类型安全的标志位集合：枚举值表示位序号，掩码在编译期计算。
+ * 只能与同一枚举类型的标志组合，避免把不同含义的 int 常量混用；
+ * 大小与底层整数相同，可以直接按数组存放并参与向量化。*/
+template<typename E>
+class FlagSet
+{
+    static_assert(std::is_enum<E>::value, "FlagSet requires an enum type");
+
+public:
+    using underlying_type = std::make_unsigned_t<std::underlying_type_t<E>>;
+
+    constexpr FlagSet() = default;
+    constexpr FlagSet(E flag) : bits_(mask(flag)) {}
+    constexpr FlagSet(std::initializer_list<E> flags)
+    {
+        for (E flag : flags)
+        {
+            bits_ |= mask(flag);
+        }
+    }
+
+    // 由原始状态字构造，用于与现有 int 标志字段互转
+    static constexpr FlagSet from_raw(underlying_type bits)
+    {
+        FlagSet result;
+        result.bits_ = bits;
+        return result;
+    }
+
+    static constexpr underlying_type mask(E flag)
+    {
+        return static_cast<underlying_type>(underlying_type(1) << static_cast<underlying_type>(flag));
+    }
+
+    constexpr underlying_type raw() const { return bits_; }
+
+    // 设置标志
+    constexpr FlagSet &set(FlagSet flags)
+    {
+        bits_ |= flags.bits_;
+        return *this;
+    }
+
+    // 清除标志
+    constexpr FlagSet &clear(FlagSet flags)
+    {
+        bits_ &= static_cast<underlying_type>(~flags.bits_);
+        return *this;
+    }
+
+    // 检查单个标志
+    constexpr bool test(E flag) const { return (bits_ & mask(flag)) != 0; }
+
+    // 任一 / 全部 / 都不 包含在给定集合中
+    constexpr bool any(FlagSet flags) const { return (bits_ & flags.bits_) != 0; }
+    constexpr bool all(FlagSet flags) const { return (bits_ & flags.bits_) == flags.bits_; }
+    constexpr bool none(FlagSet flags) const { return (bits_ & flags.bits_) == 0; }
+
+    // 包含 required 中全部标志且不含 excluded 中任何标志，合并为一次掩码比较
+    constexpr bool matches(FlagSet required, FlagSet excluded) const
+    {
+        return (bits_ & (required.bits_ | excluded.bits_)) == required.bits_;
+    }
+
+    constexpr bool empty() const { return bits_ == 0; }
+
+    // 已设置的标志个数
+    constexpr int count() const
+    {
+#if defined(__GNUC__)
+        // 先扩展到 64 位，底层类型为 uint64_t 时也不截断
+        return __builtin_popcountll(static_cast<unsigned long long>(bits_));
+#else
+        int n = 0;
+        for (underlying_type bits = bits_; bits != 0; bits &= bits - 1)
+        {
+            ++n;
+        }
+        return n;
+#endif
+    }
+
+    constexpr FlagSet operator|(FlagSet other) const { return from_raw(bits_ | other.bits_); }
+    constexpr FlagSet operator&(FlagSet other) const { return from_raw(bits_ & other.bits_); }
+    constexpr FlagSet operator^(FlagSet other) const { return from_raw(bits_ ^ other.bits_); }
+    constexpr FlagSet operator~() const { return from_raw(static_cast<underlying_type>(~bits_)); }
+
+    constexpr FlagSet &operator|=(FlagSet other) { return set(other); }
+    constexpr FlagSet &operator&=(FlagSet other)
+    {
+        bits_ &= other.bits_;
+        return *this;
+    }
+
+    constexpr bool operator==(FlagSet other) const { return bits_ == other.bits_; }
+    constexpr bool operator!=(FlagSet other) const { return bits_ != other.bits_; }
+
+private:
+    underlying_type bits_ = 0;
+};
+
+/* 合约状态标志，位序号与 bitflag_benchmark.cpp 中 IntValueFlags 的取值一一对应 */
+enum class InstrumentFlag : uint32_t
+{
+    RiskWarning = 0,
+    Delisted = 1,
+    Transferred = 2,
+    NotProfitable = 3,
+    DualClassShares = 4,
+    CDR = 5,
+    Registered = 6,
+    DelistedFinal = 7,
+};
+
+using InstrumentFlags = FlagSet<InstrumentFlag>;
+
+// 同一枚举的标志用 | 直接组合成集合
+constexpr InstrumentFlags operator|(InstrumentFlag lhs, InstrumentFlag rhs)
+{
+    return InstrumentFlags(lhs) | InstrumentFlags(rhs);
+}
+
+static_assert(sizeof(InstrumentFlags) == sizeof(uint32_t), "FlagSet must stay the size of its status word");
+static_assert(InstrumentFlags::mask(InstrumentFlag::Registered) == 64, "bit positions must match IntValueFlags");
+static_assert((InstrumentFlag::RiskWarning | InstrumentFlag::Delisted).count() == 2, "masks are computed at compile time");
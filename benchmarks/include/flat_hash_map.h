@@ -0,0 +1,374 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* 开放寻址哈希表（SwissTable 风格），用于合约字典这类"建好后以查找为主"的场景。
+ * 槽位按 16 个一组，每个槽位对应 1 字节控制字：最高位为 1 表示空/已删除，
+ * 否则低 7 位存放哈希值的 H2 部分。查找时用 SSE2 一次比较整组 16 个控制字，
+ * 只有 H2 命中的槽位才比较 key；元素连续存放在一块内存中，没有 unordered_map 的节点跳转。
+ * 哈希值的高位 (H1) 决定起始组，组间按三角数序列探测。
+ * 要求 Hash 输出的各个位都足够均匀，MarketInstKey 自带的缓存哈希满足这一点。*/
+template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class FlatHashMap
+{
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<const Key, Value>;
+
+    template<bool IsConst>
+    class Iterator
+    {
+    public:
+        using map_ptr = typename std::conditional<IsConst, const FlatHashMap *, FlatHashMap *>::type;
+        using reference = typename std::conditional<IsConst, const value_type &, value_type &>::type;
+        using pointer = typename std::conditional<IsConst, const value_type *, value_type *>::type;
+
+        Iterator(map_ptr map, std::size_t index) : map_(map), index_(index) { skip_empty(); }
+
+        reference operator*() const { return map_->slots_[index_]; }
+        pointer operator->() const { return &map_->slots_[index_]; }
+
+        Iterator &operator++()
+        {
+            ++index_;
+            skip_empty();
+            return *this;
+        }
+
+        bool operator==(const Iterator &other) const { return index_ == other.index_; }
+        bool operator!=(const Iterator &other) const { return index_ != other.index_; }
+
+    private:
+        void skip_empty()
+        {
+            while (index_ < map_->capacity_ && !is_full(map_->ctrl_[index_]))
+            {
+                ++index_;
+            }
+        }
+
+        map_ptr map_;
+        std::size_t index_;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    FlatHashMap() = default;
+
+    explicit FlatHashMap(std::size_t expected_size) { reserve(expected_size); }
+
+    FlatHashMap(const FlatHashMap &) = delete;
+    FlatHashMap &operator=(const FlatHashMap &) = delete;
+
+    FlatHashMap(FlatHashMap &&other) noexcept { swap(other); }
+
+    FlatHashMap &operator=(FlatHashMap &&other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            swap(other);
+        }
+        return *this;
+    }
+
+    ~FlatHashMap() { release(); }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, capacity_); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, capacity_); }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    std::size_t capacity() const { return capacity_; }
+
+    // 查找，未找到返回 nullptr
+    Value *find(const Key &key)
+    {
+        std::size_t index = find_index(key, Hash()(key));
+        return index == kNotFound ? nullptr : &slots_[index].second;
+    }
+
+    const Value *find(const Key &key) const
+    {
+        std::size_t index = find_index(key, Hash()(key));
+        return index == kNotFound ? nullptr : &slots_[index].second;
+    }
+
+    bool contains(const Key &key) const { return find(key) != nullptr; }
+
+    // 插入，key 已存在时不覆盖；返回值指针与是否新插入
+    template<typename... Args>
+    std::pair<Value *, bool> emplace(const Key &key, Args &&...args)
+    {
+        std::size_t hash = Hash()(key);
+        std::size_t index = find_index(key, hash);
+        if (index != kNotFound)
+        {
+            return {&slots_[index].second, false};
+        }
+
+        if ((size_ + deleted_ + 1) * 8 > capacity_ * 7)
+        {
+            rehash(size_ + 1 > capacity_ * 7 / 16 ? capacity_ * 2 : capacity_);
+        }
+
+        index = find_insert_index(hash);
+        if (ctrl_[index] == kDeleted)
+        {
+            --deleted_;
+        }
+        ctrl_[index] = h2(hash);
+        new (&slots_[index]) value_type(std::piecewise_construct, std::forward_as_tuple(key),
+                                        std::forward_as_tuple(std::forward<Args>(args)...));
+        ++size_;
+        return {&slots_[index].second, true};
+    }
+
+    // 插入或覆盖
+    void insert_or_assign(const Key &key, const Value &value)
+    {
+        auto result = emplace(key, value);
+        if (!result.second)
+        {
+            *result.first = value;
+        }
+    }
+
+    Value &operator[](const Key &key) { return *emplace(key).first; }
+
+    // 删除，返回是否存在
+    bool erase(const Key &key)
+    {
+        std::size_t index = find_index(key, Hash()(key));
+        if (index == kNotFound)
+        {
+            return false;
+        }
+
+        slots_[index].~value_type();
+        --size_;
+        // 所在组从未被填满时，没有探测序列越过它，可以直接置空；否则留下墓碑
+        if (match_empty(group_start(index)) != 0)
+        {
+            ctrl_[index] = kEmpty;
+        }
+        else
+        {
+            ctrl_[index] = kDeleted;
+            ++deleted_;
+        }
+        return true;
+    }
+
+    void clear()
+    {
+        destroy_slots();
+        if (ctrl_)
+        {
+            std::memset(ctrl_, static_cast<unsigned char>(kEmpty), capacity_);
+        }
+        size_ = 0;
+        deleted_ = 0;
+    }
+
+    // 预留空间，保证插入 expected_size 个元素之前不会扩容
+    void reserve(std::size_t expected_size)
+    {
+        std::size_t needed = kGroupWidth;
+        while (needed * 7 / 8 < expected_size)
+        {
+            needed *= 2;
+        }
+        if (needed > capacity_)
+        {
+            rehash(needed);
+        }
+    }
+
+    void swap(FlatHashMap &other) noexcept
+    {
+        std::swap(ctrl_, other.ctrl_);
+        std::swap(slots_, other.slots_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(size_, other.size_);
+        std::swap(deleted_, other.deleted_);
+    }
+
+private:
+    static constexpr std::size_t kGroupWidth = 16;
+    static constexpr std::size_t kNotFound = static_cast<std::size_t>(-1);
+    static constexpr int8_t kEmpty = -128;  // 0b10000000
+    static constexpr int8_t kDeleted = -2;  // 0b11111110
+
+    static bool is_full(int8_t ctrl) { return ctrl >= 0; }
+    static int8_t h2(std::size_t hash) { return static_cast<int8_t>(hash & 0x7F); }
+    static std::size_t h1(std::size_t hash) { return hash >> 7; }
+    static std::size_t group_start(std::size_t index) { return index & ~(kGroupWidth - 1); }
+
+    // 组内与 h2 相等的槽位掩码，每位对应一个槽位
+    uint32_t match(std::size_t group, int8_t value) const
+    {
+#if defined(__SSE2__)
+        __m128i ctrl = _mm_load_si128(reinterpret_cast<const __m128i *>(ctrl_ + group));
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(value))));
+#else
+        uint32_t mask = 0;
+        for (std::size_t i = 0; i < kGroupWidth; ++i)
+        {
+            mask |= static_cast<uint32_t>(ctrl_[group + i] == value) << i;
+        }
+        return mask;
+#endif
+    }
+
+    uint32_t match_empty(std::size_t group) const { return capacity_ == 0 ? 0 : match(group, kEmpty); }
+
+    // 空槽或墓碑（最高位为 1）的掩码
+    uint32_t match_empty_or_deleted(std::size_t group) const
+    {
+#if defined(__SSE2__)
+        __m128i ctrl = _mm_load_si128(reinterpret_cast<const __m128i *>(ctrl_ + group));
+        return static_cast<uint32_t>(_mm_movemask_epi8(ctrl));
+#else
+        uint32_t mask = 0;
+        for (std::size_t i = 0; i < kGroupWidth; ++i)
+        {
+            mask |= static_cast<uint32_t>(ctrl_[group + i] < 0) << i;
+        }
+        return mask;
+#endif
+    }
+
+    static int lowest_bit(uint32_t mask) { return __builtin_ctz(mask); }
+
+    std::size_t find_index(const Key &key, std::size_t hash) const
+    {
+        if (capacity_ == 0)
+        {
+            return kNotFound;
+        }
+
+        const std::size_t group_mask = capacity_ / kGroupWidth - 1;
+        const int8_t tag = h2(hash);
+        std::size_t group = h1(hash) & group_mask;
+        for (std::size_t step = 1;; ++step)
+        {
+            std::size_t base = group * kGroupWidth;
+            for (uint32_t mask = match(base, tag); mask != 0; mask &= mask - 1)
+            {
+                std::size_t index = base + lowest_bit(mask);
+                if (KeyEqual()(slots_[index].first, key))
+                {
+                    return index;
+                }
+            }
+            // 组内还有空槽说明探测链到此为止
+            if (match(base, kEmpty) != 0 || step > group_mask)
+            {
+                return kNotFound;
+            }
+            group = (group + step) & group_mask;
+        }
+    }
+
+    // 调用前保证表中有空位
+    std::size_t find_insert_index(std::size_t hash) const
+    {
+        const std::size_t group_mask = capacity_ / kGroupWidth - 1;
+        std::size_t group = h1(hash) & group_mask;
+        for (std::size_t step = 1;; ++step)
+        {
+            std::size_t base = group * kGroupWidth;
+            uint32_t mask = match_empty_or_deleted(base);
+            if (mask != 0)
+            {
+                return base + lowest_bit(mask);
+            }
+            group = (group + step) & group_mask;
+        }
+    }
+
+    void rehash(std::size_t new_capacity)
+    {
+        if (new_capacity < kGroupWidth)
+        {
+            new_capacity = kGroupWidth;
+        }
+
+        int8_t *old_ctrl = ctrl_;
+        value_type *old_slots = slots_;
+        std::size_t old_capacity = capacity_;
+
+        ctrl_ = static_cast<int8_t *>(::operator new(new_capacity, std::align_val_t(kGroupWidth)));
+        std::memset(ctrl_, static_cast<unsigned char>(kEmpty), new_capacity);
+        slots_ = static_cast<value_type *>(::operator new(new_capacity * sizeof(value_type),
+                                                          std::align_val_t(alignof(value_type))));
+        capacity_ = new_capacity;
+        deleted_ = 0;
+
+        for (std::size_t i = 0; i < old_capacity; ++i)
+        {
+            if (is_full(old_ctrl[i]))
+            {
+                std::size_t hash = Hash()(old_slots[i].first);
+                std::size_t index = find_insert_index(hash);
+                ctrl_[index] = h2(hash);
+                new (&slots_[index]) value_type(std::move(old_slots[i]));
+                old_slots[i].~value_type();
+            }
+        }
+
+        if (old_ctrl)
+        {
+            ::operator delete(old_ctrl, std::align_val_t(kGroupWidth));
+            ::operator delete(old_slots, std::align_val_t(alignof(value_type)));
+        }
+    }
+
+    void destroy_slots()
+    {
+        for (std::size_t i = 0; i < capacity_; ++i)
+        {
+            if (is_full(ctrl_[i]))
+            {
+                slots_[i].~value_type();
+            }
+        }
+    }
+
+    void release()
+    {
+        if (ctrl_)
+        {
+            destroy_slots();
+            ::operator delete(ctrl_, std::align_val_t(kGroupWidth));
+            ::operator delete(slots_, std::align_val_t(alignof(value_type)));
+        }
+        ctrl_ = nullptr;
+        slots_ = nullptr;
+        capacity_ = 0;
+        size_ = 0;
+        deleted_ = 0;
+    }
+
+    int8_t *ctrl_ = nullptr;
+    value_type *slots_ = nullptr;
+    std::size_t capacity_ = 0;
+    std::size_t size_ = 0;
+    std::size_t deleted_ = 0;
+};
@@ -1,6 +1,48 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+
+/* 定长内联字符串，容量固定在对象内部，拼接不分配堆内存 */
+template<std::size_t Capacity>
+class FixedString
+{
+public:
+    FixedString() { data_[0] = '\0'; }
+
+    const char *data() const { return data_; }
+    const char *c_str() const { return data_; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    static constexpr std::size_t capacity() { return Capacity; }
+
+    std::string_view view() const { return std::string_view(data_, size_); }
+    operator std::string_view() const { return view(); }
+    std::string str() const { return std::string(data_, size_); }
+
+    // 供格式化函数直接写入，写完后调用 resize 设置长度
+    char *buffer() { return data_; }
+
+    void resize(std::size_t size)
+    {
+        size_ = size < Capacity ? size : Capacity;
+        data_[size_] = '\0';
+    }
+
+    bool operator==(std::string_view other) const { return view() == other; }
+
+private:
+    char data_[Capacity + 1];
+    std::size_t size_ = 0;
+};
 
 /* 市场合约，暗盘需要单独设置标志位*/
 struct MarketInst
@@ -26,6 +68,8 @@ struct MarketInst
         flag = other.flag;
     }
 
+    MarketInst(MarketInst &&other) noexcept = default;
+
     MarketInst& operator=(const MarketInst &other)
     {
         if (this != &other)
@@ -37,6 +81,8 @@ struct MarketInst
         return *this;
     }
 
+    MarketInst& operator=(MarketInst &&other) noexcept = default;
+
     bool operator==(const MarketInst &other) const
     {
         return market == other.market && inst == other.inst && flag == other.flag;
@@ -57,6 +103,73 @@ struct MarketInst
     {
         return market + "_" + inst + "_" + std::to_string(flag);
     }
+
+    // GetKey 的无分配版本，格式相同，写入调用方提供的缓冲区（不补 '\0'）
+    // 返回写入长度，缓冲区不足时返回 0 且缓冲区内容未定义
+    std::size_t FormatKey(char *buf, std::size_t size) const
+    {
+        std::size_t prefix = market.size() + inst.size() + 2;
+        if (prefix >= size)
+        {
+            return 0;
+        }
+
+        char *p = buf;
+        std::memcpy(p, market.data(), market.size());
+        p += market.size();
+        *p++ = '_';
+        std::memcpy(p, inst.data(), inst.size());
+        p += inst.size();
+        *p++ = '_';
+
+        auto result = std::to_chars(p, buf + size, flag);
+        if (result.ec != std::errc())
+        {
+            return 0;
+        }
+        return static_cast<std::size_t>(result.ptr - buf);
+    }
+
+    using KeyString = FixedString<64>;
+
+    // 返回内联字符串形式的 key，超出容量时抛出 std::length_error
+    KeyString GetKeyInline() const
+    {
+        KeyString key;
+        std::size_t len = FormatKey(key.buffer(), KeyString::capacity());
+        if (len == 0)
+        {
+            throw std::length_error("MarketInst: key longer than KeyString capacity");
+        }
+        key.resize(len);
+        return key;
+    }
+
+    // 解析 GetKey/FormatKey 生成的 key。市场代码不含 '_'，合约代码中允许出现 '_'，
+    // 因此以第一个 '_' 和最后一个 '_' 分隔。格式错误时返回 false，out 不变
+    static bool ParseKey(std::string_view key, MarketInst &out)
+    {
+        std::size_t first = key.find('_');
+        std::size_t last = key.rfind('_');
+        if (first == std::string_view::npos || first == last)
+        {
+            return false;
+        }
+
+        int parsed_flag = 0;
+        const char *flag_begin = key.data() + last + 1;
+        const char *flag_end = key.data() + key.size();
+        auto result = std::from_chars(flag_begin, flag_end, parsed_flag);
+        if (result.ec != std::errc() || result.ptr != flag_end || flag_begin == flag_end)
+        {
+            return false;
+        }
+
+        out.market.assign(key.data(), first);
+        out.inst.assign(key.data() + first + 1, last - first - 1);
+        out.flag = parsed_flag;
+        return true;
+    }
 };
 
 struct HashMarketInst
@@ -66,3 +179,154 @@ struct HashMarketInst
         return ((std::hash<std::string>()(other.market) ^ (std::hash<std::string>()(other.inst) << 1)) >> 1) ^ (std::hash<int>()(other.flag) << 1);
     }
 };
+
+
+/* 市场代码驻留表：市场数量很少（SH/SZ/HK/US...），统一映射成小整数编号。
+ * 注册走互斥锁，按编号取名字无锁：条目写入后不再修改，通过 count_ 的 release/acquire 发布。*/
+class MarketCodeTable
+{
+public:
+    static constexpr uint32_t kMaxMarkets = 256;
+
+    static MarketCodeTable &instance()
+    {
+        static MarketCodeTable table;
+        return table;
+    }
+
+    // 返回市场代码对应的编号，不存在则注册
+    uint32_t intern(std::string_view market)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        auto it = ids_.find(std::string(market));
+        if (it != ids_.end())
+        {
+            return it->second;
+        }
+
+        uint32_t id = count_.load(std::memory_order_relaxed);
+        if (id >= kMaxMarkets)
+        {
+            throw std::length_error("MarketCodeTable: too many market codes");
+        }
+        names_[id] = std::string(market);
+        ids_.emplace(names_[id], id);
+        count_.store(id + 1, std::memory_order_release);
+        return id;
+    }
+
+    const std::string &name(uint32_t id) const
+    {
+        if (id >= count_.load(std::memory_order_acquire))
+        {
+            throw std::out_of_range("MarketCodeTable: unknown market id");
+        }
+        return names_[id];
+    }
+
+private:
+    MarketCodeTable() = default;
+
+    std::mutex mtx_;
+    std::unordered_map<std::string, uint32_t> ids_;
+    std::array<std::string, kMaxMarkets> names_;
+    std::atomic<uint32_t> count_{0};
+};
+
+/* MarketInst 的定长紧凑版本，用作哈希表 key：
+ * 合约代码内联存放在两个 64 位字中（最长 16 字节，不足补 0），市场代码驻留为编号，
+ * 构造时计算一次哈希并缓存。整个结构 32 字节、可平凡拷贝，比较和哈希都不访问堆内存。*/
+struct MarketInstKey
+{
+    static constexpr std::size_t kMaxInstLength = 16;
+
+    uint64_t inst_words[2] = {0, 0};
+    uint32_t market_id = 0;
+    // 0-正常，1-暗盘
+    int32_t flag = 0;
+    uint64_t hash = 0;
+
+    MarketInstKey() { hash = compute_hash(); }
+
+    MarketInstKey(std::string_view market, std::string_view inst, int flag = 0)
+        : MarketInstKey(MarketCodeTable::instance().intern(market), inst, flag)
+    {
+    }
+
+    // 市场编号已知时跳过驻留表查找
+    MarketInstKey(uint32_t market_id, std::string_view inst, int flag = 0)
+        : market_id(market_id), flag(flag)
+    {
+        if (inst.size() > kMaxInstLength)
+        {
+            throw std::length_error("MarketInstKey: instrument code longer than 16 bytes");
+        }
+        std::memcpy(inst_words, inst.data(), inst.size());
+        hash = compute_hash();
+    }
+
+    explicit MarketInstKey(const MarketInst &mi)
+        : MarketInstKey(mi.market, mi.inst, mi.flag)
+    {
+    }
+
+    std::string_view inst() const
+    {
+        const char *chars = reinterpret_cast<const char *>(inst_words);
+        std::size_t len = 0;
+        while (len < kMaxInstLength && chars[len] != '\0')
+        {
+            ++len;
+        }
+        return std::string_view(chars, len);
+    }
+
+    const std::string &market() const
+    {
+        return MarketCodeTable::instance().name(market_id);
+    }
+
+    MarketInst ToMarketInst() const
+    {
+        return MarketInst(market(), std::string(inst()), flag);
+    }
+
+    // 哈希不同则必然不等，先比缓存的哈希可以尽早退出
+    bool operator==(const MarketInstKey &other) const
+    {
+        return hash == other.hash && inst_words[0] == other.inst_words[0] && inst_words[1] == other.inst_words[1] &&
+               market_id == other.market_id && flag == other.flag;
+    }
+
+    bool operator!=(const MarketInstKey &other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    static uint64_t mix(uint64_t h)
+    {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    uint64_t compute_hash() const
+    {
+        uint64_t h = mix(inst_words[0] ^ (static_cast<uint64_t>(market_id) << 32 | static_cast<uint32_t>(flag)));
+        return mix(h ^ inst_words[1]);
+    }
+};
+
+static_assert(sizeof(MarketInstKey) == 32, "MarketInstKey should stay compact");
+
+struct HashMarketInstKey
+{
+    std::size_t operator()(const MarketInstKey &key) const
+    {
+        return static_cast<std::size_t>(key.hash);
+    }
+};
@@ -1,8 +1,16 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <unordered_map>
 
 template<typename Key, typename Value>
 class ThreadSafeMap
@@ -99,3 +107,286 @@ private:
     mutable std::mutex mtx_;
     std::map<Key, Value> map_;
 };
+
+
+/* 分片版本：按 key 的哈希值划分到 ShardCount 个桶，每个桶独立持有一把读写锁，
+ * 读操作 (get/contains/size) 只加共享锁，不同分片之间互不阻塞。
+ * 接口与 ThreadSafeMap 保持一致，底层换成 unordered_map，不再保证有序。*/
+template<typename Key, typename Value, typename Hash = std::hash<Key>, std::size_t ShardCount = 16>
+class ShardedThreadSafeMap
+{
+    static_assert(ShardCount > 0 && (ShardCount & (ShardCount - 1)) == 0, "ShardCount must be a power of two");
+
+public:
+    using map_type = std::unordered_map<Key, Value, Hash>;
+
+    // 默认构造函数
+    ShardedThreadSafeMap() = default;
+
+    // 拷贝构造函数，逐个分片加锁拷贝
+    ShardedThreadSafeMap(const ShardedThreadSafeMap &other)
+    {
+        for (std::size_t i = 0; i < ShardCount; ++i)
+        {
+            std::shared_lock<std::shared_mutex> lock(other.shards_[i].mtx);
+            shards_[i].map = other.shards_[i].map;
+        }
+    }
+
+    // 移动构造函数
+    ShardedThreadSafeMap(ShardedThreadSafeMap &&other) noexcept
+    {
+        for (std::size_t i = 0; i < ShardCount; ++i)
+        {
+            std::unique_lock<std::shared_mutex> lock(other.shards_[i].mtx);
+            shards_[i].map = std::move(other.shards_[i].map);
+        }
+    }
+
+    // 插入或更新键值对
+    void insert(const Key &key, const Value &value)
+    {
+        Shard &shard = shard_for(key);
+        std::unique_lock<std::shared_mutex> lock(shard.mtx);
+        shard.map[key] = value;
+    }
+
+    // 获取值
+    bool get(const Key &key, Value &value) const
+    {
+        const Shard &shard = shard_for(key);
+        std::shared_lock<std::shared_mutex> lock(shard.mtx);
+        auto it = shard.map.find(key);
+        if (it != shard.map.end())
+        {
+            value = it->second;
+            return true;
+        }
+        return false;
+    }
+
+    // 删除键值对
+    void erase(const Key &key)
+    {
+        Shard &shard = shard_for(key);
+        std::unique_lock<std::shared_mutex> lock(shard.mtx);
+        shard.map.erase(key);
+    }
+
+    // 检查键是否存在
+    bool contains(const Key &key) const
+    {
+        const Shard &shard = shard_for(key);
+        std::shared_lock<std::shared_mutex> lock(shard.mtx);
+        return shard.map.find(key) != shard.map.end();
+    }
+
+    // 操作符号[]，返回实际存储对象的引用（unordered_map 重哈希不会使元素引用失效）
+    Value &operator[](const Key &key)
+    {
+        Shard &shard = shard_for(key);
+        std::unique_lock<std::shared_mutex> lock(shard.mtx);
+        return shard.map[key];
+    }
+
+    // emplace接口，先构造出键值对才能确定所在分片
+    template<typename... Args>
+    std::pair<typename map_type::iterator, bool> emplace(Args &&...args)
+    {
+        typename map_type::value_type kv(std::forward<Args>(args)...);
+        Shard &shard = shard_for(kv.first);
+        std::unique_lock<std::shared_mutex> lock(shard.mtx);
+        return shard.map.emplace(std::move(kv));
+    }
+
+    // 清空接口
+    void clear()
+    {
+        for (auto &shard : shards_)
+        {
+            std::unique_lock<std::shared_mutex> lock(shard.mtx);
+            shard.map.clear();
+        }
+    }
+
+    // 获取大小，各分片依次统计，并发写入时只是近似值
+    size_t size() const
+    {
+        size_t total = 0;
+        for (const auto &shard : shards_)
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mtx);
+            total += shard.map.size();
+        }
+        return total;
+    }
+
+    // 获取底层map的副本，各分片依次加锁合并
+    map_type get_map_copy() const
+    {
+        map_type result;
+        for (const auto &shard : shards_)
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mtx);
+            result.insert(shard.map.begin(), shard.map.end());
+        }
+        return result;
+    }
+
+private:
+    // 每个分片独占缓存行，避免相邻分片的锁互相伪共享
+    struct alignas(64) Shard
+    {
+        mutable std::shared_mutex mtx;
+        map_type map;
+    };
+
+    // 分片下标对哈希值再混合一次后取低位，避免 std::hash 对整数是恒等映射导致分布不均
+    static std::size_t shard_index(const Key &key)
+    {
+        std::size_t h = Hash()(key);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return h & (ShardCount - 1);
+    }
+
+    Shard &shard_for(const Key &key) { return shards_[shard_index(key)]; }
+    const Shard &shard_for(const Key &key) const { return shards_[shard_index(key)]; }
+
+    std::array<Shard, ShardCount> shards_;
+};
+
+/* 写时复制版本：适用于读远多于写的参考数据（如合约字典）。
+ * 写者在写锁内复制当前 map、修改后以 shared_ptr 原子发布新快照，旧快照由最后一个持有者释放；
+ * 读者不加任何锁，get_map_copy() 只返回快照句柄，O(1)。
+ * 由于快照不可变，不提供返回内部引用的 operator[]，批量修改请使用 update() 合并成一次复制。*/
+template<typename Key, typename Value>
+class CowThreadSafeMap
+{
+public:
+    using map_type = std::map<Key, Value>;
+    using snapshot_type = std::shared_ptr<const map_type>;
+
+    // 默认构造函数
+    CowThreadSafeMap() { publish(std::make_shared<const map_type>()); }
+
+    // 拷贝构造函数，快照不可变，直接共享即可
+    CowThreadSafeMap(const CowThreadSafeMap &other) { publish(other.get_map_copy()); }
+
+    // 移动构造函数：被移走的对象重新持有一个空快照，分配可能抛出，因此不是 noexcept
+    CowThreadSafeMap(CowThreadSafeMap &&other)
+    {
+        publish(other.get_map_copy());
+        other.publish(std::make_shared<const map_type>());
+    }
+
+    // 插入或更新键值对
+    void insert(const Key &key, const Value &value)
+    {
+        update([&](map_type &map) { map[key] = value; });
+    }
+
+    // 获取值
+    bool get(const Key &key, Value &value) const
+    {
+        const map_type &map = local_snapshot();
+        auto it = map.find(key);
+        if (it != map.end())
+        {
+            value = it->second;
+            return true;
+        }
+        return false;
+    }
+
+    // 删除键值对
+    void erase(const Key &key)
+    {
+        update([&](map_type &map) { map.erase(key); });
+    }
+
+    // 检查键是否存在
+    bool contains(const Key &key) const
+    {
+        const map_type &map = local_snapshot();
+        return map.find(key) != map.end();
+    }
+
+    // emplace接口，返回是否插入成功（迭代器指向的快照随时可能被替换，因此不返回迭代器）
+    template<typename... Args>
+    bool emplace(Args &&...args)
+    {
+        bool inserted = false;
+        update([&](map_type &map) { inserted = map.emplace(std::forward<Args>(args)...).second; });
+        return inserted;
+    }
+
+    // 批量修改：一次复制、一次发布，func 的签名为 void(map_type &)
+    template<typename Func>
+    void update(Func &&func)
+    {
+        std::lock_guard<std::mutex> lock(write_mtx_);
+        auto next = std::make_shared<map_type>(*get_map_copy());
+        func(*next);
+        publish(std::move(next));
+    }
+
+    // 清空接口，无需复制
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(write_mtx_);
+        publish(std::make_shared<const map_type>());
+    }
+
+    // 获取大小
+    size_t size() const
+    {
+        return local_snapshot().size();
+    }
+
+    // 获取当前快照句柄，持有期间内容不会变化
+    snapshot_type get_map_copy() const
+    {
+        return std::atomic_load_explicit(&snapshot_, std::memory_order_acquire);
+    }
+
+private:
+    // 先发布快照再发布版本号，读者看到新版本号时一定能读到不旧于它的快照
+    void publish(snapshot_type next)
+    {
+        std::atomic_store_explicit(&snapshot_, std::move(next), std::memory_order_release);
+        version_.store(next_version().fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // 版本号全局唯一，多个实例共用线程缓存时不会误命中
+    static std::atomic<uint64_t> &next_version()
+    {
+        static std::atomic<uint64_t> counter{0};
+        return counter;
+    }
+
+    // 读路径：每个线程缓存一份快照，版本号未变时只有一次原子读，不触碰引用计数；
+    // 代价是每个读线程最多额外持有一份旧快照，直到它下一次读取
+    const map_type &local_snapshot() const
+    {
+        struct Cache
+        {
+            uint64_t version = 0;
+            snapshot_type snapshot;
+        };
+        thread_local Cache cache;
+
+        uint64_t current = version_.load(std::memory_order_acquire);
+        if (cache.version != current)
+        {
+            cache.snapshot = get_map_copy();
+            cache.version = current;
+        }
+        return *cache.snapshot;
+    }
+
+    std::mutex write_mtx_;
+    snapshot_type snapshot_;
+    std::atomic<uint64_t> version_{0};
+};
@@ -1,6 +1,10 @@
 #include <benchmark/benchmark.h>
 #include <cstdint>
 #include <array>
+#include <random>
+#include <vector>
+#include "flag_filter.h"
+#include "flag_set.h"
 
 // 位标志方法：使用 uint32_t 来存储 8 个标志
 class BitFlags {
@@ -117,3 +121,265 @@ static void BM_IntValueFlags_ClearFlag(benchmark::State& state) {
 }
 
 BENCHMARK(BM_IntValueFlags_ClearFlag);
+
+// 基准测试：使用 FlagSet 设置标志
+static void BM_FlagSet_SetFlag(benchmark::State& state) {
+    InstrumentFlags flags;
+    for (auto _ : state) {
+        flags.set(InstrumentFlag::Transferred);  // 设置 Transferred 标志
+        benchmark::DoNotOptimize(flags);  // 防止优化
+    }
+}
+BENCHMARK(BM_FlagSet_SetFlag);
+
+// 基准测试：使用 FlagSet 检查标志
+static void BM_FlagSet_CheckFlag(benchmark::State& state) {
+    InstrumentFlags flags(InstrumentFlag::Transferred);
+    for (auto _ : state) {
+        bool result = flags.test(InstrumentFlag::Transferred);
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_FlagSet_CheckFlag);
+
+// 基准测试：使用 FlagSet 清除标志
+static void BM_FlagSet_ClearFlag(benchmark::State& state) {
+    InstrumentFlags flags(InstrumentFlag::Transferred);
+    for (auto _ : state) {
+        flags.clear(InstrumentFlag::Transferred);
+        benchmark::DoNotOptimize(flags);
+    }
+}
+BENCHMARK(BM_FlagSet_ClearFlag);
+
+// ---------------- 批量：整个市场的合约状态字数组 ----------------
+// 单个变量加 DoNotOptimize 只能测到一两条指令，批量遍历数组才能体现编译期掩码带来的向量化差异
+
+// 随机生成合约状态字，每个标志约 1/8 的概率被置位
+static std::vector<uint32_t> make_status_words(size_t count) {
+    std::mt19937 rng(42);
+    std::vector<uint32_t> words(count);
+    for (auto& word : words) {
+        uint32_t bits = 0;
+        for (int bit = 0; bit < 8; ++bit) {
+            if ((rng() & 7) == 0) {
+                bits |= 1u << bit;
+            }
+        }
+        word = bits;
+    }
+    return words;
+}
+
+template<typename FlagType>
+static std::vector<FlagType> make_flag_array(size_t count);
+
+template<>
+std::vector<BitFlags> make_flag_array<BitFlags>(size_t count) {
+    std::vector<uint32_t> words = make_status_words(count);
+    std::vector<BitFlags> result(count);
+    for (size_t i = 0; i < count; ++i) {
+        result[i].flags = words[i];
+    }
+    return result;
+}
+
+template<>
+std::vector<IntValueFlags> make_flag_array<IntValueFlags>(size_t count) {
+    std::vector<uint32_t> words = make_status_words(count);
+    std::vector<IntValueFlags> result(count);
+    for (size_t i = 0; i < count; ++i) {
+        result[i].flags = static_cast<int>(words[i]);
+    }
+    return result;
+}
+
+template<>
+std::vector<InstrumentFlags> make_flag_array<InstrumentFlags>(size_t count) {
+    std::vector<uint32_t> words = make_status_words(count);
+    std::vector<InstrumentFlags> result(count);
+    for (size_t i = 0; i < count; ++i) {
+        result[i] = InstrumentFlags::from_raw(words[i]);
+    }
+    return result;
+}
+
+// 筛选条件：非退市、非风险警示、且为注册制
+static bool is_tradable(const BitFlags& f) {
+    return !f.isFlagSet(0) && !f.isFlagSet(1) && f.isFlagSet(6);
+}
+
+static bool is_tradable(const IntValueFlags& f) {
+    return !f.isFlagSet(IntValueFlags::RiskWarning) && !f.isFlagSet(IntValueFlags::Delisted) &&
+           f.isFlagSet(IntValueFlags::Registered);
+}
+
+static bool is_tradable(const InstrumentFlags& f) {
+    constexpr InstrumentFlags required = InstrumentFlag::Registered;
+    constexpr InstrumentFlags excluded = InstrumentFlag::RiskWarning | InstrumentFlag::Delisted;
+    return f.matches(required, excluded);
+}
+
+// 基准测试：批量多标志筛选计数
+template<typename FlagType>
+static void BM_Bulk_CountTradable(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    std::vector<FlagType> flags = make_flag_array<FlagType>(count);
+    for (auto _ : state) {
+        size_t matched = 0;
+        for (const auto& f : flags) {
+            matched += is_tradable(f);
+        }
+        benchmark::DoNotOptimize(matched);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK_TEMPLATE(BM_Bulk_CountTradable, BitFlags)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_Bulk_CountTradable, IntValueFlags)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_Bulk_CountTradable, InstrumentFlags)->Arg(1 << 20);
+
+// 基准测试：批量设置、清除标志（例如收盘后统一打上/撤销某状态）
+static void set_and_clear(BitFlags& f) {
+    f.setFlag(2);
+    f.clearFlag(7);
+}
+
+static void set_and_clear(IntValueFlags& f) {
+    f.setFlag(IntValueFlags::Transferred);
+    f.clearFlag(IntValueFlags::DelistedFinal);
+}
+
+static void set_and_clear(InstrumentFlags& f) {
+    f.set(InstrumentFlag::Transferred).clear(InstrumentFlag::DelistedFinal);
+}
+
+template<typename FlagType>
+static void BM_Bulk_SetClear(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    std::vector<FlagType> flags = make_flag_array<FlagType>(count);
+    for (auto _ : state) {
+        for (auto& f : flags) {
+            set_and_clear(f);
+        }
+        benchmark::DoNotOptimize(flags.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK_TEMPLATE(BM_Bulk_SetClear, BitFlags)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_Bulk_SetClear, IntValueFlags)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_Bulk_SetClear, InstrumentFlags)->Arg(1 << 20);
+
+// 基准测试：批量统计已置位标志总数
+template<typename FlagType>
+static int flag_count(const FlagType& f);
+
+template<>
+int flag_count<BitFlags>(const BitFlags& f) {
+    int n = 0;
+    for (int bit = 0; bit < 8; ++bit) {
+        n += f.isFlagSet(bit);
+    }
+    return n;
+}
+
+template<>
+int flag_count<InstrumentFlags>(const InstrumentFlags& f) {
+    return f.count();
+}
+
+template<typename FlagType>
+static void BM_Bulk_Popcount(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    std::vector<FlagType> flags = make_flag_array<FlagType>(count);
+    for (auto _ : state) {
+        int64_t total = 0;
+        for (const auto& f : flags) {
+            total += flag_count(f);
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK_TEMPLATE(BM_Bulk_Popcount, BitFlags)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_Bulk_Popcount, InstrumentFlags)->Arg(1 << 20);
+
+// ---------------- 列式筛选：FlagFilter 标量 / AVX2 / 自动分发 ----------------
+
+// 快照筛选条件：非风险警示、非退市、且为注册制
+static const FlagFilter kTradableFilter(InstrumentFlags(InstrumentFlag::Registered),
+                                        InstrumentFlag::RiskWarning | InstrumentFlag::Delisted);
+
+// Avx2 为 true 时直接调用 AVX2 实现，CPU 不支持则跳过
+template<bool Avx2>
+static void BM_FlagFilter_Bitmap(benchmark::State& state) {
+    FlagFilter::BitmapFn fn = &FlagFilter::bitmap_scalar;
+    if (Avx2) {
+#ifdef FLAG_FILTER_HAS_AVX2_PATH
+        fn = FlagFilter::has_avx2() ? &FlagFilter::bitmap_avx2 : nullptr;
+#else
+        fn = nullptr;
+#endif
+    }
+    if (fn == nullptr) {
+        state.SkipWithError("AVX2 not supported on this CPU");
+        return;
+    }
+
+    const size_t count = static_cast<size_t>(state.range(0));
+    std::vector<uint32_t> words = make_status_words(count);
+    std::vector<uint64_t> bitmap((count + 63) / 64);
+    for (auto _ : state) {
+        size_t matched = fn(words.data(), count, kTradableFilter.care_mask(), kTradableFilter.expect_mask(), bitmap.data());
+        benchmark::DoNotOptimize(matched);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetBytesProcessed(state.iterations() * count * sizeof(uint32_t));
+}
+BENCHMARK_TEMPLATE(BM_FlagFilter_Bitmap, false)->RangeMultiplier(10)->Range(10000, 10000000);
+BENCHMARK_TEMPLATE(BM_FlagFilter_Bitmap, true)->RangeMultiplier(10)->Range(10000, 10000000);
+
+template<bool Avx2>
+static void BM_FlagFilter_Indices(benchmark::State& state) {
+    FlagFilter::IndicesFn fn = &FlagFilter::indices_scalar;
+    if (Avx2) {
+#ifdef FLAG_FILTER_HAS_AVX2_PATH
+        fn = FlagFilter::has_avx2() ? &FlagFilter::indices_avx2 : nullptr;
+#else
+        fn = nullptr;
+#endif
+    }
+    if (fn == nullptr) {
+        state.SkipWithError("AVX2 not supported on this CPU");
+        return;
+    }
+
+    const size_t count = static_cast<size_t>(state.range(0));
+    std::vector<uint32_t> words = make_status_words(count);
+    std::vector<uint32_t> indices(count);
+    for (auto _ : state) {
+        size_t matched = fn(words.data(), count, kTradableFilter.care_mask(), kTradableFilter.expect_mask(), indices.data());
+        benchmark::DoNotOptimize(matched);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetBytesProcessed(state.iterations() * count * sizeof(uint32_t));
+}
+BENCHMARK_TEMPLATE(BM_FlagFilter_Indices, false)->RangeMultiplier(10)->Range(10000, 10000000);
+BENCHMARK_TEMPLATE(BM_FlagFilter_Indices, true)->RangeMultiplier(10)->Range(10000, 10000000);
+
+// 经运行时分发的公共接口
+static void BM_FlagFilter_Dispatch(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    std::vector<uint32_t> words = make_status_words(count);
+    std::vector<uint32_t> indices(count);
+    for (auto _ : state) {
+        size_t matched = kTradableFilter.select_indices(words.data(), count, indices.data());
+        benchmark::DoNotOptimize(matched);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetLabel(FlagFilter::implementation_name());
+}
+BENCHMARK(BM_FlagFilter_Dispatch)->RangeMultiplier(10)->Range(10000, 10000000);
@@ -1,6 +1,8 @@
 #include <benchmark/benchmark.h>
 #include <unordered_map>
 #include <random>
+#include <vector>
+#include "flat_hash_map.h"
 #include "market_inst.h"
 
 struct StockDict
@@ -54,6 +56,55 @@ static void BM_MarketInst_Hash(benchmark::State &state)
 }
 BENCHMARK(BM_MarketInst_Hash);
 
+static void BM_MarketInst_GetKey(benchmark::State &state)
+{
+    MarketInst mi("SH", "600000", 1);
+    for (auto _ : state)
+    {
+        std::string key = mi.GetKey();
+        benchmark::DoNotOptimize(key);
+    }
+}
+BENCHMARK(BM_MarketInst_GetKey);
+
+static void BM_MarketInst_FormatKey(benchmark::State &state)
+{
+    MarketInst mi("SH", "600000", 1);
+    char buf[64];
+    for (auto _ : state)
+    {
+        std::size_t len = mi.FormatKey(buf, sizeof(buf));
+        benchmark::DoNotOptimize(buf);
+        benchmark::DoNotOptimize(len);
+    }
+}
+BENCHMARK(BM_MarketInst_FormatKey);
+
+static void BM_MarketInst_GetKeyInline(benchmark::State &state)
+{
+    MarketInst mi("SH", "600000", 1);
+    for (auto _ : state)
+    {
+        MarketInst::KeyString key = mi.GetKeyInline();
+        benchmark::DoNotOptimize(key);
+    }
+}
+BENCHMARK(BM_MarketInst_GetKeyInline);
+
+// 解析到复用的 MarketInst 中，string 容量足够时不再分配
+static void BM_MarketInst_ParseKey(benchmark::State &state)
+{
+    std::string key = MarketInst("SH", "600000", 1).GetKey();
+    MarketInst mi;
+    for (auto _ : state)
+    {
+        bool ok = MarketInst::ParseKey(key, mi);
+        benchmark::DoNotOptimize(ok);
+        benchmark::DoNotOptimize(mi);
+    }
+}
+BENCHMARK(BM_MarketInst_ParseKey);
+
 static void BM_UnorderedMap_Find(benchmark::State &state)
 {
     std::unordered_map<MarketInst, StockDict, HashMarketInst> stock_dict_map_;
@@ -79,5 +130,298 @@ static void BM_UnorderedMap_Find(benchmark::State &state)
 }
 
 // 注册基准测试，测试不同数据量级别
-BENCHMARK(BM_UnorderedMap_Find)->RangeMultiplier(10)->Range(10, 100000);
+BENCHMARK(BM_UnorderedMap_Find)->RangeMultiplier(10)->Range(10, 1000000);
+
+// ---------------- 紧凑 key：MarketInstKey 与 MarketInst 对比 ----------------
+
+static void BM_MarketInstKey_Create(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        MarketInstKey key("market", "inst", 1);
+        benchmark::DoNotOptimize(key);
+    }
+}
+BENCHMARK(BM_MarketInstKey_Create);
+
+// 市场编号已缓存时的构造，行情回调里的常见情况
+static void BM_MarketInstKey_CreateWithMarketId(benchmark::State &state)
+{
+    uint32_t market_id = MarketCodeTable::instance().intern("market");
+    for (auto _ : state)
+    {
+        MarketInstKey key(market_id, "inst", 1);
+        benchmark::DoNotOptimize(key);
+    }
+}
+BENCHMARK(BM_MarketInstKey_CreateWithMarketId);
+
+static void BM_MarketInstKey_Copy(benchmark::State &state)
+{
+    MarketInstKey key("market", "inst", 1);
+    for (auto _ : state)
+    {
+        MarketInstKey key_copy(key);
+        benchmark::DoNotOptimize(key_copy);
+    }
+}
+BENCHMARK(BM_MarketInstKey_Copy);
 
+static void BM_MarketInstKey_Compare(benchmark::State &state)
+{
+    MarketInstKey key1("market", "inst", 1);
+    MarketInstKey key2("market", "inst", 1);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(key1);
+        bool result = (key1 == key2);
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_MarketInstKey_Compare);
+
+static void BM_MarketInstKey_Hash(benchmark::State &state)
+{
+    MarketInstKey key("market", "inst", 1);
+    HashMarketInstKey hash_fn;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(key);
+        std::size_t hash = hash_fn(key);
+        benchmark::DoNotOptimize(hash);
+    }
+}
+BENCHMARK(BM_MarketInstKey_Hash);
+
+static void BM_MarketInstKey_FromMarketInst(benchmark::State &state)
+{
+    MarketInst mi("market", "inst", 1);
+    for (auto _ : state)
+    {
+        MarketInstKey key(mi);
+        benchmark::DoNotOptimize(key);
+    }
+}
+BENCHMARK(BM_MarketInstKey_FromMarketInst);
+
+static void BM_MarketInstKey_ToMarketInst(benchmark::State &state)
+{
+    MarketInstKey key("market", "inst", 1);
+    for (auto _ : state)
+    {
+        MarketInst mi = key.ToMarketInst();
+        benchmark::DoNotOptimize(mi);
+    }
+}
+BENCHMARK(BM_MarketInstKey_ToMarketInst);
+
+// 测试数据：少量市场、大量合约，与真实行情字典的分布一致
+static const char *const kMarkets[] = {"SH", "SZ", "HK", "US"};
+
+static MarketInst make_market_inst(int i)
+{
+    return MarketInst(kMarkets[i % 4], "inst" + std::to_string(i), i % 2);
+}
+
+// 预先生成查找序列，基准循环内只剩查找本身
+static std::vector<int> make_lookup_indices(int num_elements)
+{
+    std::mt19937 rng;
+    rng.seed(std::random_device()());
+    std::uniform_int_distribution<int> dist(0, num_elements - 1);
+    std::vector<int> indices(4096);
+    for (auto &idx : indices)
+    {
+        idx = dist(rng);
+    }
+    return indices;
+}
+
+// key 预先构造的 MarketInst 查找，排除 BM_UnorderedMap_Find 中每次拼字符串的开销
+static void BM_UnorderedMap_FindPrebuilt(benchmark::State &state)
+{
+    std::unordered_map<MarketInst, StockDict, HashMarketInst> stock_dict_map_;
+    int num_elements = state.range(0);
+    std::vector<MarketInst> keys;
+    keys.reserve(num_elements);
+    for (int i = 0; i < num_elements; ++i)
+    {
+        keys.push_back(make_market_inst(i));
+        stock_dict_map_.emplace(keys.back(), StockDict{i});
+    }
+
+    std::vector<int> indices = make_lookup_indices(num_elements);
+    size_t n = 0;
+    for (auto _ : state)
+    {
+        auto it = stock_dict_map_.find(keys[indices[n++ & 4095]]);
+        benchmark::DoNotOptimize(it);
+    }
+}
+BENCHMARK(BM_UnorderedMap_FindPrebuilt)->RangeMultiplier(10)->Range(10, 1000000);
+
+static void BM_MarketInstKeyMap_Find(benchmark::State &state)
+{
+    std::unordered_map<MarketInstKey, StockDict, HashMarketInstKey> stock_dict_map_;
+    int num_elements = state.range(0);
+    std::vector<MarketInstKey> keys;
+    keys.reserve(num_elements);
+    for (int i = 0; i < num_elements; ++i)
+    {
+        keys.emplace_back(make_market_inst(i));
+        stock_dict_map_.emplace(keys.back(), StockDict{i});
+    }
+
+    std::vector<int> indices = make_lookup_indices(num_elements);
+    size_t n = 0;
+    for (auto _ : state)
+    {
+        auto it = stock_dict_map_.find(keys[indices[n++ & 4095]]);
+        benchmark::DoNotOptimize(it);
+    }
+}
+BENCHMARK(BM_MarketInstKeyMap_Find)->RangeMultiplier(10)->Range(10, 1000000);
+
+// 从 MarketInst 现场转换后查找，衡量边界处转换的总成本
+static void BM_MarketInstKeyMap_FindConverted(benchmark::State &state)
+{
+    std::unordered_map<MarketInstKey, StockDict, HashMarketInstKey> stock_dict_map_;
+    int num_elements = state.range(0);
+    std::vector<MarketInst> keys;
+    keys.reserve(num_elements);
+    for (int i = 0; i < num_elements; ++i)
+    {
+        keys.push_back(make_market_inst(i));
+        stock_dict_map_.emplace(MarketInstKey(keys.back()), StockDict{i});
+    }
+
+    std::vector<int> indices = make_lookup_indices(num_elements);
+    size_t n = 0;
+    for (auto _ : state)
+    {
+        auto it = stock_dict_map_.find(MarketInstKey(keys[indices[n++ & 4095]]));
+        benchmark::DoNotOptimize(it);
+    }
+}
+BENCHMARK(BM_MarketInstKeyMap_FindConverted)->RangeMultiplier(10)->Range(10, 1000000);
+
+
+// ---------------- 合约字典容器：FlatHashMap 与 std::unordered_map 对比 ----------------
+
+using NodeDictMap = std::unordered_map<MarketInstKey, StockDict, HashMarketInstKey>;
+using FlatDictMap = FlatHashMap<MarketInstKey, StockDict, HashMarketInstKey>;
+
+static std::vector<MarketInstKey> make_dict_keys(int begin, int count)
+{
+    std::vector<MarketInstKey> keys;
+    keys.reserve(count);
+    for (int i = begin; i < begin + count; ++i)
+    {
+        keys.emplace_back(make_market_inst(i));
+    }
+    return keys;
+}
+
+template<typename MapType>
+static const StockDict *dict_find(const MapType &map, const MarketInstKey &key)
+{
+    auto it = map.find(key);
+    return it == map.end() ? nullptr : &it->second;
+}
+
+static const StockDict *dict_find(const FlatDictMap &map, const MarketInstKey &key)
+{
+    return map.find(key);
+}
+
+// 命中查找
+template<typename MapType>
+static void BM_Dict_FindHit(benchmark::State &state)
+{
+    int num_elements = state.range(0);
+    std::vector<MarketInstKey> keys = make_dict_keys(0, num_elements);
+    MapType map;
+    for (int i = 0; i < num_elements; ++i)
+    {
+        map.emplace(keys[i], StockDict{i});
+    }
+
+    std::vector<int> indices = make_lookup_indices(num_elements);
+    size_t n = 0;
+    for (auto _ : state)
+    {
+        const StockDict *dict = dict_find(map, keys[indices[n++ & 4095]]);
+        benchmark::DoNotOptimize(dict);
+    }
+}
+BENCHMARK_TEMPLATE(BM_Dict_FindHit, NodeDictMap)->RangeMultiplier(10)->Range(10, 1000000);
+BENCHMARK_TEMPLATE(BM_Dict_FindHit, FlatDictMap)->RangeMultiplier(10)->Range(10, 1000000);
+
+// 未命中查找：key 与表中元素市场相同、合约代码不同
+template<typename MapType>
+static void BM_Dict_FindMiss(benchmark::State &state)
+{
+    int num_elements = state.range(0);
+    std::vector<MarketInstKey> keys = make_dict_keys(0, num_elements);
+    std::vector<MarketInstKey> missing = make_dict_keys(num_elements, 4096);
+    MapType map;
+    for (int i = 0; i < num_elements; ++i)
+    {
+        map.emplace(keys[i], StockDict{i});
+    }
+
+    size_t n = 0;
+    for (auto _ : state)
+    {
+        const StockDict *dict = dict_find(map, missing[n++ & 4095]);
+        benchmark::DoNotOptimize(dict);
+    }
+}
+BENCHMARK_TEMPLATE(BM_Dict_FindMiss, NodeDictMap)->RangeMultiplier(10)->Range(10, 1000000);
+BENCHMARK_TEMPLATE(BM_Dict_FindMiss, FlatDictMap)->RangeMultiplier(10)->Range(10, 1000000);
+
+// 建表：从空表逐个插入 num_elements 个合约（不预留空间，包含扩容成本）
+template<typename MapType>
+static void BM_Dict_Insert(benchmark::State &state)
+{
+    int num_elements = state.range(0);
+    std::vector<MarketInstKey> keys = make_dict_keys(0, num_elements);
+    for (auto _ : state)
+    {
+        MapType map;
+        for (int i = 0; i < num_elements; ++i)
+        {
+            map.emplace(keys[i], StockDict{i});
+        }
+        benchmark::DoNotOptimize(map.size());
+    }
+    state.SetItemsProcessed(state.iterations() * num_elements);
+}
+BENCHMARK_TEMPLATE(BM_Dict_Insert, NodeDictMap)->RangeMultiplier(10)->Range(10, 1000000);
+BENCHMARK_TEMPLATE(BM_Dict_Insert, FlatDictMap)->RangeMultiplier(10)->Range(10, 1000000);
+
+// 全表遍历，例如每个快照周期扫描全部合约
+template<typename MapType>
+static void BM_Dict_Iterate(benchmark::State &state)
+{
+    int num_elements = state.range(0);
+    std::vector<MarketInstKey> keys = make_dict_keys(0, num_elements);
+    MapType map;
+    for (int i = 0; i < num_elements; ++i)
+    {
+        map.emplace(keys[i], StockDict{i});
+    }
+
+    for (auto _ : state)
+    {
+        int64_t sum = 0;
+        for (const auto &kv : map)
+        {
+            sum += kv.second.data;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * num_elements);
+}
+BENCHMARK_TEMPLATE(BM_Dict_Iterate, NodeDictMap)->RangeMultiplier(10)->Range(10, 1000000);
+BENCHMARK_TEMPLATE(BM_Dict_Iterate, FlatDictMap)->RangeMultiplier(10)->Range(10, 1000000);
@@ -1,8 +1,11 @@
 // pc_quota_client_mng_benchmark.cpp
 #include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
 #include <map>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 #include "thread_safe_map.h"
 
@@ -78,4 +81,202 @@ static void BM_NormalMap_Erase(benchmark::State &state)
 }
 BENCHMARK(BM_NormalMap_Erase);
 
+// ---------------- 多线程扩展性：单锁 ThreadSafeMap 与分片 ShardedThreadSafeMap ----------------
+
+static const int kConcurrentKeyCount = 10000;
+
+// 预先生成 key，避免基准循环内构造字符串
+static const vector<string> &concurrent_keys()
+{
+    static const vector<string> keys = [] {
+        vector<string> v;
+        v.reserve(kConcurrentKeyCount);
+        for (int i = 0; i < kConcurrentKeyCount; ++i)
+        {
+            v.push_back("key" + to_string(i));
+        }
+        return v;
+    }();
+    return keys;
+}
+
+// 所有线程共享同一个已填充的 map 实例
+template<typename MapType>
+static MapType &shared_filled_map()
+{
+    static MapType map = [] {
+        MapType m;
+        for (const auto &key : concurrent_keys())
+        {
+            m.insert(key, "value");
+        }
+        return m;
+    }();
+    return map;
+}
+
+// 纯读：每个线程按不同步长遍历 key，模拟行情查询线程
+template<typename MapType>
+static void BM_Concurrent_Get(benchmark::State &state)
+{
+    MapType &map = shared_filled_map<MapType>();
+    const auto &keys = concurrent_keys();
+    size_t idx = static_cast<size_t>(state.thread_index()) * 7919;
+    string value;
+    for (auto _ : state)
+    {
+        bool found = map.get(keys[idx % kConcurrentKeyCount], value);
+        benchmark::DoNotOptimize(found);
+        idx += 31;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_Concurrent_Get, ThreadSafeMap<string, string>)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Concurrent_Get, ShardedThreadSafeMap<string, string>)->ThreadRange(1, 64)->UseRealTime();
+
+// 读多写少：每 16 次操作中 1 次 insert，其余为 get/contains
+template<typename MapType>
+static void BM_Concurrent_Mixed(benchmark::State &state)
+{
+    MapType &map = shared_filled_map<MapType>();
+    const auto &keys = concurrent_keys();
+    size_t idx = static_cast<size_t>(state.thread_index()) * 7919;
+    string value;
+    for (auto _ : state)
+    {
+        const string &key = keys[idx % kConcurrentKeyCount];
+        if ((idx & 15) == 0)
+        {
+            map.insert(key, "value");
+        }
+        else if ((idx & 1) == 0)
+        {
+            benchmark::DoNotOptimize(map.contains(key));
+        }
+        else
+        {
+            benchmark::DoNotOptimize(map.get(key, value));
+        }
+        idx += 31;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_Concurrent_Mixed, ThreadSafeMap<string, string>)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Concurrent_Mixed, ShardedThreadSafeMap<string, string>)->ThreadRange(1, 64)->UseRealTime();
+
+// ---------------- 读多写少：后台写线程批量更新时的读吞吐 ----------------
+
+// 每批更新的 key 数量与批次间隔，模拟合约参考数据的低频批量刷新
+static const int kWriterBatchSize = 100;
+static const auto kWriterInterval = std::chrono::milliseconds(10);
+
+// 加锁 map 只能逐条写入
+template<typename MapType>
+static void bulk_update(MapType &map, size_t offset)
+{
+    const auto &keys = concurrent_keys();
+    for (int i = 0; i < kWriterBatchSize; ++i)
+    {
+        map.insert(keys[(offset + i) % kConcurrentKeyCount], "updated");
+    }
+}
+
+// 写时复制 map 整批只复制、发布一次
+static void bulk_update(CowThreadSafeMap<string, string> &map, size_t offset)
+{
+    const auto &keys = concurrent_keys();
+    map.update([&](CowThreadSafeMap<string, string>::map_type &m) {
+        for (int i = 0; i < kWriterBatchSize; ++i)
+        {
+            m[keys[(offset + i) % kConcurrentKeyCount]] = "updated";
+        }
+    });
+}
+
+// 由 0 号基准线程启停的后台写线程
+template<typename MapType>
+class BackgroundWriter
+{
+public:
+    void start(MapType &map)
+    {
+        stop_ = false;
+        thread_ = std::thread([this, &map] {
+            size_t offset = 0;
+            while (!stop_.load(std::memory_order_relaxed))
+            {
+                bulk_update(map, offset);
+                offset += kWriterBatchSize;
+                std::this_thread::sleep_for(kWriterInterval);
+            }
+        });
+    }
+
+    void stop()
+    {
+        stop_ = true;
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+    }
+
+private:
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+template<typename MapType>
+static void BM_ReadUnderWriter(benchmark::State &state)
+{
+    MapType &map = shared_filled_map<MapType>();
+    static BackgroundWriter<MapType> writer;
+    if (state.thread_index() == 0)
+    {
+        writer.start(map);
+    }
+
+    const auto &keys = concurrent_keys();
+    size_t idx = static_cast<size_t>(state.thread_index()) * 7919;
+    string value;
+    for (auto _ : state)
+    {
+        bool found = map.get(keys[idx % kConcurrentKeyCount], value);
+        benchmark::DoNotOptimize(found);
+        idx += 31;
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0)
+    {
+        writer.stop();
+    }
+}
+BENCHMARK_TEMPLATE(BM_ReadUnderWriter, ThreadSafeMap<string, string>)->ThreadRange(1, 32)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ReadUnderWriter, ShardedThreadSafeMap<string, string>)->ThreadRange(1, 32)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ReadUnderWriter, CowThreadSafeMap<string, string>)->ThreadRange(1, 32)->UseRealTime();
+
+// 获取全量副本：std::map 深拷贝与写时复制快照句柄
+static void BM_ThreadSafeMap_GetMapCopy(benchmark::State &state)
+{
+    auto &map = shared_filled_map<ThreadSafeMap<string, string>>();
+    for (auto _ : state)
+    {
+        auto copy = map.get_map_copy();
+        benchmark::DoNotOptimize(copy);
+    }
+}
+BENCHMARK(BM_ThreadSafeMap_GetMapCopy);
+
+static void BM_CowThreadSafeMap_GetMapCopy(benchmark::State &state)
+{
+    auto &map = shared_filled_map<CowThreadSafeMap<string, string>>();
+    for (auto _ : state)
+    {
+        auto snapshot = map.get_map_copy();
+        benchmark::DoNotOptimize(snapshot);
+    }
+}
+BENCHMARK(BM_CowThreadSafeMap_GetMapCopy);
+
 // BENCHMARK_MAIN();
@@ -0,0 +1,101 @@
+// 连接池取还连接的开销：改造前每次取还都持 pool_mutex_、在 pool_condition_ 上等待，
+// 并拷贝 shared_ptr（LockedQueue）；改造后线程优先复用自己的粘滞连接，其次走无锁空闲栈（ConnectionSlots）。
+// 池大小与默认 pool_size 相同，线程数超过池大小时包含等待的开销。
+// 不连接数据库，也不包含改造前每次取还时 SELECT 1 验证连接的往返
+#include <benchmark/benchmark.h>
+#include "database/connection_slots.h"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+using namespace market_feeder;
+
+namespace {
+
+constexpr size_t kPoolSize = 10;
+
+struct FakeConnection {
+    bool in_use = false;
+    uint64_t queries = 0;
+};
+
+// 与改造前 DBConnectionPool 相同的取还方式
+class LockedQueuePool {
+public:
+    LockedQueuePool() {
+        for (size_t i = 0; i < kPoolSize; ++i) {
+            auto conn = std::make_shared<FakeConnection>();
+            idle_.push(conn);
+            all_.push_back(conn);
+        }
+    }
+
+    std::shared_ptr<FakeConnection> get() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this] { return !idle_.empty(); });
+        auto conn = idle_.front();
+        idle_.pop();
+        conn->in_use = true;
+        return conn;
+    }
+
+    void put(std::shared_ptr<FakeConnection> conn) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        conn->in_use = false;
+        idle_.push(conn);
+        condition_.notify_one();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::queue<std::shared_ptr<FakeConnection>> idle_;
+    std::vector<std::shared_ptr<FakeConnection>> all_;
+};
+
+struct SlotPool {
+    explicit SlotPool(bool sticky) : slots(kPoolSize, sticky), connections(kPoolSize) {}
+
+    ConnectionSlots slots;
+    std::vector<FakeConnection> connections;
+};
+
+void BM_Checkout_LockedQueue(benchmark::State& state) {
+    static LockedQueuePool pool;
+    for (auto _ : state) {
+        auto conn = pool.get();
+        ++conn->queries;
+        pool.put(std::move(conn));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Checkout_LockedQueue)->ThreadRange(1, 32)->UseRealTime();
+
+void checkoutSlots(benchmark::State& state, SlotPool& pool) {
+    for (auto _ : state) {
+        uint32_t slot = pool.slots.acquire(std::chrono::seconds(5));
+        if (slot == ConnectionSlots::kNoSlot) {
+            state.SkipWithError("checkout timed out");
+            break;
+        }
+        ++pool.connections[slot].queries;
+        pool.slots.release(slot);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_Checkout_FreeList(benchmark::State& state) {
+    static SlotPool pool(false);
+    checkoutSlots(state, pool);
+}
+BENCHMARK(BM_Checkout_FreeList)->ThreadRange(1, 32)->UseRealTime();
+
+void BM_Checkout_Sticky(benchmark::State& state) {
+    static SlotPool pool(true);
+    checkoutSlots(state, pool);
+}
+BENCHMARK(BM_Checkout_Sticky)->ThreadRange(1, 32)->UseRealTime();
+
+}  // namespace
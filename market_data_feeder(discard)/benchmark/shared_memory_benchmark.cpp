@@ -0,0 +1,128 @@
+// 心跳写入与主进程读取的竞争：改造前所有工作进程与主进程共用一个 SysV 信号量保护整个
+// SharedMemoryData（GlobalSemaphore），改造后每个工作进程写自己的缓存行槽位、主进程 seqlock 读取（WorkerSlots）。
+// 线程 0 扮演主进程反复读取全部进程信息，其余线程扮演工作进程发送心跳
+#include <benchmark/benchmark.h>
+#include "common/ipc_manager.h"
+#include <sys/ipc.h>
+#include <sys/sem.h>
+#include <chrono>
+#include <memory>
+
+using namespace market_feeder;
+
+namespace {
+
+int64_t nowNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+// 与改造前相同的布局：ProcessInfo 数组紧密排列，整体由一个信号量保护
+struct LegacySharedData {
+    ProcessInfo processes[constants::MAX_WORKER_PROCESSES];
+    int process_count;
+};
+
+struct LegacyState {
+    LegacySharedData data;
+    int sem_id;
+
+    LegacyState() : data(), sem_id(semget(IPC_PRIVATE, 1, IPC_CREAT | 0600)) {
+        data.process_count = constants::MAX_WORKER_PROCESSES;
+        union semun {
+            int val;
+            struct semid_ds* buf;
+            unsigned short* array;
+        } arg;
+        arg.val = 1;
+        semctl(sem_id, 0, SETVAL, arg);
+    }
+
+    ~LegacyState() {
+        semctl(sem_id, 0, IPC_RMID);
+    }
+
+    void lock() {
+        struct sembuf op = {0, -1, SEM_UNDO};
+        semop(sem_id, &op, 1);
+    }
+
+    void unlock() {
+        struct sembuf op = {0, 1, SEM_UNDO};
+        semop(sem_id, &op, 1);
+    }
+};
+
+LegacyState& legacyState() {
+    static LegacyState state;
+    return state;
+}
+
+SharedMemoryData& slotState() {
+    static std::unique_ptr<SharedMemoryData> data = [] {
+        auto shared = std::make_unique<SharedMemoryData>();
+        for (int i = 0; i < constants::MAX_WORKER_PROCESSES; ++i) {
+            shared->workers[i].in_use.store(1);
+            shared->workers[i].pid.store(1000 + i);
+            shared->workers[i].worker_id.store(i);
+        }
+        return shared;
+    }();
+    return *data;
+}
+
+void BM_Heartbeat_GlobalSemaphore(benchmark::State& state) {
+    LegacyState& shared = legacyState();
+    int worker = state.thread_index() % constants::MAX_WORKER_PROCESSES;
+    size_t visible = 0;
+    for (auto _ : state) {
+        if (state.thread_index() == 0) {
+            // 主进程 getAllProcesses()
+            shared.lock();
+            for (int i = 0; i < shared.data.process_count; ++i) {
+                visible += shared.data.processes[i].processed_count;
+            }
+            shared.unlock();
+        } else {
+            // 工作进程 updateProcessStatus() / 心跳
+            shared.lock();
+            ProcessInfo& info = shared.data.processes[worker];
+            info.last_heartbeat = std::chrono::system_clock::now();
+            ++info.processed_count;
+            shared.unlock();
+        }
+    }
+    benchmark::DoNotOptimize(visible);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Heartbeat_GlobalSemaphore)->ThreadRange(2, constants::MAX_WORKER_PROCESSES)->UseRealTime();
+
+void BM_Heartbeat_WorkerSlots(benchmark::State& state) {
+    SharedMemoryData& shared = slotState();
+    int worker = state.thread_index() % constants::MAX_WORKER_PROCESSES;
+    size_t visible = 0;
+    for (auto _ : state) {
+        if (state.thread_index() == 0) {
+            // 主进程 getAllProcesses()
+            for (const WorkerSlot& slot : shared.workers) {
+                ProcessInfo info;
+                int worker_id = -1;
+                if (slot.snapshot(info, worker_id)) {
+                    visible += info.processed_count;
+                }
+            }
+        } else {
+            // 工作进程 updateWorkerCounters()
+            WorkerSlot& slot = shared.workers[worker];
+            slot.touch(nowNanoseconds());
+            slot.processed_count.store(slot.processed_count.load(std::memory_order_relaxed) + 1,
+                                       std::memory_order_relaxed);
+        }
+    }
+    benchmark::DoNotOptimize(visible);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Heartbeat_WorkerSlots)->ThreadRange(2, constants::MAX_WORKER_PROCESSES)->UseRealTime();
+
+}  // namespace
@@ -0,0 +1,90 @@
+// 内存池的多生产者压力测试：各线程并发 store，并按先进先出延迟 release，
+// 内存池只有少量小段，段频繁写满、封存、回收、重新启用。
+// 每条记录按写入线程和序号填充，释放前逐字节校验；段在写入期间被回收复用时
+// 其他线程的数据会覆盖这里的记录，校验失败即报错终止
+#include <benchmark/benchmark.h>
+#include "common/tick_arena.h"
+#include <cstring>
+#include <deque>
+#include <string>
+
+using namespace market_feeder;
+
+namespace {
+
+constexpr size_t kSegmentSize = 4 * 1024;
+constexpr size_t kArenaSize = 64 * kSegmentSize;
+constexpr size_t kWindow = 64;  // 每个线程同时持有的记录数
+
+struct HeldRecord {
+    RawDataRef ref;
+    char fill;
+};
+
+char fillByte(int thread, uint64_t sequence) {
+    return static_cast<char>('!' + (thread * 31 + sequence) % 90);
+}
+
+bool intact(const TickArena& arena, const HeldRecord& record) {
+    std::string_view data = arena.view(record.ref);
+    for (char c : data) {
+        if (c != record.fill) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void BM_TickArena_StoreReleaseChurn(benchmark::State& state) {
+    // 上一轮的线程都已退出，线程 0 重建内存池；其余线程在循环开始处等它完成
+    static TickArena arena;
+    if (state.thread_index() == 0) {
+        arena.initialize(kArenaSize, false, kSegmentSize);
+    }
+
+    const int thread = state.thread_index();
+    std::deque<HeldRecord> held;
+    std::string payload;
+    uint64_t sequence = 0;
+    uint64_t exhausted = 0;
+    bool corrupted = false;
+
+    for (auto _ : state) {
+        // 24 ~ 263 字节，单段能放下十几到上百条，轮转足够频繁
+        char fill = fillByte(thread, sequence);
+        payload.assign(24 + (sequence * 7) % 240, fill);
+        ++sequence;
+
+        HeldRecord record;
+        record.fill = fill;
+        if (arena.store(payload, record.ref)) {
+            held.push_back(record);
+        } else {
+            ++exhausted;
+        }
+
+        if (held.size() > kWindow || (!held.empty() && record.ref.size == 0)) {
+            if (!intact(arena, held.front())) {
+                corrupted = true;
+                state.SkipWithError("raw data overwritten before release");
+                break;
+            }
+            arena.release(held.front().ref);
+            held.pop_front();
+        }
+    }
+
+    for (const auto& record : held) {
+        if (!corrupted && !intact(arena, record)) {
+            corrupted = true;
+            state.SkipWithError("raw data overwritten before release");
+        }
+        arena.release(record.ref);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["exhausted"] = benchmark::Counter(static_cast<double>(exhausted), benchmark::Counter::kAvgThreads);
+}
+BENCHMARK(BM_TickArena_StoreReleaseChurn)->ThreadRange(1, 16)->UseRealTime();
+
+}  // namespace
@@ -54,11 +54,14 @@ private:
     void parseMarketDataConfig();
     void parseMonitoringConfig();
     void parsePerformanceConfig();
+    void parseAffinityConfig();
+    void parseJournalConfig();
     
     // 字符串转换函数
     LogLevel stringToLogLevel(const std::string& level) const;
     MarketType stringToMarketType(const std::string& market) const;
     MarketDataType stringToDataType(const std::string& data_type) const;
+    BackpressurePolicy stringToBackpressurePolicy(const std::string& policy) const;
     std::vector<std::string> splitString(const std::string& str, char delimiter) const;
     
 private:
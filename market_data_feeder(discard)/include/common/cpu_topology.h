@@ -0,0 +1,89 @@
+#pragma once
+
+#include "common/types.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace market_feeder
+{
+
+    // 工作进程绑核参数。CPU 列表格式同内核 cpulist（如 "2,4-7"），空表示自动
+    struct AffinityOptions
+    {
+        std::string nic_interface;     // 行情网卡，自动选择其所在的 NUMA 节点
+        int numa_node;                 // 指定节点，-1 表示按网卡或按 worker_id 轮流分配
+        std::string receive_cpus;      // 接收线程，第 k 个工作进程取第 k 个 CPU
+        std::string processor_cpus;    // 批处理线程，同上
+        std::string writer_cpus;       // 写库线程，所有工作进程共用
+        std::string housekeeping_cpus; // 心跳、统计等辅助线程，所有工作进程共用
+        bool bind_memory;              // 接收队列和内存池分配在所选节点上
+
+        AffinityOptions() : numa_node(-1), bind_memory(true) {}
+    };
+
+    // 一个工作进程各类线程的 CPU 集合
+    struct AffinityPlan
+    {
+        int node;
+        std::vector<int> receive;
+        std::vector<int> processor;
+        std::vector<int> writer;
+        std::vector<int> housekeeping;
+        bool oversubscribed; // 独占核不够，与其他工作进程共用
+
+        AffinityPlan() : node(-1), oversubscribed(false) {}
+
+        const std::vector<int> &cpusFor(ThreadRole role) const;
+    };
+
+    // 从 /sys 读取的 CPU 拓扑：在线 CPU 所属的 NUMA 节点、插槽与物理核。
+    // NUMA 内存策略直接用 mbind / set_mempolicy 系统调用，不依赖 libnuma
+    class CpuTopology
+    {
+    public:
+        struct Cpu
+        {
+            int id;
+            int node;
+            int package;
+            int core;
+        };
+
+        // 读取失败时退化为单节点、每个 CPU 一个物理核，仍可使用
+        bool discover();
+
+        const std::vector<Cpu> &cpus() const { return cpus_; }
+        int nodeCount() const { return node_count_; }
+
+        // 节点上的物理核，每个元素是同一物理核上的逻辑 CPU（超线程兄弟），按 CPU 编号排序
+        std::vector<std::vector<int>> nodeCores(int node) const;
+
+        // 计算 worker_id 的绑核方案：接收线程与批处理线程放在同一物理核的两个超线程上
+        // （没有超线程时用相邻的两个核），共享 L2，交接行情不跨核；
+        // 写库和辅助线程集中在节点的第一个物理核上，不占用独占核
+        AffinityPlan planWorker(const AffinityOptions &options, int worker_id) const;
+
+        std::string describe() const;
+
+        // 网卡所在 NUMA 节点，未知时返回 -1
+        static int nicNode(const std::string &interface);
+
+        static std::vector<int> parseCpuList(const std::string &list);
+        static std::string formatCpuList(const std::vector<int> &cpus);
+
+        // 把调用线程绑到 cpus 上
+        static bool pinCurrentThread(const std::vector<int> &cpus);
+
+        // 调用线程此后的内存分配优先放在 node 上
+        static bool preferNode(int node);
+
+        // [addr, addr + length) 的页优先分配在 node 上，须在页第一次访问之前调用
+        static bool bindMemory(void *addr, size_t length, int node);
+
+    private:
+        std::vector<Cpu> cpus_;
+        int node_count_ = 1;
+    };
+
+} // namespace market_feeder
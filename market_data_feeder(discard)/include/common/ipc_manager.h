@@ -1,6 +1,7 @@
 #pragma once
 
 #include "types.h"
+#include "tick_arena.h"
 #include <sys/types.h>
 #include <sys/ipc.h>
 #include <sys/shm.h>
@@ -11,7 +12,10 @@
 #include <functional>
 #include <map>
 #include <mutex>
+#include <atomic>
+#include <chrono>
 #include <cstring>
+#include <vector>
 
 namespace market_feeder
 {
@@ -43,87 +47,191 @@ namespace market_feeder
         }
     };
 
-    // 共享内存数据结构
-    struct SharedMemoryData
+    // 单个工作进程在共享内存中的槽位，独占缓存行，不同工作进程的写入互不干扰。
+    // 心跳与计数器各自是单独的原子量，直接写入；pid / worker_id / status / start_time
+    // 需要成组一致，写入时由 sequence 组成的 seqlock 保护，读方检测到并发写入时重试
+    struct alignas(64) WorkerSlot
     {
-        // 进程信息数组
-        ProcessInfo processes[constants::MAX_WORKER_PROCESSES];
-        int process_count;
-
-        // 全局统计信息
-        Statistics global_stats;
-
-        // 配置版本号
-        uint64_t config_version;
+        std::atomic<uint32_t> sequence; // 奇数表示正在写
+        std::atomic<uint32_t> in_use;
+        std::atomic<int32_t> pid;
+        std::atomic<int32_t> worker_id;
+        std::atomic<int32_t> status;
+        std::atomic<uint32_t> owned_keys; // 分到的证券（或市场）数
+        std::atomic<int64_t> start_time_ns;
+        std::atomic<int64_t> last_heartbeat_ns;
+        std::atomic<uint64_t> processed_count;
+        std::atomic<uint64_t> error_count;
+        std::atomic<uint64_t> received_count;
+
+        // 写方之间用 CAS 抢占奇数序号，只会与同一槽位的写方竞争
+        void beginWrite()
+        {
+            uint32_t seq = sequence.load(std::memory_order_relaxed);
+            while ((seq & 1u) ||
+                   !sequence.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                seq = sequence.load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_release);
+        }
 
-        // 控制标志
-        volatile bool shutdown_flag;
-        volatile bool reload_config_flag;
+        void endWrite()
+        {
+            sequence.fetch_add(1, std::memory_order_release);
+        }
 
-        // 互斥锁和条件变量（使用进程间同步）
-        pthread_mutex_t mutex;
-        pthread_cond_t condition;
+        // 无锁心跳，单个原子写
+        void touch(int64_t now_ns)
+        {
+            last_heartbeat_ns.store(now_ns, std::memory_order_relaxed);
+        }
 
-        SharedMemoryData() : process_count(0), config_version(0),
-                             shutdown_flag(false), reload_config_flag(false)
+        // 一致地读出全部字段，返回 false 表示槽位空闲
+        bool snapshot(ProcessInfo &info, int &slot_worker_id) const
         {
-            memset(processes, 0, sizeof(processes));
-
-            // 初始化进程间互斥锁
-            pthread_mutexattr_t mutex_attr;
-            pthread_mutexattr_init(&mutex_attr);
-            pthread_mutexattr_setpshared(&mutex_attr, PTHREAD_PROCESS_SHARED);
-            pthread_mutex_init(&mutex, &mutex_attr);
-            pthread_mutexattr_destroy(&mutex_attr);
-
-            // 初始化进程间条件变量
-            pthread_condattr_t cond_attr;
-            pthread_condattr_init(&cond_attr);
-            pthread_condattr_setpshared(&cond_attr, PTHREAD_PROCESS_SHARED);
-            pthread_cond_init(&condition, &cond_attr);
-            pthread_condattr_destroy(&cond_attr);
+            for (;;)
+            {
+                uint32_t begin = sequence.load(std::memory_order_acquire);
+                if (begin & 1u)
+                {
+                    continue;
+                }
+                bool used = in_use.load(std::memory_order_relaxed) != 0;
+                int32_t slot_pid = pid.load(std::memory_order_relaxed);
+                int32_t id = worker_id.load(std::memory_order_relaxed);
+                int32_t slot_status = status.load(std::memory_order_relaxed);
+                int64_t start_ns = start_time_ns.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence.load(std::memory_order_relaxed) != begin)
+                {
+                    continue;
+                }
+                if (!used)
+                {
+                    return false;
+                }
+
+                info.pid = slot_pid;
+                info.type = ProcessType::WORKER;
+                info.status = static_cast<ProcessStatus>(slot_status);
+                info.start_time = std::chrono::system_clock::time_point(
+                    std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(start_ns)));
+                info.last_heartbeat = std::chrono::system_clock::time_point(
+                    std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                        std::chrono::nanoseconds(last_heartbeat_ns.load(std::memory_order_relaxed))));
+                info.processed_count = processed_count.load(std::memory_order_relaxed);
+                info.error_count = error_count.load(std::memory_order_relaxed);
+                info.received_count = received_count.load(std::memory_order_relaxed);
+                info.owned_keys = owned_keys.load(std::memory_order_relaxed);
+                info.worker_id = id;
+                slot_worker_id = id;
+                return true;
+            }
         }
+    };
+
+    // 全局统计信息，只由主进程写入，读方通过 seqlock 取得一致的快照
+    struct alignas(64) GlobalStatsSlot
+    {
+        std::atomic<uint32_t> sequence;
+        std::atomic<uint64_t> total_processed;
+        std::atomic<uint64_t> total_errors;
+        std::atomic<uint64_t> current_connections;
+        std::atomic<double> cpu_usage;
+        std::atomic<uint64_t> memory_usage;
+        std::atomic<int64_t> last_update_ns;
+    };
+
+    // 共享内存数据结构：每个工作进程一个槽位（下标为 worker_id - 1），不再需要全局信号量
+    struct SharedMemoryData
+    {
+        // 工作进程槽位
+        WorkerSlot workers[constants::MAX_WORKER_PROCESSES];
+
+        // 全局统计信息
+        GlobalStatsSlot global_stats;
+
+        // 配置版本号与控制标志，主进程写、工作进程轮询
+        alignas(64) std::atomic<uint64_t> config_version;
+        std::atomic<bool> shutdown_flag;
+        std::atomic<bool> reload_config_flag;
+        pid_t master_pid;
 
-        ~SharedMemoryData()
+        // 分片成员位图，主进程先写位图再递增代数，工作进程轮询代数
+        alignas(64) std::atomic<uint64_t> shard_generation;
+        std::atomic<uint64_t> shard_members;
+
+        SharedMemoryData() : config_version(0), shutdown_flag(false), reload_config_flag(false), master_pid(0),
+                             shard_generation(0), shard_members(0)
         {
-            pthread_mutex_destroy(&mutex);
-            pthread_cond_destroy(&condition);
+            for (WorkerSlot &slot : workers)
+            {
+                slot.sequence.store(0, std::memory_order_relaxed);
+                slot.in_use.store(0, std::memory_order_relaxed);
+                slot.pid.store(0, std::memory_order_relaxed);
+                slot.worker_id.store(-1, std::memory_order_relaxed);
+                slot.status.store(static_cast<int32_t>(ProcessStatus::STOPPED), std::memory_order_relaxed);
+                slot.owned_keys.store(0, std::memory_order_relaxed);
+                slot.start_time_ns.store(0, std::memory_order_relaxed);
+                slot.last_heartbeat_ns.store(0, std::memory_order_relaxed);
+                slot.processed_count.store(0, std::memory_order_relaxed);
+                slot.error_count.store(0, std::memory_order_relaxed);
+                slot.received_count.store(0, std::memory_order_relaxed);
+            }
+            global_stats.sequence.store(0, std::memory_order_relaxed);
+            global_stats.total_processed.store(0, std::memory_order_relaxed);
+            global_stats.total_errors.store(0, std::memory_order_relaxed);
+            global_stats.current_connections.store(0, std::memory_order_relaxed);
+            global_stats.cpu_usage.store(0.0, std::memory_order_relaxed);
+            global_stats.memory_usage.store(0, std::memory_order_relaxed);
+            global_stats.last_update_ns.store(0, std::memory_order_relaxed);
         }
     };
 
+    // 跨进程使用要求这些原子量无锁
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared memory atomics must be lock-free");
+    static_assert(std::atomic<double>::is_always_lock_free, "shared memory atomics must be lock-free");
+
     class IPCManager
     {
     public:
         static IPCManager &getInstance();
 
-        // 初始化IPC系统
-        bool initialize(ProcessType process_type);
+        // 初始化IPC系统，工作进程需给出 worker_id 以连接自己的行情数据通道
+        bool initialize(ProcessType process_type, int worker_id = -1);
 
         // 清理IPC资源
         void cleanup();
 
-        // 消息队列操作
+        // 消息队列操作，只用于控制消息；MARKET_DATA 类型会被拒绝，行情由各工作进程直接从 SDK 订阅
         bool sendMessage(const IPCMessage &message, pid_t target_pid = 0);
         bool receiveMessage(IPCMessage &message, IPCMessageType type = IPCMessageType::HEARTBEAT, bool blocking = true);
 
         // 共享内存操作
         SharedMemoryData *getSharedMemory();
-        bool lockSharedMemory();
-        bool unlockSharedMemory();
 
         // 信号处理
         void setupSignalHandlers();
         void registerSignalHandler(int signal, std::function<void(int)> handler);
 
-        // 进程管理
-        bool registerProcess(const ProcessInfo &process_info);
-        bool unregisterProcess(pid_t pid);
+        // 进程管理：每个工作进程写自己的槽位，互不加锁；主进程通过 seqlock 读取
         bool updateProcessStatus(pid_t pid, ProcessStatus status);
         bool updateProcessHeartbeat(pid_t pid);
         std::vector<ProcessInfo> getAllProcesses();
         bool addWorkerProcess(pid_t pid, int worker_id);
         bool removeWorkerProcess(pid_t pid);
 
+        // 工作进程发布自己的累计接收数、处理数与错误数，各为单个原子写
+        bool updateWorkerCounters(int worker_id, uint64_t processed_count, uint64_t error_count,
+                                  uint64_t received_count = 0);
+
+        // 分片：主进程发布成员位图（代数加一），工作进程发现代数变化后重新计算自己的分片
+        void publishShardMembers(uint64_t members);
+        uint64_t getShardMembers(uint64_t &generation);
+        uint64_t getShardGeneration();
+        bool updateWorkerShard(int worker_id, uint32_t owned_keys);
+
         // 统计信息
         bool updateStatistics(const Statistics &stats);
         Statistics getGlobalStatistics();
@@ -146,23 +254,24 @@ namespace market_feeder
         // 创建IPC资源
         bool createMessageQueue();
         bool createSharedMemory();
-        bool createSemaphore();
-        bool createSemaphores();
 
         bool connectMessageQueue();
         bool connectSharedMemory();
-        bool connectSemaphore();
-        bool connectSemaphores();
 
         // 初始化函数
         void initializeSharedData();
+
+        // 按 pid 查找槽位，找不到返回 nullptr
+        WorkerSlot *findWorkerSlot(pid_t pid);
+
+        // worker_id（1 ~ MAX_WORKER_PROCESSES）对应的槽位 workers[worker_id - 1]，越界返回 nullptr
+        WorkerSlot *workerSlot(int worker_id);
         bool initializeMaster();
         bool initializeWorker();
 
         // 销毁IPC资源
         void destroyMessageQueue();
         void destroySharedMemory();
-        void destroySemaphore();
 
         // 信号处理函数
         static void signalHandler(int signal);
@@ -179,9 +288,8 @@ namespace market_feeder
         key_t shm_key_;
         SharedMemoryData *shared_memory_ = nullptr;
 
-        // 信号量
-        int sem_id_ = -1;
-        key_t sem_key_;
+        // 本进程的 worker_id，主进程为 -1
+        int worker_id_ = -1;
 
         // 信号处理器映射
         static std::map<int, std::function<void(int)>> signal_handlers_;
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace market_feeder
+{
+
+    // 编译期确定的计时点。新增计时点在 COUNT 之前追加，并在 latencySiteName 中补上名称
+    enum class LatencySite : uint8_t
+    {
+        ON_MARKET_DATA = 0, // SDK 行情回调
+        FLUSH_DATA_BUFFER,  // 同步写库一批
+        PROCESS_BATCH,      // 批处理线程取数、攒批、交给写库流水线
+
+        // 抽样行情的逐段耗时（monitoring.trace_sample_rate），除第一项外只统计已提交的行情
+        TICK_EXCHANGE_TO_RECEIVE, // 交易所时间戳到 SDK 回调入口（跨主机时钟）
+        TICK_RECEIVE_TO_ENQUEUE,  // SDK 回调入口到写入接收队列
+        TICK_ENQUEUE_TO_SEAL,     // 接收队列到批次封口
+        TICK_SEAL_TO_COMMIT,      // 封口到写库事务提交
+        TICK_RECEIVE_TO_COMMIT,   // 进程内全程
+        TICK_EXCHANGE_TO_COMMIT,  // 交易所时间戳到提交（跨主机时钟）
+
+        WRITER_COMMIT,      // 写库线程执行一次成功提交的事务（不含失败的尝试与退避等待）
+        WRITER_QUEUE_DEPTH, // 每次 submit 入队后的排队批次数；记录的是批次数而不是纳秒
+        COUNT
+    };
+
+    constexpr size_t kLatencySiteCount = static_cast<size_t>(LatencySite::COUNT);
+
+    // 导出和日志中使用的名称，同时是 Prometheus 的 site 标签
+    const char *latencySiteName(LatencySite site);
+
+    // 日志中的数值单位：计时点为 "ns"，WRITER_QUEUE_DEPTH 这类计数为空
+    const char *latencySiteUnit(LatencySite site);
+
+    // 时间戳计数器。支持恒定频率 TSC 的 x86 上直接读 rdtsc（约 20 个周期，无系统调用），
+    // 否则退化为 steady_clock 纳秒。计数只用于求差，换算成纳秒的系数由 calibrate 对照 steady_clock 测出
+    class TscClock
+    {
+    public:
+        static uint64_t now()
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            if (use_tsc_.load(std::memory_order_relaxed))
+            {
+                return __rdtsc();
+            }
+#endif
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                             std::chrono::steady_clock::now().time_since_epoch())
+                                             .count());
+        }
+
+        static uint64_t toNanoseconds(uint64_t ticks)
+        {
+            return static_cast<uint64_t>(static_cast<double>(ticks) * ns_per_tick_.load(std::memory_order_relaxed));
+        }
+
+        // 进程启动时调用一次（阻塞约 duration），之前读到的计数按 1 纳秒换算。
+        // /proc/cpuinfo 中没有 constant_tsc 和 nonstop_tsc 时不使用 TSC
+        static void calibrate(std::chrono::milliseconds duration = std::chrono::milliseconds(20));
+
+        static bool usingTsc() { return use_tsc_.load(std::memory_order_relaxed); }
+        static double nanosecondsPerTick() { return ns_per_tick_.load(std::memory_order_relaxed); }
+
+    private:
+        static std::atomic<bool> use_tsc_;
+        static std::atomic<double> ns_per_tick_;
+    };
+
+    // HDR 风格的纳秒直方图：小于 32 的值逐一计数，之后每个 2 的幂区间再均分为 32 个子桶，
+    // 相对误差不超过 1/32。只允许一个线程写入（计数用 load + store，不需要原子加），任意线程可读
+    class LatencyHistogram
+    {
+    public:
+        static constexpr unsigned kSubBucketBits = 5;
+        static constexpr uint64_t kSubBuckets = uint64_t(1) << kSubBucketBits;
+        static constexpr unsigned kMaxBits = 40; // 2^40 ns 约 18 分钟，更大的值计入最后一个桶
+        static constexpr size_t kBucketCount = (kMaxBits - kSubBucketBits + 1) * kSubBuckets;
+
+        LatencyHistogram()
+        {
+            for (auto &bucket : buckets_)
+            {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+            sum_.store(0, std::memory_order_relaxed);
+        }
+
+        void record(uint64_t value_ns)
+        {
+            std::atomic<uint64_t> &bucket = buckets_[bucketIndex(value_ns)];
+            bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            sum_.store(sum_.load(std::memory_order_relaxed) + value_ns, std::memory_order_relaxed);
+        }
+
+        uint64_t bucket(size_t index) const { return buckets_[index].load(std::memory_order_relaxed); }
+        uint64_t sum() const { return sum_.load(std::memory_order_relaxed); }
+
+        static size_t bucketIndex(uint64_t value)
+        {
+            if (value < kSubBuckets)
+            {
+                return static_cast<size_t>(value);
+            }
+            unsigned msb = 63u - static_cast<unsigned>(__builtin_clzll(value));
+            if (msb >= kMaxBits)
+            {
+                return kBucketCount - 1;
+            }
+            uint64_t top = value >> (msb - kSubBucketBits); // 最高 6 位，落在 [32, 64)
+            return static_cast<size_t>((msb - kSubBucketBits + 1) * kSubBuckets + (top - kSubBuckets));
+        }
+
+        // 桶内最大值，分位数按它报告（偏保守）
+        static uint64_t bucketUpperBound(size_t index)
+        {
+            if (index < 2 * kSubBuckets)
+            {
+                return index;
+            }
+            uint64_t group = index / kSubBuckets;
+            uint64_t low = (kSubBuckets + index % kSubBuckets) << (group - 1);
+            return low + (uint64_t(1) << (group - 1)) - 1;
+        }
+
+    private:
+        std::atomic<uint64_t> buckets_[kBucketCount];
+        std::atomic<uint64_t> sum_;
+    };
+
+    // 一个计时点在一个统计周期内的分布
+    struct LatencySummary
+    {
+        uint64_t count;
+        uint64_t mean_ns;
+        uint64_t p50_ns;
+        uint64_t p99_ns;
+        uint64_t p999_ns;
+        uint64_t max_ns; // 最高非空桶的上界
+    };
+
+    // 一个进程一个统计周期的全部计时点，原样放进 IPCMessage::data 发给主进程
+    struct LatencyReport
+    {
+        int32_t worker_id;
+        uint32_t site_count;
+        int64_t window_ns; // 与上一次汇总的间隔
+        LatencySummary sites[kLatencySiteCount];
+    };
+
+    // 按线程分配的直方图登记表。每个线程第一次记录时登记一组直方图，此后只写自己的一组，
+    // 热路径上没有锁、没有共享缓存行的写入；线程退出后这组直方图留给下一个新线程继续使用。
+    // 汇总时合并所有线程的累计计数，与上次汇总相减得到本周期的分布，写方从不清零
+    class LatencyRegistry
+    {
+    public:
+        static LatencyRegistry &getInstance();
+
+        // 记录一次耗时，ticks 为 TscClock 计数之差
+        static void record(LatencySite site, uint64_t ticks)
+        {
+            localBlock().sites[static_cast<size_t>(site)].record(TscClock::toNanoseconds(ticks));
+        }
+
+        static void recordNanoseconds(LatencySite site, uint64_t value_ns)
+        {
+            localBlock().sites[static_cast<size_t>(site)].record(value_ns);
+        }
+
+        // 汇总本周期（自上次 collect 起）各计时点的分位数，同一时刻只应有一个调用方
+        void collect(LatencyReport &report);
+
+    private:
+        struct ThreadBlock
+        {
+            LatencyHistogram sites[kLatencySiteCount];
+            std::atomic<bool> in_use;
+        };
+
+        // 线程退出时归还所持有的一组直方图
+        struct LocalHandle
+        {
+            ThreadBlock *block = nullptr;
+            ~LocalHandle();
+        };
+
+        LatencyRegistry();
+
+        static ThreadBlock &localBlock()
+        {
+            static thread_local LocalHandle handle;
+            if (!handle.block)
+            {
+                handle.block = getInstance().acquireBlock();
+            }
+            return *handle.block;
+        }
+
+        ThreadBlock *acquireBlock();
+
+        std::mutex mutex_;
+        std::vector<std::unique_ptr<ThreadBlock>> blocks_;
+
+        // 上次汇总时的累计计数，只由 collect 访问
+        std::vector<uint64_t> previous_buckets_; // kLatencySiteCount * kBucketCount
+        uint64_t previous_sums_[kLatencySiteCount];
+        std::chrono::steady_clock::time_point last_collect_;
+    };
+
+    // 作用域计时器：构造和析构各读一次 TSC，析构时写入调用线程的直方图，不格式化、不写日志
+    class LatencyTimer
+    {
+    public:
+        explicit LatencyTimer(LatencySite site) : site_(site), start_(TscClock::now()) {}
+        ~LatencyTimer() { LatencyRegistry::record(site_, TscClock::now() - start_); }
+
+        LatencyTimer(const LatencyTimer &) = delete;
+        LatencyTimer &operator=(const LatencyTimer &) = delete;
+
+    private:
+        LatencySite site_;
+        uint64_t start_;
+    };
+
+} // namespace market_feeder
+
+#define MARKET_FEEDER_CONCAT_IMPL(a, b) a##b
+#define MARKET_FEEDER_CONCAT(a, b) MARKET_FEEDER_CONCAT_IMPL(a, b)
+
+// 计时当前作用域，site 为 LatencySite 的枚举名，例如 PERF_TIMER(ON_MARKET_DATA)
+#define PERF_TIMER(site) \
+    market_feeder::LatencyTimer MARKET_FEEDER_CONCAT(perf_timer_, __LINE__)(market_feeder::LatencySite::site)
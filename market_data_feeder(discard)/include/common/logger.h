@@ -150,42 +150,4 @@ private:
 #define LOG_ACCESS(format, ...) market_feeder::Logger::getInstance().access(format, ##__VA_ARGS__)
 #define LOG_PERF(format, ...) market_feeder::Logger::getInstance().perf(format, ##__VA_ARGS__)
 
-class PerformanceTimer {
-public:
-    // 构造函数：初始化计时器名称并记录开始时间
-    explicit PerformanceTimer(const std::string& name)
-        : name_(name),
-          start_time_(std::chrono::high_resolution_clock::now()) {}
-
-    // 析构函数：自动计算总耗时并记录日志
-    ~PerformanceTimer() {
-        const auto end_time = std::chrono::high_resolution_clock::now();
-        const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time_);
-        
-        // 调用日志工具记录总耗时
-        Logger::getInstance().logPerformance(
-            fmt::format("[PERF] {} took {} μs", name_, duration.count())
-        );
-    }
-
-    // 记录检查点：计算当前时间与开始时间的差值并记录
-    void checkpoint(const std::string& checkpoint_name) {
-        const auto current_time = std::chrono::high_resolution_clock::now();
-        const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(current_time - start_time_);
-        
-        // 调用日志工具记录检查点耗时
-        Logger::getInstance().logPerformance(
-            fmt::format("[PERF] {} - Checkpoint '{}' at {} μs", name_, checkpoint_name, duration.count())
-        );
-    }
-
-    // 禁止拷贝构造和赋值（计时器对象应唯一）
-    PerformanceTimer(const PerformanceTimer&) = delete;
-    PerformanceTimer& operator=(const PerformanceTimer&) = delete;
-
-private:
-    std::string name_;                      // 计时器名称（用于日志标识）
-    std::chrono::high_resolution_clock::time_point start_time_;  // 计时起始时间点
-};
-
 } // namespace market_feeder
\ No newline at end of file
@@ -0,0 +1,295 @@
+#pragma once
+
+#include "common/types.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace market_feeder
+{
+
+    // 有界多生产者 / 单消费者环形队列，槽位在构造时一次性分配。
+    // 生产者通过回调直接在槽位上填写数据（不构造临时对象），消费者在槽位上就地读取；
+    // 每个槽位带序号（Vyukov 有界队列），入队只有一次 CAS，不加锁。
+    // 队列满时按 BackpressurePolicy 处理：
+    //   DROP_OLDEST 生产者自己出队最旧的一条丢弃后重试，回调线程永不等待；
+    //   BLOCK       生产者让出 CPU 直到有空位或队列关闭；
+    //   SPILL       写入加锁的溢出队列，溢出队列非空期间新数据都进溢出队列，消费者先取完环内再取溢出。
+    //               同一生产者线程的先后顺序保持不变；不同线程并发入队时，尚未看到溢出队列非空的生产者
+    //               仍可能写进环内，这条数据会先于更早进入溢出队列的数据被消费。
+    //               因此同一合约的行情来自多个回调线程时，SPILL 不保证逐合约有序，需要严格有序时用 BLOCK
+    template <typename T>
+    class MpscRing
+    {
+    public:
+        struct Stats
+        {
+            uint64_t high_water; // 观察到的最大排队深度
+            uint64_t dropped;    // DROP_OLDEST 丢弃的条数，或队列关闭后被拒绝的条数
+            uint64_t blocked;    // BLOCK 策略下因队列满而等待的次数
+            uint64_t spilled;    // 进入溢出队列的条数
+            size_t spill_depth;  // 当前溢出队列长度
+        };
+
+        // capacity 向上取整为 2 的幂
+        MpscRing(size_t capacity, BackpressurePolicy policy)
+            : capacity_(roundUpPowerOfTwo(capacity)), mask_(capacity_ - 1),
+              slots_(new Slot[capacity_]), policy_(policy)
+        {
+            for (size_t i = 0; i < capacity_; ++i)
+            {
+                slots_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        MpscRing(const MpscRing &) = delete;
+        MpscRing &operator=(const MpscRing &) = delete;
+
+        size_t capacity() const { return capacity_; }
+        BackpressurePolicy policy() const { return policy_; }
+
+        // ---- 生产者（任意线程）----
+
+        // 取得一个槽位并调用 fill(T&) 就地填写；队列已关闭时返回 false
+        template <typename Fill>
+        bool push(Fill &&fill)
+        {
+            return push(fill, [](T &) {});
+        }
+
+        // 同上，DROP_OLDEST 丢弃最旧的一条时先调用 on_drop(T&)，用于归还其引用的资源
+        template <typename Fill, typename Drop>
+        bool push(Fill &&fill, Drop &&on_drop)
+        {
+            if (policy_ == BackpressurePolicy::SPILL && spill_size_.load(std::memory_order_acquire) > 0)
+            {
+                return spill(fill);
+            }
+
+            uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+            unsigned full_rounds = 0;
+            for (;;)
+            {
+                if (closed_.load(std::memory_order_relaxed))
+                {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+
+                Slot &slot = slots_[pos & mask_];
+                uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+                int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+                if (diff == 0)
+                {
+                    if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        fill(slot.value);
+                        slot.sequence.store(pos + 1, std::memory_order_release);
+                        recordDepth(pos + 1);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    // 队列满
+                    if (policy_ == BackpressurePolicy::SPILL)
+                    {
+                        return spill(fill);
+                    }
+                    if (policy_ == BackpressurePolicy::DROP_OLDEST)
+                    {
+                        if (popOne(on_drop))
+                        {
+                            dropped_.fetch_add(1, std::memory_order_relaxed);
+                        }
+                        else
+                        {
+                            // 最旧的槽位正被消费者或其他生产者占用，稍后重试
+                            std::this_thread::yield();
+                        }
+                    }
+                    else
+                    {
+                        if (full_rounds++ == 0)
+                        {
+                            blocked_.fetch_add(1, std::memory_order_relaxed);
+                        }
+                        backoff(full_rounds);
+                    }
+                    pos = enqueue_pos_.load(std::memory_order_relaxed);
+                }
+                else
+                {
+                    pos = enqueue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // 唤醒所有 BLOCK 等待的生产者，此后 push 一律返回 false
+        void close() { closed_.store(true, std::memory_order_relaxed); }
+
+        // ---- 消费者（单线程）----
+
+        // 按入队顺序处理至多 max_items 条，fn(T&) 直接读取槽位内容；回调返回后槽位才交还生产者
+        template <typename Fn>
+        size_t consume(Fn &&fn, size_t max_items)
+        {
+            size_t count = 0;
+            while (count < max_items && popOne(fn))
+            {
+                ++count;
+            }
+
+            // 环内还有已占用未发布的槽位时不取溢出队列，否则会越过更早入队的数据。
+            // 先以 acquire 读溢出长度再读环内深度：写入溢出的生产者此前在环内占用的槽位此时一定可见
+            if (count < max_items && spill_size_.load(std::memory_order_acquire) > 0 && size() == 0)
+            {
+                std::lock_guard<std::mutex> lock(spill_mutex_);
+                while (count < max_items && !spill_queue_.empty())
+                {
+                    fn(spill_queue_.front());
+                    spill_queue_.pop_front();
+                    ++count;
+                }
+                spill_size_.store(spill_queue_.size(), std::memory_order_release);
+            }
+            return count;
+        }
+
+        // 当前环内的近似排队深度
+        size_t size() const
+        {
+            uint64_t tail = enqueue_pos_.load(std::memory_order_relaxed);
+            uint64_t head = dequeue_pos_.load(std::memory_order_relaxed);
+            return tail > head ? static_cast<size_t>(tail - head) : 0;
+        }
+
+        bool empty() const
+        {
+            return size() == 0 && spill_size_.load(std::memory_order_relaxed) == 0;
+        }
+
+        Stats stats() const
+        {
+            Stats result;
+            result.high_water = high_water_.load(std::memory_order_relaxed);
+            result.dropped = dropped_.load(std::memory_order_relaxed);
+            result.blocked = blocked_.load(std::memory_order_relaxed);
+            result.spilled = spilled_.load(std::memory_order_relaxed);
+            result.spill_depth = spill_size_.load(std::memory_order_relaxed);
+            return result;
+        }
+
+    private:
+        struct alignas(64) Slot
+        {
+            std::atomic<uint64_t> sequence;
+            T value;
+        };
+
+        static size_t roundUpPowerOfTwo(size_t value)
+        {
+            size_t result = 2;
+            while (result < value)
+            {
+                result <<= 1;
+            }
+            return result;
+        }
+
+        // 出队一条：消费者和 DROP_OLDEST 的生产者都会调用，因此 dequeue_pos_ 同样用 CAS 推进
+        template <typename Fn>
+        bool popOne(Fn &&fn)
+        {
+            uint64_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                Slot &slot = slots_[pos & mask_];
+                uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+                int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos + 1);
+                if (diff == 0)
+                {
+                    if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        fn(slot.value);
+                        slot.sequence.store(pos + capacity_, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = dequeue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        template <typename Fill>
+        bool spill(Fill &fill)
+        {
+            std::lock_guard<std::mutex> lock(spill_mutex_);
+            if (closed_.load(std::memory_order_relaxed))
+            {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            spill_queue_.emplace_back();
+            fill(spill_queue_.back());
+            spill_size_.store(spill_queue_.size(), std::memory_order_release);
+            spilled_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        void recordDepth(uint64_t tail)
+        {
+            uint64_t head = dequeue_pos_.load(std::memory_order_relaxed);
+            uint64_t depth = tail > head ? tail - head : 0;
+            uint64_t current = high_water_.load(std::memory_order_relaxed);
+            while (depth > current &&
+                   !high_water_.compare_exchange_weak(current, depth, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        // BLOCK 策略的等待：先自旋让出，长时间满时短暂休眠
+        static void backoff(unsigned rounds)
+        {
+            if (rounds < 64)
+            {
+                std::this_thread::yield();
+            }
+            else
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+
+        const size_t capacity_;
+        const size_t mask_;
+        std::unique_ptr<Slot[]> slots_;
+        const BackpressurePolicy policy_;
+
+        alignas(64) std::atomic<uint64_t> enqueue_pos_{0};
+        alignas(64) std::atomic<uint64_t> dequeue_pos_{0};
+        alignas(64) std::atomic<bool> closed_{false};
+
+        // 统计计数器，只在慢路径或深度创新高时写
+        alignas(64) std::atomic<uint64_t> high_water_{0};
+        std::atomic<uint64_t> dropped_{0};
+        std::atomic<uint64_t> blocked_{0};
+        std::atomic<uint64_t> spilled_{0};
+
+        alignas(64) std::atomic<size_t> spill_size_{0};
+        std::mutex spill_mutex_;
+        std::deque<T> spill_queue_;
+    };
+
+} // namespace market_feeder
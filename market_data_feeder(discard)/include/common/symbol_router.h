@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace market_feeder
+{
+
+    // 证券到工作进程的一致性哈希分片。
+    // 成员用位图表示（第 i 位为 worker_id i + 1，worker_id 取 1 ~ kMaxMembers），每个成员在环上放 kVirtualNodes 个虚拟节点，
+    // 键归属于顺时针方向的第一个节点。主进程和所有工作进程用同一位图各自构建，结果一致，不需要传递分配表；
+    // 成员增减时只有落在变动节点上的键换主，其余订阅保持不动
+    class SymbolRouter
+    {
+    public:
+        static constexpr int kVirtualNodes = 256;
+        static constexpr int kMaxMembers = 64;
+
+        SymbolRouter() : members_(0) {}
+
+        // 按成员位图重建哈希环
+        void rebuild(uint64_t members);
+
+        uint64_t members() const { return members_; }
+        bool contains(int worker_id) const
+        {
+            return (members_ & memberBit(worker_id)) != 0;
+        }
+
+        // 键的归属工作进程，环为空时返回 -1
+        int ownerOf(std::string_view key) const;
+
+        // keys 中归属 worker_id 的子集，保持原有顺序
+        std::vector<std::string> select(const std::vector<std::string> &keys, int worker_id) const;
+
+        static uint64_t hashKey(std::string_view key);
+
+        static uint64_t memberBit(int worker_id)
+        {
+            return worker_id >= 1 && worker_id <= kMaxMembers ? uint64_t(1) << (worker_id - 1) : 0;
+        }
+
+    private:
+        uint64_t members_;
+        std::vector<std::pair<uint64_t, int>> ring_; // 按哈希值排序的（虚拟节点, worker_id）
+    };
+
+} // namespace market_feeder
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "common/types.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace market_feeder
+{
+
+    // 行情原始数据的内存池。整块内存一次性 mmap（可选 2MB 大页），切成固定大小的段；
+    // 写入方在当前段上原子地顺序分配，不加锁，只在段用完切换到下一个空闲段时短暂持锁。
+    // 每段记录存活的记录数，段写满且其中的记录全部释放后整段回收复用。
+    // MarketData::raw_data 只保存段内偏移和长度，记录本身保持定长、可按字节拷贝
+    class TickArena
+    {
+    public:
+        static constexpr size_t kDefaultSegmentSize = 64 * 1024;
+        static constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+        struct Stats
+        {
+            size_t capacity;       // 内存池字节数
+            size_t free_segments;  // 可直接复用的空闲段
+            uint64_t stored;       // 成功写入的条数
+            uint64_t exhausted;    // 内存池耗尽导致原始数据被丢弃的条数
+            bool huge_pages;       // 是否由 MAP_HUGETLB 大页提供
+        };
+
+        TickArena();
+        ~TickArena();
+
+        TickArena(const TickArena &) = delete;
+        TickArena &operator=(const TickArena &) = delete;
+
+        // 分配 bytes 字节的内存池（上限 4GB，偏移用 32 位保存）；
+        // use_hugepages 为 true 时先尝试 MAP_HUGETLB，失败退化为普通页并建议内核使用透明大页；
+        // numa_node >= 0 时内存优先分配在该节点上
+        bool initialize(size_t bytes, bool use_hugepages, size_t segment_size = kDefaultSegmentSize,
+                        int numa_node = -1);
+        void destroy();
+
+        bool isInitialized() const { return base_ != nullptr; }
+
+        // 拷贝一段原始数据到池中并填写 ref；超过单段大小或池已耗尽时返回 false，ref 置空
+        bool store(std::string_view raw, RawDataRef &ref);
+
+        // ref 对应的数据，在 release 之前有效
+        std::string_view view(const RawDataRef &ref) const
+        {
+            if (ref.size == 0 || !base_)
+            {
+                return std::string_view();
+            }
+            return std::string_view(base_ + ref.offset, ref.size);
+        }
+
+        // 记录已经写库或被丢弃，归还其原始数据；空 ref 直接忽略
+        void release(const RawDataRef &ref);
+
+        Stats getStats() const;
+
+    private:
+        enum SegmentState : uint32_t
+        {
+            SEGMENT_FREE = 0,
+            SEGMENT_ACTIVE = 1,
+            SEGMENT_SEALED = 2
+        };
+
+        struct alignas(64) Segment
+        {
+            std::atomic<uint32_t> used;  // 已分配字节数，可能超过段大小（分配失败的部分）
+            std::atomic<uint32_t> live;  // 尚未释放的记录数
+            std::atomic<uint32_t> state;
+        };
+
+        // 当前段已满，切换到下一个空闲段；没有空闲段时返回 false
+        bool rotate(uint32_t full_segment);
+
+        // 段已封存且没有存活记录时放回空闲列表
+        void recycleIfDone(uint32_t index);
+
+        char *base_;
+        size_t mapped_size_;
+        size_t segment_size_;
+        bool huge_pages_;
+
+        std::unique_ptr<Segment[]> segments_;
+        uint32_t segment_count_;
+        alignas(64) std::atomic<uint32_t> current_;
+
+        mutable std::mutex free_mutex_;
+        std::vector<uint32_t> free_segments_;
+
+        alignas(64) std::atomic<uint64_t> stored_;
+        std::atomic<uint64_t> exhausted_;
+    };
+
+} // namespace market_feeder
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "common/types.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace market_feeder
+{
+
+    // 工作进程的行情日志：只追加、按段轮转的内存映射文件，保证进程崩溃后未写库的行情不丢。
+    // 每条记录定长（序号 + MarketData），批处理线程从接收队列取数时直接写进映射页，不经过中间缓冲和 write 调用；
+    // 记录的序号最后写入，作为这条记录完整的标志。行情进入接收队列时还没有写日志，
+    // 进程崩溃时仍在接收队列（含 SPILL 溢出队列）中的行情会丢失，丢失量不超过队列深度。
+    // 写库线程按批次提交结果推进检查点：所有序号小于检查点的记录都已确定写库，
+    // 整段落在检查点之前的段文件随即删除。重试耗尽而放弃的批次让检查点停在它的起点，
+    // 本次运行内不再推进（段文件随之保留），工作进程重启后从这里重放，放弃的批次得以重试；
+    // 之后已提交的批次会重复写入，语义为至少一次。
+    // 数据依赖页缓存，进程崩溃不丢，主机掉电可能丢失最近未回写的页；原始报文不写入日志
+    class TickJournal
+    {
+    public:
+        static constexpr size_t kDefaultSegmentSize = 64 * 1024 * 1024;
+
+        struct Stats
+        {
+            uint64_t next_sequence;  // 下一条记录的序号
+            uint64_t checkpoint;     // 已写库的序号上界
+            uint64_t segments;       // 现存段文件数
+            uint64_t replayed;       // 启动时重放的记录数
+            uint64_t abandoned;      // 本次运行中放弃的批次数，非 0 时检查点不再推进
+        };
+
+        TickJournal();
+        ~TickJournal();
+
+        TickJournal(const TickJournal &) = delete;
+        TickJournal &operator=(const TickJournal &) = delete;
+
+        // 打开（或创建）directory 下的日志，恢复写入位置和检查点。
+        // 已有日志沿用创建时的段大小，segment_size 只对新日志生效
+        bool open(const std::string &directory, size_t segment_size = kDefaultSegmentSize);
+        void close();
+
+        bool isOpen() const { return segment_base_ != nullptr; }
+
+        // 追加一条记录（单线程调用），原始数据引用不写入；段写满时轮转到新段，失败返回 false
+        bool append(const MarketData &data);
+
+        // 下一条记录的序号，即当前已追加记录的上界
+        uint64_t nextSequence() const { return next_sequence_; }
+
+        // 按提交顺序登记一个批次，end 为批次最后一条记录序号 + 1（单线程调用）
+        void trackBatch(uint64_t end);
+
+        // 撤销最近一次登记的批次（批次没有交给写库线程时调用）
+        void cancelBatch(uint64_t end);
+
+        // 批次已写库（committed）或已放弃（任意线程、任意顺序）；之前的批次都完成后推进检查点并删除过期段。
+        // 放弃的批次之后检查点停在它的起点，直到重启重放
+        void completeBatch(uint64_t end, bool committed);
+
+        uint64_t checkpoint() const;
+
+        // 把检查点之后的记录按至多 batch_size 条一批交给 fn(batch, end)，返回重放条数。
+        // 应在 open 之后、第一次 append 之前调用
+        size_t replay(size_t batch_size, const std::function<void(std::vector<MarketData> &, uint64_t)> &fn);
+
+        Stats getStats() const;
+
+        // 不打开日志，读取 directory 下检查点之后待重放的记录数；日志不存在时返回 0
+        static uint64_t pendingRecords(const std::string &directory);
+
+        // 工作进程的日志目录，主进程和工作进程共用同一规则
+        static std::string workerDirectory(const std::string &root, int worker_id);
+
+    private:
+        struct Record
+        {
+            std::atomic<uint64_t> sequence_plus_one;  // 0 表示空槽位，最后写入
+            MarketData data;
+        };
+
+        // 检查点文件，同样映射到内存，写完一个 8 字节字段即生效
+        struct CheckpointHeader
+        {
+            uint64_t magic;
+            uint64_t segment_records;  // 每段记录数，决定序号到文件位置的映射
+            std::atomic<uint64_t> committed;
+            uint64_t record_size;      // 创建时的 sizeof(Record)，MarketData 布局变化后旧日志不能直接读
+        };
+
+        std::string segmentPath(uint64_t segment) const;
+        static std::string segmentPath(const std::string &directory, uint64_t segment);
+
+        bool mapCheckpoint(size_t segment_size);
+        bool mapSegment(uint64_t segment, bool create);
+        void unmapSegment();
+
+        // 恢复写入位置：扫描最后一个段中序号连续的记录
+        void recoverWritePosition();
+
+        // 删除整段都在检查点之前的段文件
+        void removeSegmentsBefore(uint64_t sequence);
+
+        std::string directory_;
+        uint64_t segment_records_;
+
+        CheckpointHeader *header_;
+
+        Record *segment_base_;
+        uint64_t segment_index_;  // 当前映射的段
+        uint64_t next_sequence_;
+
+        struct InflightBatch
+        {
+            uint64_t end;
+            bool done;
+            bool committed;
+        };
+
+        mutable std::mutex checkpoint_mutex_;
+        std::deque<InflightBatch> inflight_;  // 按提交顺序
+        uint64_t oldest_segment_;
+        uint64_t abandoned_;  // 受 checkpoint_mutex_ 保护
+
+        std::atomic<uint64_t> replayed_;
+    };
+
+} // namespace market_feeder
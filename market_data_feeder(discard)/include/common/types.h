@@ -1,10 +1,13 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <chrono>
 #include <cstdint>
+#include <cstring>
+#include <algorithm>
 
 namespace market_feeder {
 
@@ -50,6 +53,21 @@ enum class MarketType {
     US = 3         // 美国市场
 };
 
+// 行情接收队列满时的处理策略
+enum class BackpressurePolicy {
+    DROP_OLDEST = 0,  // 丢弃最旧的数据，SDK 回调线程不等待
+    BLOCK = 1,        // 回调线程等待空位
+    SPILL = 2         // 溢出到无界的备用队列，多个回调线程之间不保证逐合约有序
+};
+
+// 工作进程内的线程类别，用于按类别绑核
+enum class ThreadRole {
+    RECEIVE = 0,       // SDK 接收线程
+    PROCESSOR = 1,     // 批处理线程（主循环）
+    WRITER = 2,        // 写库线程
+    HOUSEKEEPING = 3   // 心跳、统计等辅助线程
+};
+
 // 进程信息结构
 struct ProcessInfo {
     pid_t pid;
@@ -59,25 +77,60 @@ struct ProcessInfo {
     std::chrono::system_clock::time_point last_heartbeat;
     uint64_t processed_count;
     uint64_t error_count;
+    int worker_id;
+    uint64_t received_count;     // 累计接收的行情条数
+    uint32_t owned_keys;         // 分到的证券（或市场）数
     
     ProcessInfo() : pid(0), type(ProcessType::WORKER), 
                    status(ProcessStatus::STOPPED),
-                   processed_count(0), error_count(0) {}
+                   processed_count(0), error_count(0),
+                   worker_id(-1), received_count(0), owned_keys(0) {}
 };
 
-// 市场数据结构
+// 原始数据在 TickArena 中的位置，size 为 0 表示没有原始数据
+struct RawDataRef {
+    uint32_t offset;
+    uint32_t size;
+    
+    RawDataRef() : offset(0), size(0) {}
+};
+
+// 抽样跟踪的行情在进程内各阶段的 TscClock 计数，receive 为 0 表示未抽中
+struct TickTrace {
+    uint64_t receive;  // SDK 回调入口
+    uint64_t enqueue;  // 写入接收队列
+    uint64_t seal;     // 所在批次封口，交给写库
+    
+    TickTrace() : receive(0), enqueue(0), seal(0) {}
+};
+
+// 市场数据结构：定长、可按字节拷贝，入队和攒批都不需要堆分配
 struct MarketData {
-    std::string symbol;           // 证券代码
+    static constexpr size_t SYMBOL_CAPACITY = 32;  // 与 market_data.symbol VARCHAR(32) 一致
+    
+    char symbol[SYMBOL_CAPACITY];  // 证券代码，以 '\0' 结尾
     MarketType market;           // 市场类型
     MarketDataType data_type;    // 数据类型
     std::chrono::system_clock::time_point timestamp;  // 时间戳
     double price;                // 价格
     uint64_t volume;            // 成交量
-    std::string raw_data;       // 原始数据
+    RawDataRef raw_data;        // 原始数据
+    TickTrace trace;            // 延迟跟踪，只在本进程内有效
     
-    MarketData() : market(MarketType::SH), 
+    MarketData() : symbol(), market(MarketType::SH), 
                   data_type(MarketDataType::TICK),
                   price(0.0), volume(0) {}
+    
+    // 超出容量的部分截断
+    void setSymbol(std::string_view value) {
+        size_t length = std::min(value.size(), SYMBOL_CAPACITY - 1);
+        memcpy(symbol, value.data(), length);
+        symbol[length] = '\0';
+    }
+    
+    std::string_view getSymbol() const {
+        return std::string_view(symbol, strnlen(symbol, SYMBOL_CAPACITY));
+    }
 };
 
 // 配置结构
@@ -122,6 +175,18 @@ struct Config {
         int query_timeout;
         bool auto_reconnect;
         std::string charset;
+        int insert_chunk_size;
+        bool sticky_connections;     // 线程优先复用自己的连接
+        int validate_idle_ms;        // 空闲超过该时长的连接取用时才验证
+        int tick_cache_buckets;      // 查询缓存每个证券的桶数，0 关闭
+        int tick_cache_bucket_ms;
+        int tick_cache_max_ticks_per_bucket;
+        int tick_cache_max_ticks;    // 全部证券合计的缓存条数上限
+        int writer_threads;          // 并发写库事务数
+        int max_inflight_batches;    // 排队 + 执行中的批次上限
+        int commit_max_retries;
+        int retry_backoff_ms;
+        int retry_backoff_max_ms;
     } database;
     
     // SDK配置
@@ -138,9 +203,12 @@ struct Config {
     struct {
         std::vector<MarketType> markets;
         std::vector<MarketDataType> data_types;
+        std::vector<std::string> symbols;        // 按证券分片的证券列表，空表示按市场分片
         int buffer_size;
         int batch_size;
         int process_interval;
+        int ingest_queue_size;                   // SDK 回调到批处理之间的接收队列槽位数
+        BackpressurePolicy backpressure_policy;  // 接收队列满时的策略
     } market_data;
     
     // 监控配置
@@ -149,6 +217,8 @@ struct Config {
         int port;
         int stats_interval;
         int health_check_interval;
+        std::string latency_stats_file;  // 主进程写出的耗时分布文件，供 system_monitor 导出，空表示不写
+        int trace_sample_rate;           // 每 N 条行情跟踪一条从 SDK 回调到写库提交的各阶段耗时，0 关闭
     } monitoring;
     
     // 性能配置
@@ -160,6 +230,25 @@ struct Config {
         bool tcp_nodelay;
         bool so_reuseport;
     } performance;
+    
+    // 线程绑核配置
+    struct {
+        bool enabled;                   // 按线程类别绑核，开启后取代 worker_cpu_affinity
+        std::string nic_interface;      // 行情网卡，工作进程放在其 NUMA 节点上
+        int numa_node;                  // 指定节点，-1 自动
+        std::string receive_cpus;       // CPU 列表，空表示自动
+        std::string processor_cpus;
+        std::string writer_cpus;
+        std::string housekeeping_cpus;
+        bool bind_memory;               // 接收队列和内存池分配在所选节点上
+    } affinity;
+    
+    // 行情日志配置
+    struct {
+        bool enabled;
+        std::string directory;      // 每个工作进程使用其下的 worker_<id> 子目录
+        int segment_size_mb;        // 单个段文件大小
+    } journal;
 };
 
 // 统计信息结构
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "common/types.h"
+#include "database/database_manager.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace market_feeder {
+
+// 写库流水线：工作进程把攒满的批次交给它后立即继续攒下一批，
+// 由 writer_threads 个线程各自占用一个连接并发执行事务；失败按指数退避重试，次数有上限。
+// 正在排队和执行的批次总数不超过 max_inflight_batches，超出时 submit 等待，内存占用有界。
+// 批次的 vector 在提交完成后回收复用（双缓冲），避免每批重新分配。
+// 成功提交的事务耗时记入 LatencySite::WRITER_COMMIT，随工作进程的延迟统计一起上报
+class BatchWriter {
+public:
+    struct Options {
+        int writer_threads;         // 并发事务数，应不大于连接池大小
+        int max_inflight_batches;   // 排队 + 执行中的批次上限
+        int max_retries;            // 单个批次失败后的最大重试次数
+        int retry_backoff_ms;       // 首次重试等待，之后每次翻倍
+        int retry_backoff_max_ms;   // 单次等待上限
+        std::function<void()> on_thread_start;  // 每个写库线程启动时调用，用于绑核
+
+        Options() : writer_threads(2), max_inflight_batches(8), max_retries(3),
+                   retry_backoff_ms(100), retry_backoff_max_ms(2000) {}
+    };
+
+    // 批次最终完成（成功提交或重试耗尽）时在写库线程上回调，回调返回后 batch 被清空回收；
+    // tag 为 submit 时传入的值，原样带回
+    using CompletionCallback = std::function<void(std::vector<MarketData>& batch, bool committed, uint64_t tag)>;
+
+    struct Stats {
+        size_t queue_depth;          // 等待执行的批次
+        size_t in_flight;            // 排队 + 执行中的批次
+        uint64_t committed_batches;
+        uint64_t committed_rows;
+        uint64_t failed_batches;     // 重试耗尽后放弃的批次
+        uint64_t retries;
+        uint64_t submit_waits;       // 因 in_flight 达到上限而等待的提交次数
+        size_t max_queue_depth;      // 启动以来 submit 后观察到的最大排队批次数，分布见 LatencySite::WRITER_QUEUE_DEPTH
+    };
+
+    BatchWriter(DatabaseManager& db_manager, const Options& options, CompletionCallback on_complete);
+    ~BatchWriter();
+
+    BatchWriter(const BatchWriter&) = delete;
+    BatchWriter& operator=(const BatchWriter&) = delete;
+
+    bool start();
+
+    // 停止接收新批次，等待已提交的批次全部完成后退出
+    void stop();
+
+    bool isRunning() const { return running_.load(); }
+
+    // 提交一个攒好的批次；in_flight 达到上限时最多等待 timeout_ms 毫秒，超时或已停止返回 false（batch 保持不变）
+    bool submit(std::vector<MarketData>& batch, int timeout_ms = 1000, uint64_t tag = 0);
+
+    // 取一个已预留容量的空 vector 用于攒下一批
+    std::vector<MarketData> acquireBuffer(size_t capacity);
+
+    Stats getStats() const;
+
+private:
+    struct PendingBatch {
+        std::vector<MarketData> rows;
+        uint64_t tag;
+    };
+
+    void writerLoop();
+
+    // 执行一个批次，失败时按退避重试，返回是否最终提交成功
+    bool commitWithRetry(const std::vector<MarketData>& batch);
+
+    bool isRetryable(DBErrorCode code) const;
+
+    DatabaseManager& db_manager_;
+    Options options_;
+    CompletionCallback on_complete_;
+
+    std::vector<std::thread> threads_;
+    std::atomic<bool> running_;
+
+    mutable std::mutex queue_mutex_;
+    std::condition_variable queue_condition_;   // 有新批次或停止
+    std::condition_variable space_condition_;   // in_flight 下降
+    std::deque<PendingBatch> pending_;
+    size_t in_flight_;
+
+    std::mutex free_mutex_;
+    std::vector<std::vector<MarketData>> free_buffers_;
+
+    std::atomic<uint64_t> committed_batches_;
+    std::atomic<uint64_t> committed_rows_;
+    std::atomic<uint64_t> failed_batches_;
+    std::atomic<uint64_t> retries_;
+    std::atomic<uint64_t> submit_waits_;
+    size_t max_queue_depth_;    // 受 queue_mutex_ 保护
+};
+
+} // namespace market_feeder
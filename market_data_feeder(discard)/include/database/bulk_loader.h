@@ -0,0 +1,76 @@
+#pragma once
+
+#include "common/types.h"
+#include "database/database_manager.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace market_feeder {
+
+// 历史行情回灌用的批量导入，不走逐批 INSERT。
+// LOAD_DATA_INFILE：行情先顺序写入制表符分隔的暂存文件，每满 rows_per_load 行用一条 LOAD DATA INFILE 导入；
+//   X 协议不支持 LOCAL INFILE，暂存目录必须是 MySQL 服务端可读的路径（secure_file_priv）。
+// TABLE_INSERT：每满 rows_per_load 行用 X DevAPI 的表插入一次发送，适用于数据库不在本机的情况。
+// drop_secondary_indexes 为 true 时导入前删除 market_data 的二级索引，finish() 时一次性重建
+class MarketDataBulkLoader {
+public:
+    enum class Method {
+        LOAD_DATA_INFILE = 0,
+        TABLE_INSERT = 1
+    };
+
+    struct Options {
+        Method method;
+        std::string staging_dir;      // LOAD_DATA_INFILE 的暂存目录
+        size_t rows_per_load;         // 每次导入的行数
+        bool drop_secondary_indexes;  // 导入期间去掉二级索引
+        bool keep_staging_files;      // 导入后保留暂存文件，便于排查
+
+        Options() : method(Method::LOAD_DATA_INFILE), staging_dir("/var/lib/mysql-files"),
+                   rows_per_load(200000), drop_secondary_indexes(false), keep_staging_files(false) {}
+    };
+
+    MarketDataBulkLoader(DatabaseManager& db_manager, const Options& options);
+    ~MarketDataBulkLoader();
+
+    MarketDataBulkLoader(const MarketDataBulkLoader&) = delete;
+    MarketDataBulkLoader& operator=(const MarketDataBulkLoader&) = delete;
+
+    // 开始一次回灌，按需删除二级索引
+    DBErrorCode begin();
+
+    // 追加行情，攒满 rows_per_load 行时导入一次
+    DBErrorCode append(const MarketData& data);
+    DBErrorCode append(const std::vector<MarketData>& data_batch);
+
+    // 导入剩余数据并重建索引；析构时未调用则自动调用
+    DBErrorCode finish();
+
+    bool isActive() const { return active_; }
+
+private:
+    DBErrorCode flush();
+
+    bool openStagingFile();
+    // 关闭暂存文件，写入出错（如磁盘满）时返回 false
+    bool closeStagingFile();
+    void writeRow(const MarketData& data);
+
+    DatabaseManager& db_manager_;
+    Options options_;
+    bool active_;
+    bool indexes_dropped_;
+
+    // LOAD_DATA_INFILE
+    std::FILE* staging_file_;
+    std::string staging_path_;
+    uint64_t file_sequence_;
+
+    // TABLE_INSERT
+    std::vector<MarketData> pending_;
+
+    size_t pending_rows_;
+};
+
+} // namespace market_feeder
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <thread>
+
+namespace market_feeder {
+
+// 连接池的槽位分配，只管理槽位编号，不涉及连接本身。
+// 空闲槽位放在无锁栈中（Treiber 栈，栈顶带版本号防止 ABA）；开启 sticky 时，
+// 线程归还的槽位先停在本线程的粘滞位上，下次取用只需一次 CAS，不经过共享栈顶。
+// 停在粘滞位上的槽位在共享栈取空时可以被其他线程抢走，线程闲置或退出不会让连接一直被占着。
+// 每个线程只记住一个池的粘滞槽位，同一线程交替使用多个池时退化为共享栈
+class ConnectionSlots {
+public:
+    static constexpr uint32_t kNoSlot = std::numeric_limits<uint32_t>::max();
+
+    struct Stats {
+        size_t in_use;
+        uint64_t steals;  // 从其他线程粘滞位抢到的次数
+        uint64_t waits;   // 没有可用槽位而等待的次数
+    };
+
+    ConnectionSlots(size_t count, bool sticky)
+        : count_(static_cast<uint32_t>(count)), sticky_(sticky), id_(nextId()),
+          slots_(new Slot[count]), free_head_(pack(0, kNoSlot)) {
+        for (uint32_t i = count_; i > 0; --i) {
+            slots_[i - 1].state.store(SLOT_FREE, std::memory_order_relaxed);
+            pushFree(i - 1);
+        }
+    }
+
+    ConnectionSlots(const ConnectionSlots&) = delete;
+    ConnectionSlots& operator=(const ConnectionSlots&) = delete;
+
+    size_t size() const { return count_; }
+
+    // 不等待地取一个槽位，没有空闲时返回 kNoSlot
+    uint32_t tryAcquire() {
+        StickyCache& cache = stickyCache();
+        if (sticky_ && cache.owner == id_ && cache.slot != kNoSlot) {
+            uint32_t slot = cache.slot;
+            uint32_t expected = SLOT_PARKED;
+            if (slots_[slot].state.compare_exchange_strong(expected, SLOT_IN_USE, std::memory_order_acquire)) {
+                return slot;
+            }
+            // 已被其他线程抢走
+            cache.slot = kNoSlot;
+        }
+
+        uint32_t slot = popFree();
+        if (slot != kNoSlot) {
+            slots_[slot].state.store(SLOT_IN_USE, std::memory_order_relaxed);
+            return slot;
+        }
+        return sticky_ ? steal() : kNoSlot;
+    }
+
+    // 取一个槽位，没有空闲时退避等待至多 timeout；超时或已关闭返回 kNoSlot
+    uint32_t acquire(std::chrono::milliseconds timeout) {
+        if (closed_.load(std::memory_order_relaxed)) {
+            return kNoSlot;
+        }
+        uint32_t slot = tryAcquire();
+        if (slot != kNoSlot) {
+            return slot;
+        }
+
+        // 慢路径才读时钟
+        waits_.fetch_add(1, std::memory_order_relaxed);
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        for (unsigned rounds = 0; ; ++rounds) {
+            if (rounds < 64) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+            if (closed_.load(std::memory_order_relaxed)) {
+                return kNoSlot;
+            }
+            slot = tryAcquire();
+            if (slot != kNoSlot || std::chrono::steady_clock::now() >= deadline) {
+                return slot;
+            }
+        }
+    }
+
+    // 归还槽位：本线程的粘滞位空着（或就是这个槽位）时停在粘滞位，否则放回共享栈
+    void release(uint32_t slot) {
+        if (sticky_) {
+            StickyCache& cache = stickyCache();
+            // 原粘滞槽位已被抢走或正被本线程另外持有时，改用这个槽位
+            if (cache.owner != id_ || cache.slot == kNoSlot || cache.slot == slot ||
+                slots_[cache.slot].state.load(std::memory_order_relaxed) != SLOT_PARKED) {
+                cache.owner = id_;
+                cache.slot = slot;
+                slots_[slot].state.store(SLOT_PARKED, std::memory_order_release);
+                return;
+            }
+        }
+        slots_[slot].state.store(SLOT_FREE, std::memory_order_relaxed);
+        pushFree(slot);
+    }
+
+    // 此后 acquire 一律返回 kNoSlot，已取出的槽位仍可归还
+    void close() { closed_.store(true, std::memory_order_relaxed); }
+
+    size_t inUse() const {
+        size_t count = 0;
+        for (uint32_t i = 0; i < count_; ++i) {
+            if (slots_[i].state.load(std::memory_order_relaxed) == SLOT_IN_USE) {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    Stats stats() const {
+        Stats result;
+        result.in_use = inUse();
+        result.steals = steals_.load(std::memory_order_relaxed);
+        result.waits = waits_.load(std::memory_order_relaxed);
+        return result;
+    }
+
+private:
+    enum SlotState : uint32_t {
+        SLOT_FREE = 0,    // 在共享栈中
+        SLOT_PARKED = 1,  // 停在某个线程的粘滞位上
+        SLOT_IN_USE = 2
+    };
+
+    struct alignas(64) Slot {
+        std::atomic<uint32_t> state;
+        std::atomic<uint32_t> next;  // 共享栈中的下一个槽位
+    };
+
+    struct StickyCache {
+        uint64_t owner;  // 所属池的 id_，池地址可能被复用，因此不用指针
+        uint32_t slot;
+    };
+
+    static StickyCache& stickyCache() {
+        static thread_local StickyCache cache = {0, kNoSlot};
+        return cache;
+    }
+
+    static uint64_t nextId() {
+        static std::atomic<uint64_t> counter(0);
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    // 栈顶：高 32 位版本号，低 32 位槽位编号
+    static uint64_t pack(uint32_t tag, uint32_t slot) {
+        return (static_cast<uint64_t>(tag) << 32) | slot;
+    }
+
+    uint32_t popFree() {
+        uint64_t head = free_head_.load(std::memory_order_acquire);
+        for (;;) {
+            uint32_t slot = static_cast<uint32_t>(head);
+            if (slot == kNoSlot) {
+                return kNoSlot;
+            }
+            uint32_t next = slots_[slot].next.load(std::memory_order_relaxed);
+            if (free_head_.compare_exchange_weak(head, pack(static_cast<uint32_t>(head >> 32) + 1, next),
+                                                 std::memory_order_acquire, std::memory_order_acquire)) {
+                return slot;
+            }
+        }
+    }
+
+    void pushFree(uint32_t slot) {
+        uint64_t head = free_head_.load(std::memory_order_relaxed);
+        for (;;) {
+            slots_[slot].next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+            if (free_head_.compare_exchange_weak(head, pack(static_cast<uint32_t>(head >> 32) + 1, slot),
+                                                 std::memory_order_release, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+    }
+
+    // 从其他线程的粘滞位抢一个，起点按线程错开避免都抢同一个
+    uint32_t steal() {
+        if (count_ == 0) {
+            return kNoSlot;
+        }
+        uint32_t start = static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id()) % count_);
+        for (uint32_t i = 0; i < count_; ++i) {
+            uint32_t slot = (start + i) % count_;
+            uint32_t expected = SLOT_PARKED;
+            if (slots_[slot].state.compare_exchange_strong(expected, SLOT_IN_USE, std::memory_order_acquire)) {
+                steals_.fetch_add(1, std::memory_order_relaxed);
+                return slot;
+            }
+        }
+        return kNoSlot;
+    }
+
+    const uint32_t count_;
+    const bool sticky_;
+    const uint64_t id_;
+    std::unique_ptr<Slot[]> slots_;
+
+    alignas(64) std::atomic<uint64_t> free_head_;
+    alignas(64) std::atomic<bool> closed_{false};
+    std::atomic<uint64_t> steals_{0};
+    std::atomic<uint64_t> waits_{0};
+};
+
+} // namespace market_feeder
@@ -1,13 +1,13 @@
 #pragma once
 
 #include "common/types.h"
+#include "database/connection_slots.h"
+#include "database/tick_cache.h"
 #include <mysqlx/xdevapi.h>
 #include <string>
 #include <vector>
 #include <memory>
-#include <queue>
 #include <mutex>
-#include <condition_variable>
 #include <atomic>
 #include <chrono>
 #include <exception>
@@ -46,9 +46,19 @@ struct DBConfig {
     int query_timeout;
     bool auto_reconnect;
     bool use_ssl;
+    int insert_chunk_size;   // 批量写入时每条多行 INSERT 的行数
+    bool sticky_connections; // 线程优先复用自己上次归还的连接
+    int validate_idle_ms;    // 连接空闲超过该时长才在取用时验证，0 表示每次都验证
+    int tick_cache_buckets;  // 查询缓存每个证券保留的桶数，0 表示关闭缓存
+    int tick_cache_bucket_ms;
+    int tick_cache_max_ticks_per_bucket;
+    int tick_cache_max_ticks;  // 全部证券合计的缓存条数上限
     
     DBConfig() : port(3306), pool_size(10), connect_timeout(30),
-                query_timeout(60), auto_reconnect(true), use_ssl(false) {}
+                query_timeout(60), auto_reconnect(true), use_ssl(false),
+                insert_chunk_size(500), sticky_connections(true), validate_idle_ms(30000),
+                tick_cache_buckets(0), tick_cache_bucket_ms(1000),
+                tick_cache_max_ticks_per_bucket(10000), tick_cache_max_ticks(1000000) {}
 };
 
 // 数据库连接包装类
@@ -63,9 +73,19 @@ public:
     // 断开连接
     void disconnect();
     
-    // 检查连接状态
+    // 检查连接状态，会向服务器发送 SELECT 1
     bool isConnected() const;
     
+    // 会话是否存在，不访问服务器
+    bool isOpen() const { return connected_ && session_ != nullptr; }
+    
+    // 上次操作出错，或空闲超过 max_idle 时需要在取用前验证
+    bool needsValidation(std::chrono::milliseconds max_idle) const {
+        return needs_validation_ || !isOpen() ||
+               std::chrono::system_clock::now() - last_used_time_ >= max_idle;
+    }
+    void markValidated() { needs_validation_ = false; updateLastUsedTime(); }
+    
     // 执行查询
     DBErrorCode executeQuery(const std::string& sql);
     
@@ -75,6 +95,9 @@ public:
     // 执行预处理语句
     DBErrorCode executePreparedStatement(const std::string& sql, 
                                         const std::vector<mysqlx::Value>& params);
+    DBErrorCode executePreparedStatement(const std::string& sql, 
+                                        const std::vector<mysqlx::Value>& params,
+                                        mysqlx::SqlResult& result);
     
     // 开始事务
     DBErrorCode beginTransaction();
@@ -104,6 +127,10 @@ public:
     void setInUse(bool in_use) { in_use_ = in_use; }
     bool isInUse() const { return in_use_; }
     
+    // 在连接池中的槽位
+    void setPoolSlot(uint32_t slot) { pool_slot_ = slot; }
+    uint32_t getPoolSlot() const { return pool_slot_; }
+    
     // 获取最后使用时间
     std::chrono::system_clock::time_point getLastUsedTime() const { return last_used_time_; }
     void updateLastUsedTime() { last_used_time_ = std::chrono::system_clock::now(); }
@@ -112,6 +139,8 @@ private:
     std::unique_ptr<mysqlx::Session> session_;
     bool connected_;
     bool in_use_;
+    bool needs_validation_;
+    uint32_t pool_slot_;
     std::chrono::system_clock::time_point last_used_time_;
     DBConfig config_;
     std::string last_error_;
@@ -119,7 +148,9 @@ private:
     uint64_t last_insert_id_;
 };
 
-// 数据库连接池
+// 数据库连接池。连接在初始化时一次性创建，之后只在槽位间流转，取还不加锁：
+// 优先取本线程上次归还的连接，其次从无锁空闲栈取，再次抢其他线程停着的连接（见 ConnectionSlots）。
+// 连接只在上次出错或空闲超过 validate_idle_ms 后才在取用时验证，失效的连接原地重连
 class DBConnectionPool {
 public:
     DBConnectionPool();
@@ -128,41 +159,39 @@ public:
     // 初始化连接池
     bool initialize(const DBConfig& config);
     
-    // 获取连接
-    std::shared_ptr<DBConnection> getConnection(int timeout_ms = 5000);
+    // 获取连接，没有可用连接时最多等待 timeout_ms；连接归池所有，用完必须 returnConnection
+    DBConnection* getConnection(int timeout_ms = 5000);
     
     // 归还连接
-    void returnConnection(std::shared_ptr<DBConnection> connection);
+    void returnConnection(DBConnection* connection);
     
     // 获取连接池状态
     size_t getActiveConnections() const;
     size_t getIdleConnections() const;
     size_t getTotalConnections() const;
+    ConnectionSlots::Stats getSlotStats() const;
     
-    // 清理空闲连接
+    // 断开空闲超时的连接，下次取用时重连
     void cleanupIdleConnections(int idle_timeout_seconds = 300);
     
-    // 关闭连接池
+    // 关闭连接池，等待已取出的连接归还（至多 connect_timeout 秒）；只销毁空闲连接，
+    // 超时仍借出的连接保持存活直到归还，期间 initialize 返回 false
     void shutdown();
     
 private:
-    // 创建新连接
-    std::shared_ptr<DBConnection> createConnection();
-    
-    // 验证连接
-    bool validateConnection(std::shared_ptr<DBConnection> connection);
+    // 验证连接，失效时重连
+    bool validateConnection(DBConnection* connection);
     
 private:
     DBConfig config_;
-    std::queue<std::shared_ptr<DBConnection>> idle_connections_;
-    std::vector<std::shared_ptr<DBConnection>> all_connections_;
+    std::vector<std::unique_ptr<DBConnection>> connections_;
+    std::unique_ptr<ConnectionSlots> slots_;
     
+    // 只保护初始化、清理和关闭，取还连接不经过
     mutable std::mutex pool_mutex_;
-    std::condition_variable pool_condition_;
     
-    std::atomic<size_t> active_connections_;
     std::atomic<bool> shutdown_requested_;
-    bool initialized_;
+    std::atomic<bool> initialized_;
 };
 
 // 数据库管理器
@@ -177,17 +206,33 @@ public:
     // 关闭数据库管理器
     void shutdown();
     
-    // 保存市场数据
+    // 保存市场数据。批量写入在一个连接、一个事务内完成，
+    // 按 insert_chunk_size 行一条多行 INSERT，参数绑定，不拼接字符串
     DBErrorCode saveMarketData(const MarketData& data);
     DBErrorCode saveMarketDataBatch(const std::vector<MarketData>& data_batch);
     
-    // 查询市场数据
+    // 历史回灌的批量导入，由 MarketDataBulkLoader 调用。
+    // loadMarketDataFile 用 LOAD DATA INFILE 导入服务端可读的暂存文件，rows 只用于统计；
+    // bulkInsertMarketData 用 X DevAPI 表插入，整批在一个事务内发送
+    DBErrorCode loadMarketDataFile(const std::string& path, size_t rows);
+    DBErrorCode bulkInsertMarketData(const std::vector<MarketData>& data_batch);
+    
+    // 删除 / 重建 market_data 的二级索引，只处理实际存在 / 缺失的索引，可重复调用
+    DBErrorCode dropMarketDataIndexes();
+    DBErrorCode restoreMarketDataIndexes();
+    
+    // 查询市场数据，按时间排序。范围落在最近行情缓存的窗口内时直接由内存返回；
+    // 缓存只包含经由本实例写入的数据，同一证券只应由一个进程写入
     DBErrorCode queryMarketData(const std::string& symbol,
                                MarketDataType data_type,
                                const std::chrono::system_clock::time_point& start_time,
                                const std::chrono::system_clock::time_point& end_time,
                                std::vector<MarketData>& result);
     
+    // 写入归属变化时移除缓存：不再由本实例写入的证券若留在缓存里会返回过期结果，
+    // 重新归属的证券也要从新写入的数据起重新完整。symbols 为空时移除全部
+    void dropCachedMarketData(const std::vector<std::string>& symbols);
+    
     // 保存统计信息
     DBErrorCode saveStatistics(const Statistics& stats);
     
@@ -209,9 +254,34 @@ public:
         size_t active_connections;
         size_t idle_connections;
         
+        // 批量写入
+        uint64_t rows_inserted;
+        uint64_t batches_inserted;
+        double insert_time_ms;              // 成功批次的累计耗时（含事务提交）
+        double rows_per_second;             // rows_inserted / insert_time_ms
+        double last_batch_rows_per_second;
+        
+        // 批量导入（回灌），与上面的批量写入分开统计以便对比
+        uint64_t bulk_rows_loaded;
+        uint64_t bulk_loads;
+        double bulk_load_time_ms;
+        double bulk_rows_per_second;
+        
+        // 最近行情缓存
+        uint64_t cache_hits;
+        uint64_t cache_misses;
+        double cache_hit_ratio;
+        size_t cache_ticks;
+        uint64_t cache_evicted_series;
+        
         DBStatistics() : total_queries(0), successful_queries(0),
                         failed_queries(0), average_query_time_ms(0.0),
-                        active_connections(0), idle_connections(0) {}
+                        active_connections(0), idle_connections(0),
+                        rows_inserted(0), batches_inserted(0), insert_time_ms(0.0),
+                        rows_per_second(0.0), last_batch_rows_per_second(0.0),
+                        bulk_rows_loaded(0), bulk_loads(0), bulk_load_time_ms(0.0),
+                        bulk_rows_per_second(0.0), cache_hits(0), cache_misses(0),
+                        cache_hit_ratio(0.0), cache_ticks(0), cache_evicted_series(0) {}
     };
     
     DBStatistics getStatistics() const;
@@ -219,11 +289,16 @@ public:
 private:
     // 构建SQL语句
     std::string buildInsertMarketDataSQL(const MarketData& data);
-    std::string buildBatchInsertMarketDataSQL(const std::vector<MarketData>& data_batch);
-    std::string buildQueryMarketDataSQL(const std::string& symbol,
-                                       MarketDataType data_type,
-                                       const std::chrono::system_clock::time_point& start_time,
-                                       const std::chrono::system_clock::time_point& end_time);
+    // row_count 行占位符的多行 INSERT
+    std::string buildBatchInsertMarketDataSQL(size_t row_count);
+    
+    // 记录一次批量写入的结果与耗时
+    void recordBatchInsert(bool success, size_t rows, size_t statements,
+                           std::chrono::steady_clock::duration elapsed);
+    void recordBulkLoad(bool success, size_t rows, std::chrono::steady_clock::duration elapsed);
+    
+    // market_data 当前存在的索引名
+    bool getMarketDataIndexes(DBConnection* conn, std::vector<std::string>& names);
     
     // 解析查询结果
     bool parseMarketDataResult(mysqlx::SqlResult& result, std::vector<MarketData>& data);
@@ -243,9 +318,17 @@ private:
     DBConfig config_;
     bool initialized_;
     
+    // 批量写入：整块语句在初始化时生成一次
+    size_t insert_chunk_size_;
+    std::string chunk_insert_sql_;
+    
+    // 最近行情缓存，由成功提交的批次填充
+    std::unique_ptr<TickCache> tick_cache_;
+    
     // 统计信息
     mutable std::mutex stats_mutex_;
     DBStatistics stats_;
+    double query_time_total_ms_;
 };
 
 } // namespace market_feeder
\ No newline at end of file
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "common/types.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace market_feeder {
+
+// 最近行情的内存缓存，放在 queryMarketData 前面。
+// 每个（证券代码, 数据类型）一个按时间分桶的环：桶宽 bucket_ms，共 bucket_count 个桶，
+// 覆盖最新数据之前 bucket_count * bucket_ms 的窗口，新桶覆盖环上最旧的桶。
+// 只由成功提交的写库批次填充，因此缓存内容与数据库一致；
+// 查询范围完全落在窗口内、且这段时间缓存没有漏数据时由内存返回，否则回退到 SQL。
+// 以下情况视为漏数据，相关区间不由缓存服务：缓存开始前已有的数据（首个桶之前及首个桶本身）、
+// 单桶超过 max_ticks_per_bucket 被截断的桶、invalidate() 之前的数据、
+// 最新缓存桶之后已经过去的时间段（可能只是没有成交，也可能是证券已不由本进程写入）。
+// 证券换主后应调用 drop / clear 移除对应序列，重新归属时从下一个桶起重新完整。
+// 全部序列的总条数超过 max_total_ticks 时整序列淘汰最久没有写入的，被淘汰的证券回退到 SQL
+class TickCache {
+public:
+    struct Options {
+        int bucket_ms;              // 桶宽
+        int bucket_count;           // 每个证券保留的桶数
+        int max_ticks_per_bucket;   // 单桶上限，超出的桶不再由缓存服务
+        size_t max_total_ticks;     // 全部序列的总条数上限
+
+        Options() : bucket_ms(1000), bucket_count(300), max_ticks_per_bucket(10000),
+                    max_total_ticks(1000000) {}
+    };
+
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        double hit_ratio;
+        size_t series;     // 缓存的（证券, 类型）数
+        size_t ticks;      // 缓存的行情条数
+        uint64_t evicted_series;  // 超出总条数上限被淘汰的序列数
+    };
+
+    explicit TickCache(const Options& options);
+
+    TickCache(const TickCache&) = delete;
+    TickCache& operator=(const TickCache&) = delete;
+
+    // 写入已提交的行情
+    void insert(const std::vector<MarketData>& data_batch);
+
+    // [start_time, end_time] 在缓存窗口内时填写 result（按时间排序）并返回 true，否则返回 false
+    bool query(const std::string& symbol, MarketDataType data_type,
+               const std::chrono::system_clock::time_point& start_time,
+               const std::chrono::system_clock::time_point& end_time,
+               std::vector<MarketData>& result);
+
+    // 数据库被绕过缓存写入（如批量导入）后调用，此前的缓存内容不再用于查询
+    void invalidate();
+
+    // 移除 symbols 的全部数据类型的序列 / 移除全部序列，用于分片换主
+    void drop(const std::vector<std::string>& symbols);
+    void clear();
+
+    Stats getStats() const;
+
+private:
+    struct Bucket {
+        int64_t id;        // 桶编号 = 时间戳 / 桶宽，-1 表示空
+        bool truncated;
+        std::vector<MarketData> ticks;
+
+        Bucket() : id(-1), truncated(false) {}
+    };
+
+    // 一个（证券, 类型）的时间环
+    struct Series {
+        std::mutex mutex;
+        std::vector<Bucket> buckets;
+        int64_t newest_bucket;      // 已写入的最新桶编号
+        int64_t complete_from;      // 从该桶起缓存数据完整
+        size_t ticks;
+        bool detached;              // 已从 series_ 移除，持有者不再写入
+
+        Series() : newest_bucket(-1), complete_from(0), ticks(0), detached(false) {}
+    };
+
+    int64_t bucketOf(const std::chrono::system_clock::time_point& tp) const;
+    std::string makeKey(std::string_view symbol, MarketDataType data_type) const;
+    std::shared_ptr<Series> findOrCreate(const std::string& key, int64_t first_bucket);
+    void insertLocked(Series& series, int64_t bucket_id, const MarketData& data);
+    // 调用方持有 series_mutex_ 的写锁
+    void detach(Series& series);
+    void evict();
+
+    Options options_;
+    int64_t bucket_us_;
+
+    // 序列可能在写入或查询期间被 drop，调用方持有 shared_ptr
+    mutable std::shared_mutex series_mutex_;
+    std::unordered_map<std::string, std::shared_ptr<Series>> series_;
+
+    // invalidate() 之后各序列要从这个桶之后才重新完整
+    std::atomic<int64_t> invalid_before_;
+
+    std::atomic<size_t> total_ticks_;
+    std::mutex evict_mutex_;  // 同时只有一个写入线程做淘汰
+
+    std::atomic<uint64_t> hits_;
+    std::atomic<uint64_t> misses_;
+    std::atomic<uint64_t> evicted_series_;
+};
+
+} // namespace market_feeder
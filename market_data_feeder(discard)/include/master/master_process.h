@@ -4,7 +4,9 @@
 #include "common/config_manager.h"
 #include "common/logger.h"
 #include "common/ipc_manager.h"
+#include "common/latency_histogram.h"
 #include <vector>
+#include <map>
 #include <memory>
 #include <thread>
 #include <atomic>
@@ -62,6 +64,8 @@ private:
     void monitorWorkerProcesses();
     void checkWorkerHealth();
     void handleDeadWorker(pid_t pid);
+    // 不再重启该工作进程：移出分片成员并发布，其证券由其余工作进程接手
+    void retireWorker(int worker_id);
     
     // 信号处理
     void setupSignalHandlers();
@@ -77,6 +81,9 @@ private:
     void handleStatisticsMessage(const IPCMessage& message);
     void handleErrorReportMessage(const IPCMessage& message);
     
+    // 把各工作进程最近一次上报的耗时分布写到 monitoring.latency_stats_file，供 system_monitor 导出
+    void writeLatencyStats();
+    
     // 统计和监控
     void updateGlobalStatistics();
     void logProcessStatistics();
@@ -84,6 +91,8 @@ private:
     
     // 配置管理
     bool validateWorkerCount();
+    
+    // 按配置增减工作进程，并发布新的分片成员让各工作进程重新分配证券
     void adjustWorkerCount();
     
     // 清理资源
@@ -103,6 +112,19 @@ private:
     std::vector<ProcessInfo> worker_processes_;
     int target_worker_count_;
     
+    // 分片成员位图（第 i 位为 worker_id i + 1，见 SymbolRouter::memberBit），退出后不再重启的工作进程从中移除
+    uint64_t shard_members_;
+    
+    // 各工作进程连续启动失败（启动后很快退出）的次数
+    std::map<int, int> failed_starts_;
+    
+    // 上次输出负载统计时各工作进程的累计接收数，用于计算速率
+    std::map<int, uint64_t> last_received_counts_;
+    std::chrono::steady_clock::time_point last_load_report_;
+    
+    // 各工作进程最近一次上报的耗时分布及收到的时间
+    std::map<int, std::pair<LatencyReport, std::chrono::steady_clock::time_point>> latency_reports_;
+    
     // 监控线程
     std::unique_ptr<std::thread> monitor_thread_;
     std::unique_ptr<std::thread> ipc_thread_;
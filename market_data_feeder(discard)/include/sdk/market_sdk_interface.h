@@ -3,6 +3,7 @@
 #include "common/types.h"
 #include <functional>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 
@@ -31,9 +32,12 @@ enum class SDKErrorCode {
 };
 
 // SDK回调函数类型
-using MarketDataCallback = std::function<void(const MarketData&)>;
+// raw_data 为本条行情的原始报文，只在回调期间有效，需要保留时由接收方拷贝
+using MarketDataCallback = std::function<void(const MarketData&, std::string_view raw_data)>;
 using ConnectionStatusCallback = std::function<void(SDKConnectionStatus, const std::string&)>;
 using ErrorCallback = std::function<void(SDKErrorCode, const std::string&)>;
+// SDK 内部线程启动时在该线程上调用，role 表示线程用途，用于绑核
+using ThreadStartCallback = std::function<void(ThreadRole role)>;
 
 // SDK配置结构
 struct SDKConfig {
@@ -120,6 +124,7 @@ public:
     virtual void setMarketDataCallback(MarketDataCallback callback) = 0;
     virtual void setConnectionStatusCallback(ConnectionStatusCallback callback) = 0;
     virtual void setErrorCallback(ErrorCallback callback) = 0;
+    virtual void setThreadStartCallback(ThreadStartCallback callback) = 0;
     
     // 获取连接状态
     virtual SDKConnectionStatus getConnectionStatus() const = 0;
@@ -4,14 +4,19 @@
 #include "common/config_manager.h"
 #include "common/logger.h"
 #include "common/ipc_manager.h"
+#include "common/mpsc_ring.h"
+#include "common/tick_arena.h"
+#include "common/tick_journal.h"
+#include "common/symbol_router.h"
+#include "common/cpu_topology.h"
+#include "common/latency_histogram.h"
 #include "sdk/market_sdk_interface.h"
 #include "database/database_manager.h"
+#include "database/batch_writer.h"
 #include <memory>
 #include <thread>
 #include <atomic>
-#include <queue>
 #include <mutex>
-#include <condition_variable>
 #include <chrono>
 
 namespace market_feeder {
@@ -43,6 +48,10 @@ private:
     // 设置CPU亲和性
     bool setCpuAffinity();
     
+    // 按线程类别绑核：计算方案并绑定主线程（批处理线程），其余线程启动时调用 pinThread
+    void setupAffinity();
+    void pinThread(ThreadRole role);
+    
     // 设置进程优先级
     bool setProcessPriority();
     
@@ -57,15 +66,32 @@ private:
     bool initializeDatabase();
     void cleanupDatabase();
     
+    // 订阅：按分片成员计算本进程负责的证券（或市场）并订阅；成员变化时只增减差量
+    bool subscribeMarketData();
+    void rebalanceSubscriptions();
+    SubscriptionParams computeShard() const;
+    
     // 行情数据处理
     void processMarketData();
-    void handleMarketDataCallback(const MarketData& data);
+    void handleMarketDataCallback(const MarketData& data, std::string_view raw_data);
     bool validateMarketData(const MarketData& data);
     
     // 数据缓冲和批处理
-    void bufferMarketData(const MarketData& data);
-    void processBatchData();
+    // receive_ticks 非 0 表示这条行情被抽中跟踪，为 SDK 回调入口的 TscClock 计数
+    void bufferMarketData(const MarketData& data, std::string_view raw_data, uint64_t receive_ticks = 0);
+    size_t processBatchData();
     bool saveDataToDatabase(const std::vector<MarketData>& data_batch);
+    void onBatchCompleted(std::vector<MarketData>& batch, bool committed, uint64_t journal_end);
+    bool submitBatch(int timeout_ms);
+    
+    // 延迟跟踪：批缓冲封口时给抽中的行情打封口时间，提交成功后记录各阶段耗时
+    void sealBatchTraces();
+    void recordCommittedTraces(const std::vector<MarketData>& batch);
+    
+    // 行情日志：打开并重放上次崩溃遗留的记录，重放的批次交不出去时返回 false（记录留在日志里）；
+    // trackJournalBatch 登记当前批缓冲，未开启时返回 0
+    bool setupJournal();
+    uint64_t trackJournalBatch();
     
     // 心跳和通信
     void sendHeartbeat();
@@ -88,13 +114,12 @@ private:
     void handleSignalTerm(int signal);
     void handleSignalUsr1(int signal);
     
-    // 内存管理
+    // 内存管理：接收队列、批缓冲和原始报文内存池（可选大页）
     void setupMemoryPool();
     void cleanupMemoryPool();
     
     // 性能优化
     void optimizePerformance();
-    void enableHugePages();
     
     // 清理资源
     void cleanup();
@@ -115,12 +140,27 @@ private:
     // SDK和数据库
     std::unique_ptr<MarketSDKInterface> sdk_;
     std::unique_ptr<DatabaseManager> db_manager_;
+    std::unique_ptr<BatchWriter> batch_writer_;
+    
+    // 绑核
+    CpuTopology topology_;
+    AffinityPlan affinity_plan_;
+    bool affinity_enabled_;
+    bool bind_memory_;
+    
+    // 分片
+    SymbolRouter router_;
+    uint64_t shard_generation_;
+    SubscriptionParams subscription_;   // 当前已订阅的分片
+    
+    // 数据缓冲：SDK 回调线程就地写入，批处理线程单独消费
+    std::unique_ptr<MpscRing<MarketData>> ingest_queue_;
+    TickArena tick_arena_;
+    TickJournal journal_;   // 批处理线程取数时写入，接收队列中尚未取出的行情不在日志里
     
-    // 数据缓冲
-    std::queue<MarketData> data_buffer_;
-    std::mutex buffer_mutex_;
-    std::condition_variable buffer_condition_;
-    size_t max_buffer_size_;
+    // 延迟跟踪
+    uint32_t trace_sample_rate_;            // 0 关闭
+    std::vector<uint32_t> traced_indices_;  // 批缓冲中被抽中的行情下标，只由批处理线程访问
     
     // 批处理
     std::vector<MarketData> batch_buffer_;
@@ -136,6 +176,7 @@ private:
     
     // 统计信息
     Statistics stats_;
+    LatencyReport latency_report_;      // 最近一个统计周期的耗时分布
     mutable std::mutex stats_mutex_;
     
     // 时间记录
@@ -32,6 +32,8 @@ bool ConfigManager::loadConfig(const std::string& config_file) {
     parseMarketDataConfig();
     parseMonitoringConfig();
     parsePerformanceConfig();
+    parseAffinityConfig();
+    parseJournalConfig();
     
     return validateConfig();
 }
@@ -164,6 +166,18 @@ void ConfigManager::parseDatabaseConfig() {
     config_.database.query_timeout = getInt("database", "query_timeout", 60);
     config_.database.auto_reconnect = getBool("database", "auto_reconnect", true);
     config_.database.charset = getString("database", "charset", "utf8mb4");
+    config_.database.insert_chunk_size = getInt("database", "insert_chunk_size", 500);
+    config_.database.sticky_connections = getBool("database", "sticky_connections", true);
+    config_.database.validate_idle_ms = getInt("database", "validate_idle_ms", 30000);
+    config_.database.tick_cache_buckets = getInt("database", "tick_cache_buckets", 0);
+    config_.database.tick_cache_bucket_ms = getInt("database", "tick_cache_bucket_ms", 1000);
+    config_.database.tick_cache_max_ticks_per_bucket = getInt("database", "tick_cache_max_ticks_per_bucket", 10000);
+    config_.database.tick_cache_max_ticks = getInt("database", "tick_cache_max_ticks", 1000000);
+    config_.database.writer_threads = getInt("database", "writer_threads", 2);
+    config_.database.max_inflight_batches = getInt("database", "max_inflight_batches", 8);
+    config_.database.commit_max_retries = getInt("database", "commit_max_retries", 3);
+    config_.database.retry_backoff_ms = getInt("database", "retry_backoff_ms", 100);
+    config_.database.retry_backoff_max_ms = getInt("database", "retry_backoff_max_ms", 2000);
 }
 
 void ConfigManager::parseSdkConfig() {
@@ -188,9 +202,14 @@ void ConfigManager::parseMarketDataConfig() {
         config_.market_data.data_types.push_back(stringToDataType(data_type_name));
     }
     
+    config_.market_data.symbols = splitString(getString("market_data", "symbols", ""), ',');
+    
     config_.market_data.buffer_size = getInt("market_data", "buffer_size", 10240);
     config_.market_data.batch_size = getInt("market_data", "batch_size", 100);
     config_.market_data.process_interval = getInt("market_data", "process_interval", 100);
+    config_.market_data.ingest_queue_size = getInt("market_data", "ingest_queue_size", 65536);
+    config_.market_data.backpressure_policy =
+        stringToBackpressurePolicy(getString("market_data", "backpressure_policy", "drop_oldest"));
 }
 
 void ConfigManager::parseMonitoringConfig() {
@@ -198,6 +217,8 @@ void ConfigManager::parseMonitoringConfig() {
     config_.monitoring.port = getInt("monitoring", "port", 8080);
     config_.monitoring.stats_interval = getInt("monitoring", "stats_interval", 60);
     config_.monitoring.health_check_interval = getInt("monitoring", "health_check_interval", 30);
+    config_.monitoring.latency_stats_file = getString("monitoring", "latency_stats_file", "");
+    config_.monitoring.trace_sample_rate = getInt("monitoring", "trace_sample_rate", 0);
 }
 
 void ConfigManager::parsePerformanceConfig() {
@@ -209,6 +230,23 @@ void ConfigManager::parsePerformanceConfig() {
     config_.performance.so_reuseport = getBool("performance", "so_reuseport", true);
 }
 
+void ConfigManager::parseAffinityConfig() {
+    config_.affinity.enabled = getBool("affinity", "enabled", false);
+    config_.affinity.nic_interface = getString("affinity", "nic_interface", "");
+    config_.affinity.numa_node = getInt("affinity", "numa_node", -1);
+    config_.affinity.receive_cpus = getString("affinity", "receive_cpus", "");
+    config_.affinity.processor_cpus = getString("affinity", "processor_cpus", "");
+    config_.affinity.writer_cpus = getString("affinity", "writer_cpus", "");
+    config_.affinity.housekeeping_cpus = getString("affinity", "housekeeping_cpus", "");
+    config_.affinity.bind_memory = getBool("affinity", "bind_memory", true);
+}
+
+void ConfigManager::parseJournalConfig() {
+    config_.journal.enabled = getBool("journal", "enabled", false);
+    config_.journal.directory = getString("journal", "directory", "/var/lib/market_feeder/journal");
+    config_.journal.segment_size_mb = getInt("journal", "segment_size_mb", 64);
+}
+
 std::string ConfigManager::getString(const std::string& section, const std::string& key, 
                                    const std::string& default_value) const {
     auto section_it = raw_config_.find(section);
@@ -293,6 +331,17 @@ MarketDataType ConfigManager::stringToDataType(const std::string& data_type) con
     return MarketDataType::TICK; // 默认类型
 }
 
+BackpressurePolicy ConfigManager::stringToBackpressurePolicy(const std::string& policy) const {
+    std::string lower_policy = policy;
+    std::transform(lower_policy.begin(), lower_policy.end(), lower_policy.begin(), ::tolower);
+    
+    if (lower_policy == "drop_oldest") return BackpressurePolicy::DROP_OLDEST;
+    if (lower_policy == "block") return BackpressurePolicy::BLOCK;
+    if (lower_policy == "spill") return BackpressurePolicy::SPILL;
+    
+    return BackpressurePolicy::DROP_OLDEST; // 默认策略
+}
+
 std::vector<std::string> ConfigManager::splitString(const std::string& str, char delimiter) const {
     std::vector<std::string> result;
     std::stringstream ss(str);
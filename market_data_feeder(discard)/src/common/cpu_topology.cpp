@@ -0,0 +1,366 @@
+#include "common/cpu_topology.h"
+#include "common/logger.h"
+#include <sched.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+namespace market_feeder
+{
+
+    namespace
+    {
+        // <numaif.h> 属于 libnuma，这里只需要两个常量
+        constexpr int kMpolPreferred = 1;
+        constexpr int kMaxNodes = 1024;
+
+        bool readFirstLine(const std::string &path, std::string &line)
+        {
+            std::ifstream file(path);
+            return file && std::getline(file, line);
+        }
+
+        int readInt(const std::string &path, int default_value)
+        {
+            std::string line;
+            if (!readFirstLine(path, line))
+            {
+                return default_value;
+            }
+            try
+            {
+                return std::stoi(line);
+            }
+            catch (const std::exception &)
+            {
+                return default_value;
+            }
+        }
+
+        std::vector<unsigned long> nodeMask(int node)
+        {
+            const size_t bits = sizeof(unsigned long) * 8;
+            std::vector<unsigned long> mask(kMaxNodes / bits, 0);
+            mask[static_cast<size_t>(node) / bits] |= 1UL << (static_cast<size_t>(node) % bits);
+            return mask;
+        }
+
+        // 按工作进程取用的列表，第 index 个工作进程取第 index 个（循环）
+        std::vector<int> pick(const std::vector<int> &list, size_t index)
+        {
+            return std::vector<int>{list[index % list.size()]};
+        }
+    } // namespace
+
+    const std::vector<int> &AffinityPlan::cpusFor(ThreadRole role) const
+    {
+        switch (role)
+        {
+        case ThreadRole::RECEIVE:
+            return receive;
+        case ThreadRole::PROCESSOR:
+            return processor;
+        case ThreadRole::WRITER:
+            return writer;
+        case ThreadRole::HOUSEKEEPING:
+        default:
+            return housekeeping;
+        }
+    }
+
+    bool CpuTopology::discover()
+    {
+        cpus_.clear();
+        node_count_ = 1;
+
+        std::string online;
+        std::vector<int> ids;
+        if (readFirstLine("/sys/devices/system/cpu/online", online))
+        {
+            ids = parseCpuList(online);
+        }
+        if (ids.empty())
+        {
+            long count = std::max(1L, sysconf(_SC_NPROCESSORS_ONLN));
+            for (int i = 0; i < count; ++i)
+            {
+                ids.push_back(i);
+            }
+        }
+
+        std::map<int, int> node_of_cpu;
+        std::string nodes_online;
+        if (readFirstLine("/sys/devices/system/node/online", nodes_online))
+        {
+            std::vector<int> nodes = parseCpuList(nodes_online);
+            for (int node : nodes)
+            {
+                std::string cpulist;
+                if (readFirstLine("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist", cpulist))
+                {
+                    for (int cpu : parseCpuList(cpulist))
+                    {
+                        node_of_cpu[cpu] = node;
+                    }
+                }
+            }
+            if (!nodes.empty())
+            {
+                node_count_ = *std::max_element(nodes.begin(), nodes.end()) + 1;
+            }
+        }
+
+        bool complete = true;
+        for (int id : ids)
+        {
+            std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(id) + "/topology/";
+            Cpu cpu;
+            cpu.id = id;
+            cpu.node = node_of_cpu.count(id) ? node_of_cpu[id] : 0;
+            cpu.package = readInt(base + "physical_package_id", 0);
+            cpu.core = readInt(base + "core_id", -1);
+            if (cpu.core < 0)
+            {
+                // 没有拓扑信息时每个 CPU 视为独立的物理核
+                cpu.core = id;
+                complete = false;
+            }
+            cpus_.push_back(cpu);
+        }
+        return complete && !node_of_cpu.empty();
+    }
+
+    std::vector<std::vector<int>> CpuTopology::nodeCores(int node) const
+    {
+        std::map<std::pair<int, int>, std::vector<int>> cores;
+        for (const auto &cpu : cpus_)
+        {
+            if (cpu.node == node)
+            {
+                cores[{cpu.package, cpu.core}].push_back(cpu.id);
+            }
+        }
+
+        std::vector<std::vector<int>> result;
+        for (auto &entry : cores)
+        {
+            std::sort(entry.second.begin(), entry.second.end());
+            result.push_back(std::move(entry.second));
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    AffinityPlan CpuTopology::planWorker(const AffinityOptions &options, int worker_id) const
+    {
+        AffinityPlan plan;
+        size_t slot = static_cast<size_t>(std::max(worker_id - 1, 0));
+
+        plan.node = options.numa_node;
+        if (plan.node < 0 && !options.nic_interface.empty())
+        {
+            plan.node = nicNode(options.nic_interface);
+        }
+        if (plan.node < 0 || plan.node >= node_count_)
+        {
+            plan.node = static_cast<int>(slot % static_cast<size_t>(std::max(node_count_, 1)));
+        }
+
+        std::vector<std::vector<int>> cores = nodeCores(plan.node);
+        if (cores.empty())
+        {
+            // 节点上没有在线 CPU，改用所有 CPU
+            for (const auto &cpu : cpus_)
+            {
+                cores.push_back({cpu.id});
+            }
+            plan.node = -1;
+        }
+
+        // 第一个物理核给写库和辅助线程共用，其余作为独占核分给各工作进程
+        std::vector<int> shared = parseCpuList(options.housekeeping_cpus);
+        plan.housekeeping = shared.empty() ? cores.front() : shared;
+        std::vector<int> writers = parseCpuList(options.writer_cpus);
+        plan.writer = writers.empty() ? plan.housekeeping : writers;
+
+        std::vector<std::vector<int>> dedicated(cores.size() > 1 ? cores.begin() + 1 : cores.begin(), cores.end());
+        size_t needed;
+        if (dedicated.front().size() >= 2)
+        {
+            // 同一物理核的两个超线程
+            const std::vector<int> &core = dedicated[slot % dedicated.size()];
+            plan.receive = {core[0]};
+            plan.processor = {core[1]};
+            needed = slot + 1;
+        }
+        else
+        {
+            plan.receive = {dedicated[(2 * slot) % dedicated.size()][0]};
+            plan.processor = {dedicated[(2 * slot + 1) % dedicated.size()][0]};
+            needed = 2 * slot + 2;
+        }
+        plan.oversubscribed = needed > dedicated.size();
+
+        std::vector<int> receive = parseCpuList(options.receive_cpus);
+        if (!receive.empty())
+        {
+            plan.receive = pick(receive, slot);
+        }
+        std::vector<int> processor = parseCpuList(options.processor_cpus);
+        if (!processor.empty())
+        {
+            plan.processor = pick(processor, slot);
+        }
+        return plan;
+    }
+
+    std::string CpuTopology::describe() const
+    {
+        std::ostringstream out;
+        out << cpus_.size() << " cpus, " << node_count_ << " numa nodes";
+        for (int node = 0; node < node_count_; ++node)
+        {
+            std::vector<std::vector<int>> cores = nodeCores(node);
+            if (cores.empty())
+            {
+                continue;
+            }
+            std::vector<int> ids;
+            for (const auto &core : cores)
+            {
+                ids.insert(ids.end(), core.begin(), core.end());
+            }
+            std::sort(ids.begin(), ids.end());
+            out << "; node " << node << ": cpus " << formatCpuList(ids) << " (" << cores.size() << " cores)";
+        }
+        return out.str();
+    }
+
+    int CpuTopology::nicNode(const std::string &interface)
+    {
+        // 虚拟网卡没有 device 目录；单节点机器上内核报告 -1
+        return readInt("/sys/class/net/" + interface + "/device/numa_node", -1);
+    }
+
+    std::vector<int> CpuTopology::parseCpuList(const std::string &list)
+    {
+        std::vector<int> cpus;
+        std::stringstream ss(list);
+        std::string item;
+        while (std::getline(ss, item, ','))
+        {
+            item.erase(0, item.find_first_not_of(" \t"));
+            item.erase(item.find_last_not_of(" \t\n") + 1);
+            if (item.empty())
+            {
+                continue;
+            }
+            try
+            {
+                size_t dash = item.find('-');
+                int first = std::stoi(item.substr(0, dash));
+                int last = dash == std::string::npos ? first : std::stoi(item.substr(dash + 1));
+                for (int cpu = first; cpu <= last; ++cpu)
+                {
+                    cpus.push_back(cpu);
+                }
+            }
+            catch (const std::exception &)
+            {
+                LOG_WARN("Ignoring invalid cpu list entry '{}'", item);
+            }
+        }
+        return cpus;
+    }
+
+    std::string CpuTopology::formatCpuList(const std::vector<int> &cpus)
+    {
+        std::vector<int> sorted(cpus);
+        std::sort(sorted.begin(), sorted.end());
+        sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+        std::string result;
+        for (size_t i = 0; i < sorted.size();)
+        {
+            size_t j = i;
+            while (j + 1 < sorted.size() && sorted[j + 1] == sorted[j] + 1)
+            {
+                ++j;
+            }
+            if (!result.empty())
+            {
+                result += ',';
+            }
+            result += std::to_string(sorted[i]);
+            if (j > i)
+            {
+                result += '-' + std::to_string(sorted[j]);
+            }
+            i = j + 1;
+        }
+        return result;
+    }
+
+    bool CpuTopology::pinCurrentThread(const std::vector<int> &cpus)
+    {
+        if (cpus.empty())
+        {
+            return false;
+        }
+
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        for (int cpu : cpus)
+        {
+            if (cpu >= 0 && cpu < CPU_SETSIZE)
+            {
+                CPU_SET(cpu, &cpuset);
+            }
+        }
+
+        int error = pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+        if (error != 0)
+        {
+            LOG_WARN("Failed to pin thread to cpus {}: {}", formatCpuList(cpus), strerror(error));
+            return false;
+        }
+        return true;
+    }
+
+    bool CpuTopology::preferNode(int node)
+    {
+        if (node < 0 || node >= kMaxNodes)
+        {
+            return false;
+        }
+        std::vector<unsigned long> mask = nodeMask(node);
+        if (syscall(SYS_set_mempolicy, kMpolPreferred, mask.data(), kMaxNodes + 1) < 0)
+        {
+            LOG_WARN("set_mempolicy(node {}) failed: {}", node, strerror(errno));
+            return false;
+        }
+        return true;
+    }
+
+    bool CpuTopology::bindMemory(void *addr, size_t length, int node)
+    {
+        if (node < 0 || node >= kMaxNodes || !addr || length == 0)
+        {
+            return false;
+        }
+        std::vector<unsigned long> mask = nodeMask(node);
+        if (syscall(SYS_mbind, addr, length, kMpolPreferred, mask.data(), kMaxNodes + 1, 0) < 0)
+        {
+            LOG_WARN("mbind({} bytes, node {}) failed: {}", length, node, strerror(errno));
+            return false;
+        }
+        return true;
+    }
+
+} // namespace market_feeder
@@ -8,6 +8,9 @@
 #include <cstring>
 #include <signal.h>
 #include <sys/wait.h>
+#include <new>
+#include <algorithm>
+#include <chrono>
 
 namespace market_feeder
 {
@@ -23,10 +26,11 @@ namespace market_feeder
         cleanup();
     }
 
-    bool IPCManager::initialize(ProcessType process_type)
+    bool IPCManager::initialize(ProcessType process_type, int worker_id)
     {
         process_type_ = process_type;
         is_master_ = (process_type == ProcessType::MASTER);
+        worker_id_ = worker_id;
 
         if (is_master_)
         {
@@ -56,13 +60,6 @@ namespace market_feeder
             return false;
         }
 
-        // 创建信号量
-        if (!createSemaphores())
-        {
-            LOG_ERROR("Failed to create semaphores");
-            return false;
-        }
-
         // 初始化共享内存数据
         initializeSharedData();
 
@@ -93,13 +90,6 @@ namespace market_feeder
             return false;
         }
 
-        // 连接到现有的信号量
-        if (!connectSemaphores())
-        {
-            LOG_ERROR("Failed to connect to semaphores");
-            return false;
-        }
-
         // 设置信号处理
         setupSignalHandlers();
 
@@ -138,11 +128,10 @@ namespace market_feeder
                 LOG_ERROR("Failed to create message queue: {}", strerror(errno));
                 return false;
             }
-            // }
-
-            LOG_DEBUG("Message queue created with ID: {}", msg_queue_id_);
-            return true;
         }
+
+        LOG_DEBUG("Message queue created with ID: {}", msg_queue_id_);
+        return true;
     }
 
     bool IPCManager::connectMessageQueue()
@@ -198,12 +187,13 @@ namespace market_feeder
         }
 
         // 映射共享内存
-        // shared_data_ = static_cast<SharedMemoryData*>(shmat(shm_id_, nullptr, 0));
-        if (shared_data_ == reinterpret_cast<SharedMemoryData *>(-1))
+        void *memory = shmat(shm_id_, nullptr, 0);
+        if (memory == reinterpret_cast<void *>(-1))
         {
             LOG_ERROR("Failed to attach shared memory: {}", strerror(errno));
             return false;
         }
+        shared_memory_ = static_cast<SharedMemoryData *>(memory);
 
         LOG_DEBUG("Shared memory created with ID: {}, size: {} bytes", shm_id_, shm_size);
         return true;
@@ -226,109 +216,37 @@ namespace market_feeder
         }
 
         // 映射共享内存
-        // shared_data_ = static_cast<SharedMemoryData*>(shmat(shm_id_, nullptr, 0));
-        if (shared_data_ == reinterpret_cast<SharedMemoryData *>(-1))
+        void *memory = shmat(shm_id_, nullptr, 0);
+        if (memory == reinterpret_cast<void *>(-1))
         {
             LOG_ERROR("Failed to attach shared memory: {}", strerror(errno));
             return false;
         }
+        shared_memory_ = static_cast<SharedMemoryData *>(memory);
 
         LOG_DEBUG("Connected to shared memory with ID: {}", shm_id_);
         return true;
     }
 
-    bool IPCManager::createSemaphores()
-    {
-        // 创建信号量集
-        key_t key = ftok(constants::IPC_KEY_FILE.c_str(), constants::SEM_ID);
-        if (key == -1)
-        {
-            LOG_ERROR("Failed to generate key for semaphores: {}", strerror(errno));
-            return false;
-        }
-
-        sem_id_ = semget(key, constants::SEM_COUNT, IPC_CREAT | IPC_EXCL | 0666);
-        if (sem_id_ == -1)
-        {
-            if (errno == EEXIST)
-            {
-                // 信号量已存在，删除后重新创建
-                sem_id_ = semget(key, constants::SEM_COUNT, 0666);
-                if (sem_id_ != -1)
-                {
-                    semctl(sem_id_, 0, IPC_RMID);
-                }
-                sem_id_ = semget(key, constants::SEM_COUNT, IPC_CREAT | 0666);
-            }
-
-            if (sem_id_ == -1)
-            {
-                LOG_ERROR("Failed to create semaphores: {}", strerror(errno));
-                return false;
-            }
-        }
-
-        // 初始化信号量值
-        union semun
-        {
-            int val;
-            struct semid_ds *buf;
-            unsigned short *array;
-        } sem_union;
-
-        // 初始化互斥信号量为1
-        sem_union.val = 1;
-        for (int i = 0; i < constants::SEM_COUNT; ++i)
-        {
-            if (semctl(sem_id_, i, SETVAL, sem_union) == -1)
-            {
-                LOG_ERROR("Failed to initialize semaphore {}: {}", i, strerror(errno));
-                return false;
-            }
-        }
-
-        LOG_DEBUG("Semaphores created with ID: {}, count: {}", sem_id_, constants::SEM_COUNT);
-        return true;
-    }
-
-    bool IPCManager::connectSemaphores()
-    {
-        key_t key = ftok(constants::IPC_KEY_FILE.c_str(), constants::SEM_ID);
-        if (key == -1)
-        {
-            LOG_ERROR("Failed to generate key for semaphores: {}", strerror(errno));
-            return false;
-        }
-
-        sem_id_ = semget(key, constants::SEM_COUNT, 0666);
-        if (sem_id_ == -1)
-        {
-            LOG_ERROR("Failed to connect to semaphores: {}", strerror(errno));
-            return false;
-        }
-
-        LOG_DEBUG("Connected to semaphores with ID: {}", sem_id_);
-        return true;
-    }
-
     void IPCManager::initializeSharedData()
     {
-        if (!shared_data_)
+        if (!shared_memory_)
         {
             return;
         }
 
-        // 初始化共享内存数据
-        memset(shared_data_, 0, sizeof(SharedMemoryData));
-        shared_data_->master_pid = getpid();
-        shared_data_->start_time = time(nullptr);
-        shared_data_->shutdown_flag = false;
-        shared_data_->reload_flag = false;
-        shared_data_->worker_count = 0;
+        // 共享内存中全是原子量，在映射地址上原地构造
+        new (shared_memory_) SharedMemoryData();
+        shared_memory_->master_pid = getpid();
 
         LOG_DEBUG("Shared memory data initialized");
     }
 
+    SharedMemoryData *IPCManager::getSharedMemory()
+    {
+        return shared_memory_;
+    }
+
     void IPCManager::setupSignalHandlers()
     {
         // 忽略SIGPIPE信号
@@ -338,24 +256,27 @@ namespace market_feeder
         // 注意：在实际应用中，应该使用signalfd或其他现代信号处理方式
     }
 
-    bool IPCManager::sendMessage(const IPCMessage &message)
+    bool IPCManager::sendMessage(const IPCMessage &message, pid_t target_pid)
     {
-        if (!initialized_ || msg_queue_id_ == -1)
+        if (message.ipc_type == IPCMessageType::MARKET_DATA)
         {
-            LOG_ERROR("IPC manager not initialized or message queue not available");
+            LOG_WARN("Market data is not carried over the control queue");
             return false;
         }
 
-        struct
+        if (!initialized_ || msg_queue_id_ == -1)
         {
-            long mtype;
-            IPCMessage msg;
-        } msg_buf;
+            LOG_ERROR("IPC manager not initialized or message queue not available");
+            return false;
+        }
 
-        msg_buf.mtype = static_cast<long>(message.type);
-        msg_buf.msg = message;
+        // IPCMessage 以 long msg_type 开头，可直接作为 msgbuf；只发送已使用的 data 部分
+        IPCMessage msg_buf = message;
+        msg_buf.msg_type = static_cast<long>(message.ipc_type);
+        size_t data_size = std::min(message.data_size, sizeof(message.data));
+        size_t msg_size = offsetof(IPCMessage, data) - sizeof(long) + data_size;
 
-        if (msgsnd(msg_queue_id_, &msg_buf, sizeof(IPCMessage), IPC_NOWAIT) == -1)
+        if (msgsnd(msg_queue_id_, &msg_buf, msg_size, IPC_NOWAIT) == -1)
         {
             if (errno != EAGAIN)
             {
@@ -365,11 +286,11 @@ namespace market_feeder
         }
 
         LOG_TRACE("Message sent: type={}, from={}, to={}",
-                  static_cast<int>(message.type), message.sender_pid, message.receiver_pid);
+                  static_cast<int>(message.ipc_type), message.sender_pid, target_pid);
         return true;
     }
 
-    bool IPCManager::receiveMessage(IPCMessage &message, int type, bool blocking)
+    bool IPCManager::receiveMessage(IPCMessage &message, IPCMessageType type, bool blocking)
     {
         if (!initialized_ || msg_queue_id_ == -1)
         {
@@ -377,16 +298,10 @@ namespace market_feeder
             return false;
         }
 
-        struct
-        {
-            long mtype;
-            IPCMessage msg;
-        } msg_buf;
-
         int flags = blocking ? 0 : IPC_NOWAIT;
-        long msg_type = (type == MessageType::ANY) ? 0 : static_cast<long>(type);
+        size_t max_size = sizeof(IPCMessage) - sizeof(long);
 
-        ssize_t result = msgrcv(msg_queue_id_, &msg_buf, sizeof(IPCMessage), msg_type, flags);
+        ssize_t result = msgrcv(msg_queue_id_, &message, max_size, static_cast<long>(type), flags);
         if (result == -1)
         {
             if (errno != ENOMSG && errno != EAGAIN)
@@ -396,213 +311,285 @@ namespace market_feeder
             return false;
         }
 
-        message = msg_buf.msg;
-        LOG_TRACE("Message received: type={}, from={}, to={}",
-                  static_cast<int>(message.type), message.sender_pid, message.receiver_pid);
+        LOG_TRACE("Message received: type={}, from={}",
+                  static_cast<int>(message.ipc_type), message.sender_pid);
         return true;
     }
 
-    bool IPCManager::lockSharedMemory(int sem_index)
+    namespace
     {
-        if (!initialized_ || sem_id_ == -1)
+        int64_t nowNanoseconds()
         {
-            return false;
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                .count();
         }
+    } // namespace
 
-        struct sembuf sem_op;
-        sem_op.sem_num = sem_index;
-        sem_op.sem_op = -1; // P操作（减1）
-        sem_op.sem_flg = SEM_UNDO;
-
-        if (semop(sem_id_, &sem_op, 1) == -1)
+    WorkerSlot *IPCManager::findWorkerSlot(pid_t pid)
+    {
+        if (!shared_memory_ || pid <= 0)
         {
-            LOG_ERROR("Failed to lock semaphore {}: {}", sem_index, strerror(errno));
-            return false;
+            return nullptr;
         }
 
-        return true;
+        // 槽位的 pid 只在 add / remove 时变化，这里读到的旧值最多导致一次查找失败
+        for (WorkerSlot &slot : shared_memory_->workers)
+        {
+            if (slot.in_use.load(std::memory_order_acquire) && slot.pid.load(std::memory_order_relaxed) == pid)
+            {
+                return &slot;
+            }
+        }
+        return nullptr;
     }
 
-    bool IPCManager::unlockSharedMemory(int sem_index)
+    WorkerSlot *IPCManager::workerSlot(int worker_id)
     {
-        if (!initialized_ || sem_id_ == -1)
+        // worker_id 从 1 开始，与数据通道一致
+        if (!shared_memory_ || worker_id < 1 || worker_id > constants::MAX_WORKER_PROCESSES)
         {
-            return false;
+            return nullptr;
         }
+        return &shared_memory_->workers[worker_id - 1];
+    }
 
-        struct sembuf sem_op;
-        sem_op.sem_num = sem_index;
-        sem_op.sem_op = 1; // V操作（加1）
-        sem_op.sem_flg = SEM_UNDO;
-
-        if (semop(sem_id_, &sem_op, 1) == -1)
+    bool IPCManager::addWorkerProcess(pid_t pid, int worker_id)
+    {
+        WorkerSlot *found = workerSlot(worker_id);
+        if (!found)
         {
-            LOG_ERROR("Failed to unlock semaphore {}: {}", sem_index, strerror(errno));
             return false;
         }
 
+        // 槽位由 worker_id 决定，重启的工作进程复用原槽位
+        WorkerSlot &slot = *found;
+        int64_t now = nowNanoseconds();
+        slot.beginWrite();
+        slot.pid.store(pid, std::memory_order_relaxed);
+        slot.worker_id.store(worker_id, std::memory_order_relaxed);
+        slot.status.store(static_cast<int32_t>(ProcessStatus::STARTING), std::memory_order_relaxed);
+        slot.start_time_ns.store(now, std::memory_order_relaxed);
+        slot.last_heartbeat_ns.store(now, std::memory_order_relaxed);
+        slot.processed_count.store(0, std::memory_order_relaxed);
+        slot.error_count.store(0, std::memory_order_relaxed);
+        slot.received_count.store(0, std::memory_order_relaxed);
+        slot.owned_keys.store(0, std::memory_order_relaxed);
+        slot.in_use.store(1, std::memory_order_release);
+        slot.endWrite();
+
+        LOG_INFO("Worker process added: pid={}, worker_id={}", pid, worker_id);
         return true;
     }
 
-    bool IPCManager::addWorkerProcess(pid_t pid, int worker_id)
+    bool IPCManager::removeWorkerProcess(pid_t pid)
     {
-        if (!lockSharedMemory(constants::SEM_WORKER_LIST))
+        WorkerSlot *slot = findWorkerSlot(pid);
+        if (!slot)
         {
             return false;
         }
 
-        bool success = false;
-        if (shared_data_ && shared_data_->worker_count < constants::MAX_WORKER_PROCESSES)
-        {
-            ProcessInfo &info = shared_data_->workers[shared_data_->worker_count];
-            info.pid = pid;
-            info.worker_id = worker_id;
-            info.status = ProcessStatus::STARTING;
-            info.start_time = time(nullptr);
-            info.last_heartbeat = time(nullptr);
+        slot->beginWrite();
+        slot->in_use.store(0, std::memory_order_relaxed);
+        slot->status.store(static_cast<int32_t>(ProcessStatus::STOPPED), std::memory_order_relaxed);
+        slot->pid.store(0, std::memory_order_relaxed);
+        slot->endWrite();
 
-            shared_data_->worker_count++;
-            success = true;
+        LOG_INFO("Worker process removed: pid={}", pid);
+        return true;
+    }
 
-            LOG_INFO("Worker process added: pid={}, worker_id={}", pid, worker_id);
+    bool IPCManager::updateProcessStatus(pid_t pid, ProcessStatus status)
+    {
+        WorkerSlot *slot = findWorkerSlot(pid);
+        if (!slot)
+        {
+            return false;
         }
 
-        unlockSharedMemory(constants::SEM_WORKER_LIST);
-        return success;
+        // status 单独一个原子量即可保证读方不撕裂，但与 pid 一起需要一致的快照
+        slot->beginWrite();
+        slot->status.store(static_cast<int32_t>(status), std::memory_order_relaxed);
+        slot->endWrite();
+        slot->touch(nowNanoseconds());
+        return true;
     }
 
-    bool IPCManager::removeWorkerProcess(pid_t pid)
+    bool IPCManager::updateProcessHeartbeat(pid_t pid)
     {
-        if (!lockSharedMemory(constants::SEM_WORKER_LIST))
+        WorkerSlot *slot = findWorkerSlot(pid);
+        if (!slot)
         {
             return false;
         }
+        slot->touch(nowNanoseconds());
+        return true;
+    }
 
-        bool success = false;
-        if (shared_data_)
+    bool IPCManager::updateWorkerCounters(int worker_id, uint64_t processed_count, uint64_t error_count,
+                                          uint64_t received_count)
+    {
+        WorkerSlot *slot = workerSlot(worker_id);
+        if (!slot)
         {
-            for (int i = 0; i < shared_data_->worker_count; ++i)
-            {
-                if (shared_data_->workers[i].pid == pid)
-                {
-                    // 移动后面的元素
-                    for (int j = i; j < shared_data_->worker_count - 1; ++j)
-                    {
-                        shared_data_->workers[j] = shared_data_->workers[j + 1];
-                    }
-                    shared_data_->worker_count--;
-                    success = true;
-
-                    LOG_INFO("Worker process removed: pid={}", pid);
-                    break;
-                }
-            }
+            return false;
         }
 
-        unlockSharedMemory(constants::SEM_WORKER_LIST);
-        return success;
+        slot->processed_count.store(processed_count, std::memory_order_relaxed);
+        slot->error_count.store(error_count, std::memory_order_relaxed);
+        slot->received_count.store(received_count, std::memory_order_relaxed);
+        slot->touch(nowNanoseconds());
+        return true;
     }
 
-    bool IPCManager::updateProcessStatus(pid_t pid, ProcessStatus status)
+    void IPCManager::publishShardMembers(uint64_t members)
     {
-        if (!lockSharedMemory(constants::SEM_WORKER_LIST))
+        if (!shared_memory_)
         {
-            return false;
+            return;
+        }
+        shared_memory_->shard_members.store(members, std::memory_order_relaxed);
+        shared_memory_->shard_generation.fetch_add(1, std::memory_order_release);
+    }
+
+    uint64_t IPCManager::getShardMembers(uint64_t &generation)
+    {
+        if (!shared_memory_)
+        {
+            generation = 0;
+            return 0;
         }
 
-        bool success = false;
-        if (shared_data_)
+        // 只有主进程写，读到前后一致的代数即得到与之对应的位图
+        for (;;)
         {
-            for (int i = 0; i < shared_data_->worker_count; ++i)
+            uint64_t begin = shared_memory_->shard_generation.load(std::memory_order_acquire);
+            uint64_t members = shared_memory_->shard_members.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (shared_memory_->shard_generation.load(std::memory_order_relaxed) == begin)
             {
-                if (shared_data_->workers[i].pid == pid)
-                {
-                    shared_data_->workers[i].status = status;
-                    shared_data_->workers[i].last_heartbeat = time(nullptr);
-                    success = true;
-                    break;
-                }
+                generation = begin;
+                return members;
             }
         }
+    }
 
-        unlockSharedMemory(constants::SEM_WORKER_LIST);
-        return success;
+    uint64_t IPCManager::getShardGeneration()
+    {
+        return shared_memory_ ? shared_memory_->shard_generation.load(std::memory_order_acquire) : 0;
     }
 
-    bool IPCManager::updateStatistics(const Statistics &stats)
+    bool IPCManager::updateWorkerShard(int worker_id, uint32_t owned_keys)
     {
-        if (!lockSharedMemory(constants::SEM_STATISTICS))
+        WorkerSlot *slot = workerSlot(worker_id);
+        if (!slot)
         {
             return false;
         }
+        slot->owned_keys.store(owned_keys, std::memory_order_relaxed);
+        return true;
+    }
 
-        if (shared_data_)
+    bool IPCManager::updateStatistics(const Statistics &stats)
+    {
+        if (!shared_memory_)
         {
-            shared_data_->stats = stats;
-            shared_data_->stats.last_update = time(nullptr);
+            return false;
         }
 
-        unlockSharedMemory(constants::SEM_STATISTICS);
+        // 只有主进程写全局统计，单写方的 seqlock 不需要 CAS
+        GlobalStatsSlot &slot = shared_memory_->global_stats;
+        slot.sequence.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.total_processed.store(stats.total_processed, std::memory_order_relaxed);
+        slot.total_errors.store(stats.total_errors, std::memory_order_relaxed);
+        slot.current_connections.store(stats.current_connections, std::memory_order_relaxed);
+        slot.cpu_usage.store(stats.cpu_usage, std::memory_order_relaxed);
+        slot.memory_usage.store(stats.memory_usage, std::memory_order_relaxed);
+        slot.last_update_ns.store(nowNanoseconds(), std::memory_order_relaxed);
+        slot.sequence.fetch_add(1, std::memory_order_release);
         return true;
     }
 
-    Statistics IPCManager::getStatistics()
+    Statistics IPCManager::getGlobalStatistics()
     {
-        Statistics stats = {};
+        Statistics stats;
+        if (!shared_memory_)
+        {
+            return stats;
+        }
 
-        if (lockSharedMemory(constants::SEM_STATISTICS))
+        const GlobalStatsSlot &slot = shared_memory_->global_stats;
+        for (;;)
         {
-            if (shared_data_)
+            uint32_t begin = slot.sequence.load(std::memory_order_acquire);
+            if (begin & 1u)
             {
-                stats = shared_data_->stats;
+                continue;
+            }
+            stats.total_processed = slot.total_processed.load(std::memory_order_relaxed);
+            stats.total_errors = slot.total_errors.load(std::memory_order_relaxed);
+            stats.current_connections = slot.current_connections.load(std::memory_order_relaxed);
+            stats.cpu_usage = slot.cpu_usage.load(std::memory_order_relaxed);
+            stats.memory_usage = slot.memory_usage.load(std::memory_order_relaxed);
+            int64_t last_update_ns = slot.last_update_ns.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == begin)
+            {
+                stats.last_update = std::chrono::system_clock::time_point(
+                    std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                        std::chrono::nanoseconds(last_update_ns)));
+                return stats;
             }
-            unlockSharedMemory(constants::SEM_STATISTICS);
         }
-
-        return stats;
     }
 
     std::vector<ProcessInfo> IPCManager::getAllProcesses()
     {
         std::vector<ProcessInfo> workers;
+        if (!shared_memory_)
+        {
+            return workers;
+        }
 
-        if (lockSharedMemory(constants::SEM_WORKER_LIST))
+        // 每个槽位独立地 seqlock 读取，不阻塞任何工作进程
+        for (const WorkerSlot &slot : shared_memory_->workers)
         {
-            if (shared_data_)
+            ProcessInfo info;
+            int worker_id = -1;
+            if (slot.snapshot(info, worker_id))
             {
-                for (int i = 0; i < shared_data_->worker_count; ++i)
-                {
-                    workers.push_back(shared_data_->workers[i]);
-                }
+                workers.push_back(info);
             }
-            unlockSharedMemory(constants::SEM_WORKER_LIST);
         }
-
         return workers;
     }
 
     void IPCManager::setShutdownFlag(bool flag)
     {
-        // if (shared_data_) {
-        // shared_data_->shutdown_flag = flag;
-        // }
+        if (shared_memory_)
+        {
+            shared_memory_->shutdown_flag.store(flag, std::memory_order_release);
+        }
     }
 
     bool IPCManager::getShutdownFlag()
     {
-        return false; // shared_data_ ? shared_data_->shutdown_flag : false;
+        return shared_memory_ ? shared_memory_->shutdown_flag.load(std::memory_order_acquire) : false;
     }
 
-    void IPCManager::setReloadFlag(bool flag)
+    void IPCManager::setReloadConfigFlag(bool flag)
     {
-        // if (shared_data_) {
-        // shared_data_->reload_flag = flag;
-        // }
+        if (shared_memory_)
+        {
+            shared_memory_->reload_config_flag.store(flag, std::memory_order_release);
+        }
     }
 
-    bool IPCManager::getReloadFlag()
+    bool IPCManager::getReloadConfigFlag()
     {
-        return false; // shared_data_ ? shared_data_->reload_flag : false;
+        return shared_memory_ ? shared_memory_->reload_config_flag.load(std::memory_order_acquire) : false;
     }
 
     void IPCManager::cleanup()
@@ -615,10 +602,10 @@ namespace market_feeder
         LOG_INFO("Cleaning up IPC resources...");
 
         // 分离共享内存
-        if (shared_data_ && shared_data_ != reinterpret_cast<SharedMemoryData *>(-1))
+        if (shared_memory_)
         {
-            // shmdt(shared_data_);
-            shared_data_ = nullptr;
+            shmdt(shared_memory_);
+            shared_memory_ = nullptr;
         }
 
         // 如果是主进程，删除IPC资源
@@ -635,19 +622,11 @@ namespace market_feeder
             LOG_DEBUG("Shared memory removed");
         }
 
-        if (sem_id_ != -1)
-        {
-            semctl(sem_id_, 0, IPC_RMID);
-            LOG_DEBUG("Semaphores removed");
-        }
-    }
-
-    msg_queue_id_ = -1;
-    shm_id_ = -1;
-    sem_id_ = -1;
-    initialized_ = false;
+        msg_queue_id_ = -1;
+        shm_id_ = -1;
+        initialized_ = false;
 
-    LOG_INFO("IPC cleanup completed");
-}
+        LOG_INFO("IPC cleanup completed");
+    }
 
 } // namespace market_feeder
\ No newline at end of file
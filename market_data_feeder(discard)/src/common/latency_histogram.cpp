@@ -0,0 +1,201 @@
+#include "common/latency_histogram.h"
+#include "common/logger.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+
+namespace market_feeder
+{
+
+    std::atomic<bool> TscClock::use_tsc_{false};
+    std::atomic<double> TscClock::ns_per_tick_{1.0};
+
+    namespace
+    {
+        const char *const kSiteNames[kLatencySiteCount] = {
+            "on_market_data",
+            "flush_data_buffer",
+            "process_batch",
+            "tick_exchange_to_receive",
+            "tick_receive_to_enqueue",
+            "tick_enqueue_to_seal",
+            "tick_seal_to_commit",
+            "tick_receive_to_commit",
+            "tick_exchange_to_commit",
+            "writer_commit",
+            "writer_queue_depth",
+        };
+
+        bool hasInvariantTsc()
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            std::ifstream cpuinfo("/proc/cpuinfo");
+            std::string line;
+            while (std::getline(cpuinfo, line))
+            {
+                if (line.compare(0, 5, "flags") == 0)
+                {
+                    return line.find(" constant_tsc") != std::string::npos &&
+                           line.find(" nonstop_tsc") != std::string::npos;
+                }
+            }
+#endif
+            return false;
+        }
+
+        // 按累计计数中的名次找桶，rank 从 1 开始
+        uint64_t percentileOf(const std::vector<uint64_t> &counts, uint64_t total, double quantile)
+        {
+            uint64_t rank = static_cast<uint64_t>(quantile * static_cast<double>(total - 1)) + 1;
+            uint64_t seen = 0;
+            for (size_t i = 0; i < counts.size(); ++i)
+            {
+                seen += counts[i];
+                if (seen >= rank)
+                {
+                    return LatencyHistogram::bucketUpperBound(i);
+                }
+            }
+            return LatencyHistogram::bucketUpperBound(counts.size() - 1);
+        }
+    } // namespace
+
+    const char *latencySiteName(LatencySite site)
+    {
+        size_t index = static_cast<size_t>(site);
+        return index < kLatencySiteCount ? kSiteNames[index] : "unknown";
+    }
+
+    const char *latencySiteUnit(LatencySite site)
+    {
+        return site == LatencySite::WRITER_QUEUE_DEPTH ? "" : "ns";
+    }
+
+    void TscClock::calibrate(std::chrono::milliseconds duration)
+    {
+        if (!hasInvariantTsc())
+        {
+            use_tsc_.store(false, std::memory_order_relaxed);
+            ns_per_tick_.store(1.0, std::memory_order_relaxed);
+            LOG_INFO("Invariant TSC not available, latency timers use steady_clock");
+            return;
+        }
+
+#if defined(__x86_64__) || defined(__i386__)
+        auto wall_start = std::chrono::steady_clock::now();
+        uint64_t tsc_start = __rdtsc();
+        std::this_thread::sleep_for(duration);
+        uint64_t tsc_end = __rdtsc();
+        auto wall_end = std::chrono::steady_clock::now();
+
+        double elapsed_ns = static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(wall_end - wall_start).count());
+        if (tsc_end <= tsc_start || elapsed_ns <= 0)
+        {
+            LOG_WARN("TSC calibration failed, latency timers use steady_clock");
+            return;
+        }
+
+        ns_per_tick_.store(elapsed_ns / static_cast<double>(tsc_end - tsc_start), std::memory_order_relaxed);
+        use_tsc_.store(true, std::memory_order_relaxed);
+        LOG_INFO("TSC calibrated: {:.3f} GHz", 1.0 / ns_per_tick_.load(std::memory_order_relaxed));
+#endif
+    }
+
+    LatencyRegistry &LatencyRegistry::getInstance()
+    {
+        static LatencyRegistry instance;
+        return instance;
+    }
+
+    LatencyRegistry::LatencyRegistry()
+        : previous_buckets_(kLatencySiteCount * LatencyHistogram::kBucketCount, 0),
+          last_collect_(std::chrono::steady_clock::now())
+    {
+        std::fill(std::begin(previous_sums_), std::end(previous_sums_), 0);
+    }
+
+    LatencyRegistry::LocalHandle::~LocalHandle()
+    {
+        if (block)
+        {
+            block->in_use.store(false, std::memory_order_release);
+        }
+    }
+
+    LatencyRegistry::ThreadBlock *LatencyRegistry::acquireBlock()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &block : blocks_)
+        {
+            bool expected = false;
+            if (block->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire))
+            {
+                return block.get();
+            }
+        }
+
+        blocks_.push_back(std::make_unique<ThreadBlock>());
+        blocks_.back()->in_use.store(true, std::memory_order_relaxed);
+        return blocks_.back().get();
+    }
+
+    void LatencyRegistry::collect(LatencyReport &report)
+    {
+        auto now = std::chrono::steady_clock::now();
+        report.site_count = static_cast<uint32_t>(kLatencySiteCount);
+        report.window_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - last_collect_).count();
+        last_collect_ = now;
+
+        std::vector<uint64_t> window(LatencyHistogram::kBucketCount);
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t site = 0; site < kLatencySiteCount; ++site)
+        {
+            uint64_t *previous = &previous_buckets_[site * LatencyHistogram::kBucketCount];
+            uint64_t sum = 0;
+            std::fill(window.begin(), window.end(), 0);
+            for (const auto &block : blocks_)
+            {
+                const LatencyHistogram &histogram = block->sites[site];
+                for (size_t i = 0; i < LatencyHistogram::kBucketCount; ++i)
+                {
+                    window[i] += histogram.bucket(i);
+                }
+                sum += histogram.sum();
+            }
+
+            // 累计值减去上次的累计值；写方并发写入时个别桶可能比上次读到的后一步，按 0 处理
+            uint64_t total = 0;
+            size_t highest = 0;
+            for (size_t i = 0; i < LatencyHistogram::kBucketCount; ++i)
+            {
+                uint64_t cumulative = window[i];
+                window[i] = cumulative >= previous[i] ? cumulative - previous[i] : 0;
+                previous[i] = cumulative;
+                total += window[i];
+                if (window[i] != 0)
+                {
+                    highest = i;
+                }
+            }
+            uint64_t window_sum = sum >= previous_sums_[site] ? sum - previous_sums_[site] : 0;
+            previous_sums_[site] = sum;
+
+            LatencySummary &summary = report.sites[site];
+            std::memset(&summary, 0, sizeof(summary));
+            summary.count = total;
+            if (total == 0)
+            {
+                continue;
+            }
+            summary.mean_ns = window_sum / total;
+            summary.p50_ns = percentileOf(window, total, 0.50);
+            summary.p99_ns = percentileOf(window, total, 0.99);
+            summary.p999_ns = percentileOf(window, total, 0.999);
+            summary.max_ns = LatencyHistogram::bucketUpperBound(highest);
+        }
+    }
+
+} // namespace market_feeder
@@ -0,0 +1,83 @@
+#include "common/symbol_router.h"
+#include <algorithm>
+
+namespace market_feeder
+{
+
+    namespace
+    {
+        // splitmix64 的收尾混合，打散 FNV 在短键上的低位相关
+        uint64_t mix(uint64_t value)
+        {
+            value ^= value >> 30;
+            value *= 0xbf58476d1ce4e5b9ULL;
+            value ^= value >> 27;
+            value *= 0x94d049bb133111ebULL;
+            value ^= value >> 31;
+            return value;
+        }
+    } // namespace
+
+    uint64_t SymbolRouter::hashKey(std::string_view key)
+    {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (unsigned char c : key)
+        {
+            hash ^= c;
+            hash *= 0x100000001b3ULL;
+        }
+        return mix(hash);
+    }
+
+    void SymbolRouter::rebuild(uint64_t members)
+    {
+        members_ = members;
+        ring_.clear();
+        ring_.reserve(static_cast<size_t>(__builtin_popcountll(members)) * kVirtualNodes);
+
+        for (int worker_id = 1; worker_id <= kMaxMembers; ++worker_id)
+        {
+            if (!contains(worker_id))
+            {
+                continue;
+            }
+            // 虚拟节点位置只取决于 worker_id，与其他成员无关
+            for (int node = 0; node < kVirtualNodes; ++node)
+            {
+                uint64_t point = mix((static_cast<uint64_t>(worker_id) << 32) | static_cast<uint64_t>(node));
+                ring_.emplace_back(point, worker_id);
+            }
+        }
+        std::sort(ring_.begin(), ring_.end());
+    }
+
+    int SymbolRouter::ownerOf(std::string_view key) const
+    {
+        if (ring_.empty())
+        {
+            return -1;
+        }
+
+        uint64_t hash = hashKey(key);
+        auto it = std::lower_bound(ring_.begin(), ring_.end(), std::make_pair(hash, 0));
+        if (it == ring_.end())
+        {
+            it = ring_.begin();
+        }
+        return it->second;
+    }
+
+    std::vector<std::string> SymbolRouter::select(const std::vector<std::string> &keys, int worker_id) const
+    {
+        std::vector<std::string> owned;
+        for (const auto &key : keys)
+        {
+            if (ownerOf(key) == worker_id)
+            {
+                owned.push_back(key);
+            }
+        }
+        return owned;
+    }
+
+} // namespace market_feeder
@@ -0,0 +1,285 @@
+#include "common/tick_arena.h"
+#include "common/logger.h"
+#include "common/cpu_topology.h"
+#include <sys/mman.h>
+#include <cerrno>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace market_feeder
+{
+
+    namespace
+    {
+        constexpr uint32_t kNoSegment = std::numeric_limits<uint32_t>::max();
+
+        size_t roundUp(size_t value, size_t alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    } // namespace
+
+    TickArena::TickArena()
+        : base_(nullptr), mapped_size_(0), segment_size_(kDefaultSegmentSize), huge_pages_(false),
+          segment_count_(0), current_(kNoSegment), stored_(0), exhausted_(0)
+    {
+    }
+
+    TickArena::~TickArena()
+    {
+        destroy();
+    }
+
+    bool TickArena::initialize(size_t bytes, bool use_hugepages, size_t segment_size, int numa_node)
+    {
+        destroy();
+
+        if (segment_size < 4096 || segment_size > kHugePageSize || bytes < segment_size)
+        {
+            LOG_ERROR("Invalid tick arena size: {} bytes, segment {} bytes", bytes, segment_size);
+            return false;
+        }
+        // 偏移用 32 位保存，总大小不超过 4GB
+        const size_t max_bytes = (static_cast<size_t>(std::numeric_limits<uint32_t>::max()) + 1) / segment_size * segment_size;
+        bytes = std::min(roundUp(bytes, segment_size), max_bytes);
+
+        // 指定节点时先 mbind 再逐页写入预取，MAP_POPULATE 会在绑定之前就分配好页
+        const int populate = numa_node >= 0 ? 0 : MAP_POPULATE;
+        void *memory = MAP_FAILED;
+        if (use_hugepages)
+        {
+            mapped_size_ = roundUp(bytes, kHugePageSize);
+            memory = mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | populate, -1, 0);
+            if (memory == MAP_FAILED)
+            {
+                LOG_WARN("MAP_HUGETLB failed for tick arena ({} bytes): {}, falling back to normal pages",
+                         mapped_size_, strerror(errno));
+            }
+            else
+            {
+                huge_pages_ = true;
+            }
+        }
+
+        if (memory == MAP_FAILED)
+        {
+            mapped_size_ = bytes;
+            memory = mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | populate, -1, 0);
+            if (memory == MAP_FAILED)
+            {
+                LOG_ERROR("Failed to map tick arena ({} bytes): {}", mapped_size_, strerror(errno));
+                mapped_size_ = 0;
+                return false;
+            }
+            if (use_hugepages)
+            {
+                // 没有预留大页时退而使用透明大页，失败不影响功能
+                madvise(memory, mapped_size_, MADV_HUGEPAGE);
+            }
+        }
+
+        if (numa_node >= 0)
+        {
+            CpuTopology::bindMemory(memory, mapped_size_, numa_node);
+            for (size_t offset = 0; offset < mapped_size_; offset += 4096)
+            {
+                static_cast<volatile char *>(memory)[offset] = 0;
+            }
+        }
+
+        base_ = static_cast<char *>(memory);
+        segment_size_ = segment_size;
+        segment_count_ = static_cast<uint32_t>(bytes / segment_size);
+        segments_.reset(new Segment[segment_count_]);
+        for (uint32_t i = 0; i < segment_count_; ++i)
+        {
+            segments_[i].used.store(0, std::memory_order_relaxed);
+            segments_[i].live.store(0, std::memory_order_relaxed);
+            segments_[i].state.store(SEGMENT_FREE, std::memory_order_relaxed);
+        }
+
+        // 0 号段作为当前段，其余按编号顺序取用
+        free_segments_.clear();
+        for (uint32_t i = segment_count_; i > 1; --i)
+        {
+            free_segments_.push_back(i - 1);
+        }
+        segments_[0].state.store(SEGMENT_ACTIVE, std::memory_order_relaxed);
+        current_.store(0, std::memory_order_release);
+
+        LOG_INFO("Tick arena initialized: {} bytes in {} segments, huge pages {}, numa node {}",
+                 bytes, segment_count_, huge_pages_ ? "on" : "off", numa_node);
+        return true;
+    }
+
+    void TickArena::destroy()
+    {
+        if (base_)
+        {
+            munmap(base_, mapped_size_);
+        }
+        base_ = nullptr;
+        mapped_size_ = 0;
+        huge_pages_ = false;
+        segments_.reset();
+        segment_count_ = 0;
+        current_.store(kNoSegment, std::memory_order_relaxed);
+        free_segments_.clear();
+    }
+
+    bool TickArena::store(std::string_view raw, RawDataRef &ref)
+    {
+        ref = RawDataRef();
+        if (raw.empty())
+        {
+            return true;
+        }
+
+        // 按 8 字节对齐分配，超过单段大小的数据无法保存
+        size_t bytes = roundUp(raw.size(), 8);
+        if (!base_ || bytes > segment_size_)
+        {
+            exhausted_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        uint32_t size = static_cast<uint32_t>(bytes);
+
+        for (;;)
+        {
+            uint32_t index = current_.load(std::memory_order_acquire);
+            if (index == kNoSegment)
+            {
+                break;
+            }
+
+            // 先登记存活再占位，保证段在本次写入完成前不会被回收。
+            // 读到 index 之后这个段可能已被封存、回收甚至重新启用，登记后须确认它仍是活动的当前段，
+            // 否则撤销登记重试；与 rotate / recycleIfDone 的封存和存活检查之间需要 seq_cst
+            Segment &segment = segments_[index];
+            segment.live.fetch_add(1, std::memory_order_seq_cst);
+            if (current_.load(std::memory_order_seq_cst) != index ||
+                segment.state.load(std::memory_order_seq_cst) != SEGMENT_ACTIVE)
+            {
+                if (segment.live.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    recycleIfDone(index);
+                }
+                continue;
+            }
+            uint32_t offset = segment.used.fetch_add(size, std::memory_order_relaxed);
+            if (static_cast<size_t>(offset) + size <= segment_size_)
+            {
+                size_t position = static_cast<size_t>(index) * segment_size_ + offset;
+                memcpy(base_ + position, raw.data(), raw.size());
+                ref.offset = static_cast<uint32_t>(position);
+                ref.size = static_cast<uint32_t>(raw.size());
+                stored_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+
+            // 当前段放不下，撤销登记并切换到下一段
+            if (segment.live.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                recycleIfDone(index);
+            }
+            if (!rotate(index))
+            {
+                break;
+            }
+        }
+
+        exhausted_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    void TickArena::release(const RawDataRef &ref)
+    {
+        if (ref.size == 0 || !base_)
+        {
+            return;
+        }
+
+        uint32_t index = static_cast<uint32_t>(ref.offset / segment_size_);
+        if (segments_[index].live.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            recycleIfDone(index);
+        }
+    }
+
+    bool TickArena::rotate(uint32_t full_segment)
+    {
+        {
+            std::lock_guard<std::mutex> lock(free_mutex_);
+            if (current_.load(std::memory_order_relaxed) != full_segment)
+            {
+                // 其他线程已经切换过，或池已耗尽
+                return current_.load(std::memory_order_relaxed) != kNoSegment;
+            }
+
+            segments_[full_segment].state.store(SEGMENT_SEALED, std::memory_order_seq_cst);
+            if (free_segments_.empty())
+            {
+                current_.store(kNoSegment, std::memory_order_release);
+            }
+            else
+            {
+                uint32_t next = free_segments_.back();
+                free_segments_.pop_back();
+                segments_[next].used.store(0, std::memory_order_relaxed);
+                segments_[next].state.store(SEGMENT_ACTIVE, std::memory_order_release);
+                current_.store(next, std::memory_order_release);
+            }
+        }
+
+        recycleIfDone(full_segment);
+        return current_.load(std::memory_order_acquire) != kNoSegment;
+    }
+
+    void TickArena::recycleIfDone(uint32_t index)
+    {
+        Segment &segment = segments_[index];
+        if (segment.state.load(std::memory_order_acquire) != SEGMENT_SEALED ||
+            segment.live.load(std::memory_order_acquire) != 0)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(free_mutex_);
+        if (segment.state.load(std::memory_order_relaxed) != SEGMENT_SEALED ||
+            segment.live.load(std::memory_order_seq_cst) != 0)
+        {
+            return;
+        }
+
+        if (current_.load(std::memory_order_relaxed) == kNoSegment)
+        {
+            // 池曾经耗尽，直接把回收的段作为当前段
+            segment.used.store(0, std::memory_order_relaxed);
+            segment.state.store(SEGMENT_ACTIVE, std::memory_order_release);
+            current_.store(index, std::memory_order_release);
+        }
+        else
+        {
+            segment.state.store(SEGMENT_FREE, std::memory_order_relaxed);
+            free_segments_.push_back(index);
+        }
+    }
+
+    TickArena::Stats TickArena::getStats() const
+    {
+        Stats stats;
+        stats.capacity = static_cast<size_t>(segment_count_) * segment_size_;
+        {
+            std::lock_guard<std::mutex> lock(free_mutex_);
+            stats.free_segments = free_segments_.size();
+        }
+        stats.stored = stored_.load(std::memory_order_relaxed);
+        stats.exhausted = exhausted_.load(std::memory_order_relaxed);
+        stats.huge_pages = huge_pages_;
+        return stats;
+    }
+
+} // namespace market_feeder
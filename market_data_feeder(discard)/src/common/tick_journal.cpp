@@ -0,0 +1,509 @@
+#include "common/tick_journal.h"
+#include "common/logger.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+namespace market_feeder
+{
+
+    namespace
+    {
+        constexpr uint64_t kJournalMagic = 0x4c4e524a4b434954ULL; // "TICKJRNL"
+        constexpr size_t kCheckpointFileSize = 4096;
+        constexpr char kSegmentPrefix[] = "segment_";
+        constexpr char kSegmentSuffix[] = ".journal";
+
+        // 逐级创建目录
+        bool makeDirectories(const std::string &path)
+        {
+            for (size_t pos = 1; pos <= path.size(); ++pos)
+            {
+                if (pos == path.size() || path[pos] == '/')
+                {
+                    std::string part = path.substr(0, pos);
+                    if (mkdir(part.c_str(), 0755) < 0 && errno != EEXIST)
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        // 目录下的段编号，升序
+        std::vector<uint64_t> listSegments(const std::string &directory)
+        {
+            std::vector<uint64_t> segments;
+            DIR *dir = opendir(directory.c_str());
+            if (!dir)
+            {
+                return segments;
+            }
+
+            const size_t prefix_length = sizeof(kSegmentPrefix) - 1;
+            while (struct dirent *entry = readdir(dir))
+            {
+                std::string name = entry->d_name;
+                if (name.compare(0, prefix_length, kSegmentPrefix) != 0 ||
+                    name.size() <= prefix_length + sizeof(kSegmentSuffix) - 1 ||
+                    name.compare(name.size() - (sizeof(kSegmentSuffix) - 1), std::string::npos, kSegmentSuffix) != 0)
+                {
+                    continue;
+                }
+                segments.push_back(std::strtoull(name.c_str() + prefix_length, nullptr, 10));
+            }
+            closedir(dir);
+
+            std::sort(segments.begin(), segments.end());
+            return segments;
+        }
+    } // namespace
+
+    TickJournal::TickJournal()
+        : segment_records_(0), header_(nullptr), segment_base_(nullptr), segment_index_(0),
+          next_sequence_(0), oldest_segment_(0), abandoned_(0), replayed_(0)
+    {
+    }
+
+    TickJournal::~TickJournal()
+    {
+        close();
+    }
+
+    bool TickJournal::open(const std::string &directory, size_t segment_size)
+    {
+        close();
+
+        directory_ = directory;
+        if (!makeDirectories(directory_))
+        {
+            LOG_ERROR("Failed to create journal directory {}: {}", directory_, strerror(errno));
+            return false;
+        }
+        if (!mapCheckpoint(segment_size))
+        {
+            return false;
+        }
+        segment_records_ = header_->segment_records;
+
+        uint64_t committed = header_->committed.load(std::memory_order_relaxed);
+        std::vector<uint64_t> segments = listSegments(directory_);
+        oldest_segment_ = segments.empty() ? committed / segment_records_ : segments.front();
+
+        if (segments.empty())
+        {
+            next_sequence_ = committed;
+            if (!mapSegment(committed / segment_records_, true))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            if (!mapSegment(segments.back(), false))
+            {
+                return false;
+            }
+            recoverWritePosition();
+        }
+
+        // 检查点之后的段已被删除（例如检查点刚好落在段尾），从检查点重新开始
+        if (next_sequence_ < committed)
+        {
+            unmapSegment();
+            next_sequence_ = committed;
+            if (!mapSegment(committed / segment_records_, true))
+            {
+                return false;
+            }
+        }
+
+        removeSegmentsBefore(committed);
+
+        LOG_INFO("Tick journal opened at {}: {} records per segment, checkpoint {}, next sequence {}",
+                 directory_, segment_records_, committed, next_sequence_);
+        return true;
+    }
+
+    void TickJournal::close()
+    {
+        unmapSegment();
+
+        // 写库线程可能仍在回调 completeBatch，检查点映射要在锁内释放
+        std::lock_guard<std::mutex> lock(checkpoint_mutex_);
+        inflight_.clear();
+        abandoned_ = 0;
+        if (header_)
+        {
+            munmap(header_, kCheckpointFileSize);
+            header_ = nullptr;
+        }
+    }
+
+    std::string TickJournal::workerDirectory(const std::string &root, int worker_id)
+    {
+        return root + "/worker_" + std::to_string(worker_id);
+    }
+
+    std::string TickJournal::segmentPath(uint64_t segment) const
+    {
+        return segmentPath(directory_, segment);
+    }
+
+    std::string TickJournal::segmentPath(const std::string &directory, uint64_t segment)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "%s%020" PRIu64 "%s", kSegmentPrefix, segment, kSegmentSuffix);
+        return directory + "/" + name;
+    }
+
+    bool TickJournal::mapCheckpoint(size_t segment_size)
+    {
+        std::string path = directory_ + "/checkpoint";
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0)
+        {
+            LOG_ERROR("Failed to open journal checkpoint {}: {}", path, strerror(errno));
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) < 0 || (st.st_size < static_cast<off_t>(kCheckpointFileSize) &&
+                                   ftruncate(fd, kCheckpointFileSize) < 0))
+        {
+            LOG_ERROR("Failed to size journal checkpoint {}: {}", path, strerror(errno));
+            ::close(fd);
+            return false;
+        }
+
+        void *memory = mmap(nullptr, kCheckpointFileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (memory == MAP_FAILED)
+        {
+            LOG_ERROR("Failed to map journal checkpoint {}: {}", path, strerror(errno));
+            return false;
+        }
+
+        header_ = static_cast<CheckpointHeader *>(memory);
+        if (header_->magic != kJournalMagic || header_->segment_records == 0)
+        {
+            // 新日志
+            header_->segment_records = std::max<uint64_t>(segment_size / sizeof(Record), 1);
+            header_->committed.store(0, std::memory_order_relaxed);
+            header_->record_size = sizeof(Record);
+            header_->magic = kJournalMagic;
+        }
+        else if (header_->record_size != sizeof(Record))
+        {
+            LOG_ERROR("Journal {} has {}-byte records, this build uses {}; replay it with the matching build or remove it",
+                      directory_, header_->record_size, sizeof(Record));
+            munmap(header_, kCheckpointFileSize);
+            header_ = nullptr;
+            return false;
+        }
+        return true;
+    }
+
+    bool TickJournal::mapSegment(uint64_t segment, bool create)
+    {
+        std::string path = segmentPath(segment);
+        int fd = ::open(path.c_str(), O_RDWR | (create ? O_CREAT : 0), 0644);
+        if (fd < 0)
+        {
+            LOG_ERROR("Failed to open journal segment {}: {}", path, strerror(errno));
+            return false;
+        }
+
+        // 预先分配磁盘块，磁盘满时在这里失败，而不是写映射页时收到 SIGBUS
+        size_t bytes = segment_records_ * sizeof(Record);
+        int error = posix_fallocate(fd, 0, static_cast<off_t>(bytes));
+        if (error != 0)
+        {
+            LOG_ERROR("Failed to allocate journal segment {}: {}", path, strerror(error));
+            ::close(fd);
+            return false;
+        }
+
+        void *memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (memory == MAP_FAILED)
+        {
+            LOG_ERROR("Failed to map journal segment {}: {}", path, strerror(errno));
+            return false;
+        }
+
+        segment_base_ = static_cast<Record *>(memory);
+        segment_index_ = segment;
+        return true;
+    }
+
+    void TickJournal::unmapSegment()
+    {
+        if (segment_base_)
+        {
+            munmap(segment_base_, segment_records_ * sizeof(Record));
+            segment_base_ = nullptr;
+        }
+    }
+
+    void TickJournal::recoverWritePosition()
+    {
+        // 序号最后写入，第一个序号不连续的位置就是崩溃时的写入位置
+        uint64_t first = segment_index_ * segment_records_;
+        uint64_t offset = 0;
+        while (offset < segment_records_ &&
+               segment_base_[offset].sequence_plus_one.load(std::memory_order_acquire) == first + offset + 1)
+        {
+            ++offset;
+        }
+        next_sequence_ = first + offset;
+    }
+
+    bool TickJournal::append(const MarketData &data)
+    {
+        if (!segment_base_)
+        {
+            return false;
+        }
+
+        uint64_t offset = next_sequence_ - segment_index_ * segment_records_;
+        if (offset >= segment_records_)
+        {
+            uint64_t next_segment = segment_index_ + 1;
+            unmapSegment();
+            if (!mapSegment(next_segment, true))
+            {
+                return false;
+            }
+            offset = 0;
+        }
+
+        Record &record = segment_base_[offset];
+        record.data = data;
+        record.data.raw_data = RawDataRef();
+        record.sequence_plus_one.store(next_sequence_ + 1, std::memory_order_release);
+        ++next_sequence_;
+        return true;
+    }
+
+    void TickJournal::trackBatch(uint64_t end)
+    {
+        std::lock_guard<std::mutex> lock(checkpoint_mutex_);
+        if (!inflight_.empty() && end <= inflight_.back().end)
+        {
+            return;
+        }
+        inflight_.push_back(InflightBatch{end, false, false});
+    }
+
+    void TickJournal::cancelBatch(uint64_t end)
+    {
+        std::lock_guard<std::mutex> lock(checkpoint_mutex_);
+        if (!inflight_.empty() && inflight_.back().end == end && !inflight_.back().done)
+        {
+            inflight_.pop_back();
+        }
+    }
+
+    void TickJournal::completeBatch(uint64_t end, bool committed)
+    {
+        std::lock_guard<std::mutex> lock(checkpoint_mutex_);
+        if (!header_)
+        {
+            return;
+        }
+
+        auto it = std::find_if(inflight_.begin(), inflight_.end(),
+                               [end](const InflightBatch &batch) { return batch.end == end; });
+        if (it == inflight_.end())
+        {
+            return;
+        }
+        it->done = true;
+        it->committed = committed;
+
+        // 写库线程并发提交，只有前面的批次都完成后检查点才能越过。
+        // 放弃的批次不越过：检查点停在它之前，之后完成的批次只出队不推进，队列长度仍然有界
+        uint64_t checkpoint = 0;
+        while (!inflight_.empty() && inflight_.front().done)
+        {
+            if (!inflight_.front().committed && abandoned_++ == 0)
+            {
+                LOG_ERROR("Journal batch ending at {} abandoned, checkpoint held at {} until restart",
+                          inflight_.front().end, std::max(checkpoint, header_->committed.load(std::memory_order_relaxed)));
+            }
+            if (abandoned_ == 0)
+            {
+                checkpoint = inflight_.front().end;
+            }
+            inflight_.pop_front();
+        }
+        if (checkpoint > header_->committed.load(std::memory_order_relaxed))
+        {
+            header_->committed.store(checkpoint, std::memory_order_release);
+            removeSegmentsBefore(checkpoint);
+        }
+    }
+
+    uint64_t TickJournal::checkpoint() const
+    {
+        return header_ ? header_->committed.load(std::memory_order_acquire) : 0;
+    }
+
+    void TickJournal::removeSegmentsBefore(uint64_t sequence)
+    {
+        // 当前段即使写满被删除也不影响已有映射，下次追加会轮转到新段
+        while ((oldest_segment_ + 1) * segment_records_ <= sequence)
+        {
+            std::string path = segmentPath(oldest_segment_);
+            if (unlink(path.c_str()) < 0 && errno != ENOENT)
+            {
+                LOG_WARN("Failed to remove journal segment {}: {}", path, strerror(errno));
+            }
+            ++oldest_segment_;
+        }
+    }
+
+    size_t TickJournal::replay(size_t batch_size, const std::function<void(std::vector<MarketData> &, uint64_t)> &fn)
+    {
+        uint64_t begin = checkpoint();
+        uint64_t end = next_sequence_;
+        if (!header_ || begin >= end)
+        {
+            return 0;
+        }
+
+        LOG_INFO("Replaying {} journaled records from checkpoint {}", end - begin, begin);
+
+        batch_size = std::max<size_t>(batch_size, 1);
+        std::vector<MarketData> batch;
+        batch.reserve(batch_size);
+        size_t replayed = 0;
+        const size_t bytes = segment_records_ * sizeof(Record);
+
+        for (uint64_t segment = begin / segment_records_; segment * segment_records_ < end; ++segment)
+        {
+            std::string path = segmentPath(segment);
+            int fd = ::open(path.c_str(), O_RDONLY);
+            void *memory = fd < 0 ? MAP_FAILED : mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+            if (memory == MAP_FAILED)
+            {
+                LOG_ERROR("Journal segment {} unreadable, its records are skipped: {}", path, strerror(errno));
+                continue;
+            }
+
+            const Record *records = static_cast<const Record *>(memory);
+            uint64_t first = segment * segment_records_;
+            uint64_t last = std::min(end, first + segment_records_);
+            for (uint64_t sequence = std::max(begin, first); sequence < last; ++sequence)
+            {
+                const Record &record = records[sequence - first];
+                if (record.sequence_plus_one.load(std::memory_order_acquire) == sequence + 1)
+                {
+                    batch.push_back(record.data);
+                    // 上一个进程的跟踪时间戳对本进程没有意义
+                    batch.back().trace = TickTrace();
+                    ++replayed;
+                }
+                if (batch.size() >= batch_size)
+                {
+                    fn(batch, sequence + 1);
+                    batch.clear();
+                }
+            }
+            munmap(memory, bytes);
+        }
+
+        if (!batch.empty())
+        {
+            fn(batch, end);
+        }
+
+        replayed_.fetch_add(replayed, std::memory_order_relaxed);
+        return replayed;
+    }
+
+    TickJournal::Stats TickJournal::getStats() const
+    {
+        Stats stats;
+        stats.next_sequence = next_sequence_;
+        stats.checkpoint = checkpoint();
+        {
+            std::lock_guard<std::mutex> lock(checkpoint_mutex_);
+            uint64_t newest = segment_records_ > 0 ? next_sequence_ / segment_records_ : 0;
+            stats.segments = newest >= oldest_segment_ ? newest - oldest_segment_ + 1 : 0;
+            stats.abandoned = abandoned_;
+        }
+        stats.replayed = replayed_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    uint64_t TickJournal::pendingRecords(const std::string &directory)
+    {
+        // 只读打开，不创建任何文件
+        std::string path = directory + "/checkpoint";
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return 0;
+        }
+        uint64_t fields[2] = {0, 0};
+        uint64_t committed = 0;
+        uint64_t record_size = 0;
+        bool valid = pread(fd, fields, sizeof(fields), 0) == static_cast<ssize_t>(sizeof(fields)) &&
+                     pread(fd, &committed, sizeof(committed), sizeof(fields)) == static_cast<ssize_t>(sizeof(committed)) &&
+                     pread(fd, &record_size, sizeof(record_size), offsetof(CheckpointHeader, record_size)) ==
+                         static_cast<ssize_t>(sizeof(record_size));
+        ::close(fd);
+        if (!valid || fields[0] != kJournalMagic || fields[1] == 0 || record_size != sizeof(Record))
+        {
+            return 0;
+        }
+        const uint64_t segment_records = fields[1];
+
+        std::vector<uint64_t> segments = listSegments(directory);
+        if (segments.empty())
+        {
+            return 0;
+        }
+
+        const size_t bytes = segment_records * sizeof(Record);
+        fd = ::open(segmentPath(directory, segments.back()).c_str(), O_RDONLY);
+        void *memory = fd < 0 ? MAP_FAILED : mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+        if (memory == MAP_FAILED)
+        {
+            return 0;
+        }
+
+        const Record *records = static_cast<const Record *>(memory);
+        uint64_t first = segments.back() * segment_records;
+        uint64_t offset = 0;
+        while (offset < segment_records &&
+               records[offset].sequence_plus_one.load(std::memory_order_acquire) == first + offset + 1)
+        {
+            ++offset;
+        }
+        munmap(memory, bytes);
+
+        uint64_t next = first + offset;
+        return next > committed ? next - committed : 0;
+    }
+
+} // namespace market_feeder
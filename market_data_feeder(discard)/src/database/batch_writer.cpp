@@ -0,0 +1,211 @@
+#include "database/batch_writer.h"
+#include "common/latency_histogram.h"
+#include "common/logger.h"
+#include <algorithm>
+
+namespace market_feeder {
+
+BatchWriter::BatchWriter(DatabaseManager& db_manager, const Options& options, CompletionCallback on_complete)
+    : db_manager_(db_manager), options_(options), on_complete_(std::move(on_complete)),
+      running_(false), in_flight_(0), committed_batches_(0), committed_rows_(0),
+      failed_batches_(0), retries_(0), submit_waits_(0), max_queue_depth_(0) {
+    options_.writer_threads = std::max(options_.writer_threads, 1);
+    options_.max_inflight_batches = std::max(options_.max_inflight_batches, options_.writer_threads);
+    options_.max_retries = std::max(options_.max_retries, 0);
+}
+
+BatchWriter::~BatchWriter() {
+    stop();
+}
+
+bool BatchWriter::start() {
+    if (running_) {
+        return true;
+    }
+
+    running_ = true;
+    for (int i = 0; i < options_.writer_threads; ++i) {
+        threads_.emplace_back(&BatchWriter::writerLoop, this);
+    }
+
+    LOG_INFO("Batch writer started: {} writer threads, {} in-flight batches, {} retries",
+             options_.writer_threads, options_.max_inflight_batches, options_.max_retries);
+    return true;
+}
+
+void BatchWriter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    queue_condition_.notify_all();
+    space_condition_.notify_all();
+
+    // 写库线程取完剩余批次后才退出
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    threads_.clear();
+
+    LOG_INFO("Batch writer stopped: {} batches committed, {} failed",
+             committed_batches_.load(), failed_batches_.load());
+}
+
+bool BatchWriter::submit(std::vector<MarketData>& batch, int timeout_ms, uint64_t tag) {
+    if (batch.empty()) {
+        return true;
+    }
+
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    if (in_flight_ >= static_cast<size_t>(options_.max_inflight_batches)) {
+        submit_waits_.fetch_add(1, std::memory_order_relaxed);
+        if (!space_condition_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this] {
+            return in_flight_ < static_cast<size_t>(options_.max_inflight_batches) || !running_;
+        })) {
+            return false;
+        }
+    }
+    if (!running_) {
+        return false;
+    }
+
+    pending_.push_back(PendingBatch{std::move(batch), tag});
+    batch.clear();
+    ++in_flight_;
+    size_t depth = pending_.size();
+    max_queue_depth_ = std::max(max_queue_depth_, depth);
+    lock.unlock();
+
+    // 排队深度的分布与 WRITER_COMMIT 一起导出，看写库线程是否跟得上
+    LatencyRegistry::recordNanoseconds(LatencySite::WRITER_QUEUE_DEPTH, depth);
+    queue_condition_.notify_one();
+    return true;
+}
+
+std::vector<MarketData> BatchWriter::acquireBuffer(size_t capacity) {
+    std::vector<MarketData> buffer;
+    {
+        std::lock_guard<std::mutex> lock(free_mutex_);
+        if (!free_buffers_.empty()) {
+            buffer = std::move(free_buffers_.back());
+            free_buffers_.pop_back();
+        }
+    }
+    buffer.reserve(capacity);
+    return buffer;
+}
+
+void BatchWriter::writerLoop() {
+    if (options_.on_thread_start) {
+        options_.on_thread_start();
+    }
+    
+    for (;;) {
+        std::vector<MarketData> batch;
+        uint64_t tag = 0;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_condition_.wait(lock, [this] { return !pending_.empty() || !running_; });
+            if (pending_.empty()) {
+                return;
+            }
+            batch = std::move(pending_.front().rows);
+            tag = pending_.front().tag;
+            pending_.pop_front();
+        }
+
+        bool committed = commitWithRetry(batch);
+        if (committed) {
+            committed_batches_.fetch_add(1, std::memory_order_relaxed);
+            committed_rows_.fetch_add(batch.size(), std::memory_order_relaxed);
+        } else {
+            failed_batches_.fetch_add(1, std::memory_order_relaxed);
+            LOG_ERROR("Dropping batch of {} market data records after {} retries",
+                      batch.size(), options_.max_retries);
+        }
+
+        if (on_complete_) {
+            on_complete_(batch, committed, tag);
+        }
+
+        // 回收 vector 供下一批使用
+        batch.clear();
+        {
+            std::lock_guard<std::mutex> lock(free_mutex_);
+            if (free_buffers_.size() < static_cast<size_t>(options_.max_inflight_batches)) {
+                free_buffers_.push_back(std::move(batch));
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            --in_flight_;
+        }
+        space_condition_.notify_one();
+    }
+}
+
+bool BatchWriter::commitWithRetry(const std::vector<MarketData>& batch) {
+    int backoff_ms = options_.retry_backoff_ms;
+
+    for (int attempt = 0; ; ++attempt) {
+        uint64_t start_ticks = TscClock::now();
+        DBErrorCode result = db_manager_.saveMarketDataBatch(batch);
+
+        if (result == DBErrorCode::SUCCESS) {
+            LatencyRegistry::record(LatencySite::WRITER_COMMIT, TscClock::now() - start_ticks);
+            return true;
+        }
+
+        if (attempt >= options_.max_retries || !isRetryable(result)) {
+            return false;
+        }
+
+        retries_.fetch_add(1, std::memory_order_relaxed);
+        LOG_WARN("Batch commit failed (error {}), retry {}/{} in {} ms",
+                 static_cast<int>(result), attempt + 1, options_.max_retries, backoff_ms);
+
+        // 停止时不再等待，直接重试剩余次数以尽快排空
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_condition_.wait_for(lock, std::chrono::milliseconds(backoff_ms), [this] { return !running_; });
+        }
+        backoff_ms = std::min(backoff_ms * 2, options_.retry_backoff_max_ms);
+    }
+}
+
+bool BatchWriter::isRetryable(DBErrorCode code) const {
+    switch (code) {
+        case DBErrorCode::CONNECTION_FAILED:
+        case DBErrorCode::QUERY_FAILED:
+        case DBErrorCode::TRANSACTION_FAILED:
+        case DBErrorCode::TIMEOUT:
+        case DBErrorCode::POOL_EXHAUSTED:
+            return true;
+        default:
+            return false;
+    }
+}
+
+BatchWriter::Stats BatchWriter::getStats() const {
+    Stats stats;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        stats.queue_depth = pending_.size();
+        stats.in_flight = in_flight_;
+        stats.max_queue_depth = max_queue_depth_;
+    }
+    stats.committed_batches = committed_batches_.load(std::memory_order_relaxed);
+    stats.committed_rows = committed_rows_.load(std::memory_order_relaxed);
+    stats.failed_batches = failed_batches_.load(std::memory_order_relaxed);
+    stats.retries = retries_.load(std::memory_order_relaxed);
+    stats.submit_waits = submit_waits_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace market_feeder
@@ -10,8 +10,8 @@ namespace market_feeder {
 
 // DBConnection实现
 DBConnection::DBConnection() 
-    : session_(nullptr), connected_(false), in_use_(false), 
-      affected_rows_(0), last_insert_id_(0) {
+    : session_(nullptr), connected_(false), in_use_(false), needs_validation_(false),
+      pool_slot_(ConnectionSlots::kNoSlot), affected_rows_(0), last_insert_id_(0) {
     last_used_time_ = std::chrono::system_clock::now();
 }
 
@@ -47,6 +47,7 @@ DBErrorCode DBConnection::connect(const DBConfig& config) {
         session_ = std::make_unique<mysqlx::Session>(settings);
         
         connected_ = true;
+        needs_validation_ = false;
         last_error_.clear();
         updateLastUsedTime();
         
@@ -91,7 +92,7 @@ bool DBConnection::isConnected() const {
 }
 
 DBErrorCode DBConnection::executeQuery(const std::string& sql) {
-    if (!isConnected()) {
+    if (!isOpen()) {
         LOG_ERROR("Database not connected");
         return DBErrorCode::CONNECTION_FAILED;
     }
@@ -114,17 +115,19 @@ DBErrorCode DBConnection::executeQuery(const std::string& sql) {
         
     } catch (const mysqlx::Error& e) {
         last_error_ = e.what();
+        needs_validation_ = true;
         LOG_ERROR("Failed to execute SQL: {} - Error: {}", sql, last_error_);
         return DBErrorCode::QUERY_FAILED;
     } catch (const std::exception& e) {
         last_error_ = e.what();
+        needs_validation_ = true;
         LOG_ERROR("Failed to execute SQL: {} - Error: {}", sql, last_error_);
         return DBErrorCode::QUERY_FAILED;
     }
 }
 
 DBErrorCode DBConnection::executeQuery(const std::string& sql, mysqlx::SqlResult& result) {
-    if (!isConnected()) {
+    if (!isOpen()) {
         LOG_ERROR("Database not connected");
         return DBErrorCode::CONNECTION_FAILED;
     }
@@ -145,10 +148,12 @@ DBErrorCode DBConnection::executeQuery(const std::string& sql, mysqlx::SqlResult
         
     } catch (const mysqlx::Error& e) {
         last_error_ = e.what();
+        needs_validation_ = true;
         LOG_ERROR("Failed to execute SQL: {} - Error: {}", sql, last_error_);
         return DBErrorCode::QUERY_FAILED;
     } catch (const std::exception& e) {
         last_error_ = e.what();
+        needs_validation_ = true;
         LOG_ERROR("Failed to execute SQL: {} - Error: {}", sql, last_error_);
         return DBErrorCode::QUERY_FAILED;
     }
@@ -156,7 +161,14 @@ DBErrorCode DBConnection::executeQuery(const std::string& sql, mysqlx::SqlResult
 
 DBErrorCode DBConnection::executePreparedStatement(const std::string& sql, 
                                                   const std::vector<mysqlx::Value>& params) {
-    if (!isConnected()) {
+    mysqlx::SqlResult result;
+    return executePreparedStatement(sql, params, result);
+}
+
+DBErrorCode DBConnection::executePreparedStatement(const std::string& sql, 
+                                                  const std::vector<mysqlx::Value>& params,
+                                                  mysqlx::SqlResult& result) {
+    if (!isOpen()) {
         LOG_ERROR("Database not connected");
         return DBErrorCode::CONNECTION_FAILED;
     }
@@ -169,7 +181,7 @@ DBErrorCode DBConnection::executePreparedStatement(const std::string& sql,
             stmt.bind(param);
         }
         
-        auto result = stmt.execute();
+        result = stmt.execute();
         affected_rows_ = result.getAffectedItemsCount();
         
         try {
@@ -184,17 +196,19 @@ DBErrorCode DBConnection::executePreparedStatement(const std::string& sql,
         
     } catch (const mysqlx::Error& e) {
         last_error_ = e.what();
+        needs_validation_ = true;
         LOG_ERROR("Failed to execute prepared statement: {} - Error: {}", sql, last_error_);
         return DBErrorCode::QUERY_FAILED;
     } catch (const std::exception& e) {
         last_error_ = e.what();
+        needs_validation_ = true;
         LOG_ERROR("Failed to execute prepared statement: {} - Error: {}", sql, last_error_);
         return DBErrorCode::QUERY_FAILED;
     }
 }
 
 DBErrorCode DBConnection::beginTransaction() {
-    if (!isConnected()) {
+    if (!isOpen()) {
         return DBErrorCode::CONNECTION_FAILED;
     }
     
@@ -204,13 +218,14 @@ DBErrorCode DBConnection::beginTransaction() {
         return DBErrorCode::SUCCESS;
     } catch (const mysqlx::Error& e) {
         last_error_ = e.what();
+        needs_validation_ = true;
         LOG_ERROR("Failed to begin transaction: {}", last_error_);
         return DBErrorCode::TRANSACTION_FAILED;
     }
 }
 
 DBErrorCode DBConnection::commitTransaction() {
-    if (!isConnected()) {
+    if (!isOpen()) {
         return DBErrorCode::CONNECTION_FAILED;
     }
     
@@ -220,13 +235,14 @@ DBErrorCode DBConnection::commitTransaction() {
         return DBErrorCode::SUCCESS;
     } catch (const mysqlx::Error& e) {
         last_error_ = e.what();
+        needs_validation_ = true;
         LOG_ERROR("Failed to commit transaction: {}", last_error_);
         return DBErrorCode::TRANSACTION_FAILED;
     }
 }
 
 DBErrorCode DBConnection::rollbackTransaction() {
-    if (!isConnected()) {
+    if (!isOpen()) {
         return DBErrorCode::CONNECTION_FAILED;
     }
     
@@ -236,6 +252,7 @@ DBErrorCode DBConnection::rollbackTransaction() {
         return DBErrorCode::SUCCESS;
     } catch (const mysqlx::Error& e) {
         last_error_ = e.what();
+        needs_validation_ = true;
         LOG_ERROR("Failed to rollback transaction: {}", last_error_);
         return DBErrorCode::TRANSACTION_FAILED;
     }
@@ -282,11 +299,18 @@ std::string DBConnection::escapeString(const std::string& str) const {
 
 // DBConnectionPool实现
 DBConnectionPool::DBConnectionPool() 
-    : active_connections_(0), shutdown_requested_(false), initialized_(false) {
+    : shutdown_requested_(false), initialized_(false) {
 }
 
 DBConnectionPool::~DBConnectionPool() {
     shutdown();
+    
+    // 仍有借出的连接时不销毁会话，宁可泄漏也不在使用方执行语句时释放
+    if (slots_ && slots_->inUse() > 0) {
+        for (auto& conn : connections_) {
+            conn.release();
+        }
+    }
 }
 
 bool DBConnectionPool::initialize(const DBConfig& config) {
@@ -297,148 +321,125 @@ bool DBConnectionPool::initialize(const DBConfig& config) {
         return true;
     }
     
+    if (config.pool_size <= 0) {
+        LOG_ERROR("Invalid database pool size: {}", config.pool_size);
+        return false;
+    }
+    
+    // 上次关闭时超时未归还的连接仍在使用，槽位和连接都不能替换
+    if (slots_ && slots_->inUse() > 0) {
+        LOG_ERROR("Cannot reinitialize database connection pool: {} connections still in use", slots_->inUse());
+        return false;
+    }
+    
     config_ = config;
     shutdown_requested_ = false;
     
-    // 创建初始连接
+    // 创建全部连接，之后池的大小不再变化
+    connections_.clear();
     for (int i = 0; i < config.pool_size; ++i) {
-        auto conn = createConnection();
-        if (conn && conn->connect(config) == DBErrorCode::SUCCESS) {
-            idle_connections_.push(conn);
-            all_connections_.push_back(conn);
-        } else {
+        auto conn = std::make_unique<DBConnection>();
+        if (conn->connect(config) != DBErrorCode::SUCCESS) {
             LOG_ERROR("Failed to create initial database connection {}", i);
+            connections_.clear();
             return false;
         }
+        conn->setPoolSlot(static_cast<uint32_t>(i));
+        connections_.push_back(std::move(conn));
     }
+    slots_ = std::make_unique<ConnectionSlots>(connections_.size(), config.sticky_connections);
     
     initialized_ = true;
     
-    LOG_INFO("Database connection pool initialized with {} connections", config.pool_size);
+    LOG_INFO("Database connection pool initialized with {} connections, sticky {}, validate after {} ms idle",
+             config.pool_size, config.sticky_connections ? "on" : "off", config.validate_idle_ms);
     return true;
 }
 
-std::shared_ptr<DBConnection> DBConnectionPool::getConnection(int timeout_ms) {
-    std::unique_lock<std::mutex> lock(pool_mutex_);
-    
+DBConnection* DBConnectionPool::getConnection(int timeout_ms) {
     if (!initialized_ || shutdown_requested_) {
         LOG_ERROR("Database connection pool not available");
         return nullptr;
     }
     
-    // 等待可用连接
-    auto timeout = std::chrono::milliseconds(timeout_ms);
-    if (!pool_condition_.wait_for(lock, timeout, [this] { 
-        return !idle_connections_.empty() || shutdown_requested_; 
-    })) {
-        LOG_ERROR("Timeout waiting for database connection");
-        return nullptr;
-    }
-    
-    if (shutdown_requested_) {
+    uint32_t slot = slots_->acquire(std::chrono::milliseconds(timeout_ms));
+    if (slot == ConnectionSlots::kNoSlot) {
+        if (!shutdown_requested_) {
+            LOG_ERROR("Timeout waiting for database connection");
+        }
         return nullptr;
     }
     
-    auto conn = idle_connections_.front();
-    idle_connections_.pop();
+    DBConnection* conn = connections_[slot].get();
     
-    // 验证连接
-    if (!validateConnection(conn)) {
-        // 连接无效，创建新连接
-        conn = createConnection();
-        if (!conn || conn->connect(config_) != DBErrorCode::SUCCESS) {
-            LOG_ERROR("Failed to create replacement database connection");
-            return nullptr;
-        }
+    // 懒验证：只有上次出错或空闲较久的连接才发 SELECT 1
+    if (conn->needsValidation(std::chrono::milliseconds(config_.validate_idle_ms)) && 
+        !validateConnection(conn)) {
+        slots_->release(slot);
+        return nullptr;
     }
     
     conn->setInUse(true);
-    conn->updateLastUsedTime();
-    active_connections_++;
-    
     return conn;
 }
 
-void DBConnectionPool::returnConnection(std::shared_ptr<DBConnection> connection) {
+void DBConnectionPool::returnConnection(DBConnection* connection) {
     if (!connection) {
         return;
     }
     
-    std::lock_guard<std::mutex> lock(pool_mutex_);
-    
-    if (!initialized_ || shutdown_requested_) {
-        return;
-    }
-    
+    // 关闭过程中也要归还，shutdown 等待所有连接回到池中
     connection->setInUse(false);
-    active_connections_--;
-    
-    // 验证连接是否仍然有效
-    if (validateConnection(connection)) {
-        idle_connections_.push(connection);
-        pool_condition_.notify_one();
-    } else {
-        // 连接无效，从all_connections_中移除
-        auto it = std::find(all_connections_.begin(), all_connections_.end(), connection);
-        if (it != all_connections_.end()) {
-            all_connections_.erase(it);
-        }
-        
-        // 创建新连接替代
-        auto new_conn = createConnection();
-        if (new_conn && new_conn->connect(config_) == DBErrorCode::SUCCESS) {
-            idle_connections_.push(new_conn);
-            all_connections_.push_back(new_conn);
-            pool_condition_.notify_one();
-        } else {
-            LOG_ERROR("Failed to create replacement database connection");
-        }
-    }
+    slots_->release(connection->getPoolSlot());
 }
 
 size_t DBConnectionPool::getActiveConnections() const {
-    return active_connections_.load();
+    return slots_ ? slots_->inUse() : 0;
 }
 
 size_t DBConnectionPool::getIdleConnections() const {
-    std::lock_guard<std::mutex> lock(pool_mutex_);
-    return idle_connections_.size();
+    return getTotalConnections() - getActiveConnections();
 }
 
 size_t DBConnectionPool::getTotalConnections() const {
-    std::lock_guard<std::mutex> lock(pool_mutex_);
-    return all_connections_.size();
+    return slots_ ? slots_->size() : 0;
+}
+
+ConnectionSlots::Stats DBConnectionPool::getSlotStats() const {
+    if (!slots_) {
+        return ConnectionSlots::Stats();
+    }
+    return slots_->stats();
 }
 
 void DBConnectionPool::cleanupIdleConnections(int idle_timeout_seconds) {
     std::lock_guard<std::mutex> lock(pool_mutex_);
     
-    if (!initialized_) {
+    if (!initialized_ || shutdown_requested_) {
         return;
     }
     
+    // 逐个取出当前空闲的连接，断开超时的，再全部归还；断开的连接在下次取用时重连
     auto now = std::chrono::system_clock::now();
     auto timeout = std::chrono::seconds(idle_timeout_seconds);
-    
-    std::queue<std::shared_ptr<DBConnection>> new_idle_queue;
-    
-    while (!idle_connections_.empty()) {
-        auto conn = idle_connections_.front();
-        idle_connections_.pop();
-        
-        if (now - conn->getLastUsedTime() < timeout) {
-            new_idle_queue.push(conn);
-        } else {
-            // 移除超时连接
-            auto it = std::find(all_connections_.begin(), all_connections_.end(), conn);
-            if (it != all_connections_.end()) {
-                all_connections_.erase(it);
-            }
-            LOG_DEBUG("Removed idle database connection due to timeout");
+    std::vector<uint32_t> claimed;
+    size_t closed = 0;
+    
+    for (uint32_t slot = slots_->tryAcquire(); slot != ConnectionSlots::kNoSlot; slot = slots_->tryAcquire()) {
+        claimed.push_back(slot);
+        DBConnection* conn = connections_[slot].get();
+        if (conn->isOpen() && now - conn->getLastUsedTime() >= timeout) {
+            conn->disconnect();
+            ++closed;
         }
     }
+    for (uint32_t slot : claimed) {
+        slots_->release(slot);
+    }
     
-    idle_connections_ = std::move(new_idle_queue);
+    if (closed > 0) {
+        LOG_DEBUG("Closed {} idle database connections due to timeout", closed);
+    }
 }
 
 void DBConnectionPool::shutdown() {
@@ -451,34 +452,81 @@ void DBConnectionPool::shutdown() {
     LOG_INFO("Shutting down database connection pool...");
     
     shutdown_requested_ = true;
-    pool_condition_.notify_all();
+    slots_->close();
     
-    // 清空连接池
-    while (!idle_connections_.empty()) {
-        idle_connections_.pop();
+    // 连接由池持有，销毁前等待借出的连接归还
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(config_.connect_timeout);
+    while (slots_->inUse() > 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
     
-    all_connections_.clear();
-    active_connections_ = 0;
+    // 只销毁已回到池中的连接；超时仍借出的连接保持存活，使用方稍后照常归还。
+    // 槽位保留到下次初始化，关闭后仍在途的 getConnection 只会取不到连接
+    std::vector<uint32_t> claimed;
+    for (uint32_t slot = slots_->tryAcquire(); slot != ConnectionSlots::kNoSlot; slot = slots_->tryAcquire()) {
+        claimed.push_back(slot);
+        connections_[slot].reset();
+    }
+    for (uint32_t slot : claimed) {
+        slots_->release(slot);
+    }
+    if (claimed.size() < connections_.size()) {
+        LOG_WARN("{} database connections still in use at shutdown, kept open until returned", 
+                 connections_.size() - claimed.size());
+    }
     initialized_ = false;
     
     LOG_INFO("Database connection pool shutdown completed");
 }
 
-std::shared_ptr<DBConnection> DBConnectionPool::createConnection() {
-    return std::make_shared<DBConnection>();
-}
-
-bool DBConnectionPool::validateConnection(std::shared_ptr<DBConnection> connection) {
-    if (!connection) {
-        return false;
+bool DBConnectionPool::validateConnection(DBConnection* connection) {
+    if (connection->isOpen() && connection->isConnected()) {
+        connection->markValidated();
+        return true;
     }
     
-    return connection->isConnected();
+    // 连接已失效，原地重连
+    connection->disconnect();
+    if (connection->connect(config_) != DBErrorCode::SUCCESS) {
+        LOG_ERROR("Failed to reconnect database connection {}", connection->getPoolSlot());
+        return false;
+    }
+    LOG_INFO("Database connection {} reconnected", connection->getPoolSlot());
+    return true;
 }
 
 // DatabaseManager实现
-DatabaseManager::DatabaseManager() : initialized_(false) {
+namespace {
+
+// market_data 表一行的列数，与 buildBatchInsertMarketDataSQL 的列顺序一致
+constexpr size_t kMarketDataColumns = 7;
+
+int64_t toEpochMicroseconds(const std::chrono::system_clock::time_point& tp) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(tp.time_since_epoch()).count();
+}
+
+// market_data 的二级索引，建表和回灌后重建共用
+struct IndexDefinition {
+    const char* name;
+    const char* columns;
+};
+
+// 按证券、类型和时间范围查询，走 idx_symbol_time
+constexpr char kQueryMarketDataSQL[] =
+    "SELECT symbol, market, type, timestamp, price, volume FROM market_data "
+    "WHERE symbol = ? AND type = ? AND timestamp BETWEEN ? AND ? ORDER BY timestamp";
+
+constexpr IndexDefinition kMarketDataIndexes[] = {
+    {"idx_symbol_time", "symbol, timestamp"},
+    {"idx_market_type", "market, type"},
+    {"idx_timestamp", "timestamp"}
+};
+
+} // namespace
+
+DatabaseManager::DatabaseManager() 
+    : connection_pool_(std::make_unique<DBConnectionPool>()), initialized_(false),
+      insert_chunk_size_(500), query_time_total_ms_(0.0) {
 }
 
 DatabaseManager::~DatabaseManager() {
@@ -494,9 +542,22 @@ bool DatabaseManager::initialize(const DBConfig& config) {
     LOG_INFO("Initializing database manager with MySQL Connector/C++ X DevAPI...");
     
     config_ = config;
+    insert_chunk_size_ = static_cast<size_t>(std::max(config.insert_chunk_size, 1));
+    chunk_insert_sql_ = buildBatchInsertMarketDataSQL(insert_chunk_size_);
+    
+    if (config.tick_cache_buckets > 0) {
+        TickCache::Options cache_options;
+        cache_options.bucket_count = config.tick_cache_buckets;
+        cache_options.bucket_ms = config.tick_cache_bucket_ms;
+        cache_options.max_ticks_per_bucket = config.tick_cache_max_ticks_per_bucket;
+        cache_options.max_total_ticks = static_cast<size_t>(std::max(config.tick_cache_max_ticks, 1));
+        tick_cache_ = std::make_unique<TickCache>(cache_options);
+        LOG_INFO("Tick cache enabled: {} buckets of {} ms per symbol, at most {} ticks", 
+                 config.tick_cache_buckets, config.tick_cache_bucket_ms, cache_options.max_total_ticks);
+    }
     
     // 初始化连接池
-    if (!connection_pool_.initialize(config)) {
+    if (!connection_pool_->initialize(config)) {
         LOG_ERROR("Failed to initialize database connection pool");
         return false;
     }
@@ -529,106 +590,443 @@ void DatabaseManager::shutdown() {
 }
 
 DBErrorCode DatabaseManager::saveMarketData(const MarketData& data) {
-auto conn = connection_pool_->getConnection();
+    return saveMarketDataBatch(std::vector<MarketData>(1, data));
+}
+
+DBErrorCode DatabaseManager::saveMarketDataBatch(const std::vector<MarketData>& data_batch) {
+    if (data_batch.empty()) {
+        return DBErrorCode::SUCCESS;
+    }
+    
+    // 整批使用同一个连接和事务，多个调用方并发写入时各自占用一个连接
+    auto conn = connection_pool_->getConnection();
     if (!conn) {
         LOG_ERROR("Failed to get database connection");
         return DBErrorCode::POOL_EXHAUSTED;
     }
     
-    std::ostringstream sql;
-    sql << "INSERT INTO market_data (symbol, market, type, timestamp, price, volume, "
-        << "turnover, bid_price, ask_price, bid_volume, ask_volume, created_at) VALUES ("
-        << "'" << conn->escapeString(data.symbol) << "', "
-        << static_cast<int>(data.market) << ", "
-        << static_cast<int>(data.type) << ", "
-        << data.timestamp << ", "
-        << std::fixed << std::setprecision(4) << data.price << ", "
-        << data.volume << ", "
-        << std::fixed << std::setprecision(4) << data.turnover << ", "
-        << std::fixed << std::setprecision(4) << data.bid_price << ", "
-        << std::fixed << std::setprecision(4) << data.ask_price << ", "
-        << data.bid_volume << ", "
-        << data.ask_volume << ", "
-        << "NOW())";
-    
-    auto result = conn->executeQuery(sql.str());
-    connection_pool_.returnConnection(conn);
+    auto start_time = std::chrono::steady_clock::now();
     
+    // 开始事务
+    auto result = conn->beginTransaction();
     if (result != DBErrorCode::SUCCESS) {
-        LOG_ERROR("Failed to save market data for symbol {}", data.symbol);
+        connection_pool_->returnConnection(conn);
+        return result;
+    }
+    
+    // 按 insert_chunk_size 行拆成多条多行 INSERT，参数绑定代替拼接和转义
+    std::vector<mysqlx::Value> params;
+    params.reserve(std::min(data_batch.size(), insert_chunk_size_) * kMarketDataColumns);
+    size_t statements = 0;
+    
+    for (size_t begin = 0; begin < data_batch.size() && result == DBErrorCode::SUCCESS; 
+         begin += insert_chunk_size_) {
+        size_t rows = std::min(insert_chunk_size_, data_batch.size() - begin);
+        
+        params.clear();
+        for (size_t i = begin; i < begin + rows; ++i) {
+            const auto& data = data_batch[i];
+            params.emplace_back(std::string(data.getSymbol()));
+            params.emplace_back(static_cast<int>(data.market));
+            params.emplace_back(static_cast<int>(data.data_type));
+            params.emplace_back(toEpochMicroseconds(data.timestamp));
+            params.emplace_back(data.price);
+            params.emplace_back(data.volume);
+            params.emplace_back(data.price * static_cast<double>(data.volume));
+        }
+        
+        // 整块复用初始化时生成的语句，只有最后不足一块时才另行生成
+        const std::string* sql = &chunk_insert_sql_;
+        std::string tail_sql;
+        if (rows != insert_chunk_size_) {
+            tail_sql = buildBatchInsertMarketDataSQL(rows);
+            sql = &tail_sql;
+        }
+        result = conn->executePreparedStatement(*sql, params);
+        ++statements;
+    }
+    
+    if (result == DBErrorCode::SUCCESS) {
+        result = conn->commitTransaction();
+    } else {
+        conn->rollbackTransaction();
+    }
+    connection_pool_->returnConnection(conn);
+    
+    auto elapsed = std::chrono::steady_clock::now() - start_time;
+    recordBatchInsert(result == DBErrorCode::SUCCESS, data_batch.size(), statements, elapsed);
+    
+    if (result == DBErrorCode::SUCCESS) {
+        if (tick_cache_) {
+            tick_cache_->insert(data_batch);
+        }
+        LOG_DEBUG("Saved {} market data records to database in {} statements", 
+                  data_batch.size(), statements);
+    } else {
+        LOG_ERROR("Failed to save {} market data records to database", data_batch.size());
     }
     
     return result;
 }
 
-DBErrorCode DatabaseManager::saveMarketDataBatch(const std::vector<MarketData>& data_batch) {
-    if (data_batch.empty()) {
+std::string DatabaseManager::buildBatchInsertMarketDataSQL(size_t row_count) {
+    static const char kRowPlaceholders[] = "(?, ?, ?, ?, ?, ?, ?)";
+    
+    std::string sql = "INSERT INTO market_data (symbol, market, type, timestamp, price, volume, turnover) VALUES ";
+    sql.reserve(sql.size() + row_count * (sizeof(kRowPlaceholders) + 1));
+    for (size_t i = 0; i < row_count; ++i) {
+        if (i > 0) {
+            sql += ", ";
+        }
+        sql += kRowPlaceholders;
+    }
+    return sql;
+}
+
+void DatabaseManager::recordBatchInsert(bool success, size_t rows, size_t statements,
+                                        std::chrono::steady_clock::duration elapsed) {
+    double elapsed_ms = std::chrono::duration<double, std::milli>(elapsed).count();
+    
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_.total_queries += statements;
+    if (success) {
+        stats_.successful_queries += statements;
+        stats_.rows_inserted += rows;
+        stats_.batches_inserted++;
+        stats_.insert_time_ms += elapsed_ms;
+        if (elapsed_ms > 0.0) {
+            stats_.last_batch_rows_per_second = rows * 1000.0 / elapsed_ms;
+        }
+        if (stats_.insert_time_ms > 0.0) {
+            stats_.rows_per_second = stats_.rows_inserted * 1000.0 / stats_.insert_time_ms;
+        }
+    } else {
+        stats_.failed_queries += statements;
+    }
+    
+    // 平均耗时按语句计
+    query_time_total_ms_ += elapsed_ms;
+    if (stats_.total_queries > 0) {
+        stats_.average_query_time_ms = query_time_total_ms_ / stats_.total_queries;
+    }
+}
+
+DBErrorCode DatabaseManager::queryMarketData(const std::string& symbol,
+                                             MarketDataType data_type,
+                                             const std::chrono::system_clock::time_point& start_time,
+                                             const std::chrono::system_clock::time_point& end_time,
+                                             std::vector<MarketData>& result) {
+    result.clear();
+    if (symbol.empty() || start_time > end_time) {
+        return DBErrorCode::INVALID_PARAM;
+    }
+    
+    // 最近窗口内的查询不访问数据库
+    if (tick_cache_ && tick_cache_->query(symbol, data_type, start_time, end_time, result)) {
         return DBErrorCode::SUCCESS;
     }
     
-    auto conn = connection_pool_.getConnection();
+    auto conn = connection_pool_->getConnection();
     if (!conn) {
         LOG_ERROR("Failed to get database connection");
         return DBErrorCode::POOL_EXHAUSTED;
     }
     
-    // 开始事务
-    auto tx_result = conn->beginTransaction();
-    if (tx_result != DBErrorCode::SUCCESS) {
-        connection_pool_.returnConnection(conn);
-        return tx_result;
+    auto query_start = std::chrono::steady_clock::now();
+    
+    std::vector<mysqlx::Value> params;
+    params.emplace_back(symbol);
+    params.emplace_back(static_cast<int>(data_type));
+    params.emplace_back(toEpochMicroseconds(start_time));
+    params.emplace_back(toEpochMicroseconds(end_time));
+    
+    mysqlx::SqlResult rows;
+    auto status = conn->executePreparedStatement(kQueryMarketDataSQL, params, rows);
+    if (status == DBErrorCode::SUCCESS && !parseMarketDataResult(rows, result)) {
+        status = DBErrorCode::QUERY_FAILED;
+    }
+    connection_pool_->returnConnection(conn);
+    
+    double elapsed_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - query_start).count();
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.total_queries++;
+        if (status == DBErrorCode::SUCCESS) {
+            stats_.successful_queries++;
+        } else {
+            stats_.failed_queries++;
+        }
+        query_time_total_ms_ += elapsed_ms;
+        stats_.average_query_time_ms = query_time_total_ms_ / stats_.total_queries;
     }
     
+    if (status != DBErrorCode::SUCCESS) {
+        result.clear();
+        LOG_ERROR("Failed to query market data for {}", symbol);
+    }
+    return status;
+}
+
+void DatabaseManager::dropCachedMarketData(const std::vector<std::string>& symbols) {
+    if (!tick_cache_) {
+        return;
+    }
+    if (symbols.empty()) {
+        tick_cache_->clear();
+    } else {
+        tick_cache_->drop(symbols);
+    }
+}
+
+bool DatabaseManager::parseMarketDataResult(mysqlx::SqlResult& result, std::vector<MarketData>& data) {
     try {
-        // 构建批量插入SQL
-        std::ostringstream sql;
-        sql << "INSERT INTO market_data (symbol, market, type, timestamp, price, volume, "
-            << "turnover, bid_price, ask_price, bid_volume, ask_volume, created_at) VALUES ";
-        
-        for (size_t i = 0; i < data_batch.size(); ++i) {
-            const auto& data = data_batch[i];
-            
-            if (i > 0) {
-                sql << ", ";
-            }
-            
-            sql << "('"
-                << conn->escapeString(data.symbol) << "', "
-                << static_cast<int>(data.market) << ", "
-                << static_cast<int>(data.type) << ", "
-                << data.timestamp << ", "
-                << std::fixed << std::setprecision(4) << data.price << ", "
-                << data.volume << ", "
-                << std::fixed << std::setprecision(4) << data.turnover << ", "
-                << std::fixed << std::setprecision(4) << data.bid_price << ", "
-                << std::fixed << std::setprecision(4) << data.ask_price << ", "
-                << data.bid_volume << ", "
-                << data.ask_volume << ", "
-                << "NOW())";
-        }
-        
-        auto result = conn->executeQuery(sql.str());
-        if (result == DBErrorCode::SUCCESS) {
-            conn->commitTransaction();
-            LOG_DEBUG("Saved {} market data records to database", data_batch.size());
-        } else {
-            conn->rollbackTransaction();
-            LOG_ERROR("Failed to save {} market data records to database", data_batch.size());
+        // 列顺序与 kQueryMarketDataSQL 一致，时间戳按微秒整数存储，不需要字符串解析
+        for (auto row : result.fetchAll()) {
+            MarketData item;
+            item.setSymbol(row[0].get<std::string>());
+            item.market = static_cast<MarketType>(row[1].get<int>());
+            item.data_type = static_cast<MarketDataType>(row[2].get<int>());
+            item.timestamp = std::chrono::system_clock::time_point(
+                std::chrono::microseconds(row[3].get<int64_t>()));
+            item.price = row[4].get<double>();
+            item.volume = row[5].get<uint64_t>();
+            data.push_back(item);
         }
-        
-        connection_pool_.returnConnection(conn);
+        return true;
+    } catch (const std::exception& e) {
+        LOG_ERROR("Failed to parse market data result: {}", e.what());
+        return false;
+    }
+}
+
+DBErrorCode DatabaseManager::loadMarketDataFile(const std::string& path, size_t rows) {
+    // 路径直接拼进语句，拒绝需要转义的字符
+    if (path.empty() || path.find_first_of("'\\") != std::string::npos) {
+        LOG_ERROR("Invalid bulk load file path: {}", path);
+        return DBErrorCode::INVALID_PARAM;
+    }
+    
+    auto conn = connection_pool_->getConnection();
+    if (!conn) {
+        LOG_ERROR("Failed to get database connection");
+        return DBErrorCode::POOL_EXHAUSTED;
+    }
+    
+    auto start_time = std::chrono::steady_clock::now();
+    
+    // 表上只有自增主键，导入期间关闭唯一性和外键检查
+    conn->executeQuery("SET SESSION unique_checks = 0, foreign_key_checks = 0");
+    
+    // 文件格式与 MarketDataBulkLoader::writeRow 一致；X 协议不支持 LOCAL，由服务端直接读取文件
+    std::string sql = "LOAD DATA INFILE '" + path + "' INTO TABLE market_data CHARACTER SET utf8mb4 "
+                      "FIELDS TERMINATED BY '\\t' ESCAPED BY '\\\\' LINES TERMINATED BY '\\n' "
+                      "(symbol, market, type, timestamp, price, volume, turnover)";
+    auto result = conn->executeQuery(sql);
+    
+    conn->executeQuery("SET SESSION unique_checks = 1, foreign_key_checks = 1");
+    connection_pool_->returnConnection(conn);
+    
+    // 导入的数据不经过缓存，已缓存的时间段不再完整
+    if (tick_cache_) {
+        tick_cache_->invalidate();
+    }
+    
+    recordBulkLoad(result == DBErrorCode::SUCCESS, rows, std::chrono::steady_clock::now() - start_time);
+    
+    if (result == DBErrorCode::SUCCESS) {
+        LOG_DEBUG("Loaded {} market data records from {}", rows, path);
+    } else {
+        LOG_ERROR("Failed to load market data records from {}", path);
+    }
+    return result;
+}
+
+DBErrorCode DatabaseManager::bulkInsertMarketData(const std::vector<MarketData>& data_batch) {
+    if (data_batch.empty()) {
+        return DBErrorCode::SUCCESS;
+    }
+    
+    auto conn = connection_pool_->getConnection();
+    if (!conn) {
+        LOG_ERROR("Failed to get database connection");
+        return DBErrorCode::POOL_EXHAUSTED;
+    }
+    
+    auto start_time = std::chrono::steady_clock::now();
+    
+    auto result = conn->beginTransaction();
+    if (result != DBErrorCode::SUCCESS) {
+        connection_pool_->returnConnection(conn);
         return result;
-        
+    }
+    
+    // 整批作为一条 CRUD 插入消息发送，不经过 SQL 解析和占位符绑定
+    try {
+        auto table = conn->getSession()->getSchema(config_.database).getTable("market_data");
+        auto insert = table.insert("symbol", "market", "type", "timestamp", "price", "volume", "turnover");
+        for (const auto& data : data_batch) {
+            insert.values(std::string(data.getSymbol()),
+                          static_cast<int>(data.market),
+                          static_cast<int>(data.data_type),
+                          toEpochMicroseconds(data.timestamp),
+                          data.price,
+                          data.volume,
+                          data.price * static_cast<double>(data.volume));
+        }
+        insert.execute();
+    } catch (const mysqlx::Error& e) {
+        LOG_ERROR("Failed to bulk insert market data: {}", e.what());
+        result = DBErrorCode::QUERY_FAILED;
     } catch (const std::exception& e) {
+        LOG_ERROR("Failed to bulk insert market data: {}", e.what());
+        result = DBErrorCode::QUERY_FAILED;
+    }
+    
+    if (result == DBErrorCode::SUCCESS) {
+        result = conn->commitTransaction();
+    } else {
         conn->rollbackTransaction();
-        connection_pool_.returnConnection(conn);
-        LOG_ERROR("Exception during batch insert: {}", e.what());
+    }
+    connection_pool_->returnConnection(conn);
+    
+    if (tick_cache_) {
+        tick_cache_->invalidate();
+    }
+    
+    recordBulkLoad(result == DBErrorCode::SUCCESS, data_batch.size(), 
+                   std::chrono::steady_clock::now() - start_time);
+    
+    if (result == DBErrorCode::SUCCESS) {
+        LOG_DEBUG("Bulk inserted {} market data records", data_batch.size());
+    }
+    return result;
+}
+
+DBErrorCode DatabaseManager::dropMarketDataIndexes() {
+    auto conn = connection_pool_->getConnection();
+    if (!conn) {
+        LOG_ERROR("Failed to get database connection");
+        return DBErrorCode::POOL_EXHAUSTED;
+    }
+    
+    std::vector<std::string> existing;
+    if (!getMarketDataIndexes(conn, existing)) {
+        connection_pool_->returnConnection(conn);
+        return DBErrorCode::QUERY_FAILED;
+    }
+    
+    std::string sql;
+    for (const auto& index : kMarketDataIndexes) {
+        if (std::find(existing.begin(), existing.end(), index.name) != existing.end()) {
+            sql += sql.empty() ? "ALTER TABLE market_data DROP INDEX " : ", DROP INDEX ";
+            sql += index.name;
+        }
+    }
+    
+    auto result = sql.empty() ? DBErrorCode::SUCCESS : conn->executeQuery(sql);
+    connection_pool_->returnConnection(conn);
+    
+    if (result == DBErrorCode::SUCCESS) {
+        LOG_INFO("Secondary indexes of market_data dropped for bulk load");
+    } else {
+        LOG_ERROR("Failed to drop secondary indexes of market_data");
+    }
+    return result;
+}
+
+DBErrorCode DatabaseManager::restoreMarketDataIndexes() {
+    auto conn = connection_pool_->getConnection();
+    if (!conn) {
+        LOG_ERROR("Failed to get database connection");
+        return DBErrorCode::POOL_EXHAUSTED;
+    }
+    
+    std::vector<std::string> existing;
+    if (!getMarketDataIndexes(conn, existing)) {
+        connection_pool_->returnConnection(conn);
         return DBErrorCode::QUERY_FAILED;
     }
+    
+    // 缺失的索引在一条 ALTER TABLE 中重建，只扫描一遍表
+    std::string sql;
+    for (const auto& index : kMarketDataIndexes) {
+        if (std::find(existing.begin(), existing.end(), index.name) == existing.end()) {
+            sql += sql.empty() ? "ALTER TABLE market_data ADD INDEX " : ", ADD INDEX ";
+            sql += std::string(index.name) + " (" + index.columns + ")";
+        }
+    }
+    
+    auto start_time = std::chrono::steady_clock::now();
+    auto result = sql.empty() ? DBErrorCode::SUCCESS : conn->executeQuery(sql);
+    connection_pool_->returnConnection(conn);
+    
+    if (result == DBErrorCode::SUCCESS) {
+        LOG_INFO("Secondary indexes of market_data restored in {} ms",
+                 std::chrono::duration_cast<std::chrono::milliseconds>(
+                     std::chrono::steady_clock::now() - start_time).count());
+    } else {
+        LOG_ERROR("Failed to restore secondary indexes of market_data");
+    }
+    return result;
+}
+
+bool DatabaseManager::getMarketDataIndexes(DBConnection* conn, std::vector<std::string>& names) {
+    mysqlx::SqlResult result;
+    if (conn->executeQuery("SELECT DISTINCT INDEX_NAME FROM information_schema.STATISTICS "
+                           "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = 'market_data'", result) != DBErrorCode::SUCCESS) {
+        return false;
+    }
+    
+    names.clear();
+    for (auto row : result.fetchAll()) {
+        names.push_back(row[0].get<std::string>());
+    }
+    return true;
+}
+
+void DatabaseManager::recordBulkLoad(bool success, size_t rows, std::chrono::steady_clock::duration elapsed) {
+    double elapsed_ms = std::chrono::duration<double, std::milli>(elapsed).count();
+    
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_.total_queries++;
+    if (success) {
+        stats_.successful_queries++;
+        stats_.bulk_rows_loaded += rows;
+        stats_.bulk_loads++;
+        stats_.bulk_load_time_ms += elapsed_ms;
+        if (stats_.bulk_load_time_ms > 0.0) {
+            stats_.bulk_rows_per_second = stats_.bulk_rows_loaded * 1000.0 / stats_.bulk_load_time_ms;
+        }
+    } else {
+        stats_.failed_queries++;
+    }
+    
+    query_time_total_ms_ += elapsed_ms;
+    stats_.average_query_time_ms = query_time_total_ms_ / stats_.total_queries;
+}
+
+DatabaseManager::DBStatistics DatabaseManager::getStatistics() const {
+    DBStatistics stats;
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats = stats_;
+    }
+    stats.active_connections = connection_pool_->getActiveConnections();
+    stats.idle_connections = connection_pool_->getIdleConnections();
+    if (tick_cache_) {
+        auto cache_stats = tick_cache_->getStats();
+        stats.cache_hits = cache_stats.hits;
+        stats.cache_misses = cache_stats.misses;
+        stats.cache_hit_ratio = cache_stats.hit_ratio;
+        stats.cache_ticks = cache_stats.ticks;
+        stats.cache_evicted_series = cache_stats.evicted_series;
+    }
+    return stats;
 }
 
 bool DatabaseManager::createTables() {
-    auto conn = connection_pool_.getConnection();
+    auto conn = connection_pool_->getConnection();
     if (!conn) {
         LOG_ERROR("Failed to get database connection for table creation");
         return false;
@@ -641,7 +1039,7 @@ bool DatabaseManager::createTables() {
             symbol VARCHAR(32) NOT NULL,
             market TINYINT NOT NULL,
             type TINYINT NOT NULL,
-            timestamp BIGINT NOT NULL,
+            timestamp BIGINT NOT NULL COMMENT 'epoch microseconds',
             price DECIMAL(10,4) NOT NULL,
             volume BIGINT NOT NULL,
             turnover DECIMAL(15,4) NOT NULL,
@@ -649,16 +1047,17 @@ bool DatabaseManager::createTables() {
             ask_price DECIMAL(10,4) DEFAULT 0,
             bid_volume BIGINT DEFAULT 0,
             ask_volume BIGINT DEFAULT 0,
-            created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
-            INDEX idx_symbol_time (symbol, timestamp),
-            INDEX idx_market_type (market, type),
-            INDEX idx_timestamp (timestamp)
+            created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP)";
+    for (const auto& index : kMarketDataIndexes) {
+        create_market_data_table += ",\n            INDEX " + std::string(index.name) + " (" + index.columns + ")";
+    }
+    create_market_data_table += R"(
         ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4
     )";
     
     if (conn->executeQuery(create_market_data_table) != DBErrorCode::SUCCESS) {
         LOG_ERROR("Failed to create market_data table");
-        connection_pool_.returnConnection(conn);
+        connection_pool_->returnConnection(conn);
         return false;
     }
     
@@ -681,7 +1080,7 @@ bool DatabaseManager::createTables() {
     
     if (conn->executeQuery(create_stats_table) != DBErrorCode::SUCCESS) {
         LOG_ERROR("Failed to create process_statistics table");
-        connection_pool_.returnConnection(conn);
+        connection_pool_->returnConnection(conn);
         return false;
     }
     
@@ -702,24 +1101,24 @@ bool DatabaseManager::createTables() {
     
     if (conn->executeQuery(create_process_table) != DBErrorCode::SUCCESS) {
         LOG_ERROR("Failed to create process_info table");
-        connection_pool_.returnConnection(conn);
+        connection_pool_->returnConnection(conn);
         return false;
     }
     
-    connection_pool_.returnConnection(conn);
+    connection_pool_->returnConnection(conn);
     
     LOG_INFO("Database tables created successfully");
     return true;
 }
 
 bool DatabaseManager::checkConnection() {
-    auto conn = connection_pool_.getConnection();
+    auto conn = connection_pool_->getConnection();
     if (!conn) {
         return false;
     }
     
     bool result = conn->isConnected();
-    connection_pool_.returnConnection(conn);
+    connection_pool_->returnConnection(conn);
     
     return result;
 }
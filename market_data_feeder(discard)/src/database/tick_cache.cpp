@@ -0,0 +1,277 @@
+#include "database/tick_cache.h"
+#include <algorithm>
+#include <unordered_set>
+
+namespace market_feeder {
+
+TickCache::TickCache(const Options& options)
+    : options_(options), invalid_before_(0), total_ticks_(0), hits_(0), misses_(0), evicted_series_(0) {
+    options_.bucket_ms = std::max(options_.bucket_ms, 1);
+    options_.bucket_count = std::max(options_.bucket_count, 1);
+    options_.max_ticks_per_bucket = std::max(options_.max_ticks_per_bucket, 1);
+    options_.max_total_ticks = std::max<size_t>(options_.max_total_ticks, 1);
+    bucket_us_ = static_cast<int64_t>(options_.bucket_ms) * 1000;
+}
+
+int64_t TickCache::bucketOf(const std::chrono::system_clock::time_point& tp) const {
+    int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(tp.time_since_epoch()).count();
+    return us >= 0 ? us / bucket_us_ : -1;
+}
+
+std::string TickCache::makeKey(std::string_view symbol, MarketDataType data_type) const {
+    std::string key(symbol);
+    key += '#';
+    key += static_cast<char>('0' + static_cast<int>(data_type));
+    return key;
+}
+
+std::shared_ptr<TickCache::Series> TickCache::findOrCreate(const std::string& key, int64_t first_bucket) {
+    {
+        std::shared_lock<std::shared_mutex> lock(series_mutex_);
+        auto it = series_.find(key);
+        if (it != series_.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(series_mutex_);
+    auto& series = series_[key];
+    if (!series) {
+        series = std::make_shared<Series>();
+        series->buckets.resize(static_cast<size_t>(options_.bucket_count));
+        // 第一个桶里可能有缓存开始前已写入数据库的数据，从下一个桶起才完整
+        series->complete_from = std::max(first_bucket + 1, invalid_before_.load(std::memory_order_relaxed));
+    }
+    return series;
+}
+
+void TickCache::insert(const std::vector<MarketData>& data_batch) {
+    // 批次内通常是同一证券的连续行情，相邻同键时复用上一次查到的序列
+    std::string last_key;
+    std::shared_ptr<Series> series;
+    std::unique_lock<std::mutex> series_lock;
+
+    for (const auto& data : data_batch) {
+        int64_t bucket_id = bucketOf(data.timestamp);
+        if (bucket_id < 0) {
+            continue;
+        }
+
+        std::string key = makeKey(data.getSymbol(), data.data_type);
+        if (!series || key != last_key) {
+            if (series_lock.owns_lock()) {
+                series_lock.unlock();
+            }
+            series = findOrCreate(key, bucket_id);
+            series_lock = std::unique_lock<std::mutex>(series->mutex);
+            last_key = std::move(key);
+        }
+        insertLocked(*series, bucket_id, data);
+    }
+    if (series_lock.owns_lock()) {
+        series_lock.unlock();
+    }
+
+    if (total_ticks_.load(std::memory_order_relaxed) > options_.max_total_ticks) {
+        evict();
+    }
+}
+
+void TickCache::insertLocked(Series& series, int64_t bucket_id, const MarketData& data) {
+    const int64_t count = options_.bucket_count;
+    if (series.detached) {
+        // 已被淘汰或移除，下一批写入会重新建序列
+        return;
+    }
+    if (series.newest_bucket >= 0 && bucket_id <= series.newest_bucket - count) {
+        // 早于窗口的迟到数据，窗口内查询不会用到
+        return;
+    }
+
+    Bucket& bucket = series.buckets[static_cast<size_t>(bucket_id % count)];
+    if (bucket.id != bucket_id) {
+        // 环上这个位置还是更早的桶，整桶淘汰。
+        // 突发行情撑大的桶在之后的平静时段归还多余容量
+        size_t used = bucket.ticks.size();
+        series.ticks -= used;
+        total_ticks_.fetch_sub(used, std::memory_order_relaxed);
+        bucket.ticks.clear();
+        if (bucket.ticks.capacity() > std::max<size_t>(used * 2, 64)) {
+            bucket.ticks.shrink_to_fit();
+        }
+        bucket.truncated = false;
+        bucket.id = bucket_id;
+    }
+    series.newest_bucket = std::max(series.newest_bucket, bucket_id);
+
+    if (bucket.ticks.size() >= static_cast<size_t>(options_.max_ticks_per_bucket)) {
+        bucket.truncated = true;
+        return;
+    }
+
+    bucket.ticks.push_back(data);
+    // 原始数据在提交后就归还了内存池，缓存里不保留引用
+    bucket.ticks.back().raw_data = RawDataRef();
+    series.ticks++;
+    total_ticks_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TickCache::detach(Series& series) {
+    std::lock_guard<std::mutex> lock(series.mutex);
+    total_ticks_.fetch_sub(series.ticks, std::memory_order_relaxed);
+    series.ticks = 0;
+    series.detached = true;
+}
+
+void TickCache::evict() {
+    std::unique_lock<std::mutex> evict_lock(evict_mutex_, std::try_to_lock);
+    if (!evict_lock.owns_lock()) {
+        return;
+    }
+
+    // 淘汰到上限的九成，避免每批写入都触发淘汰
+    const size_t target = options_.max_total_ticks - options_.max_total_ticks / 10;
+
+    std::unique_lock<std::shared_mutex> lock(series_mutex_);
+    std::vector<std::pair<int64_t, decltype(series_)::iterator>> order;
+    order.reserve(series_.size());
+    for (auto it = series_.begin(); it != series_.end(); ++it) {
+        std::lock_guard<std::mutex> series_lock(it->second->mutex);
+        order.emplace_back(it->second->newest_bucket, it);
+    }
+    std::sort(order.begin(), order.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    for (const auto& entry : order) {
+        if (total_ticks_.load(std::memory_order_relaxed) <= target) {
+            break;
+        }
+        detach(*entry.second->second);
+        series_.erase(entry.second);
+        evicted_series_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool TickCache::query(const std::string& symbol, MarketDataType data_type,
+                      const std::chrono::system_clock::time_point& start_time,
+                      const std::chrono::system_clock::time_point& end_time,
+                      std::vector<MarketData>& result) {
+    int64_t start_bucket = bucketOf(start_time);
+    int64_t end_bucket = bucketOf(end_time);
+
+    std::shared_ptr<Series> series;
+    if (start_bucket >= 0 && end_bucket >= start_bucket) {
+        std::shared_lock<std::shared_mutex> lock(series_mutex_);
+        auto it = series_.find(makeKey(symbol, data_type));
+        if (it != series_.end()) {
+            series = it->second;
+        }
+    }
+    if (!series) {
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    size_t first = result.size();
+    {
+        std::lock_guard<std::mutex> lock(series->mutex);
+        const int64_t count = options_.bucket_count;
+        int64_t window_first = std::max(series->complete_from, series->newest_bucket - count + 1);
+        if (series->newest_bucket < 0 || start_bucket < window_first) {
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        // 查询范围内已经过去的桶晚于最新缓存桶：无法区分没有成交与不再写入（换主后序列停止更新），
+        // 交给 SQL；只有尚未结束的当前桶允许缓存里还没有数据
+        int64_t settled = std::min(end_bucket, bucketOf(std::chrono::system_clock::now()) - 1);
+        if (settled > series->newest_bucket) {
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        int64_t last = std::min(end_bucket, series->newest_bucket);
+        for (int64_t bucket_id = start_bucket; bucket_id <= last; ++bucket_id) {
+            const Bucket& bucket = series->buckets[static_cast<size_t>(bucket_id % count)];
+            if (bucket.id != bucket_id) {
+                // 这个时间段没有数据
+                continue;
+            }
+            if (bucket.truncated) {
+                result.resize(first);
+                misses_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            for (const auto& data : bucket.ticks) {
+                if (data.timestamp >= start_time && data.timestamp <= end_time) {
+                    result.push_back(data);
+                }
+            }
+        }
+    }
+
+    // 多个写库线程并发提交，桶内不保证时间顺序；与 SQL 的 ORDER BY timestamp 一致
+    std::stable_sort(result.begin() + static_cast<std::ptrdiff_t>(first), result.end(),
+                     [](const MarketData& a, const MarketData& b) { return a.timestamp < b.timestamp; });
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void TickCache::invalidate() {
+    int64_t now_bucket = bucketOf(std::chrono::system_clock::now());
+    invalid_before_.store(now_bucket + 1, std::memory_order_relaxed);
+
+    std::shared_lock<std::shared_mutex> lock(series_mutex_);
+    for (auto& entry : series_) {
+        Series& series = *entry.second;
+        std::lock_guard<std::mutex> series_lock(series.mutex);
+        series.complete_from = std::max({series.complete_from, series.newest_bucket + 1, now_bucket + 1});
+    }
+}
+
+void TickCache::drop(const std::vector<std::string>& symbols) {
+    if (symbols.empty()) {
+        return;
+    }
+    std::unordered_set<std::string_view> dropped(symbols.begin(), symbols.end());
+
+    // 键为 证券代码#类型，按最后一个 # 之前的部分匹配
+    std::unique_lock<std::shared_mutex> lock(series_mutex_);
+    for (auto it = series_.begin(); it != series_.end();) {
+        std::string_view key(it->first);
+        if (dropped.count(key.substr(0, key.rfind('#')))) {
+            detach(*it->second);
+            it = series_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void TickCache::clear() {
+    std::unique_lock<std::shared_mutex> lock(series_mutex_);
+    for (auto& entry : series_) {
+        detach(*entry.second);
+    }
+    series_.clear();
+}
+
+TickCache::Stats TickCache::getStats() const {
+    Stats stats;
+    stats.hits = hits_.load(std::memory_order_relaxed);
+    stats.misses = misses_.load(std::memory_order_relaxed);
+    uint64_t total = stats.hits + stats.misses;
+    stats.hit_ratio = total > 0 ? static_cast<double>(stats.hits) / static_cast<double>(total) : 0.0;
+    stats.ticks = 0;
+    stats.evicted_series = evicted_series_.load(std::memory_order_relaxed);
+
+    std::shared_lock<std::shared_mutex> lock(series_mutex_);
+    stats.series = series_.size();
+    for (const auto& entry : series_) {
+        std::lock_guard<std::mutex> series_lock(entry.second->mutex);
+        stats.ticks += entry.second->ticks;
+    }
+    return stats;
+}
+
+} // namespace market_feeder
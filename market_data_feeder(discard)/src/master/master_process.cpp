@@ -2,6 +2,8 @@
 #include "common/logger.h"
 #include "common/config_manager.h"
 #include "common/ipc_manager.h"
+#include "common/tick_journal.h"
+#include "common/symbol_router.h"
 #include <sys/wait.h>
 #include <sys/stat.h>
 #include <sys/resource.h>
@@ -21,6 +23,11 @@ static volatile sig_atomic_t g_shutdown_requested = 0;
 static volatile sig_atomic_t g_reload_requested = 0;
 static volatile sig_atomic_t g_child_exited = 0;
 
+// 工作进程启动后存活不到 kHealthyUptimeSeconds 秒即退出记为一次启动失败，
+// 连续 kMaxFailedStarts 次后不再重启，把它的证券分给其余工作进程
+static constexpr int kHealthyUptimeSeconds = 30;
+static constexpr int kMaxFailedStarts = 3;
+
 // 信号处理函数
 void signal_handler(int sig) {
     switch (sig) {
@@ -41,7 +48,7 @@ void signal_handler(int sig) {
 
 MasterProcess::MasterProcess() 
     : running_(false), shutdown_requested_(false), reload_requested_(false),
-      target_worker_count_(0) {
+      target_worker_count_(0), shard_members_(0) {
 }
 
 MasterProcess::~MasterProcess() {
@@ -161,7 +168,10 @@ bool MasterProcess::reloadConfig() {
     }
     
     // 设置重载标志
-    IPCManager::getInstance().setReloadFlag(true);
+    IPCManager::getInstance().setReloadConfigFlag(true);
+    
+    // worker_processes 变化时增减工作进程并重新分片
+    adjustWorkerCount();
     
     // 向所有工作进程发送重载信号
     for (const auto& worker : worker_processes_) {
@@ -342,6 +352,13 @@ void MasterProcess::setupSignalHandlers() {
 bool MasterProcess::createWorkerProcesses() {
     LOG_INFO("Creating {} worker processes...", worker_count_);
     
+    // fork 之前发布分片成员，工作进程启动时即按它订阅自己的分片
+    shard_members_ = 0;
+    for (int i = 0; i < worker_count_; ++i) {
+        shard_members_ |= SymbolRouter::memberBit(i + 1);
+    }
+    IPCManager::getInstance().publishShardMembers(shard_members_);
+    
     for (int i = 0; i < worker_count_; ++i) {
         if (!createWorkerProcess(i + 1)) {
             LOG_ERROR("Failed to create worker process {}", i);
@@ -386,6 +403,26 @@ bool MasterProcess::createWorkerProcess(int worker_id) {
     return true;
 }
 
+bool MasterProcess::restartWorkerProcess(int worker_id) {
+    // 日志由新的工作进程在连上数据库后从检查点重放，这里只报告待重放的量
+    const auto& config = ConfigManager::getInstance().getConfig();
+    if (config.journal.enabled) {
+        uint64_t pending = TickJournal::pendingRecords(
+            TickJournal::workerDirectory(config.journal.directory, worker_id));
+        if (pending > 0) {
+            LOG_WARN("Worker process {} left {} journaled records unsaved, they will be replayed on restart", 
+                     worker_id, pending);
+        }
+    }
+    
+    int restart_count = workers_.count(worker_id) ? workers_[worker_id].restart_count : 0;
+    if (!createWorkerProcess(worker_id)) {
+        return false;
+    }
+    workers_[worker_id].restart_count = restart_count;
+    return true;
+}
+
 void MasterProcess::execWorkerProcess(int worker_id) {
     // 设置进程标题
     setProcessTitle(fmt::format("market_feeder: worker process {}", worker_id));
@@ -441,7 +478,7 @@ void MasterProcess::monitorWorkerProcesses() {
         }
         
         // 处理IPC消息
-        processMessages();
+        processIPCMessages();
         
         // 监控工作进程
         monitorWorkerProcesses();
@@ -479,64 +516,128 @@ void MasterProcess::handleDeadWorker(pid_t pid) {
             // 从IPC管理器中移除
             IPCManager::getInstance().removeWorkerProcess(pid);
             
-            // 检查是否需要重启
-            if (running_ && !IPCManager::getInstance().getShutdownFlag()) {
-                LOG_WARN("Worker process {} (pid={}) died unexpectedly, restarting...", 
-                         worker_id, pid);
+            // 检查是否需要重启；已被 adjustWorkerCount 移出分片的工作进程不再重启
+            bool retired = (shard_members_ & SymbolRouter::memberBit(worker_id)) == 0;
+            if (running_ && !retired && !IPCManager::getInstance().getShutdownFlag()) {
+                // 启动后很快退出（例如初始化失败）时重启也无济于事，计数达到上限后不再重启
+                if (time(nullptr) - worker_info.start_time < kHealthyUptimeSeconds) {
+                    ++failed_starts_[worker_id];
+                } else {
+                    failed_starts_[worker_id] = 0;
+                }
                 
                 worker_info.restart_count++;
                 
-                // 重启工作进程
-                if (createWorkerProcess(worker_id)) {
-                    LOG_INFO("Worker process {} restarted successfully", worker_id);
+                // 重启工作进程：新进程按原分片订阅，其余工作进程不必调整
+                if (failed_starts_[worker_id] >= kMaxFailedStarts) {
+                    LOG_ERROR("Worker process {} (pid={}) failed to start {} times in a row, rebalancing its symbols", 
+                              worker_id, pid, failed_starts_[worker_id]);
+                    retireWorker(worker_id);
+                } else if (restartWorkerProcess(worker_id)) {
+                    LOG_WARN("Worker process {} (pid={}) died unexpectedly, restarted", worker_id, pid);
                 } else {
-                    LOG_ERROR("Failed to restart worker process {}", worker_id);
+                    // 重启失败时把它的证券分给其余工作进程
+                    LOG_ERROR("Failed to restart worker process {}, rebalancing its symbols", worker_id);
+                    retireWorker(worker_id);
                 }
             } else {
                 // 正常关闭，移除工作进程记录
+                failed_starts_.erase(worker_id);
                 workers_.erase(it);
             }
         }
     }
 }
 
+void MasterProcess::retireWorker(int worker_id) {
+    shard_members_ &= ~SymbolRouter::memberBit(worker_id);
+    IPCManager::getInstance().publishShardMembers(shard_members_);
+    failed_starts_.erase(worker_id);
+    workers_.erase(worker_id);
+}
+
 void MasterProcess::processIPCMessages() {
     IPCMessage message;
     
-    // 处理所有待处理的消息
-    while (IPCManager::getInstance().receiveMessage(message, MessageType::ANY, false)) {
-        switch (message.type) {
-            case MessageType::HEARTBEAT:
-                handleHeartbeat(message);
-                break;
-            case MessageType::STATUS_UPDATE:
-                handleStatusUpdate(message);
-                break;
-            case MessageType::ERROR_REPORT:
-                handleErrorReport(message);
-                break;
-            case MessageType::STATISTICS:
-                handleStatistics(message);
-                break;
-            default:
-                LOG_WARN("Unknown message type: {}", static_cast<int>(message.type));
-                break;
-        }
+    // 控制队列由主进程和工作进程共用，按类型取出发给主进程的消息，
+    // 不会取走发给工作进程的 SHUTDOWN / RELOAD_CONFIG
+    auto& ipc = IPCManager::getInstance();
+    while (ipc.receiveMessage(message, IPCMessageType::HEARTBEAT, false)) {
+        handleHeartbeatMessage(message);
+    }
+    while (ipc.receiveMessage(message, IPCMessageType::STATISTICS, false)) {
+        handleStatisticsMessage(message);
+    }
+    while (ipc.receiveMessage(message, IPCMessageType::ERROR_REPORT, false)) {
+        handleErrorReportMessage(message);
     }
 }
 
 void MasterProcess::handleHeartbeatMessage(const IPCMessage& message) {
-    // 更新工作进程心跳时间
-    IPCManager::getInstance().updateWorkerStatus(message.sender_pid, ProcessStatus::RUNNING);
+    // 更新工作进程心跳时间，只写该进程自己的槽位
+    IPCManager::getInstance().updateProcessHeartbeat(message.sender_pid);
     
     LOG_TRACE("Heartbeat received from worker process {}", message.sender_pid);
 }
 
 void MasterProcess::handleStatisticsMessage(const IPCMessage& message) {
-    ProcessStatus status = static_cast<ProcessStatus>(message.data.status_data.status);
-    IPCManager::getInstance().updateWorkerStatus(message.sender_pid, status);
+    if (message.data_size != sizeof(LatencyReport)) {
+        LOG_WARN("Ignoring statistics message of {} bytes from pid {}", message.data_size, message.sender_pid);
+        return;
+    }
+    
+    LatencyReport report;
+    memcpy(&report, message.data, sizeof(LatencyReport));
+    latency_reports_[report.worker_id] = {report, std::chrono::steady_clock::now()};
+    
+    LOG_TRACE("Latency report received from worker {}", report.worker_id);
+    writeLatencyStats();
+}
+
+void MasterProcess::writeLatencyStats() {
+    const auto& path = ConfigManager::getInstance().getConfig().monitoring.latency_stats_file;
+    if (path.empty()) {
+        return;
+    }
+    
+    // 超过三个统计周期没有上报的工作进程（已退出或已缩容）不再导出
+    const auto& monitoring = ConfigManager::getInstance().getConfig().monitoring;
+    auto expiry = std::chrono::seconds(std::max(monitoring.stats_interval, 1) * 3);
+    auto now = std::chrono::steady_clock::now();
+    for (auto it = latency_reports_.begin(); it != latency_reports_.end();) {
+        if (now - it->second.second > expiry) {
+            it = latency_reports_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    
+    // 先写临时文件再改名，读方（system_monitor）不会读到写了一半的文件
+    std::string temp_path = path + ".tmp";
+    std::ofstream file(temp_path, std::ios::trunc);
+    if (!file) {
+        LOG_WARN("Failed to write latency stats {}: {}", temp_path, strerror(errno));
+        return;
+    }
+    
+    file << "# market_feeder latency v1\n";
+    file << "# source site window_ms count mean_ns p50_ns p99_ns p999_ns max_ns\n";
+    file << "# writer_queue_depth values are queued batches, not ns\n";
+    for (const auto& entry : latency_reports_) {
+        const LatencyReport& report = entry.second.first;
+        for (size_t i = 0; i < report.site_count && i < kLatencySiteCount; ++i) {
+            const LatencySummary& site = report.sites[i];
+            file << "worker_" << report.worker_id << ' ' << latencySiteName(static_cast<LatencySite>(i)) << ' '
+                 << report.window_ns / 1000000 << ' ' << site.count << ' ' << site.mean_ns << ' '
+                 << site.p50_ns << ' ' << site.p99_ns << ' ' << site.p999_ns << ' ' << site.max_ns << '\n';
+        }
+    }
+    file.close();
     
-    LOG_DEBUG("Status update from worker {}: {}", message.sender_pid, static_cast<int>(status));
+    if (file.fail() || rename(temp_path.c_str(), path.c_str()) != 0) {
+        LOG_WARN("Failed to publish latency stats {}: {}", path, strerror(errno));
+        unlink(temp_path.c_str());
+    }
 }
 
 void MasterProcess::handleErrorReportMessage(const IPCMessage& message) {
@@ -555,11 +656,11 @@ void MasterProcess::updateGlobalStatistics() {
 
 void MasterProcess::monitorWorkerProcesses() {
     auto workers = IPCManager::getInstance().getAllProcesses();
-    time_t current_time = time(nullptr);
+    auto current_time = std::chrono::system_clock::now();
     
     for (const auto& worker : workers) {
         // 检查心跳超时
-        if (current_time - worker.last_heartbeat > constants::HEARTBEAT_TIMEOUT) {
+        if (current_time - worker.last_heartbeat > std::chrono::seconds(constants::HEARTBEAT_TIMEOUT)) {
             LOG_WARN("Worker process {} heartbeat timeout", worker.pid);
             
             // 发送终止信号
@@ -571,8 +672,8 @@ void MasterProcess::monitorWorkerProcesses() {
 }
 
 void MasterProcess::logProcessStatistics() {
-    auto stats = IPCManager::getInstance().getStatistics();
-    auto workers = IPCManager::getInstance().getWorkerProcesses();
+    auto stats = IPCManager::getInstance().getGlobalStatistics();
+    auto workers = IPCManager::getInstance().getAllProcesses();
     
     LOG_INFO("=== Master Process Statistics ===");
     LOG_INFO("Active workers: {}", workers.size());
@@ -581,6 +682,100 @@ void MasterProcess::logProcessStatistics() {
     LOG_INFO("Total data sent: {} bytes", stats.data_sent);
     LOG_INFO("Errors: {}", stats.errors);
     LOG_INFO("Uptime: {} seconds", time(nullptr) - stats.start_time);
+    
+    // 各工作进程的分片负载：分到的键数与接收速率，最大速率 / 平均速率反映分片是否均衡
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - last_load_report_).count();
+    bool have_rates = last_load_report_.time_since_epoch().count() != 0 && elapsed > 0;
+    double total_rate = 0.0;
+    double max_rate = 0.0;
+    
+    for (const auto& worker : workers) {
+        uint64_t previous = last_received_counts_.count(worker.worker_id) ? 
+                            last_received_counts_[worker.worker_id] : 0;
+        // 重启后计数从 0 开始
+        uint64_t delta = worker.received_count >= previous ? worker.received_count - previous : worker.received_count;
+        double rate = have_rates ? static_cast<double>(delta) / elapsed : 0.0;
+        total_rate += rate;
+        max_rate = std::max(max_rate, rate);
+        last_received_counts_[worker.worker_id] = worker.received_count;
+        
+        LOG_INFO("Worker {} load: keys={}, received={}, {:.0f} ticks/s, processed={}, errors={}", 
+                 worker.worker_id, worker.owned_keys, worker.received_count, rate, 
+                 worker.processed_count, worker.error_count);
+    }
+    last_load_report_ = now;
+    
+    if (have_rates && !workers.empty() && total_rate > 0) {
+        double mean_rate = total_rate / static_cast<double>(workers.size());
+        LOG_INFO("Shard load: {:.0f} ticks/s total, imbalance (max/mean) {:.2f}, {} members", 
+                 total_rate, max_rate / mean_rate, __builtin_popcountll(shard_members_));
+    }
+}
+
+void MasterProcess::adjustWorkerCount() {
+    const auto& config = ConfigManager::getInstance().getConfig();
+    int target = config.master.worker_processes;
+    if (target <= 0 || target == worker_count_) {
+        return;
+    }
+    
+    LOG_INFO("Adjusting worker processes from {} to {}", worker_count_, target);
+    
+    if (target > worker_count_) {
+        // 共享内存槽位与分片成员位都按 worker_id 分配，数量有上限
+        int grown = worker_count_;
+        while (grown < target && grown < constants::MAX_WORKER_PROCESSES &&
+               SymbolRouter::memberBit(grown + 1) != 0) {
+            ++grown;
+        }
+        if (grown < target) {
+            LOG_WARN("No worker slot for worker {}, cannot grow beyond {} workers", grown + 1, grown);
+        }
+        
+        // 与 createWorkerProcesses 一样在 fork 之前发布新成员：新进程启动时即按它订阅，
+        // 其余进程收到新代数后让出换主的证券
+        for (int worker_id = worker_count_ + 1; worker_id <= grown; ++worker_id) {
+            shard_members_ |= SymbolRouter::memberBit(worker_id);
+        }
+        IPCManager::getInstance().publishShardMembers(shard_members_);
+        
+        int created = worker_count_;
+        for (int worker_id = worker_count_ + 1; worker_id <= grown; ++worker_id) {
+            if (!createWorkerProcess(worker_id)) {
+                LOG_ERROR("Failed to create worker process {}", worker_id);
+                break;
+            }
+            failed_starts_.erase(worker_id);
+            created = worker_id;
+        }
+        
+        // 没能启动的成员撤回，它们的证券留在原来的工作进程
+        if (created < grown) {
+            for (int worker_id = created + 1; worker_id <= grown; ++worker_id) {
+                shard_members_ &= ~SymbolRouter::memberBit(worker_id);
+            }
+            IPCManager::getInstance().publishShardMembers(shard_members_);
+        }
+        worker_count_ = created;
+    } else {
+        // 先发布新成员让留下的工作进程接手，再停掉多余的工作进程
+        for (int worker_id = target + 1; worker_id <= worker_count_; ++worker_id) {
+            shard_members_ &= ~SymbolRouter::memberBit(worker_id);
+        }
+        IPCManager::getInstance().publishShardMembers(shard_members_);
+        
+        for (int worker_id = target + 1; worker_id <= worker_count_; ++worker_id) {
+            auto it = workers_.find(worker_id);
+            if (it != workers_.end() && it->second.pid > 0) {
+                LOG_INFO("Stopping worker process {} (pid={})", worker_id, it->second.pid);
+                kill(it->second.pid, SIGTERM);
+            }
+        }
+        worker_count_ = target;
+    }
+    
+    LOG_INFO("Worker processes adjusted to {}, shard members {:#x}", worker_count_, shard_members_);
 }
 
 void MasterProcess::gracefulShutdown() {
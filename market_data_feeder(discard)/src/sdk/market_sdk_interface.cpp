@@ -214,6 +214,10 @@ public:
         connection_callback_ = callback;
     }
     
+    void setThreadStartCallback(ThreadStartCallback callback) override {
+        thread_start_callback_ = callback;
+    }
+    
     SDKConnectionStatus getConnectionStatus() const override {
         return connection_status_;
     }
@@ -255,6 +259,9 @@ private:
         
         heartbeat_thread_running_ = true;
         heartbeat_thread_ = std::thread([this]() {
+            if (thread_start_callback_) {
+                thread_start_callback_(ThreadRole::HOUSEKEEPING);
+            }
             while (heartbeat_thread_running_ && 
                    connection_status_ == SDKConnectionStatus::CONNECTED) {
                 
@@ -275,6 +282,9 @@ private:
     
     void startDataGenerationThread(const SubscriptionParams& params) {
         auto thread = std::make_shared<std::thread>([this, params]() {
+            if (thread_start_callback_) {
+                thread_start_callback_(ThreadRole::RECEIVE);
+            }
             generateMarketData(params);
         });
         
@@ -331,7 +341,7 @@ private:
                 
                 // 调用数据回调
                 if (data_callback_) {
-                    data_callback_(data);
+                    data_callback_(data, std::string_view());
                 }
                 
                 statistics_.messages_received++;
@@ -351,6 +361,7 @@ private:
     DataCallback data_callback_;
     ErrorCallback error_callback_;
     ConnectionCallback connection_callback_;
+    ThreadStartCallback thread_start_callback_;
     
     std::vector<SubscriptionParams> subscriptions_;
     
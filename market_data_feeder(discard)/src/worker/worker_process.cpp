@@ -10,6 +10,7 @@
 #include <chrono>
 #include <thread>
 #include <algorithm>
+#include <unordered_set>
 
 namespace market_feeder {
 
@@ -34,7 +35,7 @@ void worker_signal_handler(int sig) {
 
 WorkerProcess::WorkerProcess(int worker_id) 
     : worker_id_(worker_id), running_(false), shutdown_requested_(false),
-      reload_requested_(false), error_count_(0), recovery_attempts_(0),
+      reload_requested_(false), affinity_enabled_(false), bind_memory_(false), shard_generation_(0), trace_sample_rate_(0), latency_report_(), error_count_(0), recovery_attempts_(0),
       processed_count_(0), received_count_(0), saved_count_(0) {
 }
 
@@ -52,29 +53,82 @@ bool WorkerProcess::initialize() {
     // 获取配置
     const auto& config = ConfigManager::getInstance().getConfig();
     
-    // 设置CPU亲和性
-    if (config.worker.worker_cpu_affinity) {
+    // 设置CPU亲和性：按线程类别绑核时主线程即批处理线程，之后创建的线程各自重新绑定
+    if (config.affinity.enabled) {
+        setupAffinity();
+    } else if (config.worker.worker_cpu_affinity) {
         setCpuAffinity();
     }
     
+    // 计时器使用 TSC，绑核之后校准
+    TscClock::calibrate();
+    
     // 设置进程优先级
     if (config.worker.worker_priority != 0) {
         setProcessPriority(config.worker.worker_priority);
     }
     
     // 初始化IPC管理器
-    if (!IPCManager::getInstance().initialize(ProcessType::WORKER)) {
+    if (!IPCManager::getInstance().initialize(ProcessType::WORKER, worker_id_)) {
         LOG_ERROR("Failed to initialize IPC manager for worker {}", worker_id_);
         return false;
     }
     
     // 初始化数据库管理器
+    DBConfig db_config;
+    db_config.host = config.database.host;
+    db_config.port = config.database.port;
+    db_config.database = config.database.database;
+    db_config.username = config.database.username;
+    db_config.password = config.database.password;
+    db_config.charset = config.database.charset;
+    db_config.pool_size = config.database.pool_size;
+    db_config.connect_timeout = config.database.connect_timeout;
+    db_config.query_timeout = config.database.query_timeout;
+    db_config.auto_reconnect = config.database.auto_reconnect;
+    db_config.insert_chunk_size = config.database.insert_chunk_size;
+    db_config.sticky_connections = config.database.sticky_connections;
+    db_config.validate_idle_ms = config.database.validate_idle_ms;
+    db_config.tick_cache_buckets = config.database.tick_cache_buckets;
+    db_config.tick_cache_bucket_ms = config.database.tick_cache_bucket_ms;
+    db_config.tick_cache_max_ticks_per_bucket = config.database.tick_cache_max_ticks_per_bucket;
+    db_config.tick_cache_max_ticks = config.database.tick_cache_max_ticks;
+    
     db_manager_ = std::make_unique<DatabaseManager>();
-    if (!db_manager_->initialize(config.database)) {
+    if (!db_manager_->initialize(db_config)) {
         LOG_ERROR("Failed to initialize database manager for worker {}", worker_id_);
         return false;
     }
     
+    // 启动写库流水线，批次提交后主循环立即继续攒下一批
+    BatchWriter::Options writer_options;
+    writer_options.writer_threads = config.database.writer_threads;
+    writer_options.max_inflight_batches = config.database.max_inflight_batches;
+    writer_options.max_retries = config.database.commit_max_retries;
+    writer_options.retry_backoff_ms = config.database.retry_backoff_ms;
+    writer_options.retry_backoff_max_ms = config.database.retry_backoff_max_ms;
+    if (affinity_enabled_) {
+        writer_options.on_thread_start = [this]() { pinThread(ThreadRole::WRITER); };
+    }
+    if (writer_options.writer_threads > config.database.pool_size) {
+        LOG_WARN("writer_threads {} exceeds database pool_size {} for worker {}", 
+                 writer_options.writer_threads, config.database.pool_size, worker_id_);
+    }
+    batch_writer_ = std::make_unique<BatchWriter>(*db_manager_, writer_options,
+        [this](std::vector<MarketData>& batch, bool committed, uint64_t journal_end) {
+            onBatchCompleted(batch, committed, journal_end);
+        });
+    if (!batch_writer_->start()) {
+        LOG_ERROR("Failed to start batch writer for worker {}", worker_id_);
+        return false;
+    }
+    
+    // 接收新行情之前先重放上次遗留的日志
+    if (!setupJournal()) {
+        LOG_ERROR("Failed to replay tick journal for worker {}", worker_id_);
+        return false;
+    }
+    
     // 初始化SDK
     if (!initializeSDK()) {
         LOG_ERROR("Failed to initialize SDK for worker {}", worker_id_);
@@ -88,7 +142,7 @@ bool WorkerProcess::initialize() {
     }
     
     // 初始化数据缓冲区
-    initializeDataBuffers();
+    setupMemoryPool();
     
     // 初始化统计信息
     initializeStatistics();
@@ -143,6 +197,11 @@ void WorkerProcess::stop() {
     LOG_INFO("Stopping worker process {}", worker_id_);
     running_ = false;
     
+    // 唤醒因接收队列满而等待的 SDK 回调线程
+    if (ingest_queue_) {
+        ingest_queue_->close();
+    }
+    
     // 发送停止状态
     // sendStatusUpdate(ProcessStatus::STOPPING);
     
@@ -187,7 +246,8 @@ bool WorkerProcess::initializeSDK() {
     
     // 设置数据回调
     sdk_->setMarketDataCallback(
-        std::bind(&WorkerProcess::handleMarketDataCallback, this, std::placeholders::_1));
+        std::bind(&WorkerProcess::handleMarketDataCallback, this, 
+                  std::placeholders::_1, std::placeholders::_2));
     
     // 设置错误回调
     sdk_->setErrorCallback(
@@ -197,6 +257,11 @@ bool WorkerProcess::initializeSDK() {
     sdk_->setConnectionStatusCallback(
         std::bind(&WorkerProcess::handleError, this, std::placeholders::_1));
     
+    // SDK 内部线程按类别绑核
+    if (affinity_enabled_) {
+        sdk_->setThreadStartCallback([this](ThreadRole role) { pinThread(role); });
+    }
+    
     LOG_INFO("SDK initialized successfully for worker {}", worker_id_);
     return true;
 }
@@ -241,6 +306,54 @@ bool WorkerProcess::setCpuAffinity() {
     }
 }
 
+void WorkerProcess::setupAffinity() {
+    const auto& config = ConfigManager::getInstance().getConfig();
+    
+    if (!topology_.discover()) {
+        LOG_WARN("CPU topology incomplete for worker {}, treating every cpu as a separate core", worker_id_);
+    }
+    
+    AffinityOptions options;
+    options.nic_interface = config.affinity.nic_interface;
+    options.numa_node = config.affinity.numa_node;
+    options.receive_cpus = config.affinity.receive_cpus;
+    options.processor_cpus = config.affinity.processor_cpus;
+    options.writer_cpus = config.affinity.writer_cpus;
+    options.housekeeping_cpus = config.affinity.housekeeping_cpus;
+    options.bind_memory = config.affinity.bind_memory;
+    
+    affinity_plan_ = topology_.planWorker(options, worker_id_);
+    affinity_enabled_ = true;
+    bind_memory_ = options.bind_memory && affinity_plan_.node >= 0;
+    
+    // 主线程运行批处理循环；接收队列、批缓冲在此之后由它分配，优先落在所选节点上
+    pinThread(ThreadRole::PROCESSOR);
+    
+    int nic_node = options.nic_interface.empty() ? -1 : CpuTopology::nicNode(options.nic_interface);
+    LOG_INFO("Worker {} topology: {}", worker_id_, topology_.describe());
+    LOG_INFO("Worker {} affinity: node {} (nic {} on node {}), receive cpus {}, processor cpus {}, "
+             "writer cpus {}, housekeeping cpus {}, node-local memory {}", 
+             worker_id_, affinity_plan_.node, options.nic_interface.empty() ? "-" : options.nic_interface, 
+             nic_node, CpuTopology::formatCpuList(affinity_plan_.receive), 
+             CpuTopology::formatCpuList(affinity_plan_.processor), 
+             CpuTopology::formatCpuList(affinity_plan_.writer), 
+             CpuTopology::formatCpuList(affinity_plan_.housekeeping), bind_memory_ ? "on" : "off");
+    if (affinity_plan_.oversubscribed) {
+        LOG_WARN("Not enough dedicated cores on node {} for worker {}, sharing cores with other workers", 
+                 affinity_plan_.node, worker_id_);
+    }
+}
+
+void WorkerProcess::pinThread(ThreadRole role) {
+    if (!affinity_enabled_) {
+        return;
+    }
+    CpuTopology::pinCurrentThread(affinity_plan_.cpusFor(role));
+    if (bind_memory_) {
+        CpuTopology::preferNode(affinity_plan_.node);
+    }
+}
+
 bool WorkerProcess::setProcessPriority() {
     if (setpriority(PRIO_PROCESS, 0, priority) == 0) {
         LOG_INFO("Worker {} priority set to {}", worker_id_, priority);
@@ -253,13 +366,38 @@ bool WorkerProcess::setProcessPriority() {
 void WorkerProcess::setupMemoryPool() {
     const auto& config = ConfigManager::getInstance().getConfig();
     
-    // 为每种数据类型创建缓冲区
-    for (auto data_type : config.market_data.data_types) {
-        data_buffers_[data_type] = std::vector<MarketData>();
-        data_buffers_[data_type].reserve(config.market_data.buffer_size);
+    // 原始报文放入内存池，记录里只保存偏移；内存池不可用时行情照常处理，只是不保留原始报文
+    size_t pool_bytes = static_cast<size_t>(std::max(config.performance.memory_pool_size, 1)) * 1024 * 1024;
+    int arena_node = affinity_enabled_ && bind_memory_ ? affinity_plan_.node : -1;
+    if (!tick_arena_.initialize(pool_bytes, config.performance.use_hugepages, 
+                                TickArena::kDefaultSegmentSize, arena_node)) {
+        LOG_WARN("Tick arena unavailable for worker {}, raw data will not be kept", worker_id_);
     }
     
-    LOG_DEBUG("Data buffers initialized for worker {}", worker_id_);
+    // 接收队列的槽位一次性分配，SDK 回调只在槽位上覆盖写入
+    ingest_queue_ = std::make_unique<MpscRing<MarketData>>(
+        static_cast<size_t>(std::max(config.market_data.ingest_queue_size, 2)),
+        config.market_data.backpressure_policy);
+    
+    batch_size_ = static_cast<size_t>(std::max(config.market_data.batch_size, 1));
+    batch_timeout_ = std::chrono::milliseconds(config.market_data.process_interval);
+    batch_buffer_.reserve(batch_size_);
+    last_batch_time_ = std::chrono::system_clock::now();
+    
+    // SDK 回调线程启动前确定，之后只读
+    trace_sample_rate_ = static_cast<uint32_t>(std::max(config.monitoring.trace_sample_rate, 0));
+    
+    LOG_DEBUG("Ingest queue initialized for worker {}: {} slots, policy {}", 
+              worker_id_, ingest_queue_->capacity(), 
+              static_cast<int>(ingest_queue_->policy()));
+}
+
+void WorkerProcess::cleanupMemoryPool() {
+    ingest_queue_.reset();
+    batch_buffer_.clear();
+    tick_arena_.destroy();
+    
+    LOG_DEBUG("Memory pool released for worker {}", worker_id_);
 }
 
 void WorkerProcess::updateStatistics() {
@@ -306,49 +444,147 @@ bool WorkerProcess::initializeSDK() {
     return true;
 }
 
-bool WorkerProcess::initializeDatabase() {
+namespace {
+
+// 按市场分片时市场在哈希环上的键
+std::string marketShardKey(MarketType market) {
+    return "market:" + std::to_string(static_cast<int>(market));
+}
+
+size_t shardSize(const SubscriptionParams& params) {
+    return params.subscribe_all ? params.markets.size() : params.symbols.size();
+}
+
+// a 中有而 b 中没有的部分
+SubscriptionParams subtractShard(const SubscriptionParams& a, const SubscriptionParams& b) {
+    SubscriptionParams result;
+    result.data_types = a.data_types;
+    result.subscribe_all = a.subscribe_all;
+    if (a.subscribe_all) {
+        for (auto market : a.markets) {
+            if (std::find(b.markets.begin(), b.markets.end(), market) == b.markets.end()) {
+                result.markets.push_back(market);
+            }
+        }
+    } else {
+        result.markets = a.markets;
+        std::unordered_set<std::string> other(b.symbols.begin(), b.symbols.end());
+        for (const auto& symbol : a.symbols) {
+            if (!other.count(symbol)) {
+                result.symbols.push_back(symbol);
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+SubscriptionParams WorkerProcess::computeShard() const {
+    const auto& config = ConfigManager::getInstance().getConfig();
+    
+    SubscriptionParams params;
+    params.data_types = config.market_data.data_types;
+    bool sharded = shard_generation_ != 0;
+    
+    if (!config.market_data.symbols.empty()) {
+        // 按证券分片
+        params.markets = config.market_data.markets;
+        params.symbols = sharded ? router_.select(config.market_data.symbols, worker_id_)
+                                 : config.market_data.symbols;
+    } else {
+        // 未配置证券列表时订阅全市场，按市场分片
+        params.subscribe_all = true;
+        for (auto market : config.market_data.markets) {
+            if (!sharded || router_.ownerOf(marketShardKey(market)) == worker_id_) {
+                params.markets.push_back(market);
+            }
+        }
+    }
+    return params;
+}
+
+bool WorkerProcess::subscribeMarketData() {
     if (!sdk_) {
         LOG_ERROR("SDK not initialized for worker {}", worker_id_);
         return false;
     }
     
-    const auto& config = ConfigManager::getInstance().getConfig();
+    // 主进程没有发布分片成员（代数为 0）时不分片，订阅全部
+    uint64_t members = IPCManager::getInstance().getShardMembers(shard_generation_);
+    router_.rebuild(members);
+    subscription_ = computeShard();
+    IPCManager::getInstance().updateWorkerShard(worker_id_, static_cast<uint32_t>(shardSize(subscription_)));
     
-    LOG_INFO("Subscribing to market data for worker {}", worker_id_);
-    
-    // 订阅配置中指定的市场和数据类型
-    for (auto market : config.market_data.markets) {
-        for (auto data_type : config.market_data.data_types) {
-            SubscriptionParams params;
-            params.market = market;
-            params.data_type = data_type;
-            params.symbols.clear(); // 订阅所有股票
-            
-            if (!sdk_->subscribe(params)) {
-                LOG_ERROR("Failed to subscribe market {} data type {} for worker {}", 
-                          static_cast<int>(market), static_cast<int>(data_type), worker_id_);
-                return false;
-            }
-            
-            LOG_INFO("Subscribed to market {} data type {} for worker {}", 
-                     static_cast<int>(market), static_cast<int>(data_type), worker_id_);
-        }
+    if (shardSize(subscription_) == 0) {
+        LOG_WARN("Worker {} owns no symbols in shard generation {}", worker_id_, shard_generation_);
+        return true;
     }
     
-    LOG_INFO("Market data subscription completed for worker {}", worker_id_);
+    if (sdk_->subscribe(subscription_) != SDKErrorCode::SUCCESS) {
+        LOG_ERROR("Failed to subscribe market data for worker {}", worker_id_);
+        return false;
+    }
+    
+    LOG_INFO("Worker {} subscribed {} {} (shard generation {}, {} members)", 
+             worker_id_, shardSize(subscription_), subscription_.subscribe_all ? "markets" : "symbols", 
+             shard_generation_, __builtin_popcountll(members));
     return true;
 }
 
+void WorkerProcess::rebalanceSubscriptions() {
+    if (!sdk_) {
+        return;
+    }
+    
+    uint64_t generation = 0;
+    uint64_t members = IPCManager::getInstance().getShardMembers(generation);
+    if (generation == shard_generation_) {
+        return;
+    }
+    shard_generation_ = generation;
+    router_.rebuild(members);
+    
+    // 一致性哈希下只有变动成员相关的键换主，其余订阅不动。
+    // 各工作进程各自轮询到新代数后增减订阅，换主的证券可能有短暂重叠或空档
+    SubscriptionParams next = computeShard();
+    SubscriptionParams removed = subtractShard(subscription_, next);
+    SubscriptionParams added = subtractShard(next, subscription_);
+    
+    if (shardSize(removed) > 0 && sdk_->unsubscribe(removed) != SDKErrorCode::SUCCESS) {
+        LOG_WARN("Failed to unsubscribe {} moved keys for worker {}", shardSize(removed), worker_id_);
+    }
+    if (shardSize(added) > 0 && sdk_->subscribe(added) != SDKErrorCode::SUCCESS) {
+        LOG_ERROR("Failed to subscribe {} new keys for worker {}", shardSize(added), worker_id_);
+        sendErrorReport("Shard rebalance subscription failed");
+    }
+    
+    // 移出的证券不再由本进程写入，移入的证券缓存里只有归属前的旧数据，两者都不能再由缓存回答。
+    // 按市场分片时无法逐证券列出，整体清空
+    if (db_manager_ && (shardSize(removed) > 0 || shardSize(added) > 0)) {
+        if (next.subscribe_all) {
+            db_manager_->dropCachedMarketData({});
+        } else {
+            std::vector<std::string> moved = removed.symbols;
+            moved.insert(moved.end(), added.symbols.begin(), added.symbols.end());
+            db_manager_->dropCachedMarketData(moved);
+        }
+    }
+    
+    subscription_ = next;
+    IPCManager::getInstance().updateWorkerShard(worker_id_, static_cast<uint32_t>(shardSize(subscription_)));
+    LOG_INFO("Worker {} rebalanced to shard generation {}: {} keys owned, {} added, {} removed", 
+             worker_id_, shard_generation_, shardSize(subscription_), shardSize(added), shardSize(removed));
+}
+
 void WorkerProcess::processMarketData() {
     LOG_INFO("Entering main loop for worker {}", worker_id_);
     
     const auto& config = ConfigManager::getInstance().getConfig();
     auto last_heartbeat = std::chrono::steady_clock::now();
-    auto last_flush = std::chrono::steady_clock::now();
     auto last_stats = std::chrono::steady_clock::now();
     
     const auto heartbeat_interval = std::chrono::seconds(30);
-    const auto flush_interval = std::chrono::milliseconds(config.market_data.process_interval);
     const auto stats_interval = std::chrono::seconds(60);
     
     while (running_) {
@@ -375,21 +611,24 @@ void WorkerProcess::processMarketData() {
         // 处理IPC消息
         processIPCMessages();
         
+        // 分片成员变化（工作进程数调整或某个工作进程退出）时调整订阅
+        if (IPCManager::getInstance().getShardGeneration() != shard_generation_) {
+            rebalanceSubscriptions();
+        }
+        
         // 发送心跳
         if (now - last_heartbeat >= heartbeat_interval) {
             sendHeartbeat();
             last_heartbeat = now;
         }
         
-        // 刷新数据缓冲区
-        if (now - last_flush >= flush_interval) {
-            flushDataBuffers();
-            last_flush = now;
-        }
+        // 取出接收队列中的数据，攒满一批或超时后写库
+        size_t drained = processBatchData();
         
         // 发送统计信息
         if (now - last_stats >= stats_interval) {
-            sendStatistics();
+            sendStatisticsToMaster();
+            logPerformanceMetrics();
             last_stats = now;
         }
         
@@ -399,40 +638,46 @@ void WorkerProcess::processMarketData() {
             handleReconnection();
         }
         
-        // 短暂休眠
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        // 队列已取空时短暂休眠
+        if (drained == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
     }
     
     LOG_INFO("Exiting main loop for worker {}", worker_id_);
 }
 
-void WorkerProcess::handleMarketDataCallback(const MarketData& data) {
-    PERF_TIMER("onMarketData");
+void WorkerProcess::handleMarketDataCallback(const MarketData& data, std::string_view raw_data) {
+    PERF_TIMER(ON_MARKET_DATA);
     
     try {
-        // 更新统计信息
-        statistics_.messages_processed++;
-        statistics_.data_received += sizeof(MarketData);
-        statistics_.last_update = time(nullptr);
+        received_count_.fetch_add(1, std::memory_order_relaxed);
         
-        // 添加到缓冲区
-        auto it = data_buffers_.find(data.type);
-        if (it != data_buffers_.end()) {
-            it->second.push_back(data);
-            
-            // 检查是否需要立即刷新
-            const auto& config = ConfigManager::getInstance().getConfig();
-            if (it->second.size() >= config.market_data.batch_size) {
-                flushDataBuffer(data.type);
+        // 抽样：每个回调线程各自计数，每 trace_sample_rate_ 条跟踪一条
+        uint64_t receive_ticks = 0;
+        if (trace_sample_rate_ > 0) {
+            static thread_local uint32_t countdown = 0;
+            if (countdown == 0) {
+                countdown = trace_sample_rate_;
+                receive_ticks = TscClock::now();
+                auto exchange_delay = std::chrono::system_clock::now() - data.timestamp;
+                if (data.timestamp.time_since_epoch().count() != 0 && exchange_delay.count() >= 0) {
+                    LatencyRegistry::recordNanoseconds(LatencySite::TICK_EXCHANGE_TO_RECEIVE, 
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(exchange_delay).count());
+                }
             }
+            --countdown;
         }
         
+        // 只写入接收队列，写库在批处理线程完成，回调线程不持锁
+        bufferMarketData(data, raw_data, receive_ticks);
+        
         LOG_TRACE("Market data received: symbol={}, type={}, price={}", 
-                  data.symbol, static_cast<int>(data.type), data.price);
+                  data.symbol, static_cast<int>(data.data_type), data.price);
         
     } catch (const std::exception& e) {
         LOG_ERROR("Error processing market data for worker {}: {}", worker_id_, e.what());
-        statistics_.errors++;
+        error_count_.fetch_add(1, std::memory_order_relaxed);
     }
 }
 
@@ -492,16 +737,13 @@ void WorkerProcess::processIPCMessages() {
 }
 
 void WorkerProcess::sendHeartbeat() {
-    IPCMessage message;
-    message.message_type = 0; // HEARTBEAT
-    message.sender_pid = getpid();
-    message.target_pid = getppid();
-    message.timestamp = time(nullptr);
-    // message.data.heartbeat_data.worker_id = worker_id_;
-    
-    if (!IPCManager::getInstance().sendMessage(message)) {
+    // 心跳与计数器直接写入本进程的共享内存槽位，不经过消息队列，也不与其他工作进程争锁
+    IPCManager& ipc = IPCManager::getInstance();
+    if (!ipc.updateWorkerCounters(worker_id_, processed_count_.load(), error_count_.load(), 
+                                  received_count_.load())) {
         LOG_WARN("Failed to send heartbeat for worker {}", worker_id_);
     }
+    ipc.updateWorkerShard(worker_id_, static_cast<uint32_t>(shardSize(subscription_)));
     
     last_heartbeat_ = std::chrono::system_clock::now();
 }
@@ -537,52 +779,290 @@ void WorkerProcess::processIPCMessages() {
 }
 
 void WorkerProcess::sendStatisticsToMaster() {
+    // 计数器已经写在共享内存槽位中，这里只发送本周期的耗时分布
+    static_assert(sizeof(LatencyReport) <= sizeof(IPCMessage::data), "latency report must fit in an IPC message");
+    LatencyRegistry::getInstance().collect(latency_report_);
+    latency_report_.worker_id = worker_id_;
+    
     IPCMessage message;
-    message.type = MessageType::STATISTICS;
+    message.ipc_type = IPCMessageType::STATISTICS;
     message.sender_pid = getpid();
-    message.receiver_pid = getppid();
-    message.timestamp = time(nullptr);
-    memcpy(&message.data.stats_data, &statistics_, sizeof(ProcessStatistics));
+    message.data_size = sizeof(LatencyReport);
+    memcpy(message.data, &latency_report_, sizeof(LatencyReport));
     
     if (!IPCManager::getInstance().sendMessage(message)) {
         LOG_WARN("Failed to send statistics for worker {}", worker_id_);
     }
 }
 
-void WorkerProcess::processBatchData() {
-    for (auto& buffer_pair : data_buffers_) {
-        if (!buffer_pair.second.empty()) {
-            flushDataBuffer(buffer_pair.first);
+size_t WorkerProcess::processBatchData() {
+    if (!ingest_queue_) {
+        return 0;
+    }
+    
+    uint64_t start_ticks = TscClock::now();
+    
+    // 直接从槽位拷贝到批缓冲，槽位随即交还给生产者
+    size_t room = batch_size_ > batch_buffer_.size() ? batch_size_ - batch_buffer_.size() : 0;
+    // 开启日志时同时追加到日志映射页，单线程顺序写入
+    size_t drained = ingest_queue_->consume(
+        [this](MarketData& slot) {
+            if (slot.trace.receive != 0) {
+                traced_indices_.push_back(static_cast<uint32_t>(batch_buffer_.size()));
+            }
+            batch_buffer_.push_back(slot);
+            if (journal_.isOpen() && !journal_.append(slot)) {
+                LOG_ERROR("Tick journal append failed for worker {}, journaling disabled", worker_id_);
+                journal_.close();
+            }
+        }, room);
+    
+    auto now = std::chrono::system_clock::now();
+    if (batch_buffer_.size() >= batch_size_ ||
+        (!batch_buffer_.empty() && now - last_batch_time_ >= batch_timeout_)) {
+        if (batch_writer_) {
+            // 交给写库流水线后换一个空缓冲继续攒批；流水线已满时不等待，
+            // 批缓冲不再取数，压力回到接收队列，由背压策略处理
+            if (submitBatch(0)) {
+                last_batch_time_ = now;
+            }
+        } else {
+            sealBatchTraces();
+            uint64_t journal_end = trackJournalBatch();
+            bool committed = saveDataToDatabase(batch_buffer_);
+            onBatchCompleted(batch_buffer_, committed, journal_end);
+            batch_buffer_.clear();
+            traced_indices_.clear();
+            last_batch_time_ = now;
         }
     }
+    
+    // 空转的轮询不计入
+    if (drained > 0) {
+        LatencyRegistry::record(LatencySite::PROCESS_BATCH, TscClock::now() - start_ticks);
+    }
+    
+    return drained;
 }
 
-void WorkerProcess::bufferMarketData(const MarketData& data) {
-    PERF_TIMER("flushDataBuffer");
-    
-    auto it = data_buffers_.find(data_type);
-    if (it == data_buffers_.end() || it->second.empty()) {
+bool WorkerProcess::submitBatch(int timeout_ms) {
+    // 先登记再提交，写库线程可能在 submit 返回前就完成这一批；提交失败时下次重新打封口时间
+    sealBatchTraces();
+    uint64_t journal_end = trackJournalBatch();
+    if (!batch_writer_->submit(batch_buffer_, timeout_ms, journal_end)) {
+        if (journal_end != 0) {
+            journal_.cancelBatch(journal_end);
+        }
+        return false;
+    }
+    batch_buffer_ = batch_writer_->acquireBuffer(batch_size_);
+    traced_indices_.clear();
+    return true;
+}
+
+void WorkerProcess::sealBatchTraces() {
+    if (traced_indices_.empty()) {
         return;
     }
+    uint64_t now = TscClock::now();
+    for (uint32_t index : traced_indices_) {
+        if (index < batch_buffer_.size()) {
+            batch_buffer_[index].trace.seal = now;
+        }
+    }
+}
+
+void WorkerProcess::recordCommittedTraces(const std::vector<MarketData>& batch) {
+    uint64_t commit = TscClock::now();
+    auto commit_time = std::chrono::system_clock::now();
+    for (const auto& data : batch) {
+        const TickTrace& trace = data.trace;
+        if (trace.receive == 0 || trace.seal == 0) {
+            continue;
+        }
+        LatencyRegistry::record(LatencySite::TICK_RECEIVE_TO_ENQUEUE, trace.enqueue - trace.receive);
+        LatencyRegistry::record(LatencySite::TICK_ENQUEUE_TO_SEAL, trace.seal - trace.enqueue);
+        LatencyRegistry::record(LatencySite::TICK_SEAL_TO_COMMIT, commit - trace.seal);
+        LatencyRegistry::record(LatencySite::TICK_RECEIVE_TO_COMMIT, commit - trace.receive);
+        
+        auto exchange_delay = commit_time - data.timestamp;
+        if (data.timestamp.time_since_epoch().count() != 0 && exchange_delay.count() >= 0) {
+            LatencyRegistry::recordNanoseconds(LatencySite::TICK_EXCHANGE_TO_COMMIT, 
+                std::chrono::duration_cast<std::chrono::nanoseconds>(exchange_delay).count());
+        }
+    }
+}
+
+uint64_t WorkerProcess::trackJournalBatch() {
+    if (!journal_.isOpen() || batch_buffer_.empty()) {
+        return 0;
+    }
+    uint64_t journal_end = journal_.nextSequence();
+    journal_.trackBatch(journal_end);
+    return journal_end;
+}
+
+bool WorkerProcess::setupJournal() {
+    const auto& config = ConfigManager::getInstance().getConfig();
+    if (!config.journal.enabled) {
+        return true;
+    }
+    
+    std::string directory = TickJournal::workerDirectory(config.journal.directory, worker_id_);
+    size_t segment_size = static_cast<size_t>(std::max(config.journal.segment_size_mb, 1)) * 1024 * 1024;
+    if (!journal_.open(directory, segment_size)) {
+        LOG_WARN("Tick journal unavailable for worker {}, unsaved market data will not survive a crash", 
+                 worker_id_);
+        return true;
+    }
+    
+    // 重放期间还没有新行情，写库流水线满时等待，但最多等 kReplaySubmitAttempts 秒：
+    // 数据库长时间不可用或写库线程已停止时放弃重放，未交出的批次不登记，下次启动再重放
+    constexpr int kReplaySubmitAttempts = 60;
+    size_t batch_size = static_cast<size_t>(std::max(config.market_data.batch_size, 1));
+    bool stalled = false;
+    size_t replayed = journal_.replay(batch_size, [this, &stalled](std::vector<MarketData>& batch, uint64_t end) {
+        if (stalled) {
+            return;
+        }
+        journal_.trackBatch(end);
+        for (int attempt = 0; attempt < kReplaySubmitAttempts; ++attempt) {
+            if (batch_writer_->submit(batch, 1000, end)) {
+                return;
+            }
+            if (shutdown_requested_ || !batch_writer_->isRunning()) {
+                break;
+            }
+        }
+        journal_.cancelBatch(end);
+        stalled = true;
+    });
+    if (stalled) {
+        LOG_ERROR("Worker {} could not hand journaled records to the batch writer, "
+                  "leaving them in the journal", worker_id_);
+        return false;
+    }
+    if (replayed > 0) {
+        LOG_INFO("Worker {} replayed {} journaled records", worker_id_, replayed);
+    }
+    return true;
+}
+
+void WorkerProcess::onBatchCompleted(std::vector<MarketData>& batch, bool committed, uint64_t journal_end) {
+    if (committed) {
+        processed_count_.fetch_add(batch.size(), std::memory_order_relaxed);
+        saved_count_.fetch_add(batch.size(), std::memory_order_relaxed);
+        // saveMarketDataBatch 返回时事务已提交
+        if (trace_sample_rate_ > 0) {
+            recordCommittedTraces(batch);
+        }
+    } else {
+        error_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    // 本批已经写库（或已放弃），归还原始报文占用的内存池空间
+    for (const auto& data : batch) {
+        tick_arena_.release(data.raw_data);
+    }
+    
+    // 放弃的批次让检查点停在它之前，重启后从日志重放重试
+    if (journal_end != 0) {
+        journal_.completeBatch(journal_end, committed);
+    }
+}
+
+void WorkerProcess::bufferMarketData(const MarketData& data, std::string_view raw_data, uint64_t receive_ticks) {
+    // 定长记录直接拷贝进槽位，原始报文拷贝进内存池；队列满时的处理由背压策略决定
+    auto fill = [this, &data, raw_data, receive_ticks](MarketData& slot) {
+        slot = data;
+        tick_arena_.store(raw_data, slot.raw_data);
+        slot.trace = TickTrace();
+        if (receive_ticks != 0) {
+            slot.trace.receive = receive_ticks;
+            slot.trace.enqueue = TscClock::now();
+        }
+    };
+    auto on_drop = [this](MarketData& slot) { tick_arena_.release(slot.raw_data); };
+    
+    if (!ingest_queue_->push(fill, on_drop)) {
+        LOG_TRACE("Ingest queue closed, market data dropped for worker {}", worker_id_);
+    }
+}
+
+bool WorkerProcess::saveDataToDatabase(const std::vector<MarketData>& data_batch) {
+    PERF_TIMER(FLUSH_DATA_BUFFER);
     
     try {
         // 批量保存到数据库
-        if (db_manager_ && db_manager_->saveMarketDataBatch(it->second)) {
-            statistics_.data_sent += it->second.size() * sizeof(MarketData);
-            
-            LOG_DEBUG("Flushed {} market data records of type {} for worker {}", 
-                      it->second.size(), static_cast<int>(data_type), worker_id_);
-        } else {
-            LOG_ERROR("Failed to flush data buffer for worker {}", worker_id_);
-            statistics_.errors++;
+        if (db_manager_ && db_manager_->saveMarketDataBatch(data_batch) == DBErrorCode::SUCCESS) {
+            LOG_DEBUG("Flushed {} market data records for worker {}", 
+                      data_batch.size(), worker_id_);
+            return true;
         }
         
-        // 清空缓冲区
-        it->second.clear();
+        LOG_ERROR("Failed to flush data buffer for worker {}", worker_id_);
         
     } catch (const std::exception& e) {
         LOG_ERROR("Error flushing data buffer for worker {}: {}", worker_id_, e.what());
-        statistics_.errors++;
+    }
+    return false;
+}
+
+void WorkerProcess::logPerformanceMetrics() {
+    if (!ingest_queue_) {
+        return;
+    }
+    
+    auto queue_stats = ingest_queue_->stats();
+    LOG_INFO("Worker {} ingest queue: depth={}, high_water={}/{}, dropped={}, "
+             "blocked={}, spilled={}, spill_depth={}, received={}, saved={}", 
+             worker_id_, ingest_queue_->size(), queue_stats.high_water, 
+             ingest_queue_->capacity(), queue_stats.dropped, queue_stats.blocked, 
+             queue_stats.spilled, queue_stats.spill_depth, 
+             received_count_.load(), saved_count_.load());
+    
+    auto arena_stats = tick_arena_.getStats();
+    LOG_INFO("Worker {} tick arena: capacity={}, free_segments={}, stored={}, exhausted={}, huge_pages={}", 
+             worker_id_, arena_stats.capacity, arena_stats.free_segments, 
+             arena_stats.stored, arena_stats.exhausted, arena_stats.huge_pages);
+    
+    if (batch_writer_) {
+        auto writer_stats = batch_writer_->getStats();
+        LOG_INFO("Worker {} batch writer: queue_depth={} (max={}), in_flight={}, "
+                 "committed={} batches/{} rows, failed={}, retries={}, submit_waits={}", 
+                 worker_id_, writer_stats.queue_depth, writer_stats.max_queue_depth, 
+                 writer_stats.in_flight, writer_stats.committed_batches, writer_stats.committed_rows, 
+                 writer_stats.failed_batches, writer_stats.retries, writer_stats.submit_waits);
+    }
+    
+    if (db_manager_) {
+        auto db_stats = db_manager_->getStatistics();
+        LOG_INFO("Worker {} database: {:.0f} rows/s, queries={} (failed={}), "
+                 "tick cache hits={} misses={} hit_ratio={:.3f} ticks={} evicted={}", 
+                 worker_id_, db_stats.rows_per_second, db_stats.total_queries, 
+                 db_stats.failed_queries, db_stats.cache_hits, db_stats.cache_misses, 
+                 db_stats.cache_hit_ratio, db_stats.cache_ticks, db_stats.cache_evicted_series);
+    }
+    
+    if (journal_.isOpen()) {
+        auto journal_stats = journal_.getStats();
+        LOG_INFO("Worker {} tick journal: next_sequence={}, checkpoint={}, unsaved={}, segments={}, replayed={}, "
+                 "abandoned_batches={}", 
+                 worker_id_, journal_stats.next_sequence, journal_stats.checkpoint, 
+                 journal_stats.next_sequence - journal_stats.checkpoint, 
+                 journal_stats.segments, journal_stats.replayed, journal_stats.abandoned);
+    }
+    
+    // 本周期各计时点的耗时分布，由 sendStatisticsToMaster 汇总
+    for (size_t i = 0; i < latency_report_.site_count && i < kLatencySiteCount; ++i) {
+        const LatencySummary& site = latency_report_.sites[i];
+        if (site.count == 0) {
+            continue;
+        }
+        const char* unit = latencySiteUnit(static_cast<LatencySite>(i));
+        LOG_PERF("Worker {} latency {}: count={}, mean={}{}, p50={}{}, p99={}{}, p999={}{}, max={}{}", 
+                 worker_id_, latencySiteName(static_cast<LatencySite>(i)), site.count, site.mean_ns, unit, 
+                 site.p50_ns, unit, site.p99_ns, unit, site.p999_ns, unit, site.max_ns, unit);
     }
 }
 
@@ -598,7 +1078,9 @@ void WorkerProcess::handleShutdownMessage(const IPCMessage& message) {
     // 重新订阅市场数据（如果配置发生变化）
     if (sdk_) {
         // 取消当前订阅
-        sdk_->unsubscribeAll();
+        if (shardSize(subscription_) > 0) {
+            sdk_->unsubscribe(subscription_);
+        }
         
         // 重新订阅
         if (!subscribeMarketData()) {
@@ -641,14 +1123,26 @@ void WorkerProcess::cleanup() {
         sdk_.reset();
     }
     
+    // 提交未满的最后一批，等待写库流水线排空
+    if (batch_writer_) {
+        if (!batch_buffer_.empty()) {
+            submitBatch(1000);
+        }
+        batch_writer_->stop();
+        batch_writer_.reset();
+    }
+    
+    // 写库线程已退出，检查点不再变化
+    journal_.close();
+    
     // 关闭数据库连接
     if (db_manager_) {
         db_manager_->shutdown();
         db_manager_.reset();
     }
     
-    // 清空数据缓冲区
-    // data_buffers_.clear();
+    // 释放接收队列、批缓冲和内存池
+    cleanupMemoryPool();
     
     LOG_INFO("Worker process {} cleanup completed", worker_id_);
 }
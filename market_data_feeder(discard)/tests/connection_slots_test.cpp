@@ -0,0 +1,52 @@
+// ConnectionSlots 的计数：新建的池没有借出的槽位，取还之后回到 0，取空后等于池大小
+#include "database/connection_slots.h"
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace market_feeder;
+
+namespace {
+
+int failures = 0;
+
+void expectEqual(size_t actual, size_t expected, const char* what) {
+    if (actual != expected) {
+        std::fprintf(stderr, "FAILED: %s: expected %zu, got %zu\n", what, expected, actual);
+        ++failures;
+    }
+}
+
+void checkPool(bool sticky) {
+    constexpr size_t kCount = 10;
+    ConnectionSlots slots(kCount, sticky);
+    expectEqual(slots.inUse(), 0, "new pool in use");
+
+    uint32_t slot = slots.tryAcquire();
+    expectEqual(slot != ConnectionSlots::kNoSlot, 1, "first acquire");
+    expectEqual(slots.inUse(), 1, "in use after one acquire");
+    slots.release(slot);
+    expectEqual(slots.inUse(), 0, "in use after release");
+
+    std::vector<uint32_t> taken;
+    for (uint32_t s = slots.tryAcquire(); s != ConnectionSlots::kNoSlot; s = slots.tryAcquire()) {
+        taken.push_back(s);
+    }
+    expectEqual(taken.size(), kCount, "slots acquired until empty");
+    expectEqual(slots.inUse(), kCount, "in use when exhausted");
+    for (uint32_t s : taken) {
+        slots.release(s);
+    }
+    expectEqual(slots.inUse(), 0, "in use after releasing all");
+}
+
+}  // namespace
+
+int main() {
+    checkPool(false);
+    checkPool(true);
+    if (failures == 0) {
+        std::printf("connection_slots_test passed\n");
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
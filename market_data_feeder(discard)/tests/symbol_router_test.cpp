@@ -0,0 +1,85 @@
+// SymbolRouter 在成员满 64 个时的分片：worker_id 1 ~ 64 都有成员位、都分到证券，
+// 移除一个成员只让它自己的证券换主
+#include "common/symbol_router.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace market_feeder;
+
+namespace {
+
+int failures = 0;
+
+void expect(bool condition, const char* what) {
+    if (!condition) {
+        std::fprintf(stderr, "FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+std::vector<std::string> sampleKeys() {
+    std::vector<std::string> keys;
+    for (int i = 0; i < 20000; ++i) {
+        keys.push_back(std::to_string(600000 + i) + ".SH");
+    }
+    return keys;
+}
+
+}  // namespace
+
+int main() {
+    const int kMembers = SymbolRouter::kMaxMembers;
+
+    uint64_t members = 0;
+    for (int worker_id = 1; worker_id <= kMembers; ++worker_id) {
+        expect(SymbolRouter::memberBit(worker_id) != 0, "every worker_id has a member bit");
+        members |= SymbolRouter::memberBit(worker_id);
+    }
+    expect(members == ~uint64_t(0), "64 members fill the bitmap");
+    expect(SymbolRouter::memberBit(0) == 0, "worker_id 0 has no member bit");
+    expect(SymbolRouter::memberBit(kMembers + 1) == 0, "worker_id 65 has no member bit");
+
+    SymbolRouter router;
+    router.rebuild(members);
+    expect(!router.contains(0), "worker_id 0 is not a member");
+    expect(router.contains(kMembers), "worker_id 64 is a member");
+
+    std::vector<std::string> keys = sampleKeys();
+    std::vector<int> owned(kMembers + 1, 0);
+    std::vector<int> owners;
+    for (const auto& key : keys) {
+        int owner = router.ownerOf(key);
+        expect(owner >= 1 && owner <= kMembers, "owner is a valid worker_id");
+        if (owner >= 1 && owner <= kMembers) {
+            ++owned[owner];
+        }
+        owners.push_back(owner);
+    }
+    for (int worker_id = 1; worker_id <= kMembers; ++worker_id) {
+        if (owned[worker_id] == 0) {
+            std::fprintf(stderr, "FAILED: worker %d owns no keys\n", worker_id);
+            ++failures;
+        }
+    }
+    expect(router.select(keys, kMembers).size() == static_cast<size_t>(owned[kMembers]),
+           "select agrees with ownerOf for worker 64");
+
+    // 移除 64 号成员：只有它的证券换主，且不会落到已移除的成员上
+    SymbolRouter shrunk;
+    shrunk.rebuild(members & ~SymbolRouter::memberBit(kMembers));
+    for (size_t i = 0; i < keys.size(); ++i) {
+        int owner = shrunk.ownerOf(keys[i]);
+        if (owners[i] == kMembers) {
+            expect(owner != kMembers, "removed member owns nothing");
+        } else {
+            expect(owner == owners[i], "other keys keep their owner");
+        }
+    }
+
+    if (failures == 0) {
+        std::printf("symbol_router_test passed\n");
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,97 @@
+// TickCache 的命中条件：最新缓存桶之后已经过去的时间段不由缓存回答，
+// drop / clear 之后对应证券回退到数据库，总条数超过上限时淘汰最久没有写入的序列
+#include "database/tick_cache.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace market_feeder;
+
+namespace {
+
+int failures = 0;
+
+void expect(bool condition, const char* what) {
+    if (!condition) {
+        std::fprintf(stderr, "FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+MarketData tick(const std::string& symbol, std::chrono::system_clock::time_point timestamp) {
+    MarketData data;
+    data.setSymbol(symbol);
+    data.timestamp = timestamp;
+    data.price = 10.0;
+    data.volume = 100;
+    return data;
+}
+
+}  // namespace
+
+int main() {
+    using std::chrono::seconds;
+
+    TickCache::Options options;
+    options.bucket_ms = 1000;
+    options.bucket_count = 60;
+    TickCache cache(options);
+
+    // 首个桶不完整，从第二个桶起可由缓存服务
+    auto now = std::chrono::system_clock::now();
+    std::vector<MarketData> batch;
+    for (const char* symbol : {"600000.SH", "600001.SH"}) {
+        batch.push_back(tick(symbol, now - seconds(20)));
+        batch.push_back(tick(symbol, now - seconds(10)));
+    }
+    cache.insert(batch);
+
+    std::vector<MarketData> result;
+    expect(cache.query("600000.SH", MarketDataType::TICK, now - seconds(12), now - seconds(10), result),
+           "range ending at the newest bucket hits");
+    expect(result.size() == 1, "hit returns the cached tick");
+
+    // 最新桶之后过去的时间段缓存里没有，不能当作没有成交
+    expect(!cache.query("600000.SH", MarketDataType::TICK, now - seconds(12), now - seconds(5), result),
+           "range past the newest bucket misses");
+    expect(!cache.query("600000.SH", MarketDataType::TICK, now - seconds(12), now, result),
+           "range up to now misses when elapsed buckets are not cached");
+
+    // 当前桶还没结束，缓存写到当前桶时可以查到现在
+    cache.insert({tick("600000.SH", now)});
+    result.clear();
+    expect(cache.query("600000.SH", MarketDataType::TICK, now - seconds(12), now, result),
+           "range up to now hits once the current bucket is cached");
+    expect(result.size() == 2, "hit returns both cached ticks");
+
+    cache.drop({"600000.SH"});
+    expect(!cache.query("600000.SH", MarketDataType::TICK, now - seconds(12), now, result),
+           "dropped symbol misses");
+    expect(cache.query("600001.SH", MarketDataType::TICK, now - seconds(12), now - seconds(10), result),
+           "other symbols stay cached after drop");
+    expect(cache.getStats().series == 1, "drop removes the series");
+
+    cache.clear();
+    expect(!cache.query("600001.SH", MarketDataType::TICK, now - seconds(12), now - seconds(10), result),
+           "clear removes every series");
+    expect(cache.getStats().series == 0, "clear leaves no series");
+
+    // 上限 100 条：较新的序列写入后总数超限，最久没有写入的序列整体淘汰
+    TickCache::Options bounded_options = options;
+    bounded_options.max_total_ticks = 100;
+    TickCache bounded(bounded_options);
+    std::vector<MarketData> stale(60, tick("600002.SH", now - seconds(30)));
+    std::vector<MarketData> fresh(60, tick("600003.SH", now - seconds(10)));
+    bounded.insert(stale);
+    bounded.insert(fresh);
+    TickCache::Stats bounded_stats = bounded.getStats();
+    expect(bounded_stats.ticks <= 100, "total ticks stay within the budget");
+    expect(bounded_stats.evicted_series == 1, "one series is evicted");
+    expect(bounded_stats.series == 1 && bounded_stats.ticks == 60, "the fresher series is kept");
+
+    if (failures == 0) {
+        std::printf("tick_cache_test passed\n");
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
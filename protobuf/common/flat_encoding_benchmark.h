@@ -0,0 +1,165 @@
+#pragma once
+
+// 定长布局 FlatTestMessage 与 protobuf 的编码 / 解码 / 字段访问对比。
+// pb_3_6_1 与 pb_3_19_6 共用，由各自的 protobuf_test_*.cpp 包含一次。
+// 参数为 values 字段长度，name 固定为 16 字节的合约代码长度。
+
+#include <benchmark/benchmark.h>
+#include "flat_test_message.h"
+#include "message.pb.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+static void FillFlatSampleMessage(benchmark::TestMessage* message, int values) {
+    message->set_id(1);
+    message->set_name("SH.600000.XSHG..");
+    for (int i = 0; i < values; ++i) {
+        message->add_values(10000 + (i * 37) % 90000);
+    }
+}
+
+// int32_t 数组承载缓冲区，保证 4 字节对齐
+static std::vector<int32_t> FlatBuffer(size_t bytes) {
+    return std::vector<int32_t>((bytes + 3) / 4);
+}
+
+static void BM_Flat_Encode(benchmark::State& state) {
+    benchmark::TestMessage message;
+    FillFlatSampleMessage(&message, static_cast<int>(state.range(0)));
+    const size_t size = FlatTestMessage::EncodedSize(message);
+    std::vector<int32_t> buffer = FlatBuffer(size);
+
+    for (auto _ : state) {
+        size_t written = FlatTestMessage::Encode(message, buffer.data(), size);
+        benchmark::DoNotOptimize(written);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * size);
+    state.counters["wire_bytes"] = static_cast<double>(size);
+}
+
+static void BM_PB_EncodeToArray(benchmark::State& state) {
+    benchmark::TestMessage message;
+    FillFlatSampleMessage(&message, static_cast<int>(state.range(0)));
+    std::vector<char> buffer(message.ByteSizeLong());
+
+    for (auto _ : state) {
+        bool ok = message.SerializeToArray(buffer.data(), static_cast<int>(buffer.size()));
+        benchmark::DoNotOptimize(ok);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+    state.counters["wire_bytes"] = static_cast<double>(buffer.size());
+}
+
+// 解码：Flat 只做头部校验建立视图；protobuf 需要完整解析到复用的消息对象
+static void BM_Flat_Decode(benchmark::State& state) {
+    benchmark::TestMessage message;
+    FillFlatSampleMessage(&message, static_cast<int>(state.range(0)));
+    const size_t size = FlatTestMessage::EncodedSize(message);
+    std::vector<int32_t> buffer = FlatBuffer(size);
+    FlatTestMessage::Encode(message, buffer.data(), size);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(buffer.data());
+        FlatTestMessage view(buffer.data(), size);
+        bool ok = view.valid();
+        benchmark::DoNotOptimize(ok);
+    }
+    // 循环内只读取并校验了头部，值数组与名称未被访问，吞吐量只计头部字节
+    state.SetBytesProcessed(state.iterations() * sizeof(FlatTestMessage::Header));
+    state.counters["wire_bytes"] = static_cast<double>(size);
+}
+
+static void BM_PB_Decode(benchmark::State& state) {
+    benchmark::TestMessage message;
+    FillFlatSampleMessage(&message, static_cast<int>(state.range(0)));
+    std::string input;
+    message.SerializeToString(&input);
+    benchmark::TestMessage parsed;
+
+    for (auto _ : state) {
+        bool ok = parsed.ParseFromArray(input.data(), static_cast<int>(input.size()));
+        benchmark::DoNotOptimize(ok);
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+// 解码 + 读取全部字段：id、name 长度与 values 求和
+static void BM_Flat_DecodeAccessAll(benchmark::State& state) {
+    benchmark::TestMessage message;
+    FillFlatSampleMessage(&message, static_cast<int>(state.range(0)));
+    const size_t size = FlatTestMessage::EncodedSize(message);
+    std::vector<int32_t> buffer = FlatBuffer(size);
+    FlatTestMessage::Encode(message, buffer.data(), size);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(buffer.data());
+        FlatTestMessage view(buffer.data(), size);
+        int64_t sum = view.id() + static_cast<int64_t>(view.name_size());
+        const int32_t* values = view.values();
+        for (size_t i = 0; i < view.values_size(); ++i) {
+            sum += values[i];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(state.iterations() * size);
+}
+
+static void BM_PB_DecodeAccessAll(benchmark::State& state) {
+    benchmark::TestMessage message;
+    FillFlatSampleMessage(&message, static_cast<int>(state.range(0)));
+    std::string input;
+    message.SerializeToString(&input);
+    benchmark::TestMessage parsed;
+
+    for (auto _ : state) {
+        parsed.ParseFromArray(input.data(), static_cast<int>(input.size()));
+        int64_t sum = parsed.id() + static_cast<int64_t>(parsed.name().size());
+        for (int i = 0; i < parsed.values_size(); ++i) {
+            sum += parsed.values(i);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+// 只读取最后一个 value：Flat 直接按偏移访问，protobuf 仍需解析整条消息
+static void BM_Flat_AccessLastValue(benchmark::State& state) {
+    benchmark::TestMessage message;
+    FillFlatSampleMessage(&message, static_cast<int>(state.range(0)));
+    const size_t size = FlatTestMessage::EncodedSize(message);
+    std::vector<int32_t> buffer = FlatBuffer(size);
+    FlatTestMessage::Encode(message, buffer.data(), size);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(buffer.data());
+        FlatTestMessage view(buffer.data(), size);
+        int32_t last = view.values(view.values_size() - 1);
+        benchmark::DoNotOptimize(last);
+    }
+}
+
+static void BM_PB_AccessLastValue(benchmark::State& state) {
+    benchmark::TestMessage message;
+    FillFlatSampleMessage(&message, static_cast<int>(state.range(0)));
+    std::string input;
+    message.SerializeToString(&input);
+    benchmark::TestMessage parsed;
+
+    for (auto _ : state) {
+        parsed.ParseFromArray(input.data(), static_cast<int>(input.size()));
+        int32_t last = parsed.values(parsed.values_size() - 1);
+        benchmark::DoNotOptimize(last);
+    }
+}
+
+BENCHMARK(BM_Flat_Encode)->RangeMultiplier(10)->Range(10, 10000);
+BENCHMARK(BM_PB_EncodeToArray)->RangeMultiplier(10)->Range(10, 10000);
+BENCHMARK(BM_Flat_Decode)->RangeMultiplier(10)->Range(10, 10000);
+BENCHMARK(BM_PB_Decode)->RangeMultiplier(10)->Range(10, 10000);
+BENCHMARK(BM_Flat_DecodeAccessAll)->RangeMultiplier(10)->Range(10, 10000);
+BENCHMARK(BM_PB_DecodeAccessAll)->RangeMultiplier(10)->Range(10, 10000);
+BENCHMARK(BM_Flat_AccessLastValue)->RangeMultiplier(10)->Range(10, 10000);
+BENCHMARK(BM_PB_AccessLastValue)->RangeMultiplier(10)->Range(10, 10000);
@@ -0,0 +1,119 @@
+#pragma once
+
+// TestMessage (id, name, values) 的定长布局编码，FlatBuffers 风格：
+// 编码后的字节可以直接 mmap 后访问，读取字段无需解析、无需分配，只做一次边界校验。
+//
+// 布局（小端，整体按 4 字节对齐）：
+//   Header { magic, total_size, id, name_offset, name_size, values_offset, values_count }
+//   name 字节（不含 '\0'，补齐到 4 字节）
+//   values: int32_t[values_count]
+// 偏移量都相对于消息起始位置，因此多条消息可以首尾相接地放在同一块缓冲区中。
+
+#include "message.pb.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+class FlatTestMessage {
+public:
+    static constexpr uint32_t kMagic = 0x31544D46;  // "FMT1"
+
+    struct Header {
+        uint32_t magic;
+        uint32_t total_size;
+        int32_t id;
+        uint32_t name_offset;
+        uint32_t name_size;
+        uint32_t values_offset;
+        uint32_t values_count;
+    };
+
+    // 编码所需字节数
+    static size_t EncodedSize(size_t name_size, size_t values_count) {
+        return Align4(sizeof(Header) + name_size) + values_count * sizeof(int32_t);
+    }
+
+    static size_t EncodedSize(const benchmark::TestMessage& message) {
+        return EncodedSize(message.name().size(), static_cast<size_t>(message.values_size()));
+    }
+
+    // 编码到 buffer，buffer 须 4 字节对齐且容量足够；返回写入字节数，容量不足返回 0
+    static size_t Encode(int32_t id, const char* name, size_t name_size, const int32_t* values, size_t values_count,
+                         void* buffer, size_t capacity) {
+        size_t total = EncodedSize(name_size, values_count);
+        if (total > capacity) {
+            return 0;
+        }
+
+        char* out = static_cast<char*>(buffer);
+        Header header;
+        header.magic = kMagic;
+        header.total_size = static_cast<uint32_t>(total);
+        header.id = id;
+        header.name_offset = sizeof(Header);
+        header.name_size = static_cast<uint32_t>(name_size);
+        header.values_offset = static_cast<uint32_t>(Align4(sizeof(Header) + name_size));
+        header.values_count = static_cast<uint32_t>(values_count);
+
+        std::memcpy(out, &header, sizeof(header));
+        std::memcpy(out + header.name_offset, name, name_size);
+        // 补齐字节清零，保证相同内容编码结果逐字节一致
+        std::memset(out + header.name_offset + name_size, 0, header.values_offset - header.name_offset - name_size);
+        std::memcpy(out + header.values_offset, values, values_count * sizeof(int32_t));
+        return total;
+    }
+
+    static size_t Encode(const benchmark::TestMessage& message, void* buffer, size_t capacity) {
+        return Encode(message.id(), message.name().data(), message.name().size(), message.values().data(),
+                      static_cast<size_t>(message.values_size()), buffer, capacity);
+    }
+
+    // 在已编码的字节上建立只读视图；数据不完整或不合法时 valid() 为 false
+    FlatTestMessage(const void* data, size_t size) : data_(static_cast<const char*>(data)) {
+        if (size < sizeof(Header) || reinterpret_cast<uintptr_t>(data) % alignof(Header) != 0) {
+            return;
+        }
+        const Header* header = reinterpret_cast<const Header*>(data_);
+        if (header->magic != kMagic || header->total_size > size || header->name_offset < sizeof(Header) ||
+            header->name_offset + static_cast<uint64_t>(header->name_size) > header->values_offset ||
+            header->values_offset % alignof(int32_t) != 0 ||
+            header->values_offset + static_cast<uint64_t>(header->values_count) * sizeof(int32_t) > header->total_size) {
+            return;
+        }
+        header_ = header;
+    }
+
+    bool valid() const { return header_ != nullptr; }
+
+    // 以下访问器要求 valid()
+    int32_t id() const { return header_->id; }
+
+    std::string name() const { return std::string(name_data(), name_size()); }
+    const char* name_data() const { return data_ + header_->name_offset; }
+    size_t name_size() const { return header_->name_size; }
+
+    const int32_t* values() const { return reinterpret_cast<const int32_t*>(data_ + header_->values_offset); }
+    size_t values_size() const { return header_->values_count; }
+    int32_t values(size_t index) const { return values()[index]; }
+
+    // 本条消息占用的字节数，用于在缓冲区中定位下一条
+    size_t total_size() const { return header_->total_size; }
+
+    // 物化为 protobuf 消息，便于与现有代码互通
+    void ToMessage(benchmark::TestMessage* message) const {
+        message->set_id(id());
+        message->set_name(name_data(), name_size());
+        message->mutable_values()->Clear();
+        message->mutable_values()->Reserve(static_cast<int>(values_size()));
+        for (size_t i = 0; i < values_size(); ++i) {
+            message->add_values(values()[i]);
+        }
+    }
+
+private:
+    static size_t Align4(size_t n) { return (n + 3) & ~static_cast<size_t>(3); }
+
+    const char* data_;
+    const Header* header_ = nullptr;
+};
@@ -0,0 +1,158 @@
+#pragma once
+
+// 长度前缀的消息流：多条消息顺序写入同一块连续内存（预分配缓冲区或 mmap 文件），
+// 每条消息前写一个 varint 长度，与 protobuf 的 SerializeDelimitedTo* 线格式一致。
+// 写端基于 ZeroCopyOutputStream + CodedOutputStream，读端按长度前缀切分后原地解析，
+// 两者都不为单条消息分配 std::string。接口只依赖 MessageLite，3.6.1 与 3.19.6 通用。
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/message_lite.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+// 单条消息编码后（含长度前缀）占用的字节数，用于预估缓冲区大小
+inline size_t DelimitedMessageSize(const google::protobuf::MessageLite& message) {
+    size_t size = message.ByteSizeLong();
+    return google::protobuf::io::CodedOutputStream::VarintSize32(static_cast<uint32_t>(size)) + size;
+}
+
+class MessageStreamWriter {
+public:
+    // 写入调用方提供的 ZeroCopyOutputStream，流的生命周期须长于 writer
+    explicit MessageStreamWriter(google::protobuf::io::ZeroCopyOutputStream* output)
+        : coded_(output) {}
+
+    // 写入一段连续内存
+    MessageStreamWriter(void* buffer, size_t size)
+        : array_(new google::protobuf::io::ArrayOutputStream(buffer, static_cast<int>(size < INT_MAX ? size : INT_MAX))),
+          coded_(array_.get()) {}
+
+    MessageStreamWriter(const MessageStreamWriter&) = delete;
+    MessageStreamWriter& operator=(const MessageStreamWriter&) = delete;
+
+    // 空间不足或序列化失败时返回 false，之后的写入都会失败
+    bool Write(const google::protobuf::MessageLite& message) {
+        size_t size = message.ByteSizeLong();
+        if (size > INT_MAX) {
+            return false;
+        }
+        coded_.WriteVarint32(static_cast<uint32_t>(size));
+        message.SerializeWithCachedSizes(&coded_);
+        if (coded_.HadError()) {
+            return false;
+        }
+        ++count_;
+        return true;
+    }
+
+    size_t count() const { return count_; }
+
+    // 已写入字节数
+    size_t bytes_written() const { return static_cast<size_t>(coded_.ByteCount()); }
+
+private:
+    // 声明顺序保证 coded_ 先析构，把未使用的字节归还给底层流
+    std::unique_ptr<google::protobuf::io::ArrayOutputStream> array_;
+    google::protobuf::io::CodedOutputStream coded_;
+    size_t count_ = 0;
+};
+
+class MessageStreamReader {
+public:
+    MessageStreamReader(const void* data, size_t size)
+        : data_(static_cast<const uint8_t*>(data)), size_(size) {}
+
+    // 读取下一条消息到 message（覆盖原内容），流结束返回 false；数据损坏时 ok() 变为 false
+    bool Next(google::protobuf::MessageLite* message) {
+        if (offset_ >= size_ || !ok_) {
+            return false;
+        }
+
+        // 消息体已知边界，直接交给 ParseFromArray，走与 ParseFromString 相同的快速解析路径。
+        // 长度前缀就地解码：为每条消息构造一个 CodedInputStream 只为读一个 varint 反而更贵
+        size_t remaining = size_ - offset_;
+        uint32_t length = 0;
+        size_t header = 0;
+        if (!ReadLength(data_ + offset_, remaining, &length, &header)) {
+            ok_ = false;
+            return false;
+        }
+
+        if (length > remaining - header || !message->ParseFromArray(data_ + offset_ + header, static_cast<int>(length))) {
+            ok_ = false;
+            return false;
+        }
+
+        offset_ += header + length;
+        return true;
+    }
+
+    bool ok() const { return ok_; }
+    size_t offset() const { return offset_; }
+
+private:
+    // varint32 长度前缀，最多 5 字节
+    static bool ReadLength(const uint8_t* p, size_t available, uint32_t* length, size_t* header) {
+        uint32_t result = 0;
+        for (size_t i = 0; i < 5 && i < available; ++i) {
+            result |= static_cast<uint32_t>(p[i] & 0x7F) << (7 * i);
+            if ((p[i] & 0x80) == 0) {
+                *length = result;
+                *header = i + 1;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const uint8_t* data_;
+    size_t size_;
+    size_t offset_ = 0;
+    bool ok_ = true;
+};
+
+// 可读写映射的定长文件，用作消息流的落盘缓冲区
+class MappedFile {
+public:
+    MappedFile(const std::string& path, size_t size) : size_(size) {
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd_ < 0) {
+            throw std::runtime_error("MappedFile: open failed: " + path);
+        }
+        if (::ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+            ::close(fd_);
+            throw std::runtime_error("MappedFile: ftruncate failed: " + path);
+        }
+        data_ = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (data_ == MAP_FAILED) {
+            ::close(fd_);
+            throw std::runtime_error("MappedFile: mmap failed: " + path);
+        }
+    }
+
+    ~MappedFile() {
+        ::munmap(data_, size_);
+        ::close(fd_);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    void* data() { return data_; }
+    const void* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    int fd_ = -1;
+    void* data_ = nullptr;
+    size_t size_ = 0;
+};
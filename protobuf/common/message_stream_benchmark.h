@@ -0,0 +1,166 @@
+#pragma once
+
+// 批量发送：逐条 SerializeToString 与长度前缀消息流对比，1k~1M 条消息。
+// pb_3_6_1 与 pb_3_19_6 共用，由各自的 protobuf_test_*.cpp 包含一次。
+
+#include <benchmark/benchmark.h>
+#include "message.pb.h"
+#include "message_stream.h"
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// 16 条内容不同的消息循环使用，避免为 1M 条消息各构建一个对象
+static const std::vector<benchmark::TestMessage>& StreamSampleMessages() {
+    static const std::vector<benchmark::TestMessage> messages = [] {
+        std::vector<benchmark::TestMessage> result(16);
+        for (int i = 0; i < 16; ++i) {
+            result[i].set_id(i);
+            result[i].set_name("inst" + std::to_string(i));
+            for (int j = 0; j < 20; ++j) {
+                result[i].add_values(10000 + (i * 131 + j * 37) % 90000);
+            }
+        }
+        return result;
+    }();
+    return messages;
+}
+
+static size_t StreamBufferSize(size_t count) {
+    const auto& messages = StreamSampleMessages();
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        total += DelimitedMessageSize(messages[i % messages.size()]);
+    }
+    return total;
+}
+
+// 现状：每条消息序列化到各自的 std::string
+static void BM_PB_Batch_SerializeToString(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    const auto& messages = StreamSampleMessages();
+    size_t bytes = 0;
+
+    for (auto _ : state) {
+        std::vector<std::string> outputs(count);
+        bytes = 0;
+        for (size_t i = 0; i < count; ++i) {
+            messages[i % messages.size()].SerializeToString(&outputs[i]);
+            bytes += outputs[i].size();
+        }
+        benchmark::DoNotOptimize(outputs.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+// 消息流写入预分配的连续缓冲区
+static void BM_PB_Batch_StreamWrite(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    const auto& messages = StreamSampleMessages();
+    std::vector<char> buffer(StreamBufferSize(count));
+    size_t bytes = 0;
+
+    for (auto _ : state) {
+        MessageStreamWriter writer(buffer.data(), buffer.size());
+        for (size_t i = 0; i < count; ++i) {
+            if (!writer.Write(messages[i % messages.size()])) {
+                state.SkipWithError("stream buffer overflow");
+                break;
+            }
+        }
+        bytes = writer.bytes_written();
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+// 消息流写入 mmap 文件（页已预先触碰，测的是稳态写入成本）
+static void BM_PB_Batch_StreamWriteMapped(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    const auto& messages = StreamSampleMessages();
+    char path[] = "/tmp/pb_stream_benchXXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        state.SkipWithError("mkstemp failed");
+        return;
+    }
+    close(fd);
+    MappedFile file(path, StreamBufferSize(count));
+    unlink(path);
+    // 计时前整块写一遍，缺页和页缓存分配不计入第一轮迭代
+    memset(file.data(), 0, file.size());
+    size_t bytes = 0;
+
+    for (auto _ : state) {
+        MessageStreamWriter writer(file.data(), file.size());
+        for (size_t i = 0; i < count; ++i) {
+            if (!writer.Write(messages[i % messages.size()])) {
+                state.SkipWithError("stream buffer overflow");
+                break;
+            }
+        }
+        bytes = writer.bytes_written();
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+// 现状：逐个 std::string 解析
+static void BM_PB_Batch_ParseStrings(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    const auto& messages = StreamSampleMessages();
+    std::vector<std::string> inputs(count);
+    size_t bytes = 0;
+    for (size_t i = 0; i < count; ++i) {
+        messages[i % messages.size()].SerializeToString(&inputs[i]);
+        bytes += inputs[i].size();
+    }
+
+    benchmark::TestMessage message;
+    for (auto _ : state) {
+        for (const auto& input : inputs) {
+            bool ok = message.ParseFromString(input);
+            benchmark::DoNotOptimize(ok);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+// 从连续缓冲区顺序读取消息流
+static void BM_PB_Batch_StreamRead(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    const auto& messages = StreamSampleMessages();
+    std::vector<char> buffer(StreamBufferSize(count));
+    {
+        MessageStreamWriter writer(buffer.data(), buffer.size());
+        for (size_t i = 0; i < count; ++i) {
+            writer.Write(messages[i % messages.size()]);
+        }
+    }
+
+    benchmark::TestMessage message;
+    for (auto _ : state) {
+        MessageStreamReader reader(buffer.data(), buffer.size());
+        size_t read = 0;
+        while (reader.Next(&message)) {
+            ++read;
+        }
+        if (read != count || !reader.ok()) {
+            state.SkipWithError("stream decode failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+
+BENCHMARK(BM_PB_Batch_SerializeToString)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PB_Batch_StreamWrite)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PB_Batch_StreamWriteMapped)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PB_Batch_ParseStrings)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PB_Batch_StreamRead)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
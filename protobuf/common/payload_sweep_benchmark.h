@@ -0,0 +1,94 @@
+#pragma once
+
+// 载荷规模扫描：pb_3_6_1 与 pb_3_19_6 两个基准程序共用同一份用例，
+// 保证两个版本在完全相同的数据上对比。由各自的 protobuf_test_*.cpp 包含一次。
+// 参数：values 为 repeated 字段长度，name_len 为 name 字段字节数。
+
+#include <benchmark/benchmark.h>
+#include "message.pb.h"
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <cstdint>
+#include <string>
+
+// 数值分布接近行情价格/数量，编码后多为 2~3 字节的 varint
+static void FillSweepMessage(benchmark::TestMessage* message, int values, int name_len) {
+    message->set_id(1);
+    message->set_name(std::string(name_len, 'n'));
+    message->mutable_values()->Reserve(values);
+    for (int i = 0; i < values; ++i) {
+        message->add_values(10000 + (i * 37) % 90000);
+    }
+}
+
+// 手工按非 packed 格式编码同一条消息：每个元素各带一个 tag。
+// proto3 的 repeated int32 默认 packed，解析端按规范必须同时接受两种编码，
+// 这样无需修改 message.proto 并用两个版本的 protoc 重新生成代码即可覆盖非 packed 的解析路径
+static std::string EncodeSweepMessageUnpacked(int values, int name_len) {
+    const uint32_t kIdTag = (1 << 3) | 0;      // varint
+    const uint32_t kNameTag = (2 << 3) | 2;    // length-delimited
+    const uint32_t kValuesTag = (3 << 3) | 0;  // varint，非 packed
+
+    std::string output;
+    {
+        google::protobuf::io::StringOutputStream stream(&output);
+        google::protobuf::io::CodedOutputStream coded(&stream);
+        coded.WriteTag(kIdTag);
+        coded.WriteVarint32SignExtended(1);
+        coded.WriteTag(kNameTag);
+        coded.WriteVarint32(static_cast<uint32_t>(name_len));
+        coded.WriteString(std::string(name_len, 'n'));
+        for (int i = 0; i < values; ++i) {
+            coded.WriteTag(kValuesTag);
+            coded.WriteVarint32SignExtended(10000 + (i * 37) % 90000);
+        }
+    }
+    return output;
+}
+
+static std::string EncodeSweepMessagePacked(int values, int name_len) {
+    benchmark::TestMessage message;
+    FillSweepMessage(&message, values, name_len);
+    std::string output;
+    message.SerializeToString(&output);
+    return output;
+}
+
+// 序列化（schema 为 packed）
+static void BM_PB_Sweep_Serialize(benchmark::State& state) {
+    benchmark::TestMessage message;
+    FillSweepMessage(&message, static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    std::string output;
+
+    for (auto _ : state) {
+        message.SerializeToString(&output);
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetBytesProcessed(state.iterations() * output.size());
+    state.counters["wire_bytes"] = static_cast<double>(output.size());
+}
+
+// 解析，state.range(2) 为 1 时输入为 packed 编码，0 为非 packed 编码
+static void BM_PB_Sweep_Parse(benchmark::State& state) {
+    const int values = static_cast<int>(state.range(0));
+    const int name_len = static_cast<int>(state.range(1));
+    const std::string input = state.range(2) ? EncodeSweepMessagePacked(values, name_len)
+                                             : EncodeSweepMessageUnpacked(values, name_len);
+    benchmark::TestMessage message;
+
+    for (auto _ : state) {
+        message.Clear();
+        bool ok = message.ParseFromArray(input.data(), static_cast<int>(input.size()));
+        benchmark::DoNotOptimize(ok);
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+    state.counters["wire_bytes"] = static_cast<double>(input.size());
+}
+
+BENCHMARK(BM_PB_Sweep_Serialize)
+    ->ArgNames({"values", "name_len"})
+    ->ArgsProduct({{10, 100, 1000, 10000}, {4, 64, 1024}});
+
+BENCHMARK(BM_PB_Sweep_Parse)
+    ->ArgNames({"values", "name_len", "packed"})
+    ->ArgsProduct({{10, 100, 1000, 10000}, {4, 64, 1024}, {1, 0}});
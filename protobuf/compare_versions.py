@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+"""并排对比 pb_3_6_1 与 pb_3_19_6 两个基准程序的结果。
+
+两个程序编译自同一份 message.proto 和同一份用例 (common/payload_sweep_benchmark.h)，
+本脚本分别运行后按用例名合并，输出每个用例在两个版本下的耗时及比值。
+
+用法:
+    python3 protobuf/compare_versions.py [--bin-dir build/bin] [--filter BM_PB_Sweep] [-- 其他基准参数]
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+
+VERSIONS = [("3.6.1", "benchmark_pb_3_6_1"), ("3.19.6", "benchmark_pb_3_19_6")]
+
+
+def run_benchmark(path, bench_filter, extra_args):
+    cmd = [path, "--benchmark_format=json", "--benchmark_filter=" + bench_filter] + extra_args
+    output = subprocess.run(cmd, check=True, stdout=subprocess.PIPE).stdout
+    results = {}
+    for bench in json.loads(output)["benchmarks"]:
+        if bench.get("run_type", "iteration") != "iteration":
+            continue
+        results[bench["name"]] = bench
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--bin-dir", default="build/bin", help="directory containing both benchmark binaries")
+    parser.add_argument("--filter", default="BM_PB_Sweep", help="--benchmark_filter passed to both binaries")
+    parser.add_argument("extra", nargs="*", help="extra arguments passed to both binaries")
+    args = parser.parse_args()
+
+    runs = []
+    for version, binary in VERSIONS:
+        path = os.path.join(args.bin_dir, binary)
+        if not os.path.exists(path):
+            sys.exit("benchmark binary not found: " + path)
+        runs.append(run_benchmark(path, args.filter, args.extra))
+
+    old, new = runs
+    names = [name for name in old if name in new]
+    width = max([len(name) for name in names] + [9])
+    header = "%-*s %14s %14s %8s %12s" % (width, "Benchmark", "3.6.1 (ns)", "3.19.6 (ns)", "ratio", "wire_bytes")
+    print(header)
+    print("-" * len(header))
+    for name in names:
+        old_ns = old[name]["real_time"]
+        new_ns = new[name]["real_time"]
+        ratio = new_ns / old_ns if old_ns > 0 else float("nan")
+        wire_bytes = old[name].get("wire_bytes", "")
+        print("%-*s %14.1f %14.1f %8.2f %12s" % (width, name, old_ns, new_ns, ratio,
+                                                 "%d" % wire_bytes if wire_bytes != "" else ""))
+
+
+if __name__ == "__main__":
+    main()
@@ -1,7 +1,11 @@
 #include <benchmark/benchmark.h>
 #include "message.pb.h"
+#include <google/protobuf/arena.h>
 #include <string>
 #include <vector>
+#include "flat_encoding_benchmark.h"
+#include "message_stream_benchmark.h"
+#include "payload_sweep_benchmark.h"
 
 // 序列化基准测试
 static void BM_PB_Serialize(benchmark::State& state) {
@@ -38,4 +42,155 @@ static void BM_PB_Deserialize(benchmark::State& state) {
     }
 }
 
-BENCHMARK(BM_PB_Deserialize);
\ No newline at end of file
+BENCHMARK(BM_PB_Deserialize);
+
+// ---------------- 减少分配：Arena / 消息复用 / 预分配缓冲区 ----------------
+// 以下用例都通过 SetBytesProcessed 上报序列化后的字节数，输出 MB/s
+
+// 与上面两个用例相同的测试数据
+static void FillTestMessage(benchmark::TestMessage* message) {
+    message->set_id(1);
+    message->set_name("test");
+    for (int i = 0; i < 100; ++i) {
+        message->add_values(i);
+    }
+}
+
+static std::string SerializedTestMessage() {
+    benchmark::TestMessage message;
+    FillTestMessage(&message);
+    std::string output;
+    message.SerializeToString(&output);
+    return output;
+}
+
+// 序列化到预分配的定长缓冲区，不经过 std::string
+static void BM_PB_SerializeToArray(benchmark::State& state) {
+    benchmark::TestMessage message;
+    FillTestMessage(&message);
+    std::vector<char> buffer(message.ByteSizeLong());
+    const int size = static_cast<int>(buffer.size());
+
+    for (auto _ : state) {
+        bool ok = message.SerializeToArray(buffer.data(), size);
+        benchmark::DoNotOptimize(ok);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * size);
+}
+
+BENCHMARK(BM_PB_SerializeToArray);
+
+// 复用同一个 std::string，容量保留后不再重新分配
+static void BM_PB_SerializeToString_Reuse(benchmark::State& state) {
+    benchmark::TestMessage message;
+    FillTestMessage(&message);
+    std::string output;
+
+    for (auto _ : state) {
+        message.SerializeToString(&output);
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetBytesProcessed(state.iterations() * output.size());
+}
+
+BENCHMARK(BM_PB_SerializeToString_Reuse);
+
+// 每次新建消息反序列化，作为下面几种方式的对照
+static void BM_PB_Deserialize_Fresh(benchmark::State& state) {
+    const std::string input = SerializedTestMessage();
+
+    for (auto _ : state) {
+        benchmark::TestMessage new_message;
+        bool ok = new_message.ParseFromArray(input.data(), static_cast<int>(input.size()));
+        benchmark::DoNotOptimize(ok);
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+BENCHMARK(BM_PB_Deserialize_Fresh);
+
+// Clear() 后复用同一消息：repeated 字段和 string 的已分配容量会被保留
+static void BM_PB_Deserialize_Reuse(benchmark::State& state) {
+    const std::string input = SerializedTestMessage();
+    benchmark::TestMessage message;
+
+    for (auto _ : state) {
+        message.Clear();
+        bool ok = message.ParseFromArray(input.data(), static_cast<int>(input.size()));
+        benchmark::DoNotOptimize(ok);
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+BENCHMARK(BM_PB_Deserialize_Reuse);
+
+// 每次新建 Arena，消息及其字段都从 Arena 分配，析构时整体释放
+static void BM_PB_Deserialize_Arena(benchmark::State& state) {
+    const std::string input = SerializedTestMessage();
+
+    for (auto _ : state) {
+        google::protobuf::Arena arena;
+        auto* message = google::protobuf::Arena::CreateMessage<benchmark::TestMessage>(&arena);
+        bool ok = message->ParseFromArray(input.data(), static_cast<int>(input.size()));
+        benchmark::DoNotOptimize(ok);
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+BENCHMARK(BM_PB_Deserialize_Arena);
+
+// Arena 使用调用方提供的初始内存块并在每轮 Reset()，稳态下完全不触发堆分配
+static void BM_PB_Deserialize_ArenaReuse(benchmark::State& state) {
+    const std::string input = SerializedTestMessage();
+    std::vector<char> initial_block(64 * 1024);
+    google::protobuf::ArenaOptions options;
+    options.initial_block = initial_block.data();
+    options.initial_block_size = initial_block.size();
+    google::protobuf::Arena arena(options);
+
+    for (auto _ : state) {
+        auto* message = google::protobuf::Arena::CreateMessage<benchmark::TestMessage>(&arena);
+        bool ok = message->ParseFromArray(input.data(), static_cast<int>(input.size()));
+        benchmark::DoNotOptimize(ok);
+        arena.Reset();
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+BENCHMARK(BM_PB_Deserialize_ArenaReuse);
+
+// 构建 + 序列化的完整发送路径：堆上新建消息与 Arena 上构建对比
+static void BM_PB_BuildSerialize_Heap(benchmark::State& state) {
+    std::vector<char> buffer(SerializedTestMessage().size());
+
+    for (auto _ : state) {
+        benchmark::TestMessage message;
+        FillTestMessage(&message);
+        bool ok = message.SerializeToArray(buffer.data(), static_cast<int>(buffer.size()));
+        benchmark::DoNotOptimize(ok);
+    }
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+
+BENCHMARK(BM_PB_BuildSerialize_Heap);
+
+static void BM_PB_BuildSerialize_Arena(benchmark::State& state) {
+    std::vector<char> buffer(SerializedTestMessage().size());
+    std::vector<char> initial_block(64 * 1024);
+    google::protobuf::ArenaOptions options;
+    options.initial_block = initial_block.data();
+    options.initial_block_size = initial_block.size();
+    google::protobuf::Arena arena(options);
+
+    for (auto _ : state) {
+        auto* message = google::protobuf::Arena::CreateMessage<benchmark::TestMessage>(&arena);
+        FillTestMessage(message);
+        bool ok = message->SerializeToArray(buffer.data(), static_cast<int>(buffer.size()));
+        benchmark::DoNotOptimize(ok);
+        arena.Reset();
+    }
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+
+BENCHMARK(BM_PB_BuildSerialize_Arena);
@@ -2,6 +2,9 @@
 #include "message.pb.h"
 #include <string>
 #include <vector>
+#include "flat_encoding_benchmark.h"
+#include "message_stream_benchmark.h"
+#include "payload_sweep_benchmark.h"
 
 // 序列化基准测试
 static void BM_PB_Serialize(benchmark::State& state) {
@@ -0,0 +1,64 @@
+// 各接口 / 各块设备统计的采集成本：netlink RTM_GETSTATS（只含 IFLA_STATS_LINK_64）、
+// RTM_GETLINK 完整 dump 与解析 /proc/net/dev 文本的对比，以及 /proc/diskstats 的单次读取
+#include <benchmark/benchmark.h>
+#include "device_stats.h"
+#include <vector>
+
+namespace {
+
+void BM_LinkStats_Netlink(benchmark::State& state) {
+    LinkStatsScraper scraper;
+    if (!scraper.usingNetlink()) {
+        state.SkipWithError("NETLINK_ROUTE socket unavailable");
+        return;
+    }
+    std::vector<InterfaceSample> samples;
+    for (auto _ : state) {
+        bool ok = scraper.scrapeNetlink(samples);
+        benchmark::DoNotOptimize(ok);
+        benchmark::DoNotOptimize(samples.data());
+    }
+    state.counters["interfaces"] = static_cast<double>(samples.size());
+}
+BENCHMARK(BM_LinkStats_Netlink);
+
+void BM_LinkStats_LinkDump(benchmark::State& state) {
+    LinkStatsScraper scraper;
+    if (!scraper.usingNetlink()) {
+        state.SkipWithError("NETLINK_ROUTE socket unavailable");
+        return;
+    }
+    std::vector<InterfaceSample> samples;
+    for (auto _ : state) {
+        bool ok = scraper.scrapeLinkDump(samples);
+        benchmark::DoNotOptimize(ok);
+        benchmark::DoNotOptimize(samples.data());
+    }
+    state.counters["interfaces"] = static_cast<double>(samples.size());
+}
+BENCHMARK(BM_LinkStats_LinkDump);
+
+void BM_LinkStats_ProcNetDev(benchmark::State& state) {
+    LinkStatsScraper scraper;
+    std::vector<InterfaceSample> samples;
+    for (auto _ : state) {
+        scraper.scrapeProcNetDev(samples);
+        benchmark::DoNotOptimize(samples.data());
+    }
+    state.counters["interfaces"] = static_cast<double>(samples.size());
+}
+BENCHMARK(BM_LinkStats_ProcNetDev);
+
+void BM_DiskStats(benchmark::State& state) {
+    DiskStatsScraper scraper;
+    size_t devices = 0;
+    for (auto _ : state) {
+        const std::vector<BlockDeviceSample>& samples = scraper.scrape();
+        devices = samples.size();
+        benchmark::DoNotOptimize(samples.data());
+    }
+    state.counters["devices"] = static_cast<double>(devices);
+}
+BENCHMARK(BM_DiskStats);
+
+}  // namespace
@@ -0,0 +1,322 @@
+// 单次采样的 /proc 读取成本：原先每个指标各自构造 ifstream 逐行解析（Legacy），
+// 对比常驻 fd + pread + 非分配解析的 ProcScraper
+#include <benchmark/benchmark.h>
+#include "proc_scraper.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 与改造前 SystemMonitor 中 getCpuUsage / getMemoryInfo / getThreadCount / getProcessInfo /
+// getProcessSchedulingInfo / getDetailedMemoryInfo 等函数相同的读取方式
+struct LegacySample {
+    unsigned long long utime = 0, stime = 0;
+    int priority = 0, nice = 0;
+    size_t vm_rss = 0, vm_peak = 0, threads = 0, mem_total = 0;
+    size_t voluntary = 0, involuntary = 0;
+    std::string state;
+    size_t read_bytes = 0, write_bytes = 0, syscr = 0, syscw = 0;
+    size_t bytes_recv = 0, bytes_sent = 0, packets_recv = 0, packets_sent = 0;
+    double load1 = 0, load5 = 0, load15 = 0;
+    size_t running = 0, total = 0;
+    size_t max_open_files = 0;
+    size_t mem_available = 0, buffers = 0, cached = 0, swap_total = 0, swap_free = 0;
+    double uptime = 0;
+    std::vector<size_t> frequencies;
+    std::vector<double> temperatures;
+    std::string sched_line;
+};
+
+void legacyStatCpu(LegacySample& s) {
+    std::ifstream stat_file("/proc/self/stat");
+    std::string line;
+    std::getline(stat_file, line);
+    std::istringstream iss(line);
+    std::string token;
+    for (int i = 0; i < 13; ++i) {
+        iss >> token;
+    }
+    iss >> s.utime >> s.stime;
+}
+
+void legacyMemory(LegacySample& s) {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        std::istringstream iss(line);
+        std::string key, unit;
+        size_t value;
+        if (iss >> key >> value >> unit) {
+            if (key == "VmRSS:") {
+                s.vm_rss = value;
+            } else if (key == "VmPeak:") {
+                s.vm_peak = value;
+            }
+        }
+    }
+    std::ifstream meminfo("/proc/meminfo");
+    while (std::getline(meminfo, line)) {
+        if (line.substr(0, 9) == "MemTotal:") {
+            std::istringstream mem_iss(line);
+            std::string key;
+            mem_iss >> key >> s.mem_total;
+            break;
+        }
+    }
+}
+
+void legacyThreads(LegacySample& s) {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.substr(0, 8) == "Threads:") {
+            std::istringstream iss(line);
+            std::string label;
+            iss >> label >> s.threads;
+            break;
+        }
+    }
+}
+
+void legacyIo(LegacySample& s) {
+    std::ifstream io_file("/proc/self/io");
+    std::string line;
+    while (std::getline(io_file, line)) {
+        std::istringstream iss(line);
+        std::string key;
+        size_t value;
+        if (iss >> key >> value) {
+            if (key == "read_bytes:") {
+                s.read_bytes = value;
+            } else if (key == "write_bytes:") {
+                s.write_bytes = value;
+            } else if (key == "syscr:") {
+                s.syscr = value;
+            } else if (key == "syscw:") {
+                s.syscw = value;
+            }
+        }
+    }
+}
+
+void legacyNetwork(LegacySample& s) {
+    std::ifstream net_file("/proc/net/dev");
+    std::string line;
+    std::getline(net_file, line);
+    std::getline(net_file, line);
+    s.bytes_recv = s.bytes_sent = s.packets_recv = s.packets_sent = 0;
+    while (std::getline(net_file, line)) {
+        std::istringstream iss(line);
+        std::string interface;
+        size_t bytes_recv, packets_recv, bytes_sent, packets_sent, dummy;
+        if (iss >> interface >> bytes_recv >> packets_recv >> dummy >> dummy >> dummy >> dummy >> dummy >> dummy >>
+            bytes_sent >> packets_sent) {
+            if (interface.find("lo:") == std::string::npos) {
+                s.bytes_recv += bytes_recv;
+                s.bytes_sent += bytes_sent;
+                s.packets_recv += packets_recv;
+                s.packets_sent += packets_sent;
+            }
+        }
+    }
+}
+
+void legacyProcess(LegacySample& s) {
+    std::ifstream limits("/proc/self/limits");
+    std::string line;
+    while (std::getline(limits, line)) {
+        if (line.find("Max open files") != std::string::npos) {
+            std::istringstream iss(line);
+            std::string dummy;
+            iss >> dummy >> dummy >> dummy >> s.max_open_files;
+            break;
+        }
+    }
+    std::ifstream status("/proc/self/status");
+    while (std::getline(status, line)) {
+        std::istringstream iss(line);
+        std::string key;
+        if (iss >> key) {
+            if (key == "State:") {
+                iss >> s.state;
+            } else if (key == "voluntary_ctxt_switches:") {
+                iss >> s.voluntary;
+            } else if (key == "nonvoluntary_ctxt_switches:") {
+                iss >> s.involuntary;
+            }
+        }
+    }
+}
+
+void legacyLoadavg(LegacySample& s) {
+    std::ifstream loadavg("/proc/loadavg");
+    loadavg >> s.load1 >> s.load5 >> s.load15;
+    std::string running_total;
+    loadavg >> running_total;
+    size_t slash_pos = running_total.find('/');
+    if (slash_pos != std::string::npos) {
+        s.running = std::stoul(running_total.substr(0, slash_pos));
+        s.total = std::stoul(running_total.substr(slash_pos + 1));
+    }
+}
+
+void legacyThermalAndCpuinfo(LegacySample& s) {
+    s.temperatures.clear();
+    for (int i = 0; i < 8; ++i) {
+        std::ifstream temp_stream("/sys/class/thermal/thermal_zone" + std::to_string(i) + "/temp");
+        if (!temp_stream.is_open()) {
+            break;
+        }
+        int temp_millidegree;
+        temp_stream >> temp_millidegree;
+        s.temperatures.push_back(temp_millidegree / 1000.0);
+    }
+
+    s.frequencies.clear();
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.find("cpu MHz") != std::string::npos) {
+            size_t colon_pos = line.find(':');
+            if (colon_pos != std::string::npos) {
+                s.frequencies.push_back(static_cast<size_t>(std::stod(line.substr(colon_pos + 1))));
+            }
+        }
+    }
+}
+
+void legacyUptimeAndMeminfo(LegacySample& s) {
+    std::ifstream uptime("/proc/uptime");
+    uptime >> s.uptime;
+
+    std::ifstream meminfo("/proc/meminfo");
+    std::string line;
+    while (std::getline(meminfo, line)) {
+        std::istringstream iss(line);
+        std::string key;
+        size_t value;
+        if (iss >> key >> value) {
+            if (key == "MemAvailable:") {
+                s.mem_available = value;
+            } else if (key == "Buffers:") {
+                s.buffers = value;
+            } else if (key == "Cached:") {
+                s.cached = value;
+            } else if (key == "SwapTotal:") {
+                s.swap_total = value;
+            } else if (key == "SwapFree:") {
+                s.swap_free = value;
+            }
+        }
+    }
+}
+
+void legacyScheduling(LegacySample& s) {
+    std::ifstream stat("/proc/self/stat");
+    std::string line;
+    std::getline(stat, line);
+    std::istringstream iss(line);
+    std::string token;
+    for (int i = 0; i < 17; ++i) {
+        iss >> token;
+    }
+    iss >> s.priority >> s.nice;
+
+    std::ifstream sched("/proc/self/sched");
+    if (std::getline(sched, line) && line.find("policy") != std::string::npos) {
+        s.sched_line = line;
+    }
+}
+
+void legacyScrape(LegacySample& s) {
+    legacyStatCpu(s);
+    legacyMemory(s);
+    legacyThreads(s);
+    legacyIo(s);
+    legacyNetwork(s);
+    legacyProcess(s);
+    legacyLoadavg(s);
+    legacyThermalAndCpuinfo(s);
+    legacyUptimeAndMeminfo(s);
+    legacyScheduling(s);
+}
+
+}  // namespace
+
+// 完整一次采样
+static void BM_ProcScrape_Legacy(benchmark::State& state) {
+    LegacySample sample;
+    for (auto _ : state) {
+        legacyScrape(sample);
+        benchmark::DoNotOptimize(sample);
+    }
+}
+BENCHMARK(BM_ProcScrape_Legacy)->Unit(benchmark::kMicrosecond);
+
+static void BM_ProcScrape_Scraper(benchmark::State& state) {
+    ProcScraper scraper;
+    ProcSample sample = {};
+    for (auto _ : state) {
+        scraper.scrape(sample);
+        benchmark::DoNotOptimize(sample);
+    }
+}
+BENCHMARK(BM_ProcScrape_Scraper)->Unit(benchmark::kMicrosecond);
+
+// 不含 /proc/cpuinfo 与温度：在核心数很多的机器上 cpuinfo 的内核生成时间会占大头
+static void BM_ProcScrape_Legacy_NoCpuinfo(benchmark::State& state) {
+    LegacySample sample;
+    for (auto _ : state) {
+        legacyStatCpu(sample);
+        legacyMemory(sample);
+        legacyThreads(sample);
+        legacyIo(sample);
+        legacyNetwork(sample);
+        legacyProcess(sample);
+        legacyLoadavg(sample);
+        legacyUptimeAndMeminfo(sample);
+        legacyScheduling(sample);
+        benchmark::DoNotOptimize(sample);
+    }
+}
+BENCHMARK(BM_ProcScrape_Legacy_NoCpuinfo)->Unit(benchmark::kMicrosecond);
+
+static void BM_ProcScrape_Scraper_NoCpuinfo(benchmark::State& state) {
+    ProcScraper scraper;
+    ProcSample sample = {};
+    for (auto _ : state) {
+        scraper.scrapeStat(sample);
+        scraper.scrapeStatus(sample);
+        scraper.scrapeMeminfo(sample);
+        scraper.scrapeIo(sample);
+        scraper.scrapeNetDev(sample);
+        scraper.scrapeLoadavg(sample);
+        scraper.scrapeUptime(sample);
+        scraper.scrapeLimits(sample);
+        benchmark::DoNotOptimize(sample);
+    }
+}
+BENCHMARK(BM_ProcScrape_Scraper_NoCpuinfo)->Unit(benchmark::kMicrosecond);
+
+// 单个文件：/proc/self/status 的读取 + 解析
+static void BM_ProcStatus_Legacy(benchmark::State& state) {
+    LegacySample sample;
+    for (auto _ : state) {
+        legacyProcess(sample);
+        benchmark::DoNotOptimize(sample);
+    }
+}
+BENCHMARK(BM_ProcStatus_Legacy)->Unit(benchmark::kMicrosecond);
+
+static void BM_ProcStatus_Scraper(benchmark::State& state) {
+    ProcScraper scraper;
+    ProcSample sample = {};
+    for (auto _ : state) {
+        scraper.scrapeStatus(sample);
+        scraper.scrapeLimits(sample);
+        benchmark::DoNotOptimize(sample);
+    }
+}
+BENCHMARK(BM_ProcStatus_Scraper)->Unit(benchmark::kMicrosecond);
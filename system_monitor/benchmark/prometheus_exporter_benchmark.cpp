@@ -0,0 +1,117 @@
+// PrometheusExporter::UpdateMetrics 单次调用成本：
+// 每次更新都 Family::Add 构造标签并查找序列（改造前的写法） vs 初始化时缓存句柄后直接写入
+#include <benchmark/benchmark.h>
+#include "prometheus_exporter.h"
+#include <memory>
+#include <string>
+
+namespace {
+
+SystemInfo makeSystemInfo() {
+    SystemInfo info = {};
+    info.cpu_usage_percent = 12.5;
+    info.memory_usage_percent = 3.2;
+    info.memory_used_mb = 512;
+    info.memory_total_mb = 16384;
+    info.thread_count = 40;
+    info.system_load = {0.5, 0.6, 0.7, 2, 300};
+    info.disk_io = {1024, 2048, 10, 20};
+    info.network = {4096, 8192, 30, 40};
+    info.process.open_files_count = 64;
+    info.process.max_open_files = 1024;
+    info.process.file_descriptor_usage_percent = 6.25;
+    info.cpu_temperatures.assign(8, 45.0);
+    info.cpu_frequencies.assign(16, 2400);
+    for (int i = 0; i < 40; ++i) {
+        ThreadInfo thread = {};
+        thread.tid = 1000 + i;
+        thread.name = "worker-" + std::to_string(i);
+        thread.cpu_user_percent = 40.0 - i;
+        info.threads.push_back(thread);
+    }
+    info.sample_window.sample_count = 100;
+    return info;
+}
+
+// 改造前 UpdateMetrics 的写法：每个指标每次都经过 Family::Add
+struct LegacyExporter {
+    explicit LegacyExporter(prometheus::Registry& registry)
+        : cpu(prometheus::BuildGauge().Name("legacy_cpu").Help("cpu").Register(registry)),
+          memory(prometheus::BuildGauge().Name("legacy_memory").Help("memory").Register(registry)),
+          load(prometheus::BuildGauge().Name("legacy_load").Help("load").Register(registry)),
+          disk(prometheus::BuildGauge().Name("legacy_disk").Help("disk").Register(registry)),
+          network(prometheus::BuildGauge().Name("legacy_network").Help("network").Register(registry)),
+          fd(prometheus::BuildGauge().Name("legacy_fd").Help("fd").Register(registry)),
+          temperature(prometheus::BuildGauge().Name("legacy_temperature").Help("temperature").Register(registry)),
+          frequency(prometheus::BuildGauge().Name("legacy_frequency").Help("frequency").Register(registry)) {}
+
+    void update(const SystemInfo& info) {
+        cpu.Add({}).Set(info.cpu_usage_percent);
+        memory.Add({{"type", "used_mb"}}).Set(info.memory_used_mb);
+        memory.Add({{"type", "total_mb"}}).Set(info.memory_total_mb);
+        memory.Add({{"type", "usage_percent"}}).Set(info.memory_usage_percent);
+        load.Add({{"period", "1min"}}).Set(info.system_load.load_average_1min);
+        load.Add({{"period", "5min"}}).Set(info.system_load.load_average_5min);
+        load.Add({{"period", "15min"}}).Set(info.system_load.load_average_15min);
+        disk.Add({{"operation", "read"}, {"unit", "bytes_per_sec"}}).Set(info.disk_io.read_bytes_per_sec);
+        disk.Add({{"operation", "write"}, {"unit", "bytes_per_sec"}}).Set(info.disk_io.write_bytes_per_sec);
+        disk.Add({{"operation", "read"}, {"unit", "ops_per_sec"}}).Set(info.disk_io.read_ops_per_sec);
+        disk.Add({{"operation", "write"}, {"unit", "ops_per_sec"}}).Set(info.disk_io.write_ops_per_sec);
+        network.Add({{"direction", "receive"}, {"unit", "bytes_per_sec"}}).Set(info.network.bytes_recv_per_sec);
+        network.Add({{"direction", "send"}, {"unit", "bytes_per_sec"}}).Set(info.network.bytes_sent_per_sec);
+        network.Add({{"direction", "receive"}, {"unit", "packets_per_sec"}}).Set(info.network.packets_recv_per_sec);
+        network.Add({{"direction", "send"}, {"unit", "packets_per_sec"}}).Set(info.network.packets_sent_per_sec);
+        fd.Add({{"type", "open"}}).Set(info.process.open_files_count);
+        fd.Add({{"type", "max"}}).Set(info.process.max_open_files);
+        fd.Add({{"type", "usage_percent"}}).Set(info.process.file_descriptor_usage_percent);
+        for (size_t i = 0; i < info.cpu_temperatures.size(); ++i) {
+            temperature.Add({{"core", std::to_string(i)}}).Set(info.cpu_temperatures[i]);
+        }
+        for (size_t i = 0; i < info.cpu_frequencies.size(); ++i) {
+            frequency.Add({{"core", std::to_string(i)}}).Set(info.cpu_frequencies[i]);
+        }
+    }
+
+    prometheus::Family<prometheus::Gauge>& cpu;
+    prometheus::Family<prometheus::Gauge>& memory;
+    prometheus::Family<prometheus::Gauge>& load;
+    prometheus::Family<prometheus::Gauge>& disk;
+    prometheus::Family<prometheus::Gauge>& network;
+    prometheus::Family<prometheus::Gauge>& fd;
+    prometheus::Family<prometheus::Gauge>& temperature;
+    prometheus::Family<prometheus::Gauge>& frequency;
+};
+
+}  // namespace
+
+// 只含固定标签指标与每核温度/频率，与 CachedHandles 的同类部分对照
+static void BM_UpdateMetrics_FamilyAdd(benchmark::State& state) {
+    auto registry = std::make_shared<prometheus::Registry>();
+    LegacyExporter exporter(*registry);
+    SystemInfo info = makeSystemInfo();
+    for (auto _ : state) {
+        exporter.update(info);
+    }
+}
+BENCHMARK(BM_UpdateMetrics_FamilyAdd);
+
+// 完整 UpdateMetrics，不含线程明细
+static void BM_UpdateMetrics_CachedHandles(benchmark::State& state) {
+    PrometheusExporter exporter(std::make_shared<prometheus::Registry>());
+    SystemInfo info = makeSystemInfo();
+    info.threads.clear();
+    for (auto _ : state) {
+        exporter.UpdateMetrics(info);
+    }
+}
+BENCHMARK(BM_UpdateMetrics_CachedHandles);
+
+// 完整 UpdateMetrics，含 40 个线程（超出上限的 8 个合并为 other）
+static void BM_UpdateMetrics_WithThreads(benchmark::State& state) {
+    PrometheusExporter exporter(std::make_shared<prometheus::Registry>());
+    SystemInfo info = makeSystemInfo();
+    for (auto _ : state) {
+        exporter.UpdateMetrics(info);
+    }
+}
+BENCHMARK(BM_UpdateMetrics_WithThreads);
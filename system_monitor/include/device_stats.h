@@ -0,0 +1,96 @@
+#pragma once
+
+#include "proc_scraper.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// 单个网络接口的累计计数，来自 rtnl_link_stats64（或退化时的 /proc/net/dev）
+struct InterfaceSample {
+    char name[16];                      // IFNAMSIZ
+    int index;                          // ifindex，退化为 /proc/net/dev 时为 0
+    bool up;
+    uint64_t rx_bytes;
+    uint64_t rx_packets;
+    uint64_t rx_errors;
+    uint64_t rx_dropped;
+    uint64_t tx_bytes;
+    uint64_t tx_packets;
+    uint64_t tx_errors;
+    uint64_t tx_dropped;
+};
+
+// 通过 NETLINK_ROUTE 读取各接口的 rtnl_link_stats64，直接拿到二进制结构体，不再解析 /proc/net/dev 的文本。
+// 计数器用 RTM_GETSTATS 只 dump IFLA_STATS_LINK_64，应答远小于 RTM_GETLINK 的完整接口描述；
+// 名称与 up 状态缓存在接口表中，只在订阅的 RTNLGRP_LINK 通知到达或出现未知 ifindex 时用 RTM_GETLINK 刷新。
+// 内核不支持 RTM_GETSTATS（< 4.7）时每次用 RTM_GETLINK 的 IFLA_STATS64；
+// netlink 不可用（例如 seccomp 禁止 AF_NETLINK）时退化为解析 /proc/net/dev。回环接口不计入
+class LinkStatsScraper {
+public:
+    LinkStatsScraper();
+    ~LinkStatsScraper();
+
+    LinkStatsScraper(const LinkStatsScraper&) = delete;
+    LinkStatsScraper& operator=(const LinkStatsScraper&) = delete;
+
+    // 读取当前所有接口，返回的引用在下一次 scrape() 之前有效
+    const std::vector<InterfaceSample>& scrape();
+
+    bool usingNetlink() const { return socket_ >= 0; }
+
+    // 各采集路径单独调用，供基准测试对比
+    bool scrapeNetlink(std::vector<InterfaceSample>& out);      // RTM_GETSTATS + 缓存的接口表
+    bool scrapeLinkDump(std::vector<InterfaceSample>& out);     // RTM_GETLINK，同时刷新接口表
+    void scrapeProcNetDev(std::vector<InterfaceSample>& out);
+
+private:
+    struct LinkEntry {
+        char name[16];
+        bool up;
+        bool loopback;
+    };
+
+    // 发送一个 dump 请求并对每条应答消息回调，收到 NLMSG_DONE 返回 true
+    template<typename Fn>
+    bool dump(uint16_t type, const void* body, size_t body_size, Fn&& fn);
+
+    // 非阻塞地取走接口变更通知，有通知或通知队列溢出时标记接口表待刷新
+    void drainLinkEvents();
+
+    int socket_;
+    int events_socket_;
+    uint32_t sequence_;
+    bool stats_supported_;
+    bool links_dirty_;
+    std::vector<char> buffer_;
+    std::unordered_map<int, LinkEntry> links_;
+    ProcFile net_dev_;
+    std::vector<InterfaceSample> samples_;
+};
+
+// 单个块设备的累计计数，字段与 /proc/diskstats 第 4 列起一致
+struct BlockDeviceSample {
+    char name[32];
+    uint64_t reads_completed;
+    uint64_t sectors_read;              // 固定按 512 字节计
+    uint64_t read_time_ms;
+    uint64_t writes_completed;
+    uint64_t sectors_written;
+    uint64_t write_time_ms;
+    uint64_t io_in_progress;
+    uint64_t io_time_ms;                // 设备忙碌时间，用于计算利用率
+};
+
+// /proc/diskstats 采集器：常驻 fd + 非分配解析。
+// 从未发生过读写的设备（空闲的 loop / ram 等）不输出，避免无意义的标签
+class DiskStatsScraper {
+public:
+    DiskStatsScraper();
+
+    // 读取当前所有块设备，返回的引用在下一次 scrape() 之前有效
+    const std::vector<BlockDeviceSample>& scrape();
+
+private:
+    ProcFile diskstats_;
+    std::vector<BlockDeviceSample> samples_;
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "thread_scraper.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// perf_event_open 采集的硬件 / 软件事件
+enum class PerfEvent : uint32_t {
+    Cycles = 0,
+    Instructions = 1,
+    LlcMisses = 2,
+    BranchMisses = 3,
+    PageFaults = 4,
+};
+
+// 本进程的硬件计数器：perf_event_open 只能按线程计数，因此为 /proc/self/task 中的每个线程
+// 各开一组计数器（只计用户态），线程退出时把最终值并入累计。
+// 内核不允许（perf_event_paranoid、容器 seccomp）或硬件不支持的事件在构造时探测出来并跳过；
+// 缺页在 perf 不可用时退化为 getrusage 的 minflt + majflt。
+class PerfCounters {
+public:
+    static constexpr size_t kEventCount = 5;
+
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // 可用事件的位掩码，第 i 位对应 PerfEvent(i)
+    uint32_t availableMask() const { return available_mask_; }
+    bool available(PerfEvent event) const { return (available_mask_ >> static_cast<uint32_t>(event)) & 1u; }
+
+    // 没有任何 perf 事件可用时的原因，可用时为空
+    const std::string& unavailableReason() const { return unavailable_reason_; }
+
+    // 为新出现的线程打开计数器，关闭已退出线程的计数器
+    void syncThreads(const std::vector<ThreadSample>& threads);
+
+    // 进程累计计数（含已退出线程），不可用的事件为 0；按多路复用比例换算
+    void read(uint64_t (&totals)[kEventCount]);
+
+    static const char* eventName(PerfEvent event);
+
+private:
+    struct ThreadCounters {
+        int fds[kEventCount];
+        bool seen;
+    };
+
+    static int openEvent(PerfEvent event, int tid);
+    static uint64_t readScaled(int fd);
+    void closeThread(ThreadCounters& counters);
+
+    uint32_t available_mask_;
+    std::string unavailable_reason_;
+    std::unordered_map<int, ThreadCounters> threads_;
+    uint64_t retired_[kEventCount];
+};
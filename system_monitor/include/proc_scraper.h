@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+// 常驻打开的 /proc 文件：每次用 pread 从偏移 0 重新读取到复用缓冲区，
+// 避免每次采样都构造 ifstream、open/close 以及逐行分配 std::string
+class ProcFile {
+public:
+    explicit ProcFile(const char* path, size_t initial_capacity = 4096);
+    ~ProcFile();
+
+    ProcFile(ProcFile&& other) noexcept;
+    ProcFile& operator=(ProcFile&& other) noexcept;
+    ProcFile(const ProcFile&) = delete;
+    ProcFile& operator=(const ProcFile&) = delete;
+
+    bool isOpen() const { return fd_ >= 0; }
+
+    // 读取文件当前全部内容，返回的视图在下一次 read() 之前有效；打开或读取失败返回空视图。
+    // 缓冲区末尾保证有 '\0'，便于 strtod 之类的函数直接使用
+    std::string_view read();
+
+private:
+    int fd_;
+    std::vector<char> buffer_;
+};
+
+// 一次采样从 /proc 读出的原始数值，单位与内核输出一致（内存为 kB，CPU 时间为 jiffies）
+struct ProcSample {
+    // /proc/self/stat
+    unsigned long long utime;
+    unsigned long long stime;
+    long priority;
+    long nice;
+    unsigned int policy;
+
+    // /proc/self/status
+    char state;
+    size_t vm_rss_kb;
+    size_t vm_peak_kb;
+    size_t threads;
+    size_t voluntary_ctxt_switches;
+    size_t nonvoluntary_ctxt_switches;
+
+    // /proc/meminfo
+    size_t mem_total_kb;
+    size_t mem_available_kb;
+    size_t buffers_kb;
+    size_t cached_kb;
+    size_t swap_total_kb;
+    size_t swap_free_kb;
+
+    // /proc/self/io
+    size_t read_bytes;
+    size_t write_bytes;
+    size_t syscr;
+    size_t syscw;
+
+    // /proc/net/dev，排除回环接口后的合计
+    size_t net_bytes_recv;
+    size_t net_packets_recv;
+    size_t net_bytes_sent;
+    size_t net_packets_sent;
+
+    // /proc/loadavg
+    double load_average_1min;
+    double load_average_5min;
+    double load_average_15min;
+    size_t running_processes;
+    size_t total_processes;
+
+    // /proc/uptime
+    double uptime_seconds;
+
+    // /proc/self/limits
+    size_t max_open_files;
+
+    // /proc/cpuinfo 与 /sys/class/thermal，容量在多次采样间复用
+    std::vector<size_t> cpu_frequencies_mhz;
+    std::vector<double> cpu_temperatures;
+};
+
+// 单次遍历的 /proc 采集器：构造时打开所有文件，scrape() 每个文件只读取、解析一次
+class ProcScraper {
+public:
+    ProcScraper();
+
+    // 覆盖 sample 中的全部字段；某个文件不可读时对应字段为 0
+    void scrape(ProcSample& sample);
+
+    // 各部分单独采集，供基准测试和只需部分数据的调用方使用
+    void scrapeStat(ProcSample& sample);
+    void scrapeStatus(ProcSample& sample);
+    void scrapeMeminfo(ProcSample& sample);
+    void scrapeIo(ProcSample& sample);
+    void scrapeNetDev(ProcSample& sample);
+    void scrapeLoadavg(ProcSample& sample);
+    void scrapeUptime(ProcSample& sample);
+    void scrapeLimits(ProcSample& sample);
+    void scrapeCpuinfo(ProcSample& sample);
+    void scrapeThermal(ProcSample& sample);
+
+    // 仅读取 /proc/self/statm 的常驻内存（kB），供高频采样使用
+    size_t residentKb();
+
+private:
+    ProcFile stat_;
+    ProcFile status_;
+    ProcFile meminfo_;
+    ProcFile io_;
+    ProcFile net_dev_;
+    ProcFile loadavg_;
+    ProcFile uptime_;
+    ProcFile limits_;
+    ProcFile cpuinfo_;
+    ProcFile statm_;
+    size_t page_kb_;
+    std::vector<ProcFile> thermal_zones_;
+};
+
+// 不分配内存的文本解析工具，操作 [p, end) 区间并推进 p
+namespace proc_parse {
+
+// 跳过空格与制表符（不跨行）
+void skipSpaces(const char*& p, const char* end);
+
+// 取下一个以空白分隔的 token（不跨行）
+std::string_view nextToken(const char*& p, const char* end);
+
+// 跳过前导空白后解析整数 / 浮点数，失败返回 false 且不修改 value
+bool parseUnsigned(const char*& p, const char* end, unsigned long long& value);
+bool parseSigned(const char*& p, const char* end, long long& value);
+bool parseDouble(const char*& p, const char* end, double& value);
+
+// 依次回调每一行（不含换行符）
+template<typename Fn>
+void forEachLine(std::string_view text, Fn&& fn) {
+    const char* p = text.data();
+    const char* end = p + text.size();
+    while (p < end) {
+        const char* line_end = p;
+        while (line_end < end && *line_end != '\n') {
+            ++line_end;
+        }
+        fn(std::string_view(p, static_cast<size_t>(line_end - p)));
+        p = line_end + 1;
+    }
+}
+
+// "Key:   value ..." 形式的行：key 匹配时把冒号后的第一个数值写入 value
+bool parseKeyValue(std::string_view line, std::string_view key, size_t& value);
+
+}  // namespace proc_parse
+
+// 调度策略编号（/proc/self/stat 第 41 个字段）转名称
+const char* schedulerPolicyName(unsigned int policy);
@@ -2,6 +2,8 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include "system_monitor.h"
 #include <prometheus/counter.h>
 #include <prometheus/gauge.h>
@@ -10,16 +12,42 @@
 
 class PrometheusExporter {
 public:
-    PrometheusExporter(const std::string& bind_address);
+    // 线程级指标默认最多导出的线程数，其余线程合并到 tid="other"
+    static constexpr size_t kDefaultMaxThreadSeries = 32;
+
+    PrometheusExporter(const std::string& bind_address, size_t max_thread_series = kDefaultMaxThreadSeries);
+
+    // 只向给定 registry 注册指标，不启动 HTTP 服务，由调用方负责暴露 registry
+    explicit PrometheusExporter(std::shared_ptr<prometheus::Registry> registry,
+                                size_t max_thread_series = kDefaultMaxThreadSeries);
     ~PrometheusExporter();
 
-    // 更新系统监控指标
+    // 更新系统监控指标；固定标签的指标句柄已在初始化时解析，此处只做原子写入
     void UpdateMetrics(const SystemInfo& info);
 
+    std::shared_ptr<prometheus::Registry> GetRegistry() const { return registry_; }
+
 private:
     // 初始化所有指标
     void InitializeMetrics();
 
+    // 计数器只能增加：按累计值与上次的差值递增
+    static void AdvanceCounter(prometheus::Counter* counter, double total, double& last_total);
+
+    // 按核心编号取得动态标签的 gauge，缓存中不存在时才调用 Family::Add
+    static prometheus::Gauge* CoreGauge(prometheus::Family<prometheus::Gauge>* family,
+                                        std::vector<prometheus::Gauge*>& cache, size_t core);
+
+    // 更新线程级指标，只为 CPU 使用率最高的 max_thread_series_ 个线程保留独立序列
+    void UpdateThreadMetrics(const std::vector<ThreadInfo>& threads);
+
+    // 更新各网络接口 / 块设备指标，接口或设备消失后删除其序列
+    void UpdateInterfaceMetrics(const std::vector<InterfaceInfo>& interfaces);
+    void UpdateBlockDeviceMetrics(const std::vector<BlockDeviceInfo>& devices);
+
+    // 更新外部上报的耗时分位数，文件中消失的 (source, site) 删除其序列
+    void UpdateLatencyMetrics(const std::vector<LatencyInfo>& latency);
+
     std::unique_ptr<prometheus::Exposer> exposer_;
     std::shared_ptr<prometheus::Registry> registry_;
 
@@ -45,4 +73,155 @@ private:
 
     // 系统和进程运行时间
     prometheus::Family<prometheus::Counter>* uptime_family_;
+
+    // 高频采样窗口统计 (stat = min/max/p99)
+    prometheus::Family<prometheus::Gauge>* window_cpu_usage_family_;
+    prometheus::Family<prometheus::Gauge>* window_memory_rss_family_;
+    prometheus::Family<prometheus::Gauge>* window_context_switches_family_;
+    prometheus::Family<prometheus::Gauge>* window_sample_count_family_;
+
+    // 线程级指标 (tid / name 标签)
+    prometheus::Family<prometheus::Gauge>* thread_cpu_family_;
+    prometheus::Family<prometheus::Gauge>* thread_last_cpu_family_;
+    prometheus::Family<prometheus::Counter>* thread_context_switches_family_;
+    prometheus::Family<prometheus::Gauge>* thread_overflow_family_;
+
+    // 每核温度 / 频率 (core 标签)
+    prometheus::Family<prometheus::Gauge>* cpu_temperature_family_;
+    prometheus::Family<prometheus::Gauge>* cpu_frequency_family_;
+
+    // 各网络接口指标 (interface 标签)
+    prometheus::Family<prometheus::Gauge>* interface_io_family_;
+    prometheus::Family<prometheus::Counter>* interface_errors_family_;
+    prometheus::Family<prometheus::Gauge>* interface_up_family_;
+
+    // 各块设备指标 (device 标签)
+    prometheus::Family<prometheus::Gauge>* block_device_io_family_;
+    prometheus::Family<prometheus::Gauge>* block_device_utilization_family_;
+
+    // perf_event 硬件计数器 (event 标签)
+    prometheus::Family<prometheus::Counter>* hardware_events_family_;
+    prometheus::Family<prometheus::Gauge>* hardware_ipc_family_;
+    prometheus::Family<prometheus::Gauge>* hardware_available_family_;
+
+    // 外部上报的耗时分位数 (source / site / quantile 标签)
+    prometheus::Family<prometheus::Gauge>* latency_family_;
+    prometheus::Family<prometheus::Gauge>* latency_samples_family_;
+    // 同一文件中的计数点（LatencyInfo::isCount）不换算成秒
+    prometheus::Family<prometheus::Gauge>* queue_depth_family_;
+
+    // 固定标签指标的句柄，InitializeMetrics 中解析一次
+    struct WindowGauges {
+        prometheus::Gauge* min;
+        prometheus::Gauge* max;
+        prometheus::Gauge* p99;
+    };
+
+    struct Handles {
+        prometheus::Gauge* cpu_usage;
+        prometheus::Gauge* memory_used_mb;
+        prometheus::Gauge* memory_total_mb;
+        prometheus::Gauge* memory_usage_percent;
+        prometheus::Gauge* thread_count;
+        prometheus::Gauge* load_1min;
+        prometheus::Gauge* load_5min;
+        prometheus::Gauge* load_15min;
+        prometheus::Gauge* processes_running;
+        prometheus::Gauge* processes_total;
+        prometheus::Gauge* disk_read_bytes;
+        prometheus::Gauge* disk_write_bytes;
+        prometheus::Gauge* disk_read_ops;
+        prometheus::Gauge* disk_write_ops;
+        prometheus::Gauge* net_recv_bytes;
+        prometheus::Gauge* net_sent_bytes;
+        prometheus::Gauge* net_recv_packets;
+        prometheus::Gauge* net_sent_packets;
+        prometheus::Gauge* process_state;
+        prometheus::Gauge* fd_open;
+        prometheus::Gauge* fd_max;
+        prometheus::Gauge* fd_usage_percent;
+        prometheus::Counter* ctx_voluntary;
+        prometheus::Counter* ctx_involuntary;
+        prometheus::Counter* uptime_system;
+        prometheus::Counter* uptime_process;
+        prometheus::Gauge* window_sample_count;
+        WindowGauges window_cpu_usage;
+        WindowGauges window_memory_rss;
+        WindowGauges window_context_switches;
+        prometheus::Gauge* thread_overflow;
+        prometheus::Counter* hardware_events[PerfCounters::kEventCount];
+        prometheus::Gauge* hardware_available[PerfCounters::kEventCount];
+        prometheus::Gauge* hardware_ipc;
+    };
+
+    Handles handles_;
+    std::vector<prometheus::Gauge*> temperature_gauges_;
+    std::vector<prometheus::Gauge*> frequency_gauges_;
+
+    // 计数器上次写入时对应的累计值
+    double last_ctx_voluntary_ = 0;
+    double last_ctx_involuntary_ = 0;
+    double last_uptime_system_ = 0;
+    double last_uptime_process_ = 0;
+
+    struct ThreadSeries {
+        std::string name;
+        prometheus::Gauge* cpu_user;
+        prometheus::Gauge* cpu_system;
+        prometheus::Gauge* last_cpu;
+        prometheus::Counter* voluntary;
+        prometheus::Counter* involuntary;
+        size_t last_voluntary;
+        size_t last_involuntary;
+        bool seen;
+    };
+
+    void RemoveThreadSeries(ThreadSeries& series);
+
+    struct InterfaceSeries {
+        prometheus::Gauge* recv_bytes;
+        prometheus::Gauge* sent_bytes;
+        prometheus::Gauge* recv_packets;
+        prometheus::Gauge* sent_packets;
+        prometheus::Gauge* up;
+        // rx_errors / tx_errors / rx_dropped / tx_dropped
+        prometheus::Counter* faults[4];
+        uint64_t last_faults[4];
+        bool seen;
+    };
+
+    struct BlockDeviceSeries {
+        prometheus::Gauge* read_bytes;
+        prometheus::Gauge* write_bytes;
+        prometheus::Gauge* read_ops;
+        prometheus::Gauge* write_ops;
+        prometheus::Gauge* in_progress;
+        prometheus::Gauge* utilization;
+        bool seen;
+    };
+
+    void RemoveInterfaceSeries(InterfaceSeries& series);
+    void RemoveBlockDeviceSeries(BlockDeviceSeries& series);
+
+    std::unordered_map<std::string, InterfaceSeries> interface_series_;
+    std::unordered_map<std::string, BlockDeviceSeries> block_device_series_;
+
+    struct LatencySeries {
+        // p50 / p99 / p999 / max
+        prometheus::Gauge* quantiles[4];
+        prometheus::Gauge* samples;
+        prometheus::Family<prometheus::Gauge>* family;  // quantiles 所属的 latency_family_ 或 queue_depth_family_
+        double scale;
+        bool seen;
+    };
+
+    void RemoveLatencySeries(LatencySeries& series);
+
+    // 键为 source + '/' + site
+    std::unordered_map<std::string, LatencySeries> latency_series_;
+
+    size_t max_thread_series_;
+    std::unordered_map<int, ThreadSeries> thread_series_;
+    prometheus::Gauge* other_cpu_user_;
+    prometheus::Gauge* other_cpu_system_;
 };
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// 定长无锁环形缓冲：单写多读，写满后覆盖最旧的数据，写端从不等待。
+// 每个槽位带序号（seqlock）：写入前置为 2*pos+1，写完置为 2*pos+2；
+// 读端拷贝前后各读一次序号，只接受与目标位置吻合且未变化的数据，被覆盖或正在写的槽位直接跳过。
+template<typename T, size_t Capacity>
+class SampleRing {
+    static_assert(std::is_trivially_copyable<T>::value, "SampleRing requires a trivially copyable type");
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    static constexpr size_t capacity() { return Capacity; }
+
+    // 只能由单个线程调用
+    void push(const T& value) {
+        uint64_t pos = head_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[pos & (Capacity - 1)];
+        slot.seq.store(2 * pos + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.value = value;
+        slot.seq.store(2 * pos + 2, std::memory_order_release);
+        head_.store(pos + 1, std::memory_order_release);
+    }
+
+    // 累计写入次数
+    uint64_t pushed() const { return head_.load(std::memory_order_acquire); }
+
+    // 按时间升序拷贝最近至多 max_count 个元素，返回实际拷贝个数；可与 push 并发
+    size_t readLatest(T* out, size_t max_count) const {
+        uint64_t head = head_.load(std::memory_order_acquire);
+        uint64_t count = head < Capacity ? head : Capacity;
+        if (count > max_count) {
+            count = max_count;
+        }
+
+        size_t copied = 0;
+        for (uint64_t pos = head - count; pos < head; ++pos) {
+            const Slot& slot = slots_[pos & (Capacity - 1)];
+            uint64_t expected = 2 * pos + 2;
+            if (slot.seq.load(std::memory_order_acquire) != expected) {
+                continue;
+            }
+            T value = slot.value;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) != expected) {
+                continue;
+            }
+            out[copied++] = value;
+        }
+        return copied;
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> seq{0};
+        T value{};
+    };
+
+    Slot slots_[Capacity];
+    std::atomic<uint64_t> head_{0};
+};
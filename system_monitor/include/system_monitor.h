@@ -1,11 +1,24 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <memory>
 #include <thread>
 #include <atomic>
 #include <chrono>
 #include <vector>
+#include "proc_scraper.h"
+#include "device_stats.h"
+#include "perf_counters.h"
+#include "sample_ring.h"
+#include "thread_scraper.h"
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+namespace prometheus {
+class Registry;
+}
 
 struct DiskIOInfo {
     size_t read_bytes_per_sec;
@@ -21,6 +34,31 @@ struct NetworkInfo {
     size_t packets_recv_per_sec;
 };
 
+// 单个网络接口在本报告周期内的速率，错误与丢包为接口启动以来的累计值
+struct InterfaceInfo {
+    std::string name;
+    bool up;
+    size_t bytes_recv_per_sec;
+    size_t bytes_sent_per_sec;
+    size_t packets_recv_per_sec;
+    size_t packets_sent_per_sec;
+    uint64_t rx_errors;
+    uint64_t tx_errors;
+    uint64_t rx_dropped;
+    uint64_t tx_dropped;
+};
+
+// 单个块设备在本报告周期内的速率与利用率（整机视角，非本进程）
+struct BlockDeviceInfo {
+    std::string name;
+    size_t read_bytes_per_sec;
+    size_t write_bytes_per_sec;
+    size_t read_ops_per_sec;
+    size_t write_ops_per_sec;
+    size_t io_in_progress;
+    double utilization_percent;         // 设备忙碌时间占比
+};
+
 struct ProcessInfo {
     size_t open_files_count;
     size_t max_open_files;
@@ -38,6 +76,73 @@ struct SystemLoadInfo {
     size_t total_processes;
 };
 
+// 单个线程在本报告周期内的 CPU 与调度情况
+struct ThreadInfo {
+    int tid;
+    std::string name;
+    double cpu_user_percent;            // 相对单个核心，满载约为 100
+    double cpu_system_percent;
+    int last_cpu;
+    size_t voluntary_context_switches;  // 线程启动以来的累计值
+    size_t involuntary_context_switches;
+};
+
+// 高频采样的轻量样本，写入环形缓冲
+struct CompactSample {
+    int64_t timestamp_ns;               // steady_clock
+    double cpu_usage_percent;           // 与上一个样本之间的进程 CPU 使用率
+    double context_switches_per_sec;    // 自愿 + 非自愿上下文切换速率
+    uint64_t memory_rss_kb;
+};
+
+struct WindowStat {
+    double min;
+    double max;
+    double p99;
+};
+
+// 两次报告之间全部高频样本的聚合，短时尖峰在 max / p99 中仍可见
+struct SampleWindowInfo {
+    size_t sample_count;
+    int64_t sample_interval_ms;
+    WindowStat cpu_usage_percent;
+    WindowStat memory_rss_mb;
+    WindowStat context_switches_per_sec;
+};
+
+// 本报告周期内整个进程（所有线程、只计用户态）的硬件事件增量
+struct HardwareCounterInfo {
+    bool enabled;                       // 是否启用了 perf 采集
+    uint32_t available_mask;            // 第 i 位对应 PerfEvent(i)，未置位的事件值恒为 0
+    uint64_t cycles;
+    uint64_t instructions;
+    uint64_t llc_misses;
+    uint64_t branch_misses;
+    uint64_t page_faults;               // perf 不可用时取自 getrusage
+    double ipc;                         // instructions / cycles，cycles 不可用时为 0
+    std::string unavailable_reason;
+};
+
+// 外部进程（如 market_feeder 主进程）经耗时文件上报的一个计时点在一个统计周期内的分布
+struct LatencyInfo {
+    std::string source;                 // 上报方，如 worker_1
+    std::string site;                   // 计时点名称
+    int64_t window_ms;                  // 上报方的统计周期
+    uint64_t count;
+    uint64_t mean_ns;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+    uint64_t max_ns;
+
+    // 名称以 _depth 结尾的计数点（如 writer_queue_depth）记录的是排队数而不是纳秒
+    bool isCount() const {
+        static const std::string kSuffix = "_depth";
+        return site.size() >= kSuffix.size() &&
+               site.compare(site.size() - kSuffix.size(), kSuffix.size(), kSuffix) == 0;
+    }
+};
+
 struct SystemInfo {
     double cpu_usage_percent;
     double memory_usage_percent;
@@ -49,6 +154,8 @@ struct SystemInfo {
     // 新增健康检查指标
     DiskIOInfo disk_io;
     NetworkInfo network;
+    std::vector<InterfaceInfo> interfaces;        // 排除回环接口
+    std::vector<BlockDeviceInfo> block_devices;
     ProcessInfo process;
     SystemLoadInfo system_load;
     
@@ -71,15 +178,66 @@ struct SystemInfo {
     int process_priority;
     int process_nice_value;
     std::string scheduler_policy;
+
+    // 各线程明细，按 CPU 使用率从高到低排列
+    std::vector<ThreadInfo> threads;
+
+    // 本报告周期内的高频采样统计
+    SampleWindowInfo sample_window;
+
+    // perf_event 硬件计数器
+    HardwareCounterInfo hardware;
+
+    // 耗时文件中的分位数，未配置或文件过期时为空
+    std::vector<LatencyInfo> latency;
+};
+
+// 作为库嵌入其他进程时的配置
+struct SystemMonitorOptions {
+    // 未提供 registry 时在该地址启动独立的 Exposer
+    std::string prometheus_address = "0.0.0.0:8080";
+
+    // 复用宿主进程已暴露的 registry，不再启动第二个 HTTP 端口
+    std::shared_ptr<prometheus::Registry> registry;
+
+    // 为 false 时既不注册指标也不启动 Exposer，只通过订阅回调获取数据
+    bool enable_prometheus = true;
+
+    // 每次报告是否打印到 std::cout
+    bool console_output = true;
+
+    // 线程级指标最多导出的线程数
+    size_t max_thread_series = 32;
+
+    // 通过 perf_event_open 采集 cycles / instructions / LLC miss / branch miss / 缺页；
+    // 每个线程占用若干 fd，权限不足时自动退化，不影响其他指标
+    bool enable_perf_counters = false;
+
+    // 外部进程写出的耗时分布文件，每次报告重新读取；空表示不读取。
+    // 每行 "source site window_ms count mean_ns p50_ns p99_ns p999_ns max_ns"，'#' 开头的行为注释
+    std::string latency_file;
 };
 
 class SystemMonitor {
 public:
+    // 订阅回调在监控线程上同步调用，info 只在回调期间有效；回调中不应阻塞
+    using Subscriber = std::function<void(const SystemInfo& info)>;
+    using SubscriptionId = uint64_t;
+
     SystemMonitor(const std::string& prometheus_address = "0.0.0.0:8080");
+    explicit SystemMonitor(const SystemMonitorOptions& options);
     ~SystemMonitor();
 
+    // 高频样本历史容量（10ms 采样约 40 秒）
+    static constexpr size_t kSampleHistory = 4096;
+
     // 启动监控服务
     void start(int interval_seconds = 5);
+
+    // 毫秒级启动：每 report_interval 输出并导出一次完整 SystemInfo，
+    // 每 sample_interval 采集一个轻量样本写入环形缓冲；sample_interval 为 0 时与 report_interval 相同
+    void start(std::chrono::milliseconds report_interval,
+               std::chrono::milliseconds sample_interval = std::chrono::milliseconds(0));
     
     // 停止监控服务
     void stop();
@@ -89,6 +247,13 @@ public:
     
     // 设置监控间隔
     void setInterval(int seconds);
+    void setInterval(std::chrono::milliseconds interval);
+
+    // 设置高频采样间隔，0 表示与报告间隔相同
+    void setSampleInterval(std::chrono::milliseconds interval);
+
+    // 按时间升序拷贝最近至多 max_count 个轻量样本，可在任意线程调用
+    size_t getRecentSamples(CompactSample* out, size_t max_count) const;
     
     // 是否正在运行
     bool isRunning() const;
@@ -96,32 +261,60 @@ public:
     // 获取 Prometheus 指标地址
     std::string getPrometheusAddress() const;
 
+    // 订阅每次报告的 SystemInfo，返回的编号用于取消订阅；可在任意线程调用
+    SubscriptionId subscribe(Subscriber subscriber);
+
+    // 取消订阅；若回调正在监控线程上执行，本次调用仍会完成
+    void unsubscribe(SubscriptionId id);
+
+    void setConsoleOutput(bool enabled);
+
 private:
     void monitorLoop();
-    double getCpuUsage();
-    SystemInfo getMemoryInfo();
-    size_t getThreadCount();
+    void collectCompactSample();
+    SampleWindowInfo aggregateWindow(int64_t window_start_ns);
     std::string getCurrentTimestamp();
     void printSystemInfo(const SystemInfo& info);
-    
-    // 新增的健康检查方法
-    DiskIOInfo getDiskIOInfo();
-    NetworkInfo getNetworkInfo();
-    ProcessInfo getProcessInfo();
-    SystemLoadInfo getSystemLoadInfo();
-    std::vector<double> getCpuTemperatures();
-    std::vector<size_t> getCpuFrequencies();
-    size_t getSystemUptime();
+
+    // 以下方法只根据本次采样的 ProcSample 计算，不再各自读取 /proc
+    double getCpuUsage(const ProcSample& sample);
+    void getMemoryInfo(const ProcSample& sample, SystemInfo& info);
+    DiskIOInfo getDiskIOInfo(const ProcSample& sample);
+    NetworkInfo getNetworkInfo(const ProcSample& sample);
+    ProcessInfo getProcessInfo(const ProcSample& sample);
+    SystemLoadInfo getSystemLoadInfo(const ProcSample& sample);
     size_t getProcessUptime();
-    void getDetailedMemoryInfo(SystemInfo& info);
-    void getProcessSchedulingInfo(SystemInfo& info);
+    void getDetailedMemoryInfo(const ProcSample& sample, SystemInfo& info);
+    void getProcessSchedulingInfo(const ProcSample& sample, SystemInfo& info);
+    size_t countOpenFiles();
+    void getThreadInfo(SystemInfo& info);
+    void getHardwareCounters(SystemInfo& info);
+    void getInterfaceInfo(SystemInfo& info);
+    void getBlockDeviceInfo(SystemInfo& info);
+    void getLatencyInfo(SystemInfo& info);
+
+    // /proc 采集器与复用的采样缓冲
+    ProcScraper scraper_;
+    ProcSample sample_;
+    long cpu_cores_;
+    long clock_ticks_;
+
+    void log(const std::string& message);
 
     // Prometheus 相关
     std::string prometheus_address_;
     std::unique_ptr<class PrometheusExporter> prometheus_exporter_;
 
+    // 订阅者列表写时复制：监控线程每次报告只原子地取一次快照，不持锁调用回调
+    using SubscriberList = std::vector<std::pair<SubscriptionId, Subscriber>>;
+    std::shared_ptr<const SubscriberList> subscribers_;
+    std::mutex subscribers_mutex_;
+    SubscriptionId next_subscription_id_;
+
+    std::atomic<bool> console_output_;
     std::atomic<bool> running_;
-    std::atomic<int> interval_seconds_;
+    std::atomic<int64_t> interval_ms_;
+    std::atomic<int64_t> sample_interval_ms_;
     std::unique_ptr<std::thread> monitor_thread_;
     
     // CPU使用率计算相关
@@ -150,6 +343,40 @@ private:
         std::chrono::steady_clock::time_point timestamp;
     };
     
+    // 线程明细：上一次采样的累计 CPU 时间，用于计算差值
+    struct ThreadCpuTimes {
+        unsigned long long utime;
+        unsigned long long stime;
+        bool seen;
+    };
+    ThreadScraper thread_scraper_;
+    std::unordered_map<int, ThreadCpuTimes> last_thread_times_;
+    std::chrono::steady_clock::time_point last_thread_time_;
+
+    // 硬件计数器，未启用时为空；计数器按线程打开，跟随 thread_scraper_ 的线程列表
+    std::unique_ptr<PerfCounters> perf_counters_;
+    uint64_t last_perf_totals_[PerfCounters::kEventCount];
+
+    // 高频采样：环形缓冲、上一个样本的累计值与聚合用的临时数组
+    SampleRing<CompactSample, kSampleHistory> sample_ring_;
+    int64_t last_compact_time_ns_;
+    int64_t last_compact_cpu_us_;
+    int64_t last_compact_ctx_switches_;
+    int64_t last_report_time_ns_;
+    std::vector<CompactSample> window_samples_;
+    std::vector<double> window_values_;
+
+    // 各接口 / 块设备上一次的累计值，按名称对应
+    LinkStatsScraper link_scraper_;
+    DiskStatsScraper disk_scraper_;
+    std::unordered_map<std::string, InterfaceSample> last_interfaces_;
+    std::unordered_map<std::string, BlockDeviceSample> last_block_devices_;
+    std::chrono::steady_clock::time_point last_interface_time_;
+    std::chrono::steady_clock::time_point last_block_device_time_;
+
+    // 耗时文件路径，上报方写完后整体改名替换，每次重新打开
+    std::string latency_file_;
+
     IOStats last_io_stats_;
     NetworkStats last_network_stats_;
     std::chrono::steady_clock::time_point process_start_time_;
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "proc_scraper.h"
+#include <dirent.h>
+#include <unordered_map>
+#include <vector>
+
+// 单个线程一次采样的原始数值，CPU 时间单位为 jiffies
+struct ThreadSample {
+    int tid;
+    char name[16];                      // comm，内核限制最长 15 字节
+    unsigned long long utime;
+    unsigned long long stime;
+    int last_cpu;                       // 最近一次运行所在的 CPU（stat 第 39 个字段）
+    size_t voluntary_ctxt_switches;
+    size_t nonvoluntary_ctxt_switches;
+};
+
+// 遍历 /proc/self/task/<tid>：目录句柄常驻，每个线程的 stat / status 在线程存续期间保持打开，
+// 线程退出后在下一次 scrape() 时关闭
+class ThreadScraper {
+public:
+    ThreadScraper();
+    ~ThreadScraper();
+
+    ThreadScraper(const ThreadScraper&) = delete;
+    ThreadScraper& operator=(const ThreadScraper&) = delete;
+
+    // 读取当前所有线程，返回的引用在下一次 scrape() 之前有效
+    const std::vector<ThreadSample>& scrape();
+
+    // 最近一次 scrape() 的结果
+    const std::vector<ThreadSample>& samples() const { return samples_; }
+
+private:
+    struct Entry {
+        ProcFile stat;
+        ProcFile status;
+        bool seen;
+    };
+
+    bool readThread(Entry& entry, ThreadSample& sample);
+
+    DIR* task_dir_;
+    std::unordered_map<int, Entry> entries_;
+    std::vector<ThreadSample> samples_;
+};
@@ -0,0 +1,353 @@
+#include "device_stats.h"
+#include <cerrno>
+#include <cstring>
+#include <linux/if_link.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+// 内核 dump 每条消息不超过一页，32KB 足以一次收下多条而不截断
+constexpr size_t kNetlinkBufferSize = 32768;
+
+void copyName(char* dest, size_t dest_size, const char* src, size_t src_size) {
+    size_t size = src_size < dest_size - 1 ? src_size : dest_size - 1;
+    std::memcpy(dest, src, size);
+    dest[size] = '\0';
+}
+
+}  // namespace
+
+LinkStatsScraper::LinkStatsScraper()
+    : socket_(-1), events_socket_(-1), sequence_(0), stats_supported_(true), links_dirty_(true),
+      buffer_(kNetlinkBufferSize), net_dev_("/proc/net/dev") {
+    socket_ = ::socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (socket_ >= 0) {
+        struct sockaddr_nl local;
+        std::memset(&local, 0, sizeof(local));
+        local.nl_family = AF_NETLINK;
+        if (::bind(socket_, reinterpret_cast<struct sockaddr*>(&local), sizeof(local)) != 0) {
+            ::close(socket_);
+            socket_ = -1;
+        }
+    }
+
+    // 接口增删、改名、up/down 的通知；订阅失败时每次都刷新接口表
+    events_socket_ = ::socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_ROUTE);
+    if (events_socket_ >= 0) {
+        struct sockaddr_nl local;
+        std::memset(&local, 0, sizeof(local));
+        local.nl_family = AF_NETLINK;
+        local.nl_groups = RTMGRP_LINK;
+        if (::bind(events_socket_, reinterpret_cast<struct sockaddr*>(&local), sizeof(local)) != 0) {
+            ::close(events_socket_);
+            events_socket_ = -1;
+        }
+    }
+}
+
+LinkStatsScraper::~LinkStatsScraper() {
+    if (socket_ >= 0) {
+        ::close(socket_);
+    }
+    if (events_socket_ >= 0) {
+        ::close(events_socket_);
+    }
+}
+
+const std::vector<InterfaceSample>& LinkStatsScraper::scrape() {
+    if (!usingNetlink() || !scrapeNetlink(samples_)) {
+        scrapeProcNetDev(samples_);
+    }
+    return samples_;
+}
+
+template<typename Fn>
+bool LinkStatsScraper::dump(uint16_t type, const void* body, size_t body_size, Fn&& fn) {
+    // 请求体只有 ifinfomsg / if_stats_msg，64 字节足够
+    alignas(struct nlmsghdr) char request[NLMSG_SPACE(64)];
+    if (socket_ < 0 || NLMSG_SPACE(body_size) > sizeof(request)) {
+        return false;
+    }
+    std::memset(request, 0, sizeof(request));
+    auto* header = reinterpret_cast<struct nlmsghdr*>(request);
+    header->nlmsg_len = NLMSG_LENGTH(body_size);
+    header->nlmsg_type = type;
+    header->nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    header->nlmsg_seq = ++sequence_;
+    std::memcpy(NLMSG_DATA(header), body, body_size);
+
+    if (::send(socket_, request, header->nlmsg_len, 0) < 0) {
+        return false;
+    }
+
+    for (;;) {
+        ssize_t received = ::recv(socket_, buffer_.data(), buffer_.size(), 0);
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+
+        int remaining = static_cast<int>(received);
+        for (auto* reply = reinterpret_cast<struct nlmsghdr*>(buffer_.data()); NLMSG_OK(reply, remaining);
+             reply = NLMSG_NEXT(reply, remaining)) {
+            // 上一次失败遗留的应答序号不同，直接丢弃
+            if (reply->nlmsg_seq != sequence_) {
+                continue;
+            }
+            if (reply->nlmsg_type == NLMSG_DONE) {
+                return true;
+            }
+            if (reply->nlmsg_type == NLMSG_ERROR) {
+                return false;
+            }
+            fn(reply);
+        }
+    }
+}
+
+void LinkStatsScraper::drainLinkEvents() {
+    if (events_socket_ < 0) {
+        links_dirty_ = true;
+        return;
+    }
+    for (;;) {
+        ssize_t received = ::recv(events_socket_, buffer_.data(), buffer_.size(), MSG_DONTWAIT);
+        if (received > 0) {
+            // 不逐条解析，任意 RTM_NEWLINK / RTM_DELLINK 都整体重建接口表
+            links_dirty_ = true;
+            continue;
+        }
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        // ENOBUFS 表示通知队列溢出，丢失了部分变更
+        if (received < 0 && errno == ENOBUFS) {
+            links_dirty_ = true;
+            continue;
+        }
+        return;
+    }
+}
+
+bool LinkStatsScraper::scrapeLinkDump(std::vector<InterfaceSample>& out) {
+    out.clear();
+    links_.clear();
+
+    struct ifinfomsg body;
+    std::memset(&body, 0, sizeof(body));
+    body.ifi_family = AF_UNSPEC;
+    bool ok = dump(RTM_GETLINK, &body, sizeof(body), [this, &out](struct nlmsghdr* header) {
+        if (header->nlmsg_type != RTM_NEWLINK) {
+            return;
+        }
+        auto* link = static_cast<struct ifinfomsg*>(NLMSG_DATA(header));
+        LinkEntry entry = {};
+        entry.up = (link->ifi_flags & IFF_UP) != 0;
+        entry.loopback = (link->ifi_flags & IFF_LOOPBACK) != 0;
+
+        InterfaceSample sample = {};
+        bool has_stats = false;
+        int attr_len = static_cast<int>(IFLA_PAYLOAD(header));
+        for (auto* attr = IFLA_RTA(link); RTA_OK(attr, attr_len); attr = RTA_NEXT(attr, attr_len)) {
+            if (attr->rta_type == IFLA_IFNAME) {
+                // 属性中的名称带 '\0'
+                const char* name = static_cast<const char*>(RTA_DATA(attr));
+                copyName(entry.name, sizeof(entry.name), name, strnlen(name, RTA_PAYLOAD(attr)));
+            } else if (attr->rta_type == IFLA_STATS64 && RTA_PAYLOAD(attr) >= sizeof(struct rtnl_link_stats64)) {
+                // 属性只保证 4 字节对齐，拷出后再读 64 位字段
+                struct rtnl_link_stats64 stats;
+                std::memcpy(&stats, RTA_DATA(attr), sizeof(stats));
+                sample.rx_bytes = stats.rx_bytes;
+                sample.rx_packets = stats.rx_packets;
+                sample.rx_errors = stats.rx_errors;
+                sample.rx_dropped = stats.rx_dropped;
+                sample.tx_bytes = stats.tx_bytes;
+                sample.tx_packets = stats.tx_packets;
+                sample.tx_errors = stats.tx_errors;
+                sample.tx_dropped = stats.tx_dropped;
+                has_stats = true;
+            }
+        }
+        if (entry.name[0] == '\0') {
+            return;
+        }
+        links_[link->ifi_index] = entry;
+
+        if (has_stats && !entry.loopback) {
+            std::memcpy(sample.name, entry.name, sizeof(sample.name));
+            sample.index = link->ifi_index;
+            sample.up = entry.up;
+            out.push_back(sample);
+        }
+    });
+    links_dirty_ = !ok;
+    return ok;
+}
+
+bool LinkStatsScraper::scrapeNetlink(std::vector<InterfaceSample>& out) {
+    if (socket_ < 0) {
+        out.clear();
+        return false;
+    }
+
+    drainLinkEvents();
+    if (!stats_supported_) {
+        return scrapeLinkDump(out);
+    }
+    if (links_dirty_) {
+        std::vector<InterfaceSample> ignored;
+        if (!scrapeLinkDump(ignored)) {
+            out.clear();
+            return false;
+        }
+    }
+
+    out.clear();
+    bool unknown_link = false;
+    struct if_stats_msg body;
+    std::memset(&body, 0, sizeof(body));
+    body.family = AF_UNSPEC;
+    body.filter_mask = IFLA_STATS_FILTER_BIT(IFLA_STATS_LINK_64);
+    bool ok = dump(RTM_GETSTATS, &body, sizeof(body), [this, &out, &unknown_link](struct nlmsghdr* header) {
+        if (header->nlmsg_type != RTM_NEWSTATS) {
+            return;
+        }
+        auto* stats_msg = static_cast<struct if_stats_msg*>(NLMSG_DATA(header));
+        auto link = links_.find(static_cast<int>(stats_msg->ifindex));
+        if (link == links_.end()) {
+            unknown_link = true;
+            return;
+        }
+        if (link->second.loopback) {
+            return;
+        }
+
+        auto* attr = reinterpret_cast<struct rtattr*>(reinterpret_cast<char*>(stats_msg) +
+                                                      NLMSG_ALIGN(sizeof(struct if_stats_msg)));
+        int attr_len = static_cast<int>(header->nlmsg_len - NLMSG_LENGTH(sizeof(struct if_stats_msg)));
+        for (; RTA_OK(attr, attr_len); attr = RTA_NEXT(attr, attr_len)) {
+            if (attr->rta_type != IFLA_STATS_LINK_64 || RTA_PAYLOAD(attr) < sizeof(struct rtnl_link_stats64)) {
+                continue;
+            }
+            struct rtnl_link_stats64 stats;
+            std::memcpy(&stats, RTA_DATA(attr), sizeof(stats));
+            InterfaceSample sample;
+            std::memcpy(sample.name, link->second.name, sizeof(sample.name));
+            sample.index = link->first;
+            sample.up = link->second.up;
+            sample.rx_bytes = stats.rx_bytes;
+            sample.rx_packets = stats.rx_packets;
+            sample.rx_errors = stats.rx_errors;
+            sample.rx_dropped = stats.rx_dropped;
+            sample.tx_bytes = stats.tx_bytes;
+            sample.tx_packets = stats.tx_packets;
+            sample.tx_errors = stats.tx_errors;
+            sample.tx_dropped = stats.tx_dropped;
+            out.push_back(sample);
+        }
+    });
+
+    if (!ok) {
+        // RTM_GETSTATS 不受支持时内核回复 NLMSG_ERROR，以后只用 RTM_GETLINK
+        stats_supported_ = false;
+        return scrapeLinkDump(out);
+    }
+    if (unknown_link) {
+        // 通知尚未到达的新接口：本次用完整 dump，顺带刷新接口表
+        return scrapeLinkDump(out);
+    }
+    return true;
+}
+
+void LinkStatsScraper::scrapeProcNetDev(std::vector<InterfaceSample>& out) {
+    out.clear();
+
+    // 每行 "iface: rx_bytes rx_packets rx_errs rx_drop ... (8 列接收) tx_bytes tx_packets tx_errs tx_drop ..."
+    proc_parse::forEachLine(net_dev_.read(), [&out](std::string_view line) {
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos) {
+            return;
+        }
+        const char* name = line.data();
+        const char* name_end = line.data() + colon;
+        proc_parse::skipSpaces(name, name_end);
+        std::string_view iface(name, static_cast<size_t>(name_end - name));
+        if (iface == "lo") {
+            return;
+        }
+
+        const char* p = line.data() + colon + 1;
+        const char* end = line.data() + line.size();
+        unsigned long long fields[12] = {};
+        for (auto& field : fields) {
+            if (!proc_parse::parseUnsigned(p, end, field)) {
+                return;
+            }
+        }
+
+        InterfaceSample sample = {};
+        copyName(sample.name, sizeof(sample.name), iface.data(), iface.size());
+        // /proc/net/dev 不提供接口状态，有此行即视为存在
+        sample.up = true;
+        sample.rx_bytes = fields[0];
+        sample.rx_packets = fields[1];
+        sample.rx_errors = fields[2];
+        sample.rx_dropped = fields[3];
+        sample.tx_bytes = fields[8];
+        sample.tx_packets = fields[9];
+        sample.tx_errors = fields[10];
+        sample.tx_dropped = fields[11];
+        out.push_back(sample);
+    });
+}
+
+DiskStatsScraper::DiskStatsScraper() : diskstats_("/proc/diskstats") {
+}
+
+const std::vector<BlockDeviceSample>& DiskStatsScraper::scrape() {
+    samples_.clear();
+
+    // "major minor name reads merged sectors_read read_ms writes merged sectors_written write_ms
+    //  in_progress io_ms weighted_io_ms ..."，新内核在后面追加 discard / flush 字段
+    proc_parse::forEachLine(diskstats_.read(), [this](std::string_view line) {
+        const char* p = line.data();
+        const char* end = p + line.size();
+        unsigned long long major = 0, minor = 0;
+        if (!proc_parse::parseUnsigned(p, end, major) || !proc_parse::parseUnsigned(p, end, minor)) {
+            return;
+        }
+        std::string_view name = proc_parse::nextToken(p, end);
+        if (name.empty()) {
+            return;
+        }
+
+        unsigned long long fields[10] = {};
+        for (auto& field : fields) {
+            if (!proc_parse::parseUnsigned(p, end, field)) {
+                return;
+            }
+        }
+        if (fields[0] == 0 && fields[4] == 0) {
+            return;
+        }
+
+        BlockDeviceSample sample;
+        copyName(sample.name, sizeof(sample.name), name.data(), name.size());
+        sample.reads_completed = fields[0];
+        sample.sectors_read = fields[2];
+        sample.read_time_ms = fields[3];
+        sample.writes_completed = fields[4];
+        sample.sectors_written = fields[6];
+        sample.write_time_ms = fields[7];
+        sample.io_in_progress = fields[8];
+        sample.io_time_ms = fields[9];
+        samples_.push_back(sample);
+    });
+    return samples_;
+}
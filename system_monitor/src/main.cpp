@@ -26,12 +26,17 @@ void printUsage(const char* program_name) {
     std::cout << "Usage: " << program_name << " [options]" << std::endl;
     std::cout << "Options:" << std::endl;
     std::cout << "  -i, --interval <seconds>   Set monitoring interval (default: 5)" << std::endl;
+    std::cout << "  -s, --sample-ms <ms>       Enable high-frequency sampling every <ms> milliseconds" << std::endl;
+    std::cout << "  -q, --quiet                Do not print reports to the console" << std::endl;
+    std::cout << "  -p, --perf                 Collect hardware counters via perf_event_open" << std::endl;
+    std::cout << "  -l, --latency-file <path>  Export latency quantiles reported by another process" << std::endl;
     std::cout << "  -h, --help                 Show this help message" << std::endl;
     std::cout << "  -v, --version              Show version information" << std::endl;
     std::cout << std::endl;
     std::cout << "Examples:" << std::endl;
     std::cout << "  " << program_name << "                    # Monitor with 5 seconds interval" << std::endl;
     std::cout << "  " << program_name << " -i 10              # Monitor with 10 seconds interval" << std::endl;
+    std::cout << "  " << program_name << " -i 1 -s 10         # Report every second, sample every 10 ms" << std::endl;
 }
 
 void printVersion() {
@@ -162,6 +167,10 @@ void simulateBusinessLogic() {
 
 int main(int argc, char* argv[]) {
     int interval = 5;
+    int sample_ms = 0;
+    bool quiet = false;
+    bool perf = false;
+    std::string latency_file;
 
     // 解析命令行参数
     for (int i = 1; i < argc; ++i) {
@@ -189,6 +198,33 @@ int main(int argc, char* argv[]) {
                 std::cerr << "Error: --interval requires a value" << std::endl;
                 return 1;
             }
+        } else if (arg == "-q" || arg == "--quiet") {
+            quiet = true;
+        } else if (arg == "-p" || arg == "--perf") {
+            perf = true;
+        } else if (arg == "-l" || arg == "--latency-file") {
+            if (i + 1 < argc) {
+                latency_file = argv[++i];
+            } else {
+                std::cerr << "Error: --latency-file requires a value" << std::endl;
+                return 1;
+            }
+        } else if (arg == "-s" || arg == "--sample-ms") {
+            if (i + 1 < argc) {
+                try {
+                    sample_ms = std::stoi(argv[++i]);
+                    if (sample_ms <= 0) {
+                        std::cerr << "Error: Sample interval must be a positive integer" << std::endl;
+                        return 1;
+                    }
+                } catch (const std::exception& e) {
+                    std::cerr << "Error: Invalid sample interval value: " << argv[i] << std::endl;
+                    return 1;
+                }
+            } else {
+                std::cerr << "Error: --sample-ms requires a value" << std::endl;
+                return 1;
+            }
         } else {
             std::cerr << "Error: Unknown option: " << arg << std::endl;
             printUsage(argv[0]);
@@ -201,14 +237,19 @@ int main(int argc, char* argv[]) {
     signal(SIGTERM, signalHandler);
 
     try {
+        SystemMonitorOptions options;
+        options.console_output = !quiet;
+        options.enable_perf_counters = perf;
+        options.latency_file = latency_file;
+        g_monitor = std::make_unique<SystemMonitor>(options);
+
         std::cout << "Starting System Monitor Service..." << std::endl;
         std::cout << "Monitoring interval: " << interval << " seconds" << std::endl;
         std::cout << "Prometheus metrics available at: http://" << g_monitor->getPrometheusAddress() << "/metrics" << std::endl;
         std::cout << "Press Ctrl+C to stop monitoring" << std::endl;
         std::cout << std::endl;
 
-        g_monitor = std::make_unique<SystemMonitor>();
-        g_monitor->start(interval);
+        g_monitor->start(std::chrono::seconds(interval), std::chrono::milliseconds(sample_ms));
 
         // 模拟业务逻辑
         simulateBusinessLogic();
@@ -0,0 +1,152 @@
+#include "perf_counters.h"
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+struct EventConfig {
+    uint32_t type;
+    uint64_t config;
+};
+
+const EventConfig kEventConfigs[PerfCounters::kEventCount] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},   // 通常映射为 LLC miss
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+};
+
+}  // namespace
+
+PerfCounters::PerfCounters() : available_mask_(0), retired_{} {
+    // 在当前线程上逐个探测，探测用的计数器随即关闭
+    int last_errno = 0;
+    for (size_t i = 0; i < kEventCount; ++i) {
+        int fd = openEvent(static_cast<PerfEvent>(i), 0);
+        if (fd >= 0) {
+            available_mask_ |= 1u << i;
+            ::close(fd);
+        } else {
+            last_errno = errno;
+        }
+    }
+
+    if (available_mask_ == 0) {
+        unavailable_reason_ = std::string("perf_event_open failed: ") + std::strerror(last_errno);
+        if (last_errno == EACCES || last_errno == EPERM) {
+            unavailable_reason_ += " (check /proc/sys/kernel/perf_event_paranoid or CAP_PERFMON)";
+        }
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for (auto& item : threads_) {
+        closeThread(item.second);
+    }
+}
+
+const char* PerfCounters::eventName(PerfEvent event) {
+    switch (event) {
+        case PerfEvent::Cycles: return "cycles";
+        case PerfEvent::Instructions: return "instructions";
+        case PerfEvent::LlcMisses: return "llc_misses";
+        case PerfEvent::BranchMisses: return "branch_misses";
+        case PerfEvent::PageFaults: return "page_faults";
+    }
+    return "unknown";
+}
+
+int PerfCounters::openEvent(PerfEvent event, int tid) {
+    const EventConfig& config = kEventConfigs[static_cast<size_t>(event)];
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = config.type;
+    attr.config = config.config;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // 只计用户态，perf_event_paranoid = 2 时普通用户也能打开
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, tid, -1, -1, PERF_FLAG_FD_CLOEXEC));
+}
+
+uint64_t PerfCounters::readScaled(int fd) {
+    // value, time_enabled, time_running
+    uint64_t values[3] = {};
+    if (fd < 0 || ::read(fd, values, sizeof(values)) != static_cast<ssize_t>(sizeof(values))) {
+        return 0;
+    }
+    // 计数器多于硬件 PMU 时内核分时复用，按实际运行时间比例换算
+    if (values[2] > 0 && values[2] < values[1]) {
+        return static_cast<uint64_t>(static_cast<double>(values[0]) * values[1] / values[2]);
+    }
+    return values[0];
+}
+
+void PerfCounters::closeThread(ThreadCounters& counters) {
+    for (size_t i = 0; i < kEventCount; ++i) {
+        if (counters.fds[i] >= 0) {
+            retired_[i] += readScaled(counters.fds[i]);
+            ::close(counters.fds[i]);
+            counters.fds[i] = -1;
+        }
+    }
+}
+
+void PerfCounters::syncThreads(const std::vector<ThreadSample>& threads) {
+    if (available_mask_ == 0) {
+        return;
+    }
+
+    for (auto& item : threads_) {
+        item.second.seen = false;
+    }
+
+    for (const ThreadSample& thread : threads) {
+        auto it = threads_.find(thread.tid);
+        if (it == threads_.end()) {
+            ThreadCounters counters;
+            for (size_t i = 0; i < kEventCount; ++i) {
+                counters.fds[i] = available(static_cast<PerfEvent>(i)) ? openEvent(static_cast<PerfEvent>(i), thread.tid)
+                                                                       : -1;
+            }
+            it = threads_.emplace(thread.tid, counters).first;
+        }
+        it->second.seen = true;
+    }
+
+    for (auto it = threads_.begin(); it != threads_.end();) {
+        if (it->second.seen) {
+            ++it;
+        } else {
+            closeThread(it->second);
+            it = threads_.erase(it);
+        }
+    }
+}
+
+void PerfCounters::read(uint64_t (&totals)[kEventCount]) {
+    for (size_t i = 0; i < kEventCount; ++i) {
+        totals[i] = retired_[i];
+    }
+    for (const auto& item : threads_) {
+        for (size_t i = 0; i < kEventCount; ++i) {
+            if (item.second.fds[i] >= 0) {
+                totals[i] += readScaled(item.second.fds[i]);
+            }
+        }
+    }
+
+    if (!available(PerfEvent::PageFaults)) {
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0) {
+            totals[static_cast<size_t>(PerfEvent::PageFaults)] =
+                static_cast<uint64_t>(usage.ru_minflt) + static_cast<uint64_t>(usage.ru_majflt);
+        }
+    }
+}
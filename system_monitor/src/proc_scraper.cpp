@@ -0,0 +1,388 @@
+#include "proc_scraper.h"
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+
+ProcFile::ProcFile(const char* path, size_t initial_capacity)
+    : fd_(::open(path, O_RDONLY | O_CLOEXEC)), buffer_(initial_capacity < 64 ? 64 : initial_capacity) {
+}
+
+ProcFile::~ProcFile() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+ProcFile::ProcFile(ProcFile&& other) noexcept : fd_(other.fd_), buffer_(std::move(other.buffer_)) {
+    other.fd_ = -1;
+}
+
+ProcFile& ProcFile::operator=(ProcFile&& other) noexcept {
+    if (this != &other) {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+        fd_ = other.fd_;
+        buffer_ = std::move(other.buffer_);
+        other.fd_ = -1;
+    }
+    return *this;
+}
+
+std::string_view ProcFile::read() {
+    if (fd_ < 0) {
+        return {};
+    }
+
+    for (;;) {
+        // 留出 1 字节放 '\0'；读满说明缓冲区可能不够，扩容后从头重读，
+        // 稳定后每次采样只有一次 pread 系统调用
+        ssize_t n = ::pread(fd_, buffer_.data(), buffer_.size() - 1, 0);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return {};
+        }
+        if (static_cast<size_t>(n) < buffer_.size() - 1) {
+            buffer_[static_cast<size_t>(n)] = '\0';
+            return std::string_view(buffer_.data(), static_cast<size_t>(n));
+        }
+        buffer_.resize(buffer_.size() * 2);
+    }
+}
+
+namespace proc_parse {
+
+void skipSpaces(const char*& p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t')) {
+        ++p;
+    }
+}
+
+std::string_view nextToken(const char*& p, const char* end) {
+    skipSpaces(p, end);
+    const char* begin = p;
+    while (p < end && *p != ' ' && *p != '\t' && *p != '\n') {
+        ++p;
+    }
+    return std::string_view(begin, static_cast<size_t>(p - begin));
+}
+
+bool parseUnsigned(const char*& p, const char* end, unsigned long long& value) {
+    skipSpaces(p, end);
+    auto result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) {
+        return false;
+    }
+    p = result.ptr;
+    return true;
+}
+
+bool parseSigned(const char*& p, const char* end, long long& value) {
+    skipSpaces(p, end);
+    auto result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) {
+        return false;
+    }
+    p = result.ptr;
+    return true;
+}
+
+bool parseDouble(const char*& p, const char* end, double& value) {
+    skipSpaces(p, end);
+    auto result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) {
+        return false;
+    }
+    p = result.ptr;
+    return true;
+}
+
+bool parseKeyValue(std::string_view line, std::string_view key, size_t& value) {
+    if (line.size() <= key.size() || line.compare(0, key.size(), key) != 0) {
+        return false;
+    }
+    const char* p = line.data() + key.size();
+    unsigned long long parsed = 0;
+    if (!parseUnsigned(p, line.data() + line.size(), parsed)) {
+        return false;
+    }
+    value = static_cast<size_t>(parsed);
+    return true;
+}
+
+}  // namespace proc_parse
+
+const char* schedulerPolicyName(unsigned int policy) {
+    switch (policy) {
+        case 0: return "SCHED_OTHER";
+        case 1: return "SCHED_FIFO";
+        case 2: return "SCHED_RR";
+        case 3: return "SCHED_BATCH";
+        case 5: return "SCHED_IDLE";
+        case 6: return "SCHED_DEADLINE";
+        default: return "UNKNOWN";
+    }
+}
+
+ProcScraper::ProcScraper()
+    : stat_("/proc/self/stat"),
+      status_("/proc/self/status"),
+      meminfo_("/proc/meminfo"),
+      io_("/proc/self/io"),
+      net_dev_("/proc/net/dev"),
+      loadavg_("/proc/loadavg"),
+      uptime_("/proc/uptime"),
+      limits_("/proc/self/limits"),
+      cpuinfo_("/proc/cpuinfo", 64 * 1024),
+      statm_("/proc/self/statm", 256) {
+    long page_size = sysconf(_SC_PAGESIZE);
+    page_kb_ = page_size > 0 ? static_cast<size_t>(page_size) / 1024 : 4;
+
+    // 最多检查 8 个温度传感器，遇到第一个不存在的即停止
+    for (int i = 0; i < 8; ++i) {
+        std::string path = "/sys/class/thermal/thermal_zone" + std::to_string(i) + "/temp";
+        ProcFile zone(path.c_str(), 64);
+        if (!zone.isOpen()) {
+            break;
+        }
+        thermal_zones_.push_back(std::move(zone));
+    }
+}
+
+void ProcScraper::scrape(ProcSample& sample) {
+    scrapeStat(sample);
+    scrapeStatus(sample);
+    scrapeMeminfo(sample);
+    scrapeIo(sample);
+    scrapeNetDev(sample);
+    scrapeLoadavg(sample);
+    scrapeUptime(sample);
+    scrapeLimits(sample);
+    scrapeCpuinfo(sample);
+    scrapeThermal(sample);
+}
+
+void ProcScraper::scrapeStat(ProcSample& sample) {
+    sample.utime = 0;
+    sample.stime = 0;
+    sample.priority = 0;
+    sample.nice = 0;
+    sample.policy = 0;
+
+    std::string_view text = stat_.read();
+    // 第 2 个字段 comm 带括号且可能包含空格，从最后一个 ')' 之后开始按字段计数
+    size_t comm_end = text.rfind(')');
+    if (comm_end == std::string_view::npos) {
+        return;
+    }
+
+    const char* p = text.data() + comm_end + 1;
+    const char* end = text.data() + text.size();
+    for (int field = 3; field <= 41 && p < end; ++field) {
+        long long value = 0;
+        switch (field) {
+            case 14:
+            case 15:
+            case 18:
+            case 19:
+            case 41:
+                if (!proc_parse::parseSigned(p, end, value)) {
+                    return;
+                }
+                break;
+            default:
+                proc_parse::nextToken(p, end);
+                continue;
+        }
+
+        if (field == 14) {
+            sample.utime = static_cast<unsigned long long>(value);
+        } else if (field == 15) {
+            sample.stime = static_cast<unsigned long long>(value);
+        } else if (field == 18) {
+            sample.priority = static_cast<long>(value);
+        } else if (field == 19) {
+            sample.nice = static_cast<long>(value);
+        } else {
+            sample.policy = static_cast<unsigned int>(value);
+        }
+    }
+}
+
+void ProcScraper::scrapeStatus(ProcSample& sample) {
+    sample.state = '\0';
+    sample.vm_rss_kb = 0;
+    sample.vm_peak_kb = 0;
+    sample.threads = 0;
+    sample.voluntary_ctxt_switches = 0;
+    sample.nonvoluntary_ctxt_switches = 0;
+
+    proc_parse::forEachLine(status_.read(), [&sample](std::string_view line) {
+        if (line.compare(0, 6, "State:") == 0) {
+            const char* p = line.data() + 6;
+            std::string_view state = proc_parse::nextToken(p, line.data() + line.size());
+            sample.state = state.empty() ? '\0' : state[0];
+        } else if (!proc_parse::parseKeyValue(line, "VmRSS:", sample.vm_rss_kb) &&
+                   !proc_parse::parseKeyValue(line, "VmPeak:", sample.vm_peak_kb) &&
+                   !proc_parse::parseKeyValue(line, "Threads:", sample.threads) &&
+                   !proc_parse::parseKeyValue(line, "voluntary_ctxt_switches:", sample.voluntary_ctxt_switches)) {
+            proc_parse::parseKeyValue(line, "nonvoluntary_ctxt_switches:", sample.nonvoluntary_ctxt_switches);
+        }
+    });
+}
+
+void ProcScraper::scrapeMeminfo(ProcSample& sample) {
+    sample.mem_total_kb = 0;
+    sample.mem_available_kb = 0;
+    sample.buffers_kb = 0;
+    sample.cached_kb = 0;
+    sample.swap_total_kb = 0;
+    sample.swap_free_kb = 0;
+
+    proc_parse::forEachLine(meminfo_.read(), [&sample](std::string_view line) {
+        proc_parse::parseKeyValue(line, "MemTotal:", sample.mem_total_kb) ||
+            proc_parse::parseKeyValue(line, "MemAvailable:", sample.mem_available_kb) ||
+            proc_parse::parseKeyValue(line, "Buffers:", sample.buffers_kb) ||
+            proc_parse::parseKeyValue(line, "Cached:", sample.cached_kb) ||
+            proc_parse::parseKeyValue(line, "SwapTotal:", sample.swap_total_kb) ||
+            proc_parse::parseKeyValue(line, "SwapFree:", sample.swap_free_kb);
+    });
+}
+
+void ProcScraper::scrapeIo(ProcSample& sample) {
+    sample.read_bytes = 0;
+    sample.write_bytes = 0;
+    sample.syscr = 0;
+    sample.syscw = 0;
+
+    proc_parse::forEachLine(io_.read(), [&sample](std::string_view line) {
+        proc_parse::parseKeyValue(line, "read_bytes:", sample.read_bytes) ||
+            proc_parse::parseKeyValue(line, "write_bytes:", sample.write_bytes) ||
+            proc_parse::parseKeyValue(line, "syscr:", sample.syscr) ||
+            proc_parse::parseKeyValue(line, "syscw:", sample.syscw);
+    });
+}
+
+void ProcScraper::scrapeNetDev(ProcSample& sample) {
+    sample.net_bytes_recv = 0;
+    sample.net_packets_recv = 0;
+    sample.net_bytes_sent = 0;
+    sample.net_packets_sent = 0;
+
+    // 每行 "iface: rx_bytes rx_packets ... (8 列接收) tx_bytes tx_packets ..."，两行表头没有 ':'
+    proc_parse::forEachLine(net_dev_.read(), [&sample](std::string_view line) {
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos) {
+            return;
+        }
+        const char* name = line.data();
+        const char* name_end = line.data() + colon;
+        proc_parse::skipSpaces(name, name_end);
+        if (std::string_view(name, static_cast<size_t>(name_end - name)) == "lo") {
+            return;
+        }
+
+        const char* p = line.data() + colon + 1;
+        const char* end = line.data() + line.size();
+        unsigned long long fields[10] = {};
+        for (auto& field : fields) {
+            if (!proc_parse::parseUnsigned(p, end, field)) {
+                return;
+            }
+        }
+        sample.net_bytes_recv += fields[0];
+        sample.net_packets_recv += fields[1];
+        sample.net_bytes_sent += fields[8];
+        sample.net_packets_sent += fields[9];
+    });
+}
+
+void ProcScraper::scrapeLoadavg(ProcSample& sample) {
+    sample.load_average_1min = 0.0;
+    sample.load_average_5min = 0.0;
+    sample.load_average_15min = 0.0;
+    sample.running_processes = 0;
+    sample.total_processes = 0;
+
+    // "0.52 0.58 0.59 2/1234 56789"
+    std::string_view text = loadavg_.read();
+    const char* p = text.data();
+    const char* end = p + text.size();
+    unsigned long long running = 0, total = 0;
+    if (!proc_parse::parseDouble(p, end, sample.load_average_1min) ||
+        !proc_parse::parseDouble(p, end, sample.load_average_5min) ||
+        !proc_parse::parseDouble(p, end, sample.load_average_15min) ||
+        !proc_parse::parseUnsigned(p, end, running) || p >= end || *p++ != '/' ||
+        !proc_parse::parseUnsigned(p, end, total)) {
+        return;
+    }
+    sample.running_processes = static_cast<size_t>(running);
+    sample.total_processes = static_cast<size_t>(total);
+}
+
+void ProcScraper::scrapeUptime(ProcSample& sample) {
+    sample.uptime_seconds = 0.0;
+
+    std::string_view text = uptime_.read();
+    const char* p = text.data();
+    proc_parse::parseDouble(p, p + text.size(), sample.uptime_seconds);
+}
+
+void ProcScraper::scrapeLimits(ProcSample& sample) {
+    sample.max_open_files = 0;
+
+    // 取软限制；"unlimited" 解析失败时保持 0
+    proc_parse::forEachLine(limits_.read(), [&sample](std::string_view line) {
+        proc_parse::parseKeyValue(line, "Max open files", sample.max_open_files);
+    });
+}
+
+void ProcScraper::scrapeCpuinfo(ProcSample& sample) {
+    sample.cpu_frequencies_mhz.clear();
+
+    proc_parse::forEachLine(cpuinfo_.read(), [&sample](std::string_view line) {
+        if (line.compare(0, 7, "cpu MHz") != 0) {
+            return;
+        }
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos) {
+            return;
+        }
+        const char* p = line.data() + colon + 1;
+        double mhz = 0.0;
+        if (proc_parse::parseDouble(p, line.data() + line.size(), mhz)) {
+            sample.cpu_frequencies_mhz.push_back(static_cast<size_t>(mhz));
+        }
+    });
+}
+
+void ProcScraper::scrapeThermal(ProcSample& sample) {
+    sample.cpu_temperatures.clear();
+
+    for (ProcFile& zone : thermal_zones_) {
+        std::string_view text = zone.read();
+        const char* p = text.data();
+        long long millidegree = 0;
+        if (!proc_parse::parseSigned(p, p + text.size(), millidegree)) {
+            break;
+        }
+        sample.cpu_temperatures.push_back(millidegree / 1000.0);  // 转换为摄氏度
+    }
+}
+
+size_t ProcScraper::residentKb() {
+    // "size resident shared text lib data dt"，单位为页
+    std::string_view text = statm_.read();
+    const char* p = text.data();
+    const char* end = p + text.size();
+    unsigned long long size = 0, resident = 0;
+    if (!proc_parse::parseUnsigned(p, end, size) || !proc_parse::parseUnsigned(p, end, resident)) {
+        return 0;
+    }
+    return static_cast<size_t>(resident) * page_kb_;
+}
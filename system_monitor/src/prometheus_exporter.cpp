@@ -1,13 +1,19 @@
 #include "prometheus_exporter.h"
+#include <algorithm>
 #include <iostream>
 
-PrometheusExporter::PrometheusExporter(const std::string& bind_address)
-    : exposer_(std::make_unique<prometheus::Exposer>(bind_address)) {
+PrometheusExporter::PrometheusExporter(const std::string& bind_address, size_t max_thread_series)
+    : exposer_(std::make_unique<prometheus::Exposer>(bind_address)), max_thread_series_(max_thread_series) {
     registry_ = std::make_shared<prometheus::Registry>();
     exposer_->RegisterCollectable(registry_);
     InitializeMetrics();
 }
 
+PrometheusExporter::PrometheusExporter(std::shared_ptr<prometheus::Registry> registry, size_t max_thread_series)
+    : registry_(std::move(registry)), max_thread_series_(max_thread_series) {
+    InitializeMetrics();
+}
+
 PrometheusExporter::~PrometheusExporter() = default;
 
 void PrometheusExporter::InitializeMetrics() {
@@ -71,126 +77,534 @@ void PrometheusExporter::InitializeMetrics() {
         .Name("uptime_seconds")
         .Help("System and process uptime in seconds")
         .Register(*registry_);
+
+    // 初始化高频采样窗口指标
+    window_cpu_usage_family_ = &prometheus::BuildGauge()
+        .Name("process_cpu_usage_window_percent")
+        .Help("Process CPU usage over high-frequency samples in the last report window")
+        .Register(*registry_);
+
+    window_memory_rss_family_ = &prometheus::BuildGauge()
+        .Name("process_memory_rss_window_mb")
+        .Help("Process resident memory over high-frequency samples in the last report window")
+        .Register(*registry_);
+
+    window_context_switches_family_ = &prometheus::BuildGauge()
+        .Name("process_context_switches_window_per_sec")
+        .Help("Process context switch rate over high-frequency samples in the last report window")
+        .Register(*registry_);
+
+    window_sample_count_family_ = &prometheus::BuildGauge()
+        .Name("process_sample_window_count")
+        .Help("Number of high-frequency samples in the last report window")
+        .Register(*registry_);
+
+    // 初始化线程级指标
+    thread_cpu_family_ = &prometheus::BuildGauge()
+        .Name("process_thread_cpu_usage_percent")
+        .Help("Per-thread CPU usage percentage of one core")
+        .Register(*registry_);
+
+    thread_last_cpu_family_ = &prometheus::BuildGauge()
+        .Name("process_thread_last_cpu")
+        .Help("CPU the thread last ran on")
+        .Register(*registry_);
+
+    thread_context_switches_family_ = &prometheus::BuildCounter()
+        .Name("process_thread_context_switches_total")
+        .Help("Per-thread context switches")
+        .Register(*registry_);
+
+    thread_overflow_family_ = &prometheus::BuildGauge()
+        .Name("process_thread_series_overflow")
+        .Help("Threads folded into tid=\"other\" because of the per-thread series cap")
+        .Register(*registry_);
+
+    // 初始化每核温度与频率指标，序列在首次出现对应核心时创建
+    cpu_temperature_family_ = &prometheus::BuildGauge()
+        .Name("system_cpu_temperature_celsius")
+        .Help("Temperature per thermal zone")
+        .Register(*registry_);
+
+    cpu_frequency_family_ = &prometheus::BuildGauge()
+        .Name("system_cpu_frequency_mhz")
+        .Help("Current frequency per CPU core")
+        .Register(*registry_);
+
+    // 初始化各网络接口与块设备指标，序列在首次出现对应接口 / 设备时创建
+    interface_io_family_ = &prometheus::BuildGauge()
+        .Name("system_network_interface_io")
+        .Help("Per-interface network throughput")
+        .Register(*registry_);
+
+    interface_errors_family_ = &prometheus::BuildCounter()
+        .Name("system_network_interface_errors_total")
+        .Help("Per-interface receive / transmit errors and drops")
+        .Register(*registry_);
+
+    interface_up_family_ = &prometheus::BuildGauge()
+        .Name("system_network_interface_up")
+        .Help("Whether the interface is administratively up")
+        .Register(*registry_);
+
+    block_device_io_family_ = &prometheus::BuildGauge()
+        .Name("system_disk_device_io")
+        .Help("Per-block-device I/O throughput")
+        .Register(*registry_);
+
+    block_device_utilization_family_ = &prometheus::BuildGauge()
+        .Name("system_disk_device_utilization_percent")
+        .Help("Share of time the block device was busy")
+        .Register(*registry_);
+
+    // 初始化 perf_event 硬件计数器指标
+    hardware_events_family_ = &prometheus::BuildCounter()
+        .Name("process_hardware_events_total")
+        .Help("User-mode hardware and software events counted by perf_event_open")
+        .Register(*registry_);
+
+    hardware_ipc_family_ = &prometheus::BuildGauge()
+        .Name("process_ipc")
+        .Help("Instructions per cycle over the last report interval")
+        .Register(*registry_);
+
+    hardware_available_family_ = &prometheus::BuildGauge()
+        .Name("process_hardware_counter_available")
+        .Help("Whether the perf event could be opened (1) or not (0)")
+        .Register(*registry_);
+
+    // 初始化外部上报的耗时指标，序列在文件中首次出现对应计时点时创建
+    latency_family_ = &prometheus::BuildGauge()
+        .Name("app_latency_seconds")
+        .Help("Reported latency quantiles over the reporter's last statistics window (quantile=\"1\" is the max)")
+        .Register(*registry_);
+
+    latency_samples_family_ = &prometheus::BuildGauge()
+        .Name("app_latency_samples")
+        .Help("Number of latency samples in the reporter's last statistics window")
+        .Register(*registry_);
+
+    queue_depth_family_ = &prometheus::BuildGauge()
+        .Name("app_queue_depth")
+        .Help("Reported queue depth quantiles over the reporter's last statistics window (quantile=\"1\" is the max)")
+        .Register(*registry_);
+
+    other_cpu_user_ = &thread_cpu_family_->Add({{"tid", "other"}, {"name", "other"}, {"mode", "user"}});
+    other_cpu_system_ = &thread_cpu_family_->Add({{"tid", "other"}, {"name", "other"}, {"mode", "system"}});
+
+    // 解析固定标签的指标句柄，UpdateMetrics 中不再构造标签、查找序列
+    Handles& h = handles_;
+    h.cpu_usage = &cpu_usage_family_->Add({});
+    h.memory_used_mb = &memory_usage_family_->Add({{"type", "used_mb"}});
+    h.memory_total_mb = &memory_usage_family_->Add({{"type", "total_mb"}});
+    h.memory_usage_percent = &memory_usage_family_->Add({{"type", "usage_percent"}});
+    h.thread_count = &thread_count_family_->Add({});
+
+    h.load_1min = &load_average_family_->Add({{"period", "1min"}});
+    h.load_5min = &load_average_family_->Add({{"period", "5min"}});
+    h.load_15min = &load_average_family_->Add({{"period", "15min"}});
+    h.processes_running = &process_count_family_->Add({{"state", "running"}});
+    h.processes_total = &process_count_family_->Add({{"state", "total"}});
+
+    h.disk_read_bytes = &disk_io_family_->Add({{"operation", "read"}, {"unit", "bytes_per_sec"}});
+    h.disk_write_bytes = &disk_io_family_->Add({{"operation", "write"}, {"unit", "bytes_per_sec"}});
+    h.disk_read_ops = &disk_io_family_->Add({{"operation", "read"}, {"unit", "ops_per_sec"}});
+    h.disk_write_ops = &disk_io_family_->Add({{"operation", "write"}, {"unit", "ops_per_sec"}});
+
+    h.net_recv_bytes = &network_io_family_->Add({{"direction", "receive"}, {"unit", "bytes_per_sec"}});
+    h.net_sent_bytes = &network_io_family_->Add({{"direction", "send"}, {"unit", "bytes_per_sec"}});
+    h.net_recv_packets = &network_io_family_->Add({{"direction", "receive"}, {"unit", "packets_per_sec"}});
+    h.net_sent_packets = &network_io_family_->Add({{"direction", "send"}, {"unit", "packets_per_sec"}});
+
+    h.process_state = &process_status_family_->Add({{"type", "state"}});
+    h.fd_open = &file_descriptor_family_->Add({{"type", "open"}});
+    h.fd_max = &file_descriptor_family_->Add({{"type", "max"}});
+    h.fd_usage_percent = &file_descriptor_family_->Add({{"type", "usage_percent"}});
+    h.ctx_voluntary = &context_switches_family_->Add({{"type", "voluntary"}});
+    h.ctx_involuntary = &context_switches_family_->Add({{"type", "involuntary"}});
+
+    h.uptime_system = &uptime_family_->Add({{"type", "system"}});
+    h.uptime_process = &uptime_family_->Add({{"type", "process"}});
+
+    h.window_sample_count = &window_sample_count_family_->Add({});
+    const std::pair<prometheus::Family<prometheus::Gauge>*, WindowGauges*> window_families[] = {
+        {window_cpu_usage_family_, &h.window_cpu_usage},
+        {window_memory_rss_family_, &h.window_memory_rss},
+        {window_context_switches_family_, &h.window_context_switches},
+    };
+    for (const auto& entry : window_families) {
+        entry.second->min = &entry.first->Add({{"stat", "min"}});
+        entry.second->max = &entry.first->Add({{"stat", "max"}});
+        entry.second->p99 = &entry.first->Add({{"stat", "p99"}});
+    }
+
+    h.thread_overflow = &thread_overflow_family_->Add({});
+
+    for (size_t i = 0; i < PerfCounters::kEventCount; ++i) {
+        const char* event = PerfCounters::eventName(static_cast<PerfEvent>(i));
+        h.hardware_events[i] = &hardware_events_family_->Add({{"event", event}});
+        h.hardware_available[i] = &hardware_available_family_->Add({{"event", event}});
+    }
+    h.hardware_ipc = &hardware_ipc_family_->Add({});
+}
+
+void PrometheusExporter::AdvanceCounter(prometheus::Counter* counter, double total, double& last_total) {
+    if (total > last_total) {
+        counter->Increment(total - last_total);
+    }
+    last_total = total;
+}
+
+prometheus::Gauge* PrometheusExporter::CoreGauge(prometheus::Family<prometheus::Gauge>* family,
+                                                 std::vector<prometheus::Gauge*>& cache, size_t core) {
+    while (cache.size() <= core) {
+        cache.push_back(&family->Add({{"core", std::to_string(cache.size())}}));
+    }
+    return cache[core];
+}
+
+void PrometheusExporter::RemoveThreadSeries(ThreadSeries& series) {
+    thread_cpu_family_->Remove(series.cpu_user);
+    thread_cpu_family_->Remove(series.cpu_system);
+    thread_last_cpu_family_->Remove(series.last_cpu);
+    thread_context_switches_family_->Remove(series.voluntary);
+    thread_context_switches_family_->Remove(series.involuntary);
+}
+
+void PrometheusExporter::UpdateThreadMetrics(const std::vector<ThreadInfo>& threads) {
+    for (auto& item : thread_series_) {
+        item.second.seen = false;
+    }
+
+    double other_user = 0.0, other_system = 0.0;
+    size_t overflow = 0;
+    // threads 已按 CPU 使用率从高到低排列
+    for (size_t i = 0; i < threads.size(); ++i) {
+        const ThreadInfo& thread = threads[i];
+        if (i >= max_thread_series_) {
+            other_user += thread.cpu_user_percent;
+            other_system += thread.cpu_system_percent;
+            ++overflow;
+            continue;
+        }
+
+        auto it = thread_series_.find(thread.tid);
+        // 线程改名后标签不同，按新序列处理
+        if (it != thread_series_.end() && it->second.name != thread.name) {
+            RemoveThreadSeries(it->second);
+            thread_series_.erase(it);
+            it = thread_series_.end();
+        }
+        if (it == thread_series_.end()) {
+            std::string tid = std::to_string(thread.tid);
+            ThreadSeries series;
+            series.name = thread.name;
+            series.cpu_user = &thread_cpu_family_->Add({{"tid", tid}, {"name", thread.name}, {"mode", "user"}});
+            series.cpu_system = &thread_cpu_family_->Add({{"tid", tid}, {"name", thread.name}, {"mode", "system"}});
+            series.last_cpu = &thread_last_cpu_family_->Add({{"tid", tid}, {"name", thread.name}});
+            series.voluntary = &thread_context_switches_family_->Add(
+                {{"tid", tid}, {"name", thread.name}, {"type", "voluntary"}});
+            series.involuntary = &thread_context_switches_family_->Add(
+                {{"tid", tid}, {"name", thread.name}, {"type", "involuntary"}});
+            series.last_voluntary = 0;
+            series.last_involuntary = 0;
+            it = thread_series_.emplace(thread.tid, std::move(series)).first;
+        }
+
+        ThreadSeries& series = it->second;
+        series.seen = true;
+        series.cpu_user->Set(thread.cpu_user_percent);
+        series.cpu_system->Set(thread.cpu_system_percent);
+        series.last_cpu->Set(thread.last_cpu);
+        // 计数器只增加与上次的差值
+        if (thread.voluntary_context_switches > series.last_voluntary) {
+            series.voluntary->Increment(thread.voluntary_context_switches - series.last_voluntary);
+        }
+        if (thread.involuntary_context_switches > series.last_involuntary) {
+            series.involuntary->Increment(thread.involuntary_context_switches - series.last_involuntary);
+        }
+        series.last_voluntary = thread.voluntary_context_switches;
+        series.last_involuntary = thread.involuntary_context_switches;
+    }
+
+    // 已退出或跌出前 max_thread_series_ 的线程删除其序列，保证序列总数有上限
+    for (auto it = thread_series_.begin(); it != thread_series_.end();) {
+        if (it->second.seen) {
+            ++it;
+        } else {
+            RemoveThreadSeries(it->second);
+            it = thread_series_.erase(it);
+        }
+    }
+
+    other_cpu_user_->Set(other_user);
+    other_cpu_system_->Set(other_system);
+    handles_.thread_overflow->Set(overflow);
+}
+
+void PrometheusExporter::RemoveInterfaceSeries(InterfaceSeries& series) {
+    interface_io_family_->Remove(series.recv_bytes);
+    interface_io_family_->Remove(series.sent_bytes);
+    interface_io_family_->Remove(series.recv_packets);
+    interface_io_family_->Remove(series.sent_packets);
+    interface_up_family_->Remove(series.up);
+    for (prometheus::Counter* counter : series.faults) {
+        interface_errors_family_->Remove(counter);
+    }
+}
+
+void PrometheusExporter::UpdateInterfaceMetrics(const std::vector<InterfaceInfo>& interfaces) {
+    for (auto& item : interface_series_) {
+        item.second.seen = false;
+    }
+
+    for (const InterfaceInfo& iface : interfaces) {
+        auto it = interface_series_.find(iface.name);
+        if (it == interface_series_.end()) {
+            const std::string& name = iface.name;
+            InterfaceSeries series;
+            series.recv_bytes = &interface_io_family_->Add(
+                {{"interface", name}, {"direction", "receive"}, {"unit", "bytes_per_sec"}});
+            series.sent_bytes = &interface_io_family_->Add(
+                {{"interface", name}, {"direction", "send"}, {"unit", "bytes_per_sec"}});
+            series.recv_packets = &interface_io_family_->Add(
+                {{"interface", name}, {"direction", "receive"}, {"unit", "packets_per_sec"}});
+            series.sent_packets = &interface_io_family_->Add(
+                {{"interface", name}, {"direction", "send"}, {"unit", "packets_per_sec"}});
+            series.up = &interface_up_family_->Add({{"interface", name}});
+            series.faults[0] = &interface_errors_family_->Add(
+                {{"interface", name}, {"direction", "receive"}, {"type", "errors"}});
+            series.faults[1] = &interface_errors_family_->Add(
+                {{"interface", name}, {"direction", "send"}, {"type", "errors"}});
+            series.faults[2] = &interface_errors_family_->Add(
+                {{"interface", name}, {"direction", "receive"}, {"type", "dropped"}});
+            series.faults[3] = &interface_errors_family_->Add(
+                {{"interface", name}, {"direction", "send"}, {"type", "dropped"}});
+            std::fill(std::begin(series.last_faults), std::end(series.last_faults), 0);
+            it = interface_series_.emplace(name, series).first;
+        }
+
+        InterfaceSeries& series = it->second;
+        series.seen = true;
+        series.recv_bytes->Set(iface.bytes_recv_per_sec);
+        series.sent_bytes->Set(iface.bytes_sent_per_sec);
+        series.recv_packets->Set(iface.packets_recv_per_sec);
+        series.sent_packets->Set(iface.packets_sent_per_sec);
+        series.up->Set(iface.up ? 1 : 0);
+        const uint64_t faults[4] = {iface.rx_errors, iface.tx_errors, iface.rx_dropped, iface.tx_dropped};
+        for (size_t i = 0; i < 4; ++i) {
+            if (faults[i] > series.last_faults[i]) {
+                series.faults[i]->Increment(static_cast<double>(faults[i] - series.last_faults[i]));
+            }
+            series.last_faults[i] = faults[i];
+        }
+    }
+
+    for (auto it = interface_series_.begin(); it != interface_series_.end();) {
+        if (it->second.seen) {
+            ++it;
+        } else {
+            RemoveInterfaceSeries(it->second);
+            it = interface_series_.erase(it);
+        }
+    }
+}
+
+void PrometheusExporter::RemoveLatencySeries(LatencySeries& series) {
+    for (prometheus::Gauge* gauge : series.quantiles) {
+        series.family->Remove(gauge);
+    }
+    latency_samples_family_->Remove(series.samples);
+}
+
+void PrometheusExporter::UpdateLatencyMetrics(const std::vector<LatencyInfo>& latency) {
+    static const char* const kQuantiles[4] = {"0.5", "0.99", "0.999", "1"};
+
+    for (auto& item : latency_series_) {
+        item.second.seen = false;
+    }
+
+    for (const LatencyInfo& entry : latency) {
+        std::string key = entry.source + '/' + entry.site;
+        auto it = latency_series_.find(key);
+        if (it == latency_series_.end()) {
+            LatencySeries series;
+            series.family = entry.isCount() ? queue_depth_family_ : latency_family_;
+            series.scale = entry.isCount() ? 1.0 : 1e9;
+            for (size_t i = 0; i < 4; ++i) {
+                series.quantiles[i] = &series.family->Add(
+                    {{"source", entry.source}, {"site", entry.site}, {"quantile", kQuantiles[i]}});
+            }
+            series.samples = &latency_samples_family_->Add({{"source", entry.source}, {"site", entry.site}});
+            it = latency_series_.emplace(std::move(key), series).first;
+        }
+
+        LatencySeries& series = it->second;
+        series.seen = true;
+        const uint64_t values[4] = {entry.p50_ns, entry.p99_ns, entry.p999_ns, entry.max_ns};
+        for (size_t i = 0; i < 4; ++i) {
+            series.quantiles[i]->Set(static_cast<double>(values[i]) / series.scale);
+        }
+        series.samples->Set(static_cast<double>(entry.count));
+    }
+
+    for (auto it = latency_series_.begin(); it != latency_series_.end();) {
+        if (it->second.seen) {
+            ++it;
+        } else {
+            RemoveLatencySeries(it->second);
+            it = latency_series_.erase(it);
+        }
+    }
+}
+
+void PrometheusExporter::RemoveBlockDeviceSeries(BlockDeviceSeries& series) {
+    block_device_io_family_->Remove(series.read_bytes);
+    block_device_io_family_->Remove(series.write_bytes);
+    block_device_io_family_->Remove(series.read_ops);
+    block_device_io_family_->Remove(series.write_ops);
+    block_device_io_family_->Remove(series.in_progress);
+    block_device_utilization_family_->Remove(series.utilization);
+}
+
+void PrometheusExporter::UpdateBlockDeviceMetrics(const std::vector<BlockDeviceInfo>& devices) {
+    for (auto& item : block_device_series_) {
+        item.second.seen = false;
+    }
+
+    for (const BlockDeviceInfo& device : devices) {
+        auto it = block_device_series_.find(device.name);
+        if (it == block_device_series_.end()) {
+            const std::string& name = device.name;
+            BlockDeviceSeries series;
+            series.read_bytes = &block_device_io_family_->Add(
+                {{"device", name}, {"operation", "read"}, {"unit", "bytes_per_sec"}});
+            series.write_bytes = &block_device_io_family_->Add(
+                {{"device", name}, {"operation", "write"}, {"unit", "bytes_per_sec"}});
+            series.read_ops = &block_device_io_family_->Add(
+                {{"device", name}, {"operation", "read"}, {"unit", "ops_per_sec"}});
+            series.write_ops = &block_device_io_family_->Add(
+                {{"device", name}, {"operation", "write"}, {"unit", "ops_per_sec"}});
+            series.in_progress = &block_device_io_family_->Add(
+                {{"device", name}, {"operation", "in_progress"}, {"unit", "requests"}});
+            series.utilization = &block_device_utilization_family_->Add({{"device", name}});
+            it = block_device_series_.emplace(name, series).first;
+        }
+
+        BlockDeviceSeries& series = it->second;
+        series.seen = true;
+        series.read_bytes->Set(device.read_bytes_per_sec);
+        series.write_bytes->Set(device.write_bytes_per_sec);
+        series.read_ops->Set(device.read_ops_per_sec);
+        series.write_ops->Set(device.write_ops_per_sec);
+        series.in_progress->Set(device.io_in_progress);
+        series.utilization->Set(device.utilization_percent);
+    }
+
+    for (auto it = block_device_series_.begin(); it != block_device_series_.end();) {
+        if (it->second.seen) {
+            ++it;
+        } else {
+            RemoveBlockDeviceSeries(it->second);
+            it = block_device_series_.erase(it);
+        }
+    }
 }
 
 void PrometheusExporter::UpdateMetrics(const SystemInfo& info) {
+    const Handles& h = handles_;
+
     // 更新CPU使用率
-    cpu_usage_family_->Add({}).Set(info.cpu_usage_percent);
+    h.cpu_usage->Set(info.cpu_usage_percent);
 
     // 更新内存使用情况
-    auto& memory_gauge = memory_usage_family_->Add({
-        {"type", "used_mb"}
-    });
-    memory_gauge.Set(info.memory_used_mb);
-
-    memory_usage_family_->Add({
-        {"type", "total_mb"}
-    }).Set(info.memory_total_mb);
-
-    memory_usage_family_->Add({
-        {"type", "usage_percent"}
-    }).Set(info.memory_usage_percent);
+    h.memory_used_mb->Set(info.memory_used_mb);
+    h.memory_total_mb->Set(info.memory_total_mb);
+    h.memory_usage_percent->Set(info.memory_usage_percent);
 
     // 更新线程数
-    thread_count_family_->Add({}).Set(info.thread_count);
+    h.thread_count->Set(info.thread_count);
 
     // 更新系统负载
-    load_average_family_->Add({
-        {"period", "1min"}
-    }).Set(info.system_load.load_average_1min);
-
-    load_average_family_->Add({
-        {"period", "5min"}
-    }).Set(info.system_load.load_average_5min);
-
-    load_average_family_->Add({
-        {"period", "15min"}
-    }).Set(info.system_load.load_average_15min);
+    h.load_1min->Set(info.system_load.load_average_1min);
+    h.load_5min->Set(info.system_load.load_average_5min);
+    h.load_15min->Set(info.system_load.load_average_15min);
 
     // 更新进程数量
-    process_count_family_->Add({
-        {"state", "running"}
-    }).Set(info.system_load.running_processes);
-
-    process_count_family_->Add({
-        {"state", "total"}
-    }).Set(info.system_load.total_processes);
+    h.processes_running->Set(info.system_load.running_processes);
+    h.processes_total->Set(info.system_load.total_processes);
 
     // 更新磁盘IO
-    disk_io_family_->Add({
-        {"operation", "read"},
-        {"unit", "bytes_per_sec"}
-    }).Set(info.disk_io.read_bytes_per_sec);
-
-    disk_io_family_->Add({
-        {"operation", "write"},
-        {"unit", "bytes_per_sec"}
-    }).Set(info.disk_io.write_bytes_per_sec);
-
-    disk_io_family_->Add({
-        {"operation", "read"},
-        {"unit", "ops_per_sec"}
-    }).Set(info.disk_io.read_ops_per_sec);
-
-    disk_io_family_->Add({
-        {"operation", "write"},
-        {"unit", "ops_per_sec"}
-    }).Set(info.disk_io.write_ops_per_sec);
+    h.disk_read_bytes->Set(info.disk_io.read_bytes_per_sec);
+    h.disk_write_bytes->Set(info.disk_io.write_bytes_per_sec);
+    h.disk_read_ops->Set(info.disk_io.read_ops_per_sec);
+    h.disk_write_ops->Set(info.disk_io.write_ops_per_sec);
 
     // 更新网络IO
-    network_io_family_->Add({
-        {"direction", "receive"},
-        {"unit", "bytes_per_sec"}
-    }).Set(info.network.bytes_recv_per_sec);
-
-    network_io_family_->Add({
-        {"direction", "send"},
-        {"unit", "bytes_per_sec"}
-    }).Set(info.network.bytes_sent_per_sec);
-
-    network_io_family_->Add({
-        {"direction", "receive"},
-        {"unit", "packets_per_sec"}
-    }).Set(info.network.packets_recv_per_sec);
-
-    network_io_family_->Add({
-        {"direction", "send"},
-        {"unit", "packets_per_sec"}
-    }).Set(info.network.packets_sent_per_sec);
+    h.net_recv_bytes->Set(info.network.bytes_recv_per_sec);
+    h.net_sent_bytes->Set(info.network.bytes_sent_per_sec);
+    h.net_recv_packets->Set(info.network.packets_recv_per_sec);
+    h.net_sent_packets->Set(info.network.packets_sent_per_sec);
+
+    // 更新各接口与块设备
+    UpdateInterfaceMetrics(info.interfaces);
+    UpdateBlockDeviceMetrics(info.block_devices);
+    UpdateLatencyMetrics(info.latency);
 
     // 更新进程状态
-    process_status_family_->Add({
-        {"type", "state"}
-    }).Set(1); // 设置为1表示当前状态
+    h.process_state->Set(1); // 设置为1表示当前状态
 
     // 更新文件描述符
-    file_descriptor_family_->Add({
-        {"type", "open"}
-    }).Set(info.process.open_files_count);
-
-    file_descriptor_family_->Add({
-        {"type", "max"}
-    }).Set(info.process.max_open_files);
-
-    file_descriptor_family_->Add({
-        {"type", "usage_percent"}
-    }).Set(info.process.file_descriptor_usage_percent);
-
-    // 更新上下文切换计数
-    context_switches_family_->Add({
-        {"type", "voluntary"}
-    }).Increment(info.process.voluntary_context_switches);
-
-    context_switches_family_->Add({
-        {"type", "involuntary"}
-    }).Increment(info.process.involuntary_context_switches);
-
-    // 更新运行时间
-    uptime_family_->Add({
-        {"type", "system"}
-    }).Increment(info.system_uptime_seconds);
-
-    uptime_family_->Add({
-        {"type", "process"}
-    }).Increment(info.process_uptime_seconds);
-}
\ No newline at end of file
+    h.fd_open->Set(info.process.open_files_count);
+    h.fd_max->Set(info.process.max_open_files);
+    h.fd_usage_percent->Set(info.process.file_descriptor_usage_percent);
+
+    // 更新上下文切换计数与运行时间（累计值，按差值递增）
+    AdvanceCounter(h.ctx_voluntary, info.process.voluntary_context_switches, last_ctx_voluntary_);
+    AdvanceCounter(h.ctx_involuntary, info.process.involuntary_context_switches, last_ctx_involuntary_);
+    AdvanceCounter(h.uptime_system, info.system_uptime_seconds, last_uptime_system_);
+    AdvanceCounter(h.uptime_process, info.process_uptime_seconds, last_uptime_process_);
+
+    // 更新每核温度与频率
+    for (size_t i = 0; i < info.cpu_temperatures.size(); ++i) {
+        CoreGauge(cpu_temperature_family_, temperature_gauges_, i)->Set(info.cpu_temperatures[i]);
+    }
+    for (size_t i = 0; i < info.cpu_frequencies.size(); ++i) {
+        CoreGauge(cpu_frequency_family_, frequency_gauges_, i)->Set(info.cpu_frequencies[i]);
+    }
+
+    // 更新线程级指标
+    UpdateThreadMetrics(info.threads);
+
+    // 更新硬件计数器，HardwareCounterInfo 中已是本周期增量；未启用 perf 时不导出
+    const HardwareCounterInfo& hardware = info.hardware;
+    if (hardware.enabled) {
+        const uint64_t deltas[PerfCounters::kEventCount] = {
+            hardware.cycles, hardware.instructions, hardware.llc_misses, hardware.branch_misses,
+            hardware.page_faults,
+        };
+        for (size_t i = 0; i < PerfCounters::kEventCount; ++i) {
+            h.hardware_available[i]->Set((hardware.available_mask >> i) & 1u);
+            if (deltas[i] > 0) {
+                h.hardware_events[i]->Increment(static_cast<double>(deltas[i]));
+            }
+        }
+        h.hardware_ipc->Set(hardware.ipc);
+    }
+
+    // 更新高频采样窗口统计，窗口内没有样本时保留上一次的值
+    const SampleWindowInfo& window = info.sample_window;
+    h.window_sample_count->Set(window.sample_count);
+    if (window.sample_count > 0) {
+        const std::pair<const WindowGauges*, const WindowStat*> window_stats[] = {
+            {&h.window_cpu_usage, &window.cpu_usage_percent},
+            {&h.window_memory_rss, &window.memory_rss_mb},
+            {&h.window_context_switches, &window.context_switches_per_sec},
+        };
+        for (const auto& entry : window_stats) {
+            entry.first->min->Set(entry.second->min);
+            entry.first->max->Set(entry.second->max);
+            entry.first->p99->Set(entry.second->p99);
+        }
+    }
+}
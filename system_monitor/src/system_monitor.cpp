@@ -1,21 +1,62 @@
 #include "system_monitor.h"
 #include "prometheus_exporter.h"
 #include <iostream>
-#include <fstream>
 #include <sstream>
+#include <fstream>
 #include <iomanip>
 #include <chrono>
 #include <unistd.h>
 #include <sys/stat.h>
 #include <dirent.h>
+#include <sys/resource.h>
+#include <algorithm>
+
+SystemMonitor::SystemMonitor(const std::string& prometheus_address)
+    : SystemMonitor([&prometheus_address] {
+          SystemMonitorOptions options;
+          options.prometheus_address = prometheus_address;
+          return options;
+      }()) {
+}
 
-SystemMonitor::SystemMonitor(const std::string& prometheus_address) 
-    : running_(false), interval_seconds_(1), last_total_time_(0), last_idle_time_(0),
-      last_process_utime_(0), last_process_stime_(0), prometheus_address_(prometheus_address) {
+SystemMonitor::SystemMonitor(const SystemMonitorOptions& options)
+    : prometheus_address_(options.prometheus_address), subscribers_(std::make_shared<const SubscriberList>()),
+      next_subscription_id_(1), console_output_(options.console_output), running_(false), interval_ms_(1000),
+      sample_interval_ms_(0), last_total_time_(0), last_idle_time_(0), last_process_utime_(0),
+      last_process_stime_(0), latency_file_(options.latency_file) {
     process_start_time_ = std::chrono::steady_clock::now();
+    sample_ = {};
+    // 核心数与时钟频率进程内不变，只查询一次
+    cpu_cores_ = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpu_cores_ <= 0) cpu_cores_ = 1;
+    clock_ticks_ = sysconf(_SC_CLK_TCK);
+    if (clock_ticks_ <= 0) clock_ticks_ = 100;
     last_io_stats_ = {};
     last_network_stats_ = {};
-    prometheus_exporter_ = std::make_unique<PrometheusExporter>(prometheus_address);
+    last_compact_time_ns_ = 0;
+    last_compact_cpu_us_ = 0;
+    last_compact_ctx_switches_ = 0;
+    last_report_time_ns_ = 0;
+    window_samples_.resize(kSampleHistory);
+    window_values_.reserve(kSampleHistory);
+    std::fill(std::begin(last_perf_totals_), std::end(last_perf_totals_), 0);
+    if (options.enable_perf_counters) {
+        perf_counters_ = std::make_unique<PerfCounters>();
+        if (perf_counters_->availableMask() == 0) {
+            log("Hardware counters unavailable: " + perf_counters_->unavailableReason());
+        } else {
+            perf_counters_->read(last_perf_totals_);
+        }
+    }
+    if (options.registry) {
+        prometheus_address_.clear();
+        prometheus_exporter_ = std::make_unique<PrometheusExporter>(options.registry, options.max_thread_series);
+    } else if (options.enable_prometheus) {
+        prometheus_exporter_ = std::make_unique<PrometheusExporter>(options.prometheus_address,
+                                                                    options.max_thread_series);
+    } else {
+        prometheus_address_.clear();
+    }
 }
 
 SystemMonitor::~SystemMonitor() {
@@ -23,16 +64,25 @@ SystemMonitor::~SystemMonitor() {
 }
 
 void SystemMonitor::start(int interval_seconds) {
+    start(std::chrono::seconds(interval_seconds));
+}
+
+void SystemMonitor::start(std::chrono::milliseconds report_interval, std::chrono::milliseconds sample_interval) {
     if (running_.load()) {
-        std::cout << "System monitor is already running" << std::endl;
+        log("System monitor is already running");
         return;
     }
     
-    interval_seconds_ = interval_seconds;
+    setInterval(report_interval);
+    setSampleInterval(sample_interval);
     running_ = true;
     monitor_thread_ = std::make_unique<std::thread>(&SystemMonitor::monitorLoop, this);
     
-    std::cout << "System monitor started with " << interval_seconds << " seconds interval" << std::endl;
+    std::string message = "System monitor started with " + std::to_string(interval_ms_.load()) + " ms interval";
+    if (sample_interval_ms_.load() > 0) {
+        message += ", sampling every " + std::to_string(sample_interval_ms_.load()) + " ms";
+    }
+    log(message);
 }
 
 void SystemMonitor::stop() {
@@ -46,11 +96,53 @@ void SystemMonitor::stop() {
     }
     monitor_thread_.reset();
     
-    std::cout << "System monitor stopped" << std::endl;
+    log("System monitor stopped");
+}
+
+void SystemMonitor::log(const std::string& message) {
+    if (console_output_.load()) {
+        std::cout << message << std::endl;
+    }
+}
+
+void SystemMonitor::setConsoleOutput(bool enabled) {
+    console_output_ = enabled;
+}
+
+SystemMonitor::SubscriptionId SystemMonitor::subscribe(Subscriber subscriber) {
+    std::lock_guard<std::mutex> lock(subscribers_mutex_);
+    auto updated = std::make_shared<SubscriberList>(*subscribers_);
+    SubscriptionId id = next_subscription_id_++;
+    updated->emplace_back(id, std::move(subscriber));
+    std::atomic_store(&subscribers_, std::shared_ptr<const SubscriberList>(std::move(updated)));
+    return id;
+}
+
+void SystemMonitor::unsubscribe(SubscriptionId id) {
+    std::lock_guard<std::mutex> lock(subscribers_mutex_);
+    auto updated = std::make_shared<SubscriberList>();
+    for (const auto& entry : *subscribers_) {
+        if (entry.first != id) {
+            updated->push_back(entry);
+        }
+    }
+    std::atomic_store(&subscribers_, std::shared_ptr<const SubscriberList>(std::move(updated)));
 }
 
 void SystemMonitor::setInterval(int seconds) {
-    interval_seconds_ = seconds;
+    setInterval(std::chrono::seconds(seconds));
+}
+
+void SystemMonitor::setInterval(std::chrono::milliseconds interval) {
+    interval_ms_ = std::max<int64_t>(1, interval.count());
+}
+
+void SystemMonitor::setSampleInterval(std::chrono::milliseconds interval) {
+    sample_interval_ms_ = std::max<int64_t>(0, interval.count());
+}
+
+size_t SystemMonitor::getRecentSamples(CompactSample* out, size_t max_count) const {
+    return sample_ring_.readLatest(out, max_count);
 }
 
 bool SystemMonitor::isRunning() const {
@@ -62,66 +154,158 @@ std::string SystemMonitor::getPrometheusAddress() const {
 }
 
 SystemInfo SystemMonitor::getCurrentSystemInfo() {
-    SystemInfo info;
-    info.cpu_usage_percent = getCpuUsage();
-    
-    SystemInfo mem_info = getMemoryInfo();
-    info.memory_usage_percent = mem_info.memory_usage_percent;
-    info.memory_used_mb = mem_info.memory_used_mb;
-    info.memory_total_mb = mem_info.memory_total_mb;
-    
-    info.thread_count = getThreadCount();
+    SystemInfo info = {};
+
+    // 每个 /proc 文件每次采样只读取、解析一次
+    scraper_.scrape(sample_);
+
+    info.cpu_usage_percent = getCpuUsage(sample_);
+    getMemoryInfo(sample_, info);
+    info.thread_count = sample_.threads;
     info.timestamp = getCurrentTimestamp();
     
     // 新增健康检查信息
-    info.disk_io = getDiskIOInfo();
-    info.network = getNetworkInfo();
-    info.process = getProcessInfo();
-    info.system_load = getSystemLoadInfo();
-    info.cpu_temperatures = getCpuTemperatures();
-    info.cpu_frequencies = getCpuFrequencies();
-    info.system_uptime_seconds = getSystemUptime();
+    info.disk_io = getDiskIOInfo(sample_);
+    info.network = getNetworkInfo(sample_);
+    getInterfaceInfo(info);
+    getBlockDeviceInfo(info);
+    info.process = getProcessInfo(sample_);
+    info.system_load = getSystemLoadInfo(sample_);
+    info.cpu_temperatures = sample_.cpu_temperatures;
+    info.cpu_frequencies = sample_.cpu_frequencies_mhz;
+    info.system_uptime_seconds = static_cast<size_t>(sample_.uptime_seconds);
     info.process_uptime_seconds = getProcessUptime();
     
-    getDetailedMemoryInfo(info);
-    getProcessSchedulingInfo(info);
+    getDetailedMemoryInfo(sample_, info);
+    getProcessSchedulingInfo(sample_, info);
+    getThreadInfo(info);
+    getHardwareCounters(info);
+    getLatencyInfo(info);
     
     return info;
 }
 
 void SystemMonitor::monitorLoop() {
+    using clock = std::chrono::steady_clock;
+    auto next_sample = clock::now();
+    auto next_report = next_sample;
+    last_report_time_ns_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        next_sample.time_since_epoch()).count();
+
     while (running_.load()) {
-        SystemInfo info = getCurrentSystemInfo();
-        printSystemInfo(info);
-        
-        // 更新 Prometheus 指标
-        if (prometheus_exporter_) {
-            prometheus_exporter_->UpdateMetrics(info);
+        auto report_interval = std::chrono::milliseconds(interval_ms_.load());
+        int64_t sample_ms = sample_interval_ms_.load();
+        auto sample_interval = sample_ms > 0 ? std::chrono::milliseconds(sample_ms) : report_interval;
+
+        auto now = clock::now();
+        if (now >= next_sample) {
+            collectCompactSample();
+            // 按固定节拍推进；落后超过一个周期（线程被挂起等）时从当前时刻重新对齐，不补采
+            next_sample += sample_interval;
+            if (next_sample <= now) {
+                next_sample = now + sample_interval;
+            }
+        }
+
+        if (now >= next_report) {
+            int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+            SystemInfo info = getCurrentSystemInfo();
+            info.sample_window = aggregateWindow(last_report_time_ns_);
+            info.sample_window.sample_interval_ms = sample_interval.count();
+            last_report_time_ns_ = now_ns;
+
+            if (console_output_.load()) {
+                printSystemInfo(info);
+            }
+            
+            // 更新 Prometheus 指标
+            if (prometheus_exporter_) {
+                prometheus_exporter_->UpdateMetrics(info);
+            }
+
+            // 推送给订阅者，按引用传递不拷贝
+            std::shared_ptr<const SubscriberList> subscribers = std::atomic_load(&subscribers_);
+            for (const auto& entry : *subscribers) {
+                entry.second(info);
+            }
+
+            next_report += report_interval;
+            if (next_report <= now) {
+                next_report = now + report_interval;
+            }
         }
         
-        std::this_thread::sleep_for(std::chrono::seconds(interval_seconds_.load()));
+        std::this_thread::sleep_until(std::min(next_sample, next_report));
     }
 }
 
-double SystemMonitor::getCpuUsage() {
-    std::ifstream stat_file("/proc/self/stat");
-    if (!stat_file.is_open()) {
-        return -1.0;
+void SystemMonitor::collectCompactSample() {
+    // getrusage 一次系统调用取得微秒精度的 CPU 时间和上下文切换数，jiffies 精度不足以支撑 10ms 采样
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return;
     }
-    
-    std::string line;
-    std::getline(stat_file, line);
-    stat_file.close();
-    
-    std::istringstream iss(line);
-    std::string token;
-    unsigned long long utime = 0, stime = 0;
-    
-    // 跳过前13个字段，第14个是utime，第15个是stime
-    for (int i = 0; i < 13; ++i) {
-        iss >> token;
+
+    int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    int64_t cpu_us = (static_cast<int64_t>(usage.ru_utime.tv_sec) + usage.ru_stime.tv_sec) * 1000000 +
+                     usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+    int64_t ctx_switches = static_cast<int64_t>(usage.ru_nvcsw) + usage.ru_nivcsw;
+
+    if (last_compact_time_ns_ > 0 && now_ns > last_compact_time_ns_) {
+        double elapsed_us = (now_ns - last_compact_time_ns_) / 1000.0;
+        CompactSample sample;
+        sample.timestamp_ns = now_ns;
+        sample.cpu_usage_percent = 100.0 * (cpu_us - last_compact_cpu_us_) / elapsed_us / cpu_cores_;
+        sample.context_switches_per_sec = (ctx_switches - last_compact_ctx_switches_) * 1000000.0 / elapsed_us;
+        sample.memory_rss_kb = scraper_.residentKb();
+        sample_ring_.push(sample);
+    }
+
+    last_compact_time_ns_ = now_ns;
+    last_compact_cpu_us_ = cpu_us;
+    last_compact_ctx_switches_ = ctx_switches;
+}
+
+SampleWindowInfo SystemMonitor::aggregateWindow(int64_t window_start_ns) {
+    SampleWindowInfo window = {};
+
+    size_t copied = sample_ring_.readLatest(window_samples_.data(), window_samples_.size());
+    // 环形缓冲按时间升序，跳过窗口开始之前的样本
+    size_t first = 0;
+    while (first < copied && window_samples_[first].timestamp_ns <= window_start_ns) {
+        ++first;
+    }
+    window.sample_count = copied - first;
+    if (window.sample_count == 0) {
+        return window;
     }
-    iss >> utime >> stime;
+
+    auto summarize = [this, first, copied](auto field) {
+        window_values_.clear();
+        for (size_t i = first; i < copied; ++i) {
+            window_values_.push_back(field(window_samples_[i]));
+        }
+        WindowStat stat;
+        auto minmax = std::minmax_element(window_values_.begin(), window_values_.end());
+        stat.min = *minmax.first;
+        stat.max = *minmax.second;
+        // 最近秩法：第 ceil(0.99 * n) 个值
+        size_t rank = (window_values_.size() * 99 + 99) / 100 - 1;
+        std::nth_element(window_values_.begin(), window_values_.begin() + rank, window_values_.end());
+        stat.p99 = window_values_[rank];
+        return stat;
+    };
+
+    window.cpu_usage_percent = summarize([](const CompactSample& s) { return s.cpu_usage_percent; });
+    window.memory_rss_mb = summarize([](const CompactSample& s) { return s.memory_rss_kb / 1024.0; });
+    window.context_switches_per_sec = summarize([](const CompactSample& s) { return s.context_switches_per_sec; });
+    return window;
+}
+
+double SystemMonitor::getCpuUsage(const ProcSample& sample) {
+    unsigned long long utime = sample.utime;
+    unsigned long long stime = sample.stime;
     
     auto current_time = std::chrono::steady_clock::now();
     
@@ -138,19 +322,11 @@ double SystemMonitor::getCpuUsage() {
     
     double cpu_usage = 0.0;
     if (wall_time_delta > 0) {
-        // 获取系统CPU核心数
-        long cpu_cores = sysconf(_SC_NPROCESSORS_ONLN);
-        if (cpu_cores <= 0) cpu_cores = 1;
-        
-        // 获取时钟频率 (通常是100 Hz)
-        long clock_ticks = sysconf(_SC_CLK_TCK);
-        if (clock_ticks <= 0) clock_ticks = 100;
-        
         // 将进程时间从jiffies转换为微秒
-        double process_time_us = (double)process_time_delta * 1000000.0 / clock_ticks;
+        double process_time_us = (double)process_time_delta * 1000000.0 / clock_ticks_;
         
         // 计算CPU使用率 (相对于所有核心)
-        cpu_usage = 100.0 * process_time_us / wall_time_delta / cpu_cores;
+        cpu_usage = 100.0 * process_time_us / wall_time_delta / cpu_cores_;
     }
     
     last_process_utime_ = utime;
@@ -160,82 +336,14 @@ double SystemMonitor::getCpuUsage() {
     return cpu_usage;
 }
 
-SystemInfo SystemMonitor::getMemoryInfo() {
-    SystemInfo info = {};
-    
-    // 从 /proc/self/status 读取内存信息
-    std::ifstream status("/proc/self/status");
-    if (!status.is_open()) {
-        return info;
-    }
+void SystemMonitor::getMemoryInfo(const ProcSample& sample, SystemInfo& info) {
+    info.memory_used_mb = sample.vm_rss_kb / 1024;  // 当前进程使用的物理内存(MB)
+    info.memory_total_mb = sample.mem_total_kb / 1024;  // 系统总内存(MB)
     
-    std::string line;
-    size_t vm_rss = 0, vm_peak = 0;
-    
-    while (std::getline(status, line)) {
-        std::istringstream iss(line);
-        std::string key;
-        size_t value;
-        std::string unit;
-        
-        if (iss >> key >> value >> unit) {
-            if (key == "VmRSS:") {  // 当前实际物理内存使用
-                vm_rss = value;
-            } else if (key == "VmPeak:") {  // 峰值虚拟内存
-                vm_peak = value;
-            }
-        }
-    }
-    status.close();
-    
-    // 获取系统总内存作为参考
-    std::ifstream meminfo("/proc/meminfo");
-    size_t sys_mem_total = 0;
-    if (meminfo.is_open()) {
-        std::string mem_line;
-        while (std::getline(meminfo, mem_line)) {
-            if (mem_line.substr(0, 9) == "MemTotal:") {
-                std::istringstream mem_iss(mem_line);
-                std::string key;
-                mem_iss >> key >> sys_mem_total;
-                break;
-            }
-        }
-        meminfo.close();
-    }
-    
-    info.memory_used_mb = vm_rss / 1024;  // 当前进程使用的物理内存(MB)
-    info.memory_total_mb = sys_mem_total / 1024;  // 系统总内存(MB)
-    
-    if (sys_mem_total > 0) {
+    if (sample.mem_total_kb > 0) {
         // 进程内存使用率 = 进程使用内存 / 系统总内存
-        info.memory_usage_percent = 100.0 * static_cast<double>(vm_rss) / sys_mem_total;
-    }
-    
-    return info;
-}
-
-size_t SystemMonitor::getThreadCount() {
-    size_t thread_count = 0;
-    
-    // 读取当前进程的线程数
-    std::ifstream status("/proc/self/status");
-    if (!status.is_open()) {
-        return 0;
-    }
-    
-    std::string line;
-    while (std::getline(status, line)) {
-        if (line.substr(0, 8) == "Threads:") {
-            std::istringstream iss(line);
-            std::string label;
-            iss >> label >> thread_count;
-            break;
-        }
+        info.memory_usage_percent = 100.0 * static_cast<double>(sample.vm_rss_kb) / sample.mem_total_kb;
     }
-    status.close();
-    
-    return thread_count;
 }
 
 std::string SystemMonitor::getCurrentTimestamp() {
@@ -251,42 +359,17 @@ std::string SystemMonitor::getCurrentTimestamp() {
     return ss.str();
 }
 
-DiskIOInfo SystemMonitor::getDiskIOInfo() {
+DiskIOInfo SystemMonitor::getDiskIOInfo(const ProcSample& sample) {
     DiskIOInfo info = {};
     
-    std::ifstream io_file("/proc/self/io");
-    if (!io_file.is_open()) {
-        return info;
-    }
-    
-    std::string line;
-    size_t read_bytes = 0, write_bytes = 0;
-    size_t read_syscalls = 0, write_syscalls = 0;
-    
-    while (std::getline(io_file, line)) {
-        std::istringstream iss(line);
-        std::string key;
-        size_t value;
-        
-        if (iss >> key >> value) {
-            if (key == "read_bytes:") {
-                read_bytes = value;
-            } else if (key == "write_bytes:") {
-                write_bytes = value;
-            } else if (key == "syscr:") {
-                read_syscalls = value;
-            } else if (key == "syscw:") {
-                write_syscalls = value;
-            }
-        }
-    }
-    io_file.close();
+    size_t read_bytes = sample.read_bytes, write_bytes = sample.write_bytes;
+    size_t read_syscalls = sample.syscr, write_syscalls = sample.syscw;
     
     auto current_time = std::chrono::steady_clock::now();
     
     if (last_io_stats_.timestamp.time_since_epoch().count() > 0) {
-        auto time_diff = std::chrono::duration_cast<std::chrono::seconds>(
-            current_time - last_io_stats_.timestamp).count();
+        // 报告间隔可能小于 1 秒，按浮点秒计算速率
+        double time_diff = std::chrono::duration<double>(current_time - last_io_stats_.timestamp).count();
         
         if (time_diff > 0) {
             info.read_bytes_per_sec = (read_bytes - last_io_stats_.read_bytes) / time_diff;
@@ -305,46 +388,17 @@ DiskIOInfo SystemMonitor::getDiskIOInfo() {
     return info;
 }
 
-NetworkInfo SystemMonitor::getNetworkInfo() {
+NetworkInfo SystemMonitor::getNetworkInfo(const ProcSample& sample) {
     NetworkInfo info = {};
     
-    std::ifstream net_file("/proc/net/dev");
-    if (!net_file.is_open()) {
-        return info;
-    }
-    
-    std::string line;
-    size_t total_bytes_recv = 0, total_bytes_sent = 0;
-    size_t total_packets_recv = 0, total_packets_sent = 0;
-    
-    // 跳过前两行标题
-    std::getline(net_file, line);
-    std::getline(net_file, line);
-    
-    while (std::getline(net_file, line)) {
-        std::istringstream iss(line);
-        std::string interface;
-        size_t bytes_recv, packets_recv, bytes_sent, packets_sent;
-        size_t dummy;
-        
-        if (iss >> interface >> bytes_recv >> packets_recv >> dummy >> dummy >> 
-                   dummy >> dummy >> dummy >> dummy >> bytes_sent >> packets_sent) {
-            // 排除回环接口
-            if (interface.find("lo:") == std::string::npos) {
-                total_bytes_recv += bytes_recv;
-                total_bytes_sent += bytes_sent;
-                total_packets_recv += packets_recv;
-                total_packets_sent += packets_sent;
-            }
-        }
-    }
-    net_file.close();
+    size_t total_bytes_recv = sample.net_bytes_recv, total_bytes_sent = sample.net_bytes_sent;
+    size_t total_packets_recv = sample.net_packets_recv, total_packets_sent = sample.net_packets_sent;
     
     auto current_time = std::chrono::steady_clock::now();
     
     if (last_network_stats_.timestamp.time_since_epoch().count() > 0) {
-        auto time_diff = std::chrono::duration_cast<std::chrono::seconds>(
-            current_time - last_network_stats_.timestamp).count();
+        // 报告间隔可能小于 1 秒，按浮点秒计算速率
+        double time_diff = std::chrono::duration<double>(current_time - last_network_stats_.timestamp).count();
         
         if (time_diff > 0) {
             info.bytes_recv_per_sec = (total_bytes_recv - last_network_stats_.bytes_recv) / time_diff;
@@ -363,138 +417,171 @@ NetworkInfo SystemMonitor::getNetworkInfo() {
     return info;
 }
 
-ProcessInfo SystemMonitor::getProcessInfo() {
-    ProcessInfo info = {};
-    
-    // 获取打开的文件描述符数量
-    std::string fd_dir = "/proc/self/fd";
-    DIR* dir = opendir(fd_dir.c_str());
-    if (dir) {
-        struct dirent* entry;
-        while ((entry = readdir(dir)) != nullptr) {
-            if (entry->d_name[0] != '.') {
-                info.open_files_count++;
-            }
-        }
-        closedir(dir);
+void SystemMonitor::getInterfaceInfo(SystemInfo& info) {
+    const std::vector<InterfaceSample>& samples = link_scraper_.scrape();
+    auto current_time = std::chrono::steady_clock::now();
+    double time_diff = 0.0;
+    if (last_interface_time_.time_since_epoch().count() > 0) {
+        time_diff = std::chrono::duration<double>(current_time - last_interface_time_).count();
     }
-    
-    // 获取最大文件描述符限制
-    std::ifstream limits("/proc/self/limits");
-    if (limits.is_open()) {
-        std::string line;
-        while (std::getline(limits, line)) {
-            if (line.find("Max open files") != std::string::npos) {
-                std::istringstream iss(line);
-                std::string dummy;
-                iss >> dummy >> dummy >> dummy >> info.max_open_files;
-                break;
+
+    info.interfaces.reserve(samples.size());
+    for (const InterfaceSample& sample : samples) {
+        InterfaceInfo iface = {};
+        iface.name = sample.name;
+        iface.up = sample.up;
+        iface.rx_errors = sample.rx_errors;
+        iface.tx_errors = sample.tx_errors;
+        iface.rx_dropped = sample.rx_dropped;
+        iface.tx_dropped = sample.tx_dropped;
+
+        // 新出现的接口或计数器被重置时本周期速率记为 0
+        auto it = last_interfaces_.find(iface.name);
+        if (it != last_interfaces_.end() && time_diff > 0) {
+            const InterfaceSample& last = it->second;
+            if (sample.rx_bytes >= last.rx_bytes && sample.tx_bytes >= last.tx_bytes) {
+                iface.bytes_recv_per_sec = (sample.rx_bytes - last.rx_bytes) / time_diff;
+                iface.bytes_sent_per_sec = (sample.tx_bytes - last.tx_bytes) / time_diff;
+                iface.packets_recv_per_sec = (sample.rx_packets - last.rx_packets) / time_diff;
+                iface.packets_sent_per_sec = (sample.tx_packets - last.tx_packets) / time_diff;
             }
+            it->second = sample;
+        } else {
+            last_interfaces_.emplace(iface.name, sample);
         }
-        limits.close();
-    }
-    
-    if (info.max_open_files > 0) {
-        info.file_descriptor_usage_percent = 100.0 * info.open_files_count / info.max_open_files;
+        info.interfaces.push_back(std::move(iface));
     }
-    
-    // 获取进程状态和上下文切换信息
-    std::ifstream status("/proc/self/status");
-    if (status.is_open()) {
-        std::string line;
-        while (std::getline(status, line)) {
-            std::istringstream iss(line);
-            std::string key;
-            
-            if (iss >> key) {
-                if (key == "State:") {
-                    iss >> info.process_state;
-                } else if (key == "voluntary_ctxt_switches:") {
-                    iss >> info.voluntary_context_switches;
-                } else if (key == "nonvoluntary_ctxt_switches:") {
-                    iss >> info.involuntary_context_switches;
-                }
-            }
+
+    // 清理已消失的接口
+    if (last_interfaces_.size() > samples.size()) {
+        for (auto it = last_interfaces_.begin(); it != last_interfaces_.end();) {
+            bool present = std::any_of(samples.begin(), samples.end(), [&it](const InterfaceSample& sample) {
+                return it->first == sample.name;
+            });
+            it = present ? std::next(it) : last_interfaces_.erase(it);
         }
-        status.close();
     }
-    
-    return info;
+    last_interface_time_ = current_time;
 }
 
-SystemLoadInfo SystemMonitor::getSystemLoadInfo() {
-    SystemLoadInfo info = {};
-    
-    std::ifstream loadavg("/proc/loadavg");
-    if (loadavg.is_open()) {
-        loadavg >> info.load_average_1min >> info.load_average_5min >> info.load_average_15min;
-        
-        std::string running_total;
-        loadavg >> running_total;
-        
-        size_t slash_pos = running_total.find('/');
-        if (slash_pos != std::string::npos) {
-            info.running_processes = std::stoul(running_total.substr(0, slash_pos));
-            info.total_processes = std::stoul(running_total.substr(slash_pos + 1));
+void SystemMonitor::getLatencyInfo(SystemInfo& info) {
+    // 上报方停止后文件不再更新，超过该时长的内容不再导出
+    constexpr int64_t kMaxAgeSeconds = 300;
+
+    if (latency_file_.empty()) {
+        return;
+    }
+    struct stat st;
+    if (stat(latency_file_.c_str(), &st) != 0 || time(nullptr) - st.st_mtime > kMaxAgeSeconds) {
+        return;
+    }
+
+    std::ifstream file(latency_file_);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        LatencyInfo latency = {};
+        if (fields >> latency.source >> latency.site >> latency.window_ms >> latency.count >> latency.mean_ns >>
+            latency.p50_ns >> latency.p99_ns >> latency.p999_ns >> latency.max_ns) {
+            info.latency.push_back(std::move(latency));
         }
-        loadavg.close();
     }
-    
-    return info;
 }
 
-std::vector<double> SystemMonitor::getCpuTemperatures() {
-    std::vector<double> temperatures;
-    
-    // 尝试从 /sys/class/thermal/ 读取温度
-    for (int i = 0; i < 8; ++i) {  // 最多检查8个温度传感器
-        std::string temp_file = "/sys/class/thermal/thermal_zone" + std::to_string(i) + "/temp";
-        std::ifstream temp_stream(temp_file);
-        
-        if (temp_stream.is_open()) {
-            int temp_millidegree;
-            temp_stream >> temp_millidegree;
-            temperatures.push_back(temp_millidegree / 1000.0);  // 转换为摄氏度
-            temp_stream.close();
+void SystemMonitor::getBlockDeviceInfo(SystemInfo& info) {
+    // /proc/diskstats 的扇区固定为 512 字节，与设备实际扇区大小无关
+    constexpr uint64_t kSectorBytes = 512;
+
+    const std::vector<BlockDeviceSample>& samples = disk_scraper_.scrape();
+    auto current_time = std::chrono::steady_clock::now();
+    double time_diff = 0.0;
+    if (last_block_device_time_.time_since_epoch().count() > 0) {
+        time_diff = std::chrono::duration<double>(current_time - last_block_device_time_).count();
+    }
+
+    info.block_devices.reserve(samples.size());
+    for (const BlockDeviceSample& sample : samples) {
+        BlockDeviceInfo device = {};
+        device.name = sample.name;
+        device.io_in_progress = sample.io_in_progress;
+
+        auto it = last_block_devices_.find(device.name);
+        if (it != last_block_devices_.end() && time_diff > 0) {
+            const BlockDeviceSample& last = it->second;
+            if (sample.reads_completed >= last.reads_completed && sample.writes_completed >= last.writes_completed) {
+                device.read_bytes_per_sec = (sample.sectors_read - last.sectors_read) * kSectorBytes / time_diff;
+                device.write_bytes_per_sec =
+                    (sample.sectors_written - last.sectors_written) * kSectorBytes / time_diff;
+                device.read_ops_per_sec = (sample.reads_completed - last.reads_completed) / time_diff;
+                device.write_ops_per_sec = (sample.writes_completed - last.writes_completed) / time_diff;
+                device.utilization_percent =
+                    std::min(100.0, (sample.io_time_ms - last.io_time_ms) / (time_diff * 10.0));
+            }
+            it->second = sample;
         } else {
-            break;
+            last_block_devices_.emplace(device.name, sample);
         }
+        info.block_devices.push_back(std::move(device));
     }
-    
-    return temperatures;
+
+    if (last_block_devices_.size() > samples.size()) {
+        for (auto it = last_block_devices_.begin(); it != last_block_devices_.end();) {
+            bool present = std::any_of(samples.begin(), samples.end(), [&it](const BlockDeviceSample& sample) {
+                return it->first == sample.name;
+            });
+            it = present ? std::next(it) : last_block_devices_.erase(it);
+        }
+    }
+    last_block_device_time_ = current_time;
 }
 
-std::vector<size_t> SystemMonitor::getCpuFrequencies() {
-    std::vector<size_t> frequencies;
-    
-    // 从 /proc/cpuinfo 读取CPU频率
-    std::ifstream cpuinfo("/proc/cpuinfo");
-    if (cpuinfo.is_open()) {
-        std::string line;
-        while (std::getline(cpuinfo, line)) {
-            if (line.find("cpu MHz") != std::string::npos) {
-                size_t colon_pos = line.find(':');
-                if (colon_pos != std::string::npos) {
-                    double freq_mhz = std::stod(line.substr(colon_pos + 1));
-                    frequencies.push_back(static_cast<size_t>(freq_mhz));
-                }
+size_t SystemMonitor::countOpenFiles() {
+    size_t count = 0;
+    DIR* dir = opendir("/proc/self/fd");
+    if (dir) {
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != nullptr) {
+            if (entry->d_name[0] != '.') {
+                count++;
             }
         }
-        cpuinfo.close();
+        closedir(dir);
     }
-    
-    return frequencies;
+    return count;
 }
 
-size_t SystemMonitor::getSystemUptime() {
-    std::ifstream uptime("/proc/uptime");
-    if (uptime.is_open()) {
-        double uptime_seconds;
-        uptime >> uptime_seconds;
-        uptime.close();
-        return static_cast<size_t>(uptime_seconds);
+ProcessInfo SystemMonitor::getProcessInfo(const ProcSample& sample) {
+    ProcessInfo info = {};
+    
+    // 获取打开的文件描述符数量
+    info.open_files_count = countOpenFiles();
+    info.max_open_files = sample.max_open_files;
+    
+    if (info.max_open_files > 0) {
+        info.file_descriptor_usage_percent = 100.0 * info.open_files_count / info.max_open_files;
     }
-    return 0;
+    
+    // 进程状态和上下文切换信息
+    if (sample.state != '\0') {
+        info.process_state.assign(1, sample.state);
+    }
+    info.voluntary_context_switches = sample.voluntary_ctxt_switches;
+    info.involuntary_context_switches = sample.nonvoluntary_ctxt_switches;
+    
+    return info;
+}
+
+SystemLoadInfo SystemMonitor::getSystemLoadInfo(const ProcSample& sample) {
+    SystemLoadInfo info = {};
+    info.load_average_1min = sample.load_average_1min;
+    info.load_average_5min = sample.load_average_5min;
+    info.load_average_15min = sample.load_average_15min;
+    info.running_processes = sample.running_processes;
+    info.total_processes = sample.total_processes;
+    return info;
 }
 
 size_t SystemMonitor::getProcessUptime() {
@@ -503,62 +590,94 @@ size_t SystemMonitor::getProcessUptime() {
     return std::chrono::duration_cast<std::chrono::seconds>(uptime_duration).count();
 }
 
-void SystemMonitor::getDetailedMemoryInfo(SystemInfo& info) {
-    std::ifstream meminfo("/proc/meminfo");
-    if (meminfo.is_open()) {
-        std::string line;
-        while (std::getline(meminfo, line)) {
-            std::istringstream iss(line);
-            std::string key;
-            size_t value;
-            
-            if (iss >> key >> value) {
-                if (key == "MemAvailable:") {
-                    info.memory_available_mb = value / 1024;
-                } else if (key == "Buffers:") {
-                    info.memory_buffers_mb = value / 1024;
-                } else if (key == "Cached:") {
-                    info.memory_cached_mb = value / 1024;
-                } else if (key == "SwapTotal:") {
-                    info.swap_total_mb = value / 1024;
-                } else if (key == "SwapFree:") {
-                    size_t swap_free_mb = value / 1024;
-                    info.swap_used_mb = info.swap_total_mb - swap_free_mb;
-                }
-            }
-        }
-        meminfo.close();
-    }
+void SystemMonitor::getDetailedMemoryInfo(const ProcSample& sample, SystemInfo& info) {
+    info.memory_available_mb = sample.mem_available_kb / 1024;
+    info.memory_buffers_mb = sample.buffers_kb / 1024;
+    info.memory_cached_mb = sample.cached_kb / 1024;
+    info.swap_total_mb = sample.swap_total_kb / 1024;
+    info.swap_used_mb = info.swap_total_mb - sample.swap_free_kb / 1024;
 }
 
-void SystemMonitor::getProcessSchedulingInfo(SystemInfo& info) {
-    std::ifstream stat("/proc/self/stat");
-    if (stat.is_open()) {
-        std::string line;
-        std::getline(stat, line);
-        stat.close();
-        
-        std::istringstream iss(line);
-        std::string token;
-        
-        // 跳到第18个字段 (priority) 和第19个字段 (nice)
-        for (int i = 0; i < 17; ++i) {
-            iss >> token;
+void SystemMonitor::getThreadInfo(SystemInfo& info) {
+    const std::vector<ThreadSample>& samples = thread_scraper_.scrape();
+    auto current_time = std::chrono::steady_clock::now();
+    double elapsed_ticks = 0.0;
+    if (last_thread_time_.time_since_epoch().count() > 0) {
+        elapsed_ticks = std::chrono::duration<double>(current_time - last_thread_time_).count() * clock_ticks_;
+    }
+
+    for (auto& item : last_thread_times_) {
+        item.second.seen = false;
+    }
+
+    info.threads.reserve(samples.size());
+    for (const ThreadSample& sample : samples) {
+        ThreadInfo thread;
+        thread.tid = sample.tid;
+        thread.name = sample.name;
+        thread.cpu_user_percent = 0.0;
+        thread.cpu_system_percent = 0.0;
+        thread.last_cpu = sample.last_cpu;
+        thread.voluntary_context_switches = sample.voluntary_ctxt_switches;
+        thread.involuntary_context_switches = sample.nonvoluntary_ctxt_switches;
+
+        // 新出现的线程没有上一次的值，本周期记为 0
+        auto it = last_thread_times_.find(sample.tid);
+        if (it != last_thread_times_.end() && elapsed_ticks > 0.0) {
+            thread.cpu_user_percent = 100.0 * (sample.utime - it->second.utime) / elapsed_ticks;
+            thread.cpu_system_percent = 100.0 * (sample.stime - it->second.stime) / elapsed_ticks;
         }
-        iss >> info.process_priority >> info.process_nice_value;
+        last_thread_times_[sample.tid] = {sample.utime, sample.stime, true};
+        info.threads.push_back(std::move(thread));
     }
-    
-    // 获取调度策略
-    std::ifstream sched("/proc/self/sched");
-    if (sched.is_open()) {
-        std::string line;
-        if (std::getline(sched, line)) {
-            if (line.find("policy") != std::string::npos) {
-                info.scheduler_policy = line;
-            }
+
+    for (auto it = last_thread_times_.begin(); it != last_thread_times_.end();) {
+        if (it->second.seen) {
+            ++it;
+        } else {
+            it = last_thread_times_.erase(it);
         }
-        sched.close();
     }
+    last_thread_time_ = current_time;
+
+    std::sort(info.threads.begin(), info.threads.end(), [](const ThreadInfo& a, const ThreadInfo& b) {
+        return a.cpu_user_percent + a.cpu_system_percent > b.cpu_user_percent + b.cpu_system_percent;
+    });
+}
+
+void SystemMonitor::getHardwareCounters(SystemInfo& info) {
+    HardwareCounterInfo& hardware = info.hardware;
+    hardware.enabled = perf_counters_ != nullptr;
+    if (!perf_counters_) {
+        return;
+    }
+    hardware.available_mask = perf_counters_->availableMask();
+    hardware.unavailable_reason = perf_counters_->unavailableReason();
+
+    // 新线程从打开计数器时开始计数，本周期内打开前的部分不计入
+    perf_counters_->syncThreads(thread_scraper_.samples());
+
+    uint64_t totals[PerfCounters::kEventCount];
+    perf_counters_->read(totals);
+    uint64_t deltas[PerfCounters::kEventCount];
+    for (size_t i = 0; i < PerfCounters::kEventCount; ++i) {
+        deltas[i] = totals[i] > last_perf_totals_[i] ? totals[i] - last_perf_totals_[i] : 0;
+        last_perf_totals_[i] = totals[i];
+    }
+
+    hardware.cycles = deltas[static_cast<size_t>(PerfEvent::Cycles)];
+    hardware.instructions = deltas[static_cast<size_t>(PerfEvent::Instructions)];
+    hardware.llc_misses = deltas[static_cast<size_t>(PerfEvent::LlcMisses)];
+    hardware.branch_misses = deltas[static_cast<size_t>(PerfEvent::BranchMisses)];
+    hardware.page_faults = deltas[static_cast<size_t>(PerfEvent::PageFaults)];
+    hardware.ipc = hardware.cycles > 0 ? static_cast<double>(hardware.instructions) / hardware.cycles : 0.0;
+}
+
+void SystemMonitor::getProcessSchedulingInfo(const ProcSample& sample, SystemInfo& info) {
+    info.process_priority = static_cast<int>(sample.priority);
+    info.process_nice_value = static_cast<int>(sample.nice);
+    // 调度策略取自 /proc/self/stat，不依赖需要 CONFIG_SCHED_DEBUG 的 /proc/self/sched
+    info.scheduler_policy = schedulerPolicyName(sample.policy);
 }
 
 void SystemMonitor::printSystemInfo(const SystemInfo& info) {
@@ -595,6 +714,24 @@ void SystemMonitor::printSystemInfo(const SystemInfo& info) {
     std::cout << "TX: " << info.network.bytes_sent_per_sec / 1024 << " KB/s (" 
               << info.network.packets_sent_per_sec << " pkt/s)" << std::endl;
     
+    for (const InterfaceInfo& iface : info.interfaces) {
+        std::cout << "  " << iface.name << (iface.up ? "" : " (down)") << ": RX "
+                  << iface.bytes_recv_per_sec / 1024 << " KB/s, TX " << iface.bytes_sent_per_sec / 1024
+                  << " KB/s, errors " << iface.rx_errors << "/" << iface.tx_errors << ", dropped "
+                  << iface.rx_dropped << "/" << iface.tx_dropped << std::endl;
+    }
+
+    // 块设备
+    if (!info.block_devices.empty()) {
+        std::cout << "\n--- Block Devices ---" << std::endl;
+        for (const BlockDeviceInfo& device : info.block_devices) {
+            std::cout << device.name << ": read " << device.read_bytes_per_sec / 1024 << " KB/s ("
+                      << device.read_ops_per_sec << " ops/s), write " << device.write_bytes_per_sec / 1024
+                      << " KB/s (" << device.write_ops_per_sec << " ops/s), util " << std::setprecision(1)
+                      << device.utilization_percent << "%" << std::endl;
+        }
+    }
+    
     // 进程状态
     std::cout << "\n--- Process Status ---" << std::endl;
     std::cout << "State: " << info.process.process_state << std::endl;
@@ -611,6 +748,60 @@ void SystemMonitor::printSystemInfo(const SystemInfo& info) {
     std::cout << "Process: " << info.process_uptime_seconds / 3600 << "h " 
               << (info.process_uptime_seconds % 3600) / 60 << "m" << std::endl;
     
+    // 最忙的线程
+    if (!info.threads.empty()) {
+        std::cout << "\n--- Top Threads ---" << std::endl;
+        size_t shown = std::min<size_t>(info.threads.size(), 5);
+        for (size_t i = 0; i < shown; ++i) {
+            const ThreadInfo& thread = info.threads[i];
+            std::cout << thread.tid << " " << thread.name << ": " << std::setprecision(1)
+                      << thread.cpu_user_percent << "% usr " << thread.cpu_system_percent << "% sys, cpu "
+                      << thread.last_cpu << ", ctxsw " << thread.voluntary_context_switches << "/"
+                      << thread.involuntary_context_switches << std::endl;
+        }
+    }
+
+    // 高频采样窗口
+    if (info.sample_window.sample_count > 0) {
+        const SampleWindowInfo& window = info.sample_window;
+        std::cout << "\n--- Sample Window (" << window.sample_count << " samples @ "
+                  << window.sample_interval_ms << "ms) ---" << std::endl;
+        std::cout << "CPU Usage min/max/p99: " << std::setprecision(2) << window.cpu_usage_percent.min << "% / "
+                  << window.cpu_usage_percent.max << "% / " << window.cpu_usage_percent.p99 << "%" << std::endl;
+        std::cout << "RSS min/max/p99: " << window.memory_rss_mb.min << "MB / " << window.memory_rss_mb.max
+                  << "MB / " << window.memory_rss_mb.p99 << "MB" << std::endl;
+        std::cout << "Context Switches/s min/max/p99: " << std::setprecision(0)
+                  << window.context_switches_per_sec.min << " / " << window.context_switches_per_sec.max << " / "
+                  << window.context_switches_per_sec.p99 << std::endl;
+    }
+
+    // 硬件计数器
+    if (info.hardware.enabled) {
+        const HardwareCounterInfo& hardware = info.hardware;
+        std::cout << "\n--- Hardware Counters ---" << std::endl;
+        if (hardware.available_mask == 0) {
+            std::cout << "Unavailable: " << hardware.unavailable_reason << std::endl;
+            std::cout << "Page Faults: " << hardware.page_faults << std::endl;
+        } else {
+            std::cout << "Cycles: " << hardware.cycles << ", Instructions: " << hardware.instructions
+                      << ", IPC: " << std::setprecision(2) << hardware.ipc << std::endl;
+            std::cout << "LLC Misses: " << hardware.llc_misses << ", Branch Misses: " << hardware.branch_misses
+                      << ", Page Faults: " << hardware.page_faults << std::endl;
+        }
+    }
+    
+    // 外部上报的耗时分布
+    if (!info.latency.empty()) {
+        std::cout << "\n--- Reported Latency (us) ---" << std::endl;
+        for (const LatencyInfo& latency : info.latency) {
+            double scale = latency.isCount() ? 1.0 : 1000.0;
+            std::cout << latency.source << " " << latency.site << ": count " << latency.count
+                      << ", p50/p99/p999/max " << std::setprecision(1) << latency.p50_ns / scale << " / "
+                      << latency.p99_ns / scale << " / " << latency.p999_ns / scale << " / "
+                      << latency.max_ns / scale << std::endl;
+        }
+    }
+    
     // CPU温度 (如果可用)
     if (!info.cpu_temperatures.empty()) {
         std::cout << "\n--- CPU Temperature ---" << std::endl;
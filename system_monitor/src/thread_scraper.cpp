@@ -0,0 +1,105 @@
+#include "thread_scraper.h"
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+ThreadScraper::ThreadScraper() : task_dir_(opendir("/proc/self/task")) {
+}
+
+ThreadScraper::~ThreadScraper() {
+    if (task_dir_) {
+        closedir(task_dir_);
+    }
+}
+
+const std::vector<ThreadSample>& ThreadScraper::scrape() {
+    samples_.clear();
+    if (!task_dir_) {
+        return samples_;
+    }
+
+    for (auto& item : entries_) {
+        item.second.seen = false;
+    }
+
+    rewinddir(task_dir_);
+    struct dirent* dir_entry;
+    while ((dir_entry = readdir(task_dir_)) != nullptr) {
+        if (dir_entry->d_name[0] < '0' || dir_entry->d_name[0] > '9') {
+            continue;
+        }
+        int tid = std::atoi(dir_entry->d_name);
+
+        auto it = entries_.find(tid);
+        if (it == entries_.end()) {
+            std::string base = std::string("/proc/self/task/") + dir_entry->d_name;
+            it = entries_.emplace(tid, Entry{ProcFile((base + "/stat").c_str(), 1024),
+                                             ProcFile((base + "/status").c_str(), 2048), false}).first;
+        }
+
+        ThreadSample sample = {};
+        sample.tid = tid;
+        // 线程可能在遍历与读取之间退出，读取失败的直接丢弃
+        if (readThread(it->second, sample)) {
+            it->second.seen = true;
+            samples_.push_back(sample);
+        }
+    }
+
+    // 关闭已退出线程的文件
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (it->second.seen) {
+            ++it;
+        } else {
+            it = entries_.erase(it);
+        }
+    }
+    return samples_;
+}
+
+bool ThreadScraper::readThread(Entry& entry, ThreadSample& sample) {
+    std::string_view stat = entry.stat.read();
+    size_t comm_begin = stat.find('(');
+    size_t comm_end = stat.rfind(')');
+    if (comm_begin == std::string_view::npos || comm_end == std::string_view::npos || comm_end < comm_begin) {
+        return false;
+    }
+
+    size_t name_size = comm_end - comm_begin - 1;
+    if (name_size >= sizeof(sample.name)) {
+        name_size = sizeof(sample.name) - 1;
+    }
+    std::memcpy(sample.name, stat.data() + comm_begin + 1, name_size);
+    sample.name[name_size] = '\0';
+
+    const char* p = stat.data() + comm_end + 1;
+    const char* end = stat.data() + stat.size();
+    for (int field = 3; field <= 39; ++field) {
+        if (field == 14 || field == 15 || field == 39) {
+            long long value = 0;
+            if (!proc_parse::parseSigned(p, end, value)) {
+                return false;
+            }
+            if (field == 14) {
+                sample.utime = static_cast<unsigned long long>(value);
+            } else if (field == 15) {
+                sample.stime = static_cast<unsigned long long>(value);
+            } else {
+                sample.last_cpu = static_cast<int>(value);
+            }
+        } else if (proc_parse::nextToken(p, end).empty()) {
+            return false;
+        }
+    }
+
+    std::string_view status = entry.status.read();
+    if (status.empty()) {
+        return false;
+    }
+    proc_parse::forEachLine(status, [&sample](std::string_view line) {
+        if (!proc_parse::parseKeyValue(line, "voluntary_ctxt_switches:", sample.voluntary_ctxt_switches)) {
+            proc_parse::parseKeyValue(line, "nonvoluntary_ctxt_switches:", sample.nonvoluntary_ctxt_switches);
+        }
+    });
+    return true;
+}